@@ -56,3 +56,18 @@ QStringList sortedStrings(QStringList seq)
     return seq;
 }
 //! [0]
+
+//! [1]
+QList<Customer> sortedByName(const QList<Customer> &customers)
+{
+    QStringList names;
+    for (const Customer &customer : customers)
+        names.append(customer.name);
+
+    const QCollatorSortKeys keys = QCollator().sortKeys(names);
+    QList<Customer> result;
+    for (qsizetype i : keys.sortedIndexes())
+        result.append(customers.at(i));
+    return result;
+}
+//! [1]
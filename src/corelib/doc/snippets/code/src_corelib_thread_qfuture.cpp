@@ -398,3 +398,25 @@ QtFuture::whenAny(intFuture, stringFuture, voidFuture).then([](const FuturesVari
     ...
 });
 //! [27]
+
+//! [28]
+// Task is any coroutine return type, for example one from a coroutine library
+Task loadAndShow(QFuture<QByteArray> download)
+{
+    QByteArray data = co_await download;    // suspends until the download finishes
+    QImage image = co_await QtConcurrent::run(decode, data);
+    label->setPixmap(QPixmap::fromImage(image));
+}
+//! [28]
+
+//! [29]
+Task waitForReply(Object *object)
+{
+    std::optional<std::tuple<int, double>> values =
+            co_await QtFuture::nextSignal(object, &Object::multipleArgs);
+    if (!values)
+        co_return; // object was destroyed first
+    auto [i, d] = *values;
+    ...
+}
+//! [29]
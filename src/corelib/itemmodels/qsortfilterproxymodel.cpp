@@ -40,6 +40,7 @@
 #include "qsortfilterproxymodel.h"
 #include "qitemselectionmodel.h"
 #include <qsize.h>
+#include <qcollator.h>
 #include <qdebug.h>
 #include <qdatetime.h>
 #include <qpair.h>
@@ -180,6 +181,12 @@ public:
     void setSortLocaleAwareForwarder(bool on) { q_func()->setSortLocaleAware(on); }
     void sortLocaleAwareChangedForwarder(bool on) { emit q_func()->sortLocaleAwareChanged(on); }
 
+    void setSortUsingCollationKeysForwarder(bool on) { q_func()->setSortUsingCollationKeys(on); }
+    void sortUsingCollationKeysChangedForwarder(bool on)
+    {
+        emit q_func()->sortUsingCollationKeysChanged(on);
+    }
+
     void setFilterKeyColumnForwarder(int column) { q_func()->setFilterKeyColumn(column); }
 
     void setFilterRoleForwarder(int role) { q_func()->setFilterRole(role); }
@@ -245,6 +252,11 @@ public:
             &QSortFilterProxyModelPrivate::setSortLocaleAwareForwarder,
             &QSortFilterProxyModelPrivate::sortLocaleAwareChangedForwarder, false)
 
+    Q_OBJECT_COMPAT_PROPERTY_WITH_ARGS(
+            QSortFilterProxyModelPrivate, bool, sort_collation_keys,
+            &QSortFilterProxyModelPrivate::setSortUsingCollationKeysForwarder,
+            &QSortFilterProxyModelPrivate::sortUsingCollationKeysChangedForwarder, false)
+
     Q_OBJECT_COMPAT_PROPERTY_WITH_ARGS(
             QSortFilterProxyModelPrivate, bool, filter_recursive,
             &QSortFilterProxyModelPrivate::setRecursiveFilteringEnabledForwarder,
@@ -367,6 +379,8 @@ public:
     int find_source_sort_column() const;
     void sort_source_rows(QList<int> &source_rows,
                           const QModelIndex &source_parent) const;
+    bool sort_source_rows_by_collation_keys(QList<int> &source_rows,
+                                            const QModelIndex &source_parent) const;
     QList<QPair<int, QList<int>>> proxy_intervals_for_source_items_to_add(
         const QList<int> &proxy_to_source, const QList<int> &source_items,
         const QModelIndex &source_parent, Qt::Orientation orient) const;
@@ -716,6 +730,10 @@ void QSortFilterProxyModelPrivate::sort_source_rows(
 {
     Q_Q(const QSortFilterProxyModel);
     if (source_sort_column >= 0) {
+        if (sort_localeaware && sort_collation_keys
+                && sort_source_rows_by_collation_keys(source_rows, source_parent)) {
+            return;
+        }
         if (sort_order == Qt::AscendingOrder) {
             QSortFilterProxyModelLessThan lt(source_sort_column, source_parent, model, q);
             std::stable_sort(source_rows.begin(), source_rows.end(), lt);
@@ -728,6 +746,36 @@ void QSortFilterProxyModelPrivate::sort_source_rows(
     }
 }
 
+/*!
+  \internal
+
+  Sorts the given \a source_rows by the collation keys of their data for the
+  sort role, which gives the same order as the locale aware lessThan(), and
+  returns \c true. Returns \c false without sorting if the data is not a
+  string for some of the rows.
+*/
+bool QSortFilterProxyModelPrivate::sort_source_rows_by_collation_keys(
+    QList<int> &source_rows, const QModelIndex &source_parent) const
+{
+    QStringList strings;
+    strings.reserve(source_rows.size());
+    for (int row : std::as_const(source_rows)) {
+        const QVariant value = model->data(model->index(row, source_sort_column, source_parent),
+                                           sort_role);
+        if (value.userType() != QMetaType::QString)
+            return false;
+        strings.append(value.toString());
+    }
+
+    const QList<qsizetype> order = QCollator().sortKeys(strings).sortedIndexes(sort_order);
+    QList<int> sorted;
+    sorted.reserve(source_rows.size());
+    for (qsizetype i : order)
+        sorted.append(source_rows.at(i));
+    source_rows = std::move(sorted);
+    return true;
+}
+
 /*!
   \internal
 
@@ -3046,6 +3094,54 @@ QBindable<int> QSortFilterProxyModel::bindableFilterRole()
     return QBindable<int>(&d->filter_role);
 }
 
+/*!
+    \since 6.4
+    \property QSortFilterProxyModel::sortUsingCollationKeys
+    \brief whether locale aware sorting compares precomputed collation keys
+
+    If this property and \l isSortLocaleAware are both \c true, the proxy
+    model sorts rows whose data for the \l sortRole is a string by creating
+    the collation keys of all those strings with QCollator::sortKeys(), and
+    comparing the keys. This is much faster for large models than comparing
+    the strings themselves, but lessThan() is then not called; do not enable
+    this property in a subclass that reimplements lessThan().
+
+    If the data of any row is not a string, lessThan() is used as usual.
+
+    The default value is false.
+
+    \sa isSortLocaleAware, QCollatorSortKeys
+*/
+
+/*!
+    \since 6.4
+    \fn void QSortFilterProxyModel::sortUsingCollationKeysChanged(bool sortUsingCollationKeys)
+    \brief This signal is emitted when the collation key setting changes to
+           \a sortUsingCollationKeys.
+*/
+bool QSortFilterProxyModel::sortUsingCollationKeys() const
+{
+    Q_D(const QSortFilterProxyModel);
+    return d->sort_collation_keys;
+}
+
+void QSortFilterProxyModel::setSortUsingCollationKeys(bool on)
+{
+    Q_D(QSortFilterProxyModel);
+    d->sort_collation_keys.removeBindingUnlessInWrapper();
+    if (d->sort_collation_keys == on)
+        return;
+
+    d->sort_collation_keys.setValueBypassingBindings(on);
+    d->sort_collation_keys.notify(); // also emits a signal
+}
+
+QBindable<bool> QSortFilterProxyModel::bindableSortUsingCollationKeys()
+{
+    Q_D(QSortFilterProxyModel);
+    return QBindable<bool>(&d->sort_collation_keys);
+}
+
 /*!
     \since 5.10
     \property QSortFilterProxyModel::recursiveFilteringEnabled
@@ -82,6 +82,9 @@ class Q_CORE_EXPORT QSortFilterProxyModel : public QAbstractProxyModel
                BINDABLE bindableRecursiveFilteringEnabled)
     Q_PROPERTY(bool autoAcceptChildRows READ autoAcceptChildRows WRITE setAutoAcceptChildRows
                NOTIFY autoAcceptChildRowsChanged BINDABLE bindableAutoAcceptChildRows)
+    Q_PROPERTY(bool sortUsingCollationKeys READ sortUsingCollationKeys
+               WRITE setSortUsingCollationKeys NOTIFY sortUsingCollationKeysChanged
+               BINDABLE bindableSortUsingCollationKeys)
 
 public:
     explicit QSortFilterProxyModel(QObject *parent = nullptr);
@@ -114,6 +117,10 @@ public:
     void setSortLocaleAware(bool on);
     QBindable<bool> bindableIsSortLocaleAware();
 
+    bool sortUsingCollationKeys() const;
+    void setSortUsingCollationKeys(bool on);
+    QBindable<bool> bindableSortUsingCollationKeys();
+
     int sortColumn() const;
     Qt::SortOrder sortOrder() const;
 
@@ -200,6 +207,7 @@ Q_SIGNALS:
     void filterCaseSensitivityChanged(Qt::CaseSensitivity filterCaseSensitivity);
     void sortCaseSensitivityChanged(Qt::CaseSensitivity sortCaseSensitivity);
     void sortLocaleAwareChanged(bool sortLocaleAware);
+    void sortUsingCollationKeysChanged(bool sortUsingCollationKeys);
     void sortRoleChanged(int sortRole);
     void filterRoleChanged(int filterRole);
     void recursiveFilteringEnabledChanged(bool recursiveFilteringEnabled);
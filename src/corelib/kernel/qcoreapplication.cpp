@@ -72,6 +72,7 @@
 #include <qelapsedtimer.h>
 #include <qlibraryinfo.h>
 #include <qvarlengtharray.h>
+#include <private/qeventpool_p.h>
 #include <private/qfactoryloader_p.h>
 #include <private/qfunctions_p.h>
 #include <private/qlocale_p.h>
@@ -360,10 +361,16 @@ Q_CONSTINIT bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
+    if (!currentThreadData->metaCallQueue.isEmpty()) {
+        const auto locker = qt_scoped_lock(currentThreadData->postEventList.mutex);
+        currentThreadData->flushMetaCallQueue();
+    }
     return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
 }
 
 Q_CONSTINIT QAbstractEventDispatcher *QCoreApplicationPrivate::eventDispatcher = nullptr;
+Q_CONSTINIT QBasicAtomicInteger<quint32>
+QCoreApplicationPrivate::compressedEventTypes[(QEvent::MaxUser + 1) / 32] = {};
 
 #endif // QT_NO_QOBJECT
 
@@ -508,15 +515,17 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         const auto locker = qt_scoped_lock(thisThreadData->postEventList.mutex);
+        thisThreadData->flushMetaCallQueue();
         for (int i = 0; i < thisThreadData->postEventList.size(); ++i) {
             const QPostEvent &pe = thisThreadData->postEventList.at(i);
             if (pe.event) {
                 --pe.receiver->d_func()->postedEvents;
                 pe.event->m_posted = false;
-                delete pe.event;
+                QEventPool::deleteEvent(pe.event);
             }
         }
         thisThreadData->postEventList.clear();
+        thisThreadData->postEventList.compressionIndex.clear();
         thisThreadData->postEventList.recursion = 0;
         thisThreadData->quitNow = false;
         threadData_clean = true;
@@ -913,6 +922,7 @@ QCoreApplication::~QCoreApplication()
     if (QCoreApplicationPrivate::eventDispatcher)
         QCoreApplicationPrivate::eventDispatcher->closingDown();
     QCoreApplicationPrivate::eventDispatcher = nullptr;
+    QEventPool::logStatistics();
 #endif
 
 #if QT_CONFIG(library)
@@ -1568,19 +1578,40 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
     // ### Qt 7: turn into an assert
     if (receiver == nullptr) {
         qWarning("QCoreApplication::postEvent: Unexpected null receiver");
-        delete event;
+        QEventPool::deleteEvent(event);
         return;
     }
 
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     if (!locker.threadData) {
         // posting during destruction? just delete the event to prevent a leak
-        delete event;
+        QEventPool::deleteEvent(event);
         return;
     }
 
     QThreadData *data = locker.threadData;
 
+    // keep the order with queued meta calls posted before this event
+    data->flushMetaCallQueue();
+
+    const bool compressible = QCoreApplicationPrivate::isEventCompressionEnabled(event->type());
+    if (compressible && receiver->d_func()->postedEvents) {
+        // replace the pending event of this type in place, so that the
+        // receiver only gets the latest one
+        QPostEvent *pending = data->postEventList.findCompressible(receiver, event->type());
+        if (pending && pending->priority == priority) {
+            Q_TRACE(QCoreApplication_postEvent_event_compressed, receiver, event);
+            QEvent *replaced = pending->event;
+            replaced->m_posted = false;
+            pending->event = event;
+            event->m_posted = true;
+            data->postEventList.compressionIndex[{ receiver, event->type() }].event = event;
+            locker.unlock();
+            QEventPool::deleteEvent(replaced);
+            return;
+        }
+    }
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1615,10 +1646,12 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     // delete the event on exceptions to protect against memory leaks till the event is
     // properly owned in the postEventList
-    std::unique_ptr<QEvent> eventDeleter(event);
+    std::unique_ptr<QEvent, QEventPoolDeleter> eventDeleter(event);
     Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
-    data->postEventList.addEvent(QPostEvent(receiver, event, priority));
+    const qsizetype position = data->postEventList.addEvent(QPostEvent(receiver, event, priority));
     Q_UNUSED(eventDeleter.release());
+    if (compressible)
+        data->postEventList.indexCompressible(position);
     event->m_posted = true;
     ++receiver->d_func()->postedEvents;
     data->canWait = false;
@@ -1629,6 +1662,114 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         dispatcher->wakeUp();
 }
 
+/*!
+    \internal
+
+    Posts the QMetaCallEvent \a event of a queued connection to \a receiver
+    with normal priority, like QCoreApplication::postEvent() does, but
+    without taking the receiving thread's post event list mutex: the event
+    is pushed to the thread's lock-free QMetaCallEventQueue, which the
+    receiving thread moves into its post event list in batches. The event
+    dispatcher is only woken up for the first event of each batch.
+
+    The caller must hold the receiver's signal slot lock, which keeps the
+    receiver and its thread data alive. Meta call events are never
+    compressed, so compressEvent() is not consulted.
+*/
+void QCoreApplicationPrivate::postMetaCallEvent(QObject *receiver, QMetaCallEvent *event)
+{
+    Q_ASSERT(receiver);
+    Q_ASSERT(event);
+
+    Q_TRACE_SCOPE(QCoreApplication_postEvent, receiver, event, event->type());
+
+    auto &threadData = QObjectPrivate::get(receiver)->threadData;
+    QThreadData *data = threadData.loadAcquire();
+    if (!data) {
+        // posting during destruction? just delete the event to prevent a leak
+        delete event;
+        return;
+    }
+
+    QMetaCallEventQueue &queue = data->metaCallQueue;
+    queue.beginPush();
+    if (Q_UNLIKELY(threadData.loadRelaxed() != data)) {
+        // the receiver is being moved to another thread, take the slow path
+        queue.endPush();
+        QCoreApplication::postEvent(receiver, event);
+        return;
+    }
+
+    Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
+    event->m_posted = true;
+    ++receiver->d_func()->postedEvents;
+    if (queue.push(receiver, event)) {
+        queue.countWakeUp();
+        if (QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire())
+            dispatcher->wakeUp();
+    }
+    // after this, data may be destroyed if the receiver was moved meanwhile
+    queue.endPush();
+}
+
+/*!
+    \since 6.4
+
+    Enables compression of posted events of the given \a type if \a enable
+    is \c true, and disables it otherwise.
+
+    When compression is enabled for a type, postEvent() replaces an event of
+    that type which is still pending for the same receiver, with the same
+    priority, by the new event, and deletes the old one. The replacement
+    keeps the old event's place in the queue, so the receiver only gets the
+    most recent event, and a producer that posts faster than the receiver
+    consumes does not make the queue grow. Pending events are looked up
+    through an index by receiver and type, so compressing an event takes
+    constant time no matter how many events are queued.
+
+    Compression is disabled for all types by default. Events posted while
+    compression was disabled are never replaced. QEvent::MetaCall and
+    QEvent::DeferredDelete events cannot be compressed.
+
+    \threadsafe
+
+    \sa isEventCompressionEnabled(), postEvent()
+*/
+void QCoreApplication::setEventCompressionEnabled(QEvent::Type type, bool enable)
+{
+    if (Q_UNLIKELY(type == QEvent::MetaCall || type == QEvent::DeferredDelete)) {
+        qWarning("QCoreApplication::setEventCompressionEnabled: Events of type %d cannot be compressed",
+                 int(type));
+        return;
+    }
+    const uint t = uint(type);
+    if (Q_UNLIKELY(t > QEvent::MaxUser)) {
+        qWarning("QCoreApplication::setEventCompressionEnabled: Invalid event type %d", int(type));
+        return;
+    }
+    auto &word = QCoreApplicationPrivate::compressedEventTypes[t / 32];
+    const quint32 bit = 1u << (t % 32);
+    if (enable)
+        word.fetchAndOrRelaxed(bit);
+    else
+        word.fetchAndAndRelaxed(~bit);
+}
+
+/*!
+    \since 6.4
+
+    Returns \c true if posted events of the given \a type are compressed;
+    otherwise returns \c false.
+
+    \threadsafe
+
+    \sa setEventCompressionEnabled()
+*/
+bool QCoreApplication::isEventCompressionEnabled(QEvent::Type type)
+{
+    return QCoreApplicationPrivate::isEventCompressionEnabled(type);
+}
+
 /*!
   \internal
   Returns \c true if \a event was compressed away (possibly deleted) and should not be added to the list.
@@ -1647,7 +1788,7 @@ bool QCoreApplication::compressEvent(QEvent *event, QObject *receiver, QPostEven
             const QPostEvent &e = postedEvents->at(i);
             if (e.receiver == receiver && e.event && e.event->type() == QEvent::Timer
                 && ((QTimerEvent *) e.event)->timerId() == timerId) {
-                delete event;
+                QEventPool::deleteEvent(event);
                 return true;
             }
         }
@@ -1658,7 +1799,7 @@ bool QCoreApplication::compressEvent(QEvent *event, QObject *receiver, QPostEven
     if (event->type() == QEvent::DeferredDelete) {
         if (receiver->d_ptr->deleteLaterCalled) {
             // there was a previous DeferredDelete event, so we can drop the new one
-            delete event;
+            QEventPool::deleteEvent(event);
             return true;
         }
         // deleteLaterCalled is set to true in postedEvents when queueing the very first
@@ -1674,7 +1815,7 @@ bool QCoreApplication::compressEvent(QEvent *event, QObject *receiver, QPostEven
                     || cur.event->type() != event->type())
                 continue;
             // found an event for this receiver
-            delete event;
+            QEventPool::deleteEvent(event);
             return true;
         }
     }
@@ -1726,6 +1867,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     auto locker = qt_unique_lock(data->postEventList.mutex);
+    data->flushMetaCallQueue();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1771,6 +1913,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
             if (!event_type && !receiver && data->postEventList.startOffset >= 0) {
                 const QPostEventList::iterator it = data->postEventList.begin();
                 data->postEventList.erase(it, it + data->postEventList.startOffset);
+                data->postEventList.erasedCount += data->postEventList.startOffset;
                 data->postEventList.insertionOffset -= data->postEventList.startOffset;
                 Q_ASSERT(data->postEventList.insertionOffset >= 0);
                 data->postEventList.startOffset = 0;
@@ -1839,12 +1982,13 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
 
         // next, update the data structure so that we're ready
         // for the next event.
+        data->postEventList.unindexCompressible(r, e);
         const_cast<QPostEvent &>(pe).event = nullptr;
 
         locker.unlock();
         const auto relocker = qScopeGuard([&locker] { locker.lock(); });
 
-        QScopedPointer<QEvent> event_deleter(e); // will delete the event (with the mutex unlocked)
+        QScopedPointer<QEvent, QEventPoolDeleter> event_deleter(e); // will delete the event (with the mutex unlocked)
 
         // after all that work, it's time to deliver the event.
         QCoreApplication::sendEvent(r, e);
@@ -1888,6 +2032,8 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
     if (receiver && !receiver->d_func()->postedEvents)
         return;
 
+    data->flushMetaCallQueue();
+
     //we will collect all the posted events for the QObject
     //and we'll delete after the mutex was unlocked
     QVarLengthArray<QEvent*> events;
@@ -1901,6 +2047,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
             && (pe.event && (eventType == 0 || pe.event->type() == eventType))) {
             --pe.receiver->d_func()->postedEvents;
             pe.event->m_posted = false;
+            data->postEventList.unindexCompressible(pe.receiver, pe.event);
             events.append(pe.event);
             const_cast<QPostEvent &>(pe).event = nullptr;
         } else if (!data->postEventList.recursion) {
@@ -1922,7 +2069,8 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
     }
 
     locker.unlock();
-    qDeleteAll(events);
+    for (QEvent *event : std::as_const(events))
+        QEventPool::deleteEvent(event);
 }
 
 /*!
@@ -1943,6 +2091,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     const auto locker = qt_scoped_lock(data->postEventList.mutex);
+    data->flushMetaCallQueue();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
@@ -1963,6 +2112,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
 #endif
             --pe.receiver->d_func()->postedEvents;
             pe.event->m_posted = false;
+            data->postEventList.unindexCompressible(pe.receiver, pe.event);
             delete pe.event;
             const_cast<QPostEvent &>(pe).event = nullptr;
             return;
@@ -2016,7 +2166,7 @@ void QCoreApplicationPrivate::quitAutomatically()
     // window, which currently relies on removing any posted quit events
     // from the event queue. As a result, we can't use the normal quit()
     // code path, and need to post manually.
-    QCoreApplication::postEvent(q, new QEvent(QEvent::Quit));
+    QCoreApplication::postEvent(q, QEventPool::createEvent<QEvent>(QEvent::Quit));
 }
 
 /*!
@@ -2072,7 +2222,7 @@ void QCoreApplicationPrivate::quit()
         QEvent quitEvent(QEvent::Quit);
         QCoreApplication::sendEvent(q, &quitEvent);
     } else {
-        QCoreApplication::postEvent(q, new QEvent(QEvent::Quit));
+        QCoreApplication::postEvent(q, QEventPool::createEvent<QEvent>(QEvent::Quit));
     }
 }
 
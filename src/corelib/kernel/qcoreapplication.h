@@ -130,6 +130,8 @@ public:
     static void postEvent(QObject *receiver, QEvent *event, int priority = Qt::NormalEventPriority);
     static void sendPostedEvents(QObject *receiver = nullptr, int event_type = 0);
     static void removePostedEvents(QObject *receiver, int eventType = 0);
+    static void setEventCompressionEnabled(QEvent::Type type, bool enable = true);
+    static bool isEventCompressionEnabled(QEvent::Type type);
     static QAbstractEventDispatcher *eventDispatcher();
     static void setEventDispatcher(QAbstractEventDispatcher *eventDispatcher);
 
@@ -125,6 +125,16 @@ public:
     virtual void createEventDispatcher();
     virtual void eventDispatcherReady();
     static void removePostedEvent(QEvent *);
+    static void postMetaCallEvent(QObject *receiver, QMetaCallEvent *event);
+
+    // one bit per event type, see QCoreApplication::setEventCompressionEnabled()
+    static QBasicAtomicInteger<quint32> compressedEventTypes[(QEvent::MaxUser + 1) / 32];
+    static bool isEventCompressionEnabled(int type)
+    {
+        const uint t = uint(type);
+        return t <= QEvent::MaxUser
+                && (compressedEventTypes[t / 32].loadRelaxed() & (1u << (t % 32)));
+    }
 #ifdef Q_OS_WIN
     static void removePostedTimerEvent(QObject *object, int timerId);
 #endif
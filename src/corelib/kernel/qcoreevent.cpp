@@ -297,17 +297,23 @@ QT_BEGIN_NAMESPACE
     Constructs an event object of type \a type.
 */
 QEvent::QEvent(Type type)
-    : t(type), m_reserved(0),
+    : t(type), m_reserved(0), m_poolIndex(0),
       m_inputEvent(false), m_pointerEvent(false), m_singlePointEvent(false)
 {
     Q_TRACE(QEvent_ctor, this, t);
 }
 
 /*!
-    \fn QEvent::QEvent(const QEvent &other)
     \internal
     Copies the \a other event.
 */
+QEvent::QEvent(const QEvent &other)
+    : t(other.t), m_posted(other.m_posted), m_spont(other.m_spont), m_accept(other.m_accept),
+      m_reserved(other.m_reserved), m_poolIndex(0), m_inputEvent(other.m_inputEvent),
+      m_pointerEvent(other.m_pointerEvent), m_singlePointEvent(other.m_singlePointEvent)
+{
+    // the copy was not allocated from the pool that other may come from
+}
 
 /*!
     \internal
@@ -336,13 +342,25 @@ QEvent::QEvent(Type type)
 */
 
 /*!
-    \fn QEvent &QEvent::operator=(const QEvent &other)
     \internal
     Attempts to copy the \a other event.
 
     Copying events is a bad idea, yet some Qt 4 code does it (notably,
     QApplication and the state machine).
  */
+QEvent &QEvent::operator=(const QEvent &other)
+{
+    // keeps our own m_poolIndex, as we stay where we were allocated
+    t = other.t;
+    m_posted = other.m_posted;
+    m_spont = other.m_spont;
+    m_accept = other.m_accept;
+    m_reserved = other.m_reserved;
+    m_inputEvent = other.m_inputEvent;
+    m_pointerEvent = other.m_pointerEvent;
+    m_singlePointEvent = other.m_singlePointEvent;
+    return *this;
+}
 
 /*!
     Destroys the event. If it was \l{QCoreApplication::postEvent()}{posted},
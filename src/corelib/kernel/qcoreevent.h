@@ -59,7 +59,12 @@ class Q_CORE_EXPORT QEvent           // event base class
     Q_GADGET
     QDOC_PROPERTY(bool accepted READ isAccepted WRITE setAccepted)
 
-    Q_EVENT_DISABLE_COPY(QEvent);
+protected:
+    // not defaulted: a copy never belongs to a QEventPool
+    QEvent(const QEvent &other);
+    QEvent(QEvent &&) = delete;
+    QEvent &operator=(const QEvent &other);
+    QEvent &operator=(QEvent &&) = delete;
 public:
     enum Type {
         /*
@@ -343,12 +348,14 @@ private:
         8 vptr + 2 type + 3 bool flags => 3 bytes left, so 24 bits. However, compilers will word-
         align the quint16s after the bools, so add another unused bool to fill that gap, which
         leaves us with 16 bits.
+        m_poolIndex is set for events that Qt allocated from a QEventPool.
     */
     bool m_posted = false;
     bool m_spont = false;
     bool m_accept = true;
     bool m_unused = false;
-    quint16 m_reserved : 13;
+    quint16 m_reserved : 9;
+    quint16 m_poolIndex : 4;
     quint16 m_inputEvent : 1;
     quint16 m_pointerEvent : 1;
     quint16 m_singlePointEvent : 1;
@@ -356,6 +363,7 @@ private:
     friend class QCoreApplication;
     friend class QCoreApplicationPrivate;
     friend class QThreadData;
+    friend class QEventPool;
     friend class QApplication;
     friend class QGraphicsScenePrivate;
     // from QtTest:
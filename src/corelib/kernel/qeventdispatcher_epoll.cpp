@@ -0,0 +1,595 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplatformdefs.h"
+
+#include "qcoreapplication.h"
+#include "qsocketnotifier.h"
+#include "qthread.h"
+
+#include "qeventdispatcher_epoll_p.h"
+#include <private/qthread_p.h>
+#include <private/qcoreapplication_p.h>
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <sys/timerfd.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QEventDispatcherEpoll
+
+    QEventDispatcherEpoll is an alternative to QEventDispatcherUNIX for Linux
+    that keeps the set of watched file descriptors in the kernel using
+    epoll(7). Registering and unregistering a socket notifier is a single
+    epoll_ctl() call, and each event loop iteration only costs time
+    proportional to the number of ready descriptors, instead of rebuilding
+    and scanning a pollfd array holding every registered notifier.
+
+    The thread is woken up through the same eventfd/pipe as the poll()-based
+    dispatcher. Timers are managed by QTimerInfoList; in TimerFd mode, the
+    next timeout is programmed into a timerfd so that the wait keeps
+    nanosecond resolution, while PollTimeout mode rounds the timeout up to
+    the millisecond resolution of epoll_wait().
+
+    Like QEventDispatcherUNIX, descriptors are level-triggered. File
+    descriptors epoll cannot watch (such as regular files) are reported as
+    always readable and writable, which matches what poll() does.
+
+    The dispatcher is selected at run-time by setting the
+    QT_EVENT_DISPATCHER_EPOLL environment variable to a positive value;
+    QT_EVENT_DISPATCHER_EPOLL_TIMERFD additionally enables TimerFd mode.
+*/
+
+static const char *socketType(QSocketNotifier::Type type)
+{
+    switch (type) {
+    case QSocketNotifier::Read:
+        return "Read";
+    case QSocketNotifier::Write:
+        return "Write";
+    case QSocketNotifier::Exception:
+        return "Exception";
+    }
+
+    Q_UNREACHABLE();
+}
+
+static quint32 epollEvents(const QSocketNotifierSetUNIX &sn_set) noexcept
+{
+    quint32 result = 0;
+
+    if (sn_set.notifiers[QSocketNotifier::Read])
+        result |= EPOLLIN;
+
+    if (sn_set.notifiers[QSocketNotifier::Write])
+        result |= EPOLLOUT;
+
+    if (sn_set.notifiers[QSocketNotifier::Exception])
+        result |= EPOLLPRI;
+
+    return result;
+}
+
+static int epollTimeout(const timespec *tm) noexcept
+{
+    if (!tm)
+        return -1;
+
+    // round up, so that we never wake up before the timer is due and spin
+    const qint64 msecs = qint64(tm->tv_sec) * 1000 + (tm->tv_nsec + 999999) / 1000000;
+    return int(qMin(msecs, qint64(std::numeric_limits<int>::max())));
+}
+
+QEventDispatcherEpollPrivate::QEventDispatcherEpollPrivate(QEventDispatcherEpoll::TimerMode mode)
+    : timerMode(mode)
+{
+    if (Q_UNLIKELY(threadPipe.init() == false))
+        qFatal("QEventDispatcherEpollPrivate(): Cannot continue without a thread pipe");
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (Q_UNLIKELY(epollFd == -1))
+        qFatal("QEventDispatcherEpollPrivate(): Cannot continue without an epoll instance");
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = threadPipe.fds[0];
+    if (Q_UNLIKELY(epoll_ctl(epollFd, EPOLL_CTL_ADD, threadPipe.fds[0], &ev) == -1))
+        qFatal("QEventDispatcherEpollPrivate(): Cannot watch the thread pipe");
+
+    if (timerMode == QEventDispatcherEpoll::TimerFd) {
+        timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        ev.data.fd = timerFd;
+        if (timerFd == -1 || epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &ev) == -1) {
+            qErrnoWarning(errno, "QEventDispatcherEpoll: Cannot create timerfd, "
+                                 "falling back to epoll_wait() timeouts");
+            if (timerFd != -1)
+                qt_safe_close(timerFd);
+            timerFd = -1;
+            timerMode = QEventDispatcherEpoll::PollTimeout;
+        }
+    }
+}
+
+QEventDispatcherEpollPrivate::~QEventDispatcherEpollPrivate()
+{
+    if (timerFd != -1)
+        qt_safe_close(timerFd);
+    if (epollFd != -1)
+        qt_safe_close(epollFd);
+
+    // cleanup timers
+    qDeleteAll(timerList);
+}
+
+bool QEventDispatcherEpollPrivate::updateEpoll(int fd, int op, const QSocketNotifierSetUNIX &sn_set)
+{
+    epoll_event ev = {};
+    ev.events = epollEvents(sn_set);
+    ev.data.fd = fd;
+
+    if (epoll_ctl(epollFd, op, fd, &ev) == 0)
+        return true;
+
+    // The descriptor may have been closed (which silently removes it from the
+    // epoll set) and its number reused without the notifier being disabled.
+    if (op == EPOLL_CTL_MOD && errno == ENOENT)
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+    if (op == EPOLL_CTL_ADD && errno == EEXIST)
+        return epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev) == 0;
+    if (op == EPOLL_CTL_DEL && (errno == ENOENT || errno == EBADF))
+        return true;
+
+    return false;
+}
+
+void QEventDispatcherEpollPrivate::armTimerFd(const timespec *tm)
+{
+    Q_ASSERT(timerFd != -1);
+
+    // a zero it_value disarms the timer, which is what we want for tm == nullptr
+    itimerspec spec = {};
+    if (tm)
+        spec.it_value = *tm;
+
+    if (!tm && !timerFdArmed)
+        return;
+
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+    timerFdArmed = tm != nullptr;
+}
+
+int QEventDispatcherEpollPrivate::waitWithoutNotifiers(timespec *tm)
+{
+    // The registered descriptors stay in the epoll set, so we cannot use
+    // epoll_wait() here without returning immediately for ready sockets.
+    pollfd pfd = threadPipe.prepare();
+
+    switch (qt_safe_poll(&pfd, 1, tm)) {
+    case -1:
+        perror("qt_safe_poll");
+        return 0;
+    case 0:
+        return 0;
+    default:
+        return threadPipe.check(pfd);
+    }
+}
+
+int QEventDispatcherEpollPrivate::activateTimers()
+{
+    return timerList.activateTimers();
+}
+
+void QEventDispatcherEpollPrivate::markUnpollableNotifiersPending()
+{
+    for (int fd : qAsConst(unpollableFds)) {
+        const QSocketNotifierSetUNIX &sn_set = socketNotifiers.value(fd);
+        if (QSocketNotifier *notifier = sn_set.notifiers[QSocketNotifier::Read])
+            pendingNotifiers << notifier;
+        if (QSocketNotifier *notifier = sn_set.notifiers[QSocketNotifier::Write])
+            pendingNotifiers << notifier;
+    }
+}
+
+int QEventDispatcherEpollPrivate::activateSocketNotifiers(int nready)
+{
+    static const struct {
+        QSocketNotifier::Type type;
+        quint32 flags;
+    } notifiers[] = {
+        { QSocketNotifier::Read,      EPOLLIN  | EPOLLHUP | EPOLLERR },
+        { QSocketNotifier::Write,     EPOLLOUT | EPOLLHUP | EPOLLERR },
+        { QSocketNotifier::Exception, EPOLLPRI | EPOLLHUP | EPOLLERR }
+    };
+
+    int n_activated = 0;
+
+    // epoll_wait() reports each descriptor at most once, so unlike
+    // QEventDispatcherUNIX we do not need to check for duplicates here
+    for (int i = 0; i < nready; ++i) {
+        const epoll_event &ev = readyEvents.at(i);
+        const int fd = ev.data.fd;
+
+        if (fd == threadPipe.fds[0]) {
+            pollfd pfd = threadPipe.prepare();
+            pfd.revents = POLLIN;
+            n_activated += threadPipe.check(pfd);
+            continue;
+        }
+
+        if (fd == timerFd) {
+            quint64 expirations;
+            qt_safe_read(timerFd, &expirations, sizeof(expirations));
+            timerFdArmed = false;
+            continue;
+        }
+
+        const auto it = socketNotifiers.constFind(fd);
+        if (it == socketNotifiers.cend())
+            continue;
+
+        for (const auto &n : notifiers) {
+            QSocketNotifier *notifier = it.value().notifiers[n.type];
+            if (notifier && (ev.events & n.flags))
+                pendingNotifiers << notifier;
+        }
+    }
+
+    markUnpollableNotifiersPending();
+
+    if (pendingNotifiers.isEmpty())
+        return n_activated;
+
+    QEvent event(QEvent::SockAct);
+
+    while (!pendingNotifiers.isEmpty()) {
+        QSocketNotifier *notifier = pendingNotifiers.takeFirst();
+        QCoreApplication::sendEvent(notifier, &event);
+        ++n_activated;
+    }
+
+    return n_activated;
+}
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QObject *parent)
+    : QEventDispatcherEpoll(PollTimeout, parent)
+{ }
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(TimerMode timerMode, QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherEpollPrivate(timerMode), parent)
+{ }
+
+QEventDispatcherEpoll::~QEventDispatcherEpoll()
+{ }
+
+/*!
+    \internal
+
+    Returns \c true if the running kernel supports epoll.
+*/
+bool QEventDispatcherEpoll::isSupported()
+{
+    const int fd = epoll_create1(EPOLL_CLOEXEC);
+    if (fd == -1)
+        return false;
+    qt_safe_close(fd);
+    return true;
+}
+
+/*!
+    \internal
+
+    Returns the timer mode in effect, which is PollTimeout if a timerfd could
+    not be created.
+*/
+QEventDispatcherEpoll::TimerMode QEventDispatcherEpoll::timerMode() const
+{
+    Q_D(const QEventDispatcherEpoll);
+    return d->timerMode;
+}
+
+/*!
+    \internal
+*/
+void QEventDispatcherEpoll::registerTimer(int timerId, qint64 interval, Qt::TimerType timerType, QObject *obj)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1 || interval < 0 || !obj) {
+        qWarning("QEventDispatcherEpoll::registerTimer: invalid arguments");
+        return;
+    } else if (obj->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::registerTimer: timers cannot be started from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    d->timerList.registerTimer(timerId, interval, timerType, obj);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimer(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: invalid argument");
+        return false;
+    } else if (thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimer(timerId);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimers(QObject *object)
+{
+#ifndef QT_NO_DEBUG
+    if (!object) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: invalid argument");
+        return false;
+    } else if (object->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimers(object);
+}
+
+QList<QEventDispatcherEpoll::TimerInfo>
+QEventDispatcherEpoll::registeredTimers(QObject *object) const
+{
+    if (!object) {
+        qWarning("QEventDispatcherEpoll:registeredTimers: invalid argument");
+        return QList<TimerInfo>();
+    }
+
+    Q_D(const QEventDispatcherEpoll);
+    return d->timerList.registeredTimers(object);
+}
+
+void QEventDispatcherEpoll::registerSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be enabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    auto it = d->socketNotifiers.find(sockfd);
+    const bool isNew = (it == d->socketNotifiers.end());
+    if (isNew)
+        it = d->socketNotifiers.insert(sockfd, QSocketNotifierSetUNIX());
+
+    QSocketNotifierSetUNIX &sn_set = it.value();
+
+    if (sn_set.notifiers[type] && sn_set.notifiers[type] != notifier)
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+
+    sn_set.notifiers[type] = notifier;
+
+    if (d->unpollableFds.contains(sockfd))
+        return;
+
+    if (d->updateEpoll(sockfd, isNew ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, sn_set))
+        return;
+
+    if (errno == EPERM) {
+        // poll() reports regular files and the like as always ready
+        d->unpollableFds.append(sockfd);
+        return;
+    }
+
+    qErrnoWarning(errno, "QSocketNotifier: Invalid socket %d with type %s",
+                  sockfd, socketType(type));
+    sn_set.notifiers[type] = nullptr;
+    if (sn_set.isEmpty())
+        d->socketNotifiers.erase(it);
+}
+
+void QEventDispatcherEpoll::unregisterSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifier (fd %d) cannot be disabled from another thread.\n"
+                "(Notifier's thread is %s(%p), event dispatcher's thread is %s(%p), current thread is %s(%p))",
+                sockfd,
+                notifier->thread() ? notifier->thread()->metaObject()->className() : "QThread", notifier->thread(),
+                thread() ? thread()->metaObject()->className() : "QThread", thread(),
+                QThread::currentThread() ? QThread::currentThread()->metaObject()->className() : "QThread", QThread::currentThread());
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+
+    d->pendingNotifiers.removeOne(notifier);
+
+    auto i = d->socketNotifiers.find(sockfd);
+    if (i == d->socketNotifiers.end())
+        return;
+
+    QSocketNotifierSetUNIX &sn_set = i.value();
+
+    if (sn_set.notifiers[type] == nullptr)
+        return;
+
+    if (sn_set.notifiers[type] != notifier) {
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+        return;
+    }
+
+    sn_set.notifiers[type] = nullptr;
+
+    const bool isEmpty = sn_set.isEmpty();
+    if (d->unpollableFds.contains(sockfd)) {
+        if (isEmpty)
+            d->unpollableFds.removeOne(sockfd);
+    } else {
+        d->updateEpoll(sockfd, isEmpty ? EPOLL_CTL_DEL : EPOLL_CTL_MOD, sn_set);
+    }
+
+    if (isEmpty)
+        d->socketNotifiers.erase(i);
+}
+
+bool QEventDispatcherEpoll::processEvents(QEventLoop::ProcessEventsFlags flags)
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.storeRelaxed(0);
+
+    // we are awake, broadcast it
+    emit awake();
+
+    // WaitForMoreEvents only asks us to block if there was nothing to do, so
+    // don't go to sleep right after delivering posted events (unlike
+    // QEventDispatcherUNIX, which blocks even then)
+    auto threadData = d->threadData.loadRelaxed();
+    const bool hadPostedEvents = !threadData->canWaitLocked();
+    QCoreApplicationPrivate::sendPostedEvents(nullptr, 0, threadData);
+
+    const bool include_timers = (flags & QEventLoop::X11ExcludeTimers) == 0;
+    const bool include_notifiers = (flags & QEventLoop::ExcludeSocketNotifiers) == 0;
+    const bool wait_for_events = (flags & QEventLoop::WaitForMoreEvents) != 0;
+
+    const bool canWait = (!hadPostedEvents
+                          && threadData->canWaitLocked()
+                          && !d->interrupt.loadRelaxed()
+                          && wait_for_events);
+
+    if (canWait)
+        emit aboutToBlock();
+
+    if (d->interrupt.loadRelaxed())
+        return false;
+
+    timespec *tm = nullptr;
+    timespec wait_tm = { 0, 0 };
+
+    if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
+        tm = &wait_tm;
+
+    int nevents = 0;
+
+    if (!include_notifiers) {
+        nevents += d->waitWithoutNotifiers(tm);
+    } else {
+        if (!d->unpollableFds.isEmpty()) {
+            wait_tm = { 0, 0 };
+            tm = &wait_tm;
+        }
+
+        int timeout = epollTimeout(tm);
+        if (d->timerMode == TimerFd && timeout != 0) {
+            d->armTimerFd(tm);
+            timeout = -1;
+        }
+
+        // level-triggered: anything that does not fit is reported next time
+        d->readyEvents.resize(qBound(64, int(d->socketNotifiers.size()) + 2, 4096));
+
+        // on EINTR, return and let the event loop recalculate the timeout
+        const int nready = epoll_wait(d->epollFd, d->readyEvents.data(),
+                                      d->readyEvents.size(), timeout);
+        if (nready == -1 && errno != EINTR)
+            perror("epoll_wait");
+        nevents += d->activateSocketNotifiers(qMax(nready, 0));
+    }
+
+    if (include_timers)
+        nevents += d->activateTimers();
+
+    // return true if we handled events, false otherwise
+    return (nevents > 0);
+}
+
+int QEventDispatcherEpoll::remainingTime(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::remainingTime: invalid argument");
+        return -1;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.timerRemainingTime(timerId);
+}
+
+void QEventDispatcherEpoll::wakeUp()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->threadPipe.wakeUp();
+}
+
+void QEventDispatcherEpoll::interrupt()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.storeRelaxed(1);
+    wakeUp();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qeventdispatcher_epoll_p.cpp"
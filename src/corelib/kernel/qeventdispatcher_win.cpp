@@ -50,6 +50,7 @@
 
 #include "qelapsedtimer.h"
 #include "qcoreapplication_p.h"
+#include <private/qeventpool_p.h>
 #include <private/qthread_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -114,7 +115,7 @@ void WINAPI QT_WIN_CALLBACK qt_fast_timer_proc(uint timerId, uint /*reserved*/,
         return;
     auto t = reinterpret_cast<WinTimerInfo*>(user);
     Q_ASSERT(t);
-    QCoreApplication::postEvent(t->dispatcher, new QTimerEvent(t->timerId));
+    QCoreApplication::postEvent(t->dispatcher, QEventPool::createEvent<QTimerEvent>(t->timerId));
 }
 
 LRESULT QT_WIN_CALLBACK qt_internal_proc(HWND hwnd, UINT message, WPARAM wp, LPARAM lp)
@@ -390,7 +391,7 @@ void QEventDispatcherWin32Private::registerTimer(WinTimerInfo *t)
     uint interval = t->interval;
     if (interval == 0u) {
         // optimization for single-shot-zero-timer
-        QCoreApplication::postEvent(q, new QZeroTimerEvent(t->timerId));
+        QCoreApplication::postEvent(q, QEventPool::createEvent<QZeroTimerEvent>(t->timerId));
         ok = true;
     } else if (tolerance == TIMERV_DEFAULT_COALESCING) {
         // 3/2016: Although MSDN states timeSetEvent() is deprecated, the function
@@ -908,7 +909,7 @@ bool QEventDispatcherWin32::event(QEvent *e)
             } else {
                 if (t->interval == 0 && t->inTimerEvent) {
                     // post the next zero timer event as long as the timer was not restarted
-                    QCoreApplication::postEvent(this, new QZeroTimerEvent(zte->timerId()));
+                    QCoreApplication::postEvent(this, QEventPool::createEvent<QZeroTimerEvent>(zte->timerId()));
                 }
 
                 t->inTimerEvent = false;
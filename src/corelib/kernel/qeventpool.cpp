@@ -0,0 +1,398 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qeventpool_p.h"
+
+#include <private/qlocking_p.h>
+
+#include <qloggingcategory.h>
+
+QT_BEGIN_NAMESPACE
+
+struct QEventPoolMagazine
+{
+    QEventPoolMagazine *next = nullptr;
+    int count = 0;
+    void *blocks[QEventPool::MagazineSize];
+};
+
+// The magazines a thread holds for one pool. The loaded magazine may be
+// partially filled; the previous one is always either full or empty.
+// The counters are folded into the pool whenever the thread exchanges
+// magazines with the depot, and when it exits.
+struct QEventPoolThreadCache
+{
+    QEventPoolMagazine *loaded;
+    QEventPoolMagazine *previous;
+    quint64 allocations;
+    quint64 deallocations;
+};
+
+namespace {
+enum class ThreadState : quint8 {
+    Uninitialized,
+    Running,
+    Finished
+};
+}
+
+Q_LOGGING_CATEGORY(lcEventPool, "qt.core.eventpool")
+
+// Pools are created on demand for each event size and never destroyed.
+Q_CONSTINIT static QBasicMutex poolRegistryMutex;
+Q_CONSTINIT static std::atomic<QEventPool *> registeredPools[QEventPool::MaxPools] = {};
+Q_CONSTINIT static std::atomic<int> registeredPoolCount = 0;
+Q_CONSTINIT static std::atomic<QEventPool *> poolsBySize[QEventPool::MaxBlockSize / sizeof(void *) + 1] = {};
+Q_CONSTINIT static std::atomic<bool> poolingEnabled = true;
+
+// Both of these are trivially destructible, so they remain usable while
+// other thread_local objects are being destroyed at thread exit.
+Q_CONSTINIT static thread_local QEventPoolThreadCache threadCaches[QEventPool::MaxPools] = {};
+Q_CONSTINIT static thread_local ThreadState threadState = ThreadState::Uninitialized;
+
+struct QEventPoolThreadCleanup
+{
+    bool active = false;
+
+    ~QEventPoolThreadCleanup()
+    {
+        // from here on, blocks freed by this thread go straight to the system
+        threadState = ThreadState::Finished;
+        for (int i = 0; i < QEventPool::MaxPools; ++i) {
+            if (QEventPool *pool = registeredPools[i].load(std::memory_order_acquire))
+                pool->releaseThreadCache(&threadCaches[i]);
+        }
+    }
+};
+
+static thread_local QEventPoolThreadCleanup threadCleanup;
+
+/*!
+    \internal
+
+    Returns the pool for blocks of exactly \a size bytes, creating it if
+    necessary. Returns \nullptr if \a size is not suitable for pooling, if
+    all pools are in use, or if pooling is disabled.
+*/
+QEventPool *QEventPool::forSize(size_t size) noexcept
+{
+    if (size > MaxBlockSize || size % sizeof(void *) || !size)
+        return nullptr;
+    if (Q_UNLIKELY(!poolingEnabled.load(std::memory_order_relaxed)))
+        return nullptr;
+    QEventPool *pool = poolsBySize[size / sizeof(void *)].load(std::memory_order_acquire);
+    if (Q_UNLIKELY(!pool))
+        pool = createPool(size);
+    return pool;
+}
+
+QEventPool *QEventPool::createPool(size_t size) noexcept
+{
+    if (registeredPoolCount.load(std::memory_order_relaxed) == MaxPools)
+        return nullptr;
+
+    QEventPool *pool;
+    {
+        const auto locker = qt_scoped_lock(poolRegistryMutex);
+        std::atomic<QEventPool *> &slot = poolsBySize[size / sizeof(void *)];
+        pool = slot.load(std::memory_order_relaxed);
+        if (pool)
+            return pool;
+        const int index = registeredPoolCount.load(std::memory_order_relaxed);
+        if (index == MaxPools)
+            return nullptr;
+        pool = new (std::nothrow) QEventPool(size, index);
+        if (!pool)
+            return nullptr;
+        registeredPools[index].store(pool, std::memory_order_release);
+        registeredPoolCount.store(index + 1, std::memory_order_relaxed);
+        slot.store(pool, std::memory_order_release);
+    }
+    qCDebug(lcEventPool, "Created pool %p for %zu byte events", pool, size);
+    return pool;
+}
+
+/*!
+    \internal
+
+    Returns whether event allocations are pooled. This is the default.
+*/
+bool QEventPool::isEnabled() noexcept
+{
+    return poolingEnabled.load(std::memory_order_relaxed);
+}
+
+/*!
+    \internal
+
+    Enables or disables pooling of event allocations, depending on \a enable.
+    Blocks handed out before remain valid either way. Disabling the pools
+    makes memory checkers report on event objects individually again.
+*/
+void QEventPool::setEnabled(bool enable) noexcept
+{
+    poolingEnabled.store(enable, std::memory_order_relaxed);
+}
+
+/*!
+    \internal
+
+    Destroys \a event and recycles its block if it was created by
+    createEvent(); otherwise just deletes it.
+*/
+void QEventPool::deleteEvent(QEvent *event) noexcept
+{
+    if (!event)
+        return;
+    const int index = event->m_poolIndex;
+    if (!index) {
+        delete event;
+        return;
+    }
+    QEventPool *pool = registeredPools[index - 1].load(std::memory_order_acquire);
+    Q_ASSERT(pool);
+    event->~QEvent();
+    pool->deallocate(event);
+}
+
+/*!
+    \internal
+
+    Writes the statistics of all pools to the qt.core.eventpool logging
+    category.
+*/
+void QEventPool::logStatistics()
+{
+    if (!lcEventPool().isDebugEnabled())
+        return;
+    const int count = registeredPoolCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        const Statistics stats = registeredPools[i].load(std::memory_order_acquire)->statistics();
+        qCDebug(lcEventPool, "%zu byte events: %llu allocations, %llu deallocations, "
+                "%llu system allocations, %llu system deallocations, %llu depot exchanges, "
+                "%d blocks in depot",
+                stats.blockSize, stats.allocations, stats.deallocations,
+                stats.systemAllocations, stats.systemDeallocations,
+                stats.depotExchanges, stats.depotBlocks);
+    }
+}
+
+inline QEventPoolThreadCache *QEventPool::threadCache() noexcept
+{
+    if (Q_UNLIKELY(threadState != ThreadState::Running)) {
+        if (threadState == ThreadState::Finished)
+            return nullptr;
+        // constructs threadCleanup, registering it for destruction at thread exit
+        threadCleanup.active = true;
+        threadState = ThreadState::Running;
+    }
+    return &threadCaches[m_index];
+}
+
+/*!
+    \internal
+
+    Returns a block of blockSize() bytes, preferably one cached by the
+    calling thread. Throws std::bad_alloc if no memory is available.
+*/
+void *QEventPool::allocate()
+{
+    if (QEventPoolThreadCache *cache = threadCache()) {
+        ++cache->allocations;
+        QEventPoolMagazine *magazine = cache->loaded;
+        if (Q_LIKELY(magazine && magazine->count))
+            return magazine->blocks[--magazine->count];
+        return allocateSlow(cache);
+    }
+    m_systemAllocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(m_blockSize);
+}
+
+void *QEventPool::allocateSlow(QEventPoolThreadCache *cache)
+{
+    // the loaded magazine is empty
+    if (cache->previous && cache->previous->count) {
+        std::swap(cache->loaded, cache->previous);
+        return cache->loaded->blocks[--cache->loaded->count];
+    }
+
+    {
+        const auto locker = qt_scoped_lock(m_mutex);
+        flushCountersLocked(cache);
+        if (QEventPoolMagazine *full = m_fullMagazines) {
+            m_fullMagazines = full->next;
+            --m_fullMagazineCount;
+            ++m_depotExchanges;
+            if (QEventPoolMagazine *empty = cache->previous) {
+                empty->next = m_emptyMagazines;
+                m_emptyMagazines = empty;
+            }
+            cache->previous = cache->loaded;
+            cache->loaded = full;
+            return full->blocks[--full->count];
+        }
+    }
+
+    m_systemAllocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(m_blockSize);
+}
+
+/*!
+    \internal
+
+    Returns \a ptr, which must have been obtained from allocate() or from
+    the global operator new with blockSize() bytes, to the pool.
+*/
+void QEventPool::deallocate(void *ptr) noexcept
+{
+    if (!ptr)
+        return;
+    if (QEventPoolThreadCache *cache = threadCache()) {
+        ++cache->deallocations;
+        QEventPoolMagazine *magazine = cache->loaded;
+        if (Q_LIKELY(magazine && magazine->count < MagazineSize)) {
+            magazine->blocks[magazine->count++] = ptr;
+            return;
+        }
+        return deallocateSlow(cache, ptr);
+    }
+    m_systemDeallocations.fetch_add(1, std::memory_order_relaxed);
+    ::operator delete(ptr);
+}
+
+void QEventPool::deallocateSlow(QEventPoolThreadCache *cache, void *ptr) noexcept
+{
+    // the loaded magazine is full or missing
+    if (cache->previous && !cache->previous->count) {
+        std::swap(cache->loaded, cache->previous);
+        cache->loaded->blocks[cache->loaded->count++] = ptr;
+        return;
+    }
+
+    auto locker = qt_unique_lock(m_mutex);
+    QEventPoolMagazine *empty = m_emptyMagazines;
+    if (empty) {
+        m_emptyMagazines = empty->next;
+    } else {
+        locker.unlock();
+        empty = new (std::nothrow) QEventPoolMagazine;
+        if (Q_UNLIKELY(!empty)) {
+            m_systemDeallocations.fetch_add(1, std::memory_order_relaxed);
+            ::operator delete(ptr);
+            return;
+        }
+        locker.lock();
+    }
+    if (QEventPoolMagazine *full = cache->previous)
+        pushFullMagazineLocked(full);
+    flushCountersLocked(cache);
+    locker.unlock();
+
+    cache->previous = cache->loaded;
+    cache->loaded = empty;
+    empty->next = nullptr;
+    empty->blocks[empty->count++] = ptr;
+}
+
+void QEventPool::pushFullMagazineLocked(QEventPoolMagazine *magazine) noexcept
+{
+    if (m_fullMagazineCount < MaxDepotMagazines) {
+        magazine->next = m_fullMagazines;
+        m_fullMagazines = magazine;
+        ++m_fullMagazineCount;
+        ++m_depotExchanges;
+        return;
+    }
+
+    // the depot holds enough already
+    for (int i = 0; i < magazine->count; ++i)
+        ::operator delete(magazine->blocks[i]);
+    m_systemDeallocations.fetch_add(magazine->count, std::memory_order_relaxed);
+    magazine->count = 0;
+    magazine->next = m_emptyMagazines;
+    m_emptyMagazines = magazine;
+}
+
+void QEventPool::flushCountersLocked(QEventPoolThreadCache *cache) noexcept
+{
+    m_allocations += std::exchange(cache->allocations, 0);
+    m_deallocations += std::exchange(cache->deallocations, 0);
+}
+
+void QEventPool::releaseThreadCache(QEventPoolThreadCache *cache) noexcept
+{
+    const auto locker = qt_scoped_lock(m_mutex);
+    flushCountersLocked(cache);
+    for (QEventPoolMagazine *magazine : { cache->loaded, cache->previous }) {
+        if (!magazine)
+            continue;
+        if (magazine->count) {
+            pushFullMagazineLocked(magazine);
+        } else {
+            magazine->next = m_emptyMagazines;
+            m_emptyMagazines = magazine;
+        }
+    }
+    cache->loaded = cache->previous = nullptr;
+}
+
+/*!
+    \internal
+
+    Returns counters describing how often the pool had to fall back to the
+    system allocator and to its shared depot. The allocation and deallocation
+    counts lag behind by what the threads still hold in their magazines.
+*/
+QEventPool::Statistics QEventPool::statistics() const
+{
+    Statistics stats;
+    stats.blockSize = m_blockSize;
+    stats.systemAllocations = m_systemAllocations.load(std::memory_order_relaxed);
+    stats.systemDeallocations = m_systemDeallocations.load(std::memory_order_relaxed);
+
+    const auto locker = qt_scoped_lock(m_mutex);
+    stats.allocations = m_allocations;
+    stats.deallocations = m_deallocations;
+    stats.depotExchanges = m_depotExchanges;
+    for (const QEventPoolMagazine *magazine = m_fullMagazines; magazine; magazine = magazine->next)
+        stats.depotBlocks += magazine->count;
+    return stats;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,171 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QEVENTPOOL_P_H
+#define QEVENTPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qcoreevent.h>
+#include <QtCore/qmutex.h>
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+struct QEventPoolMagazine;
+struct QEventPoolThreadCache;
+
+// Caches blocks of one exact size for event objects, which are typically
+// created in one thread and destroyed in another. Every thread keeps two
+// magazines of blocks; only when both run empty (or full) does it exchange a
+// magazine with the pool's shared depot, so the depot mutex is taken once
+// every MagazineSize allocations at most. The blocks themselves come from the
+// global operator new, so any block may also be released with the global
+// operator delete, and any block of the pool's size may be given to it.
+class Q_CORE_EXPORT QEventPool
+{
+    Q_DISABLE_COPY_MOVE(QEventPool)
+public:
+    enum {
+        MagazineSize = 64,
+        MaxDepotMagazines = 32,
+        MaxPools = 15,  // the pool index must fit into QEvent::m_poolIndex
+        MaxBlockSize = 256
+    };
+
+    struct Statistics
+    {
+        size_t blockSize = 0;
+        quint64 allocations = 0;
+        quint64 deallocations = 0;
+        quint64 systemAllocations = 0;
+        quint64 systemDeallocations = 0;
+        quint64 depotExchanges = 0;
+        int depotBlocks = 0;
+    };
+
+    static QEventPool *forSize(size_t size) noexcept;
+    static bool isEnabled() noexcept;
+    static void setEnabled(bool enable) noexcept;
+    static void logStatistics();
+
+    template <typename T, typename... Args>
+    static T *createEvent(Args &&...args);
+    static void deleteEvent(QEvent *event) noexcept;
+
+    size_t blockSize() const noexcept { return m_blockSize; }
+
+    void *allocate();
+    void deallocate(void *ptr) noexcept;
+
+    Statistics statistics() const;
+
+private:
+    QEventPool(size_t blockSize, int index) noexcept
+        : m_blockSize(blockSize), m_index(index)
+    {}
+
+    static QEventPool *createPool(size_t size) noexcept;
+    QEventPoolThreadCache *threadCache() noexcept;
+    void *allocateSlow(QEventPoolThreadCache *cache);
+    void deallocateSlow(QEventPoolThreadCache *cache, void *ptr) noexcept;
+    void releaseThreadCache(QEventPoolThreadCache *cache) noexcept;
+    void pushFullMagazineLocked(QEventPoolMagazine *magazine) noexcept;
+    void flushCountersLocked(QEventPoolThreadCache *cache) noexcept;
+    friend struct QEventPoolThreadCleanup;
+
+    const size_t m_blockSize;
+    const int m_index;
+
+    mutable QBasicMutex m_mutex;
+    QEventPoolMagazine *m_fullMagazines = nullptr;
+    QEventPoolMagazine *m_emptyMagazines = nullptr;
+    int m_fullMagazineCount = 0;
+    quint64 m_depotExchanges = 0;
+    quint64 m_allocations = 0;
+    quint64 m_deallocations = 0;
+    std::atomic<quint64> m_systemAllocations = 0;
+    std::atomic<quint64> m_systemDeallocations = 0;
+};
+
+struct QEventPoolDeleter
+{
+    static void cleanup(QEvent *event) noexcept { QEventPool::deleteEvent(event); }
+    void operator()(QEvent *event) const noexcept { QEventPool::deleteEvent(event); }
+};
+
+// Creates an event of type T for Qt's own use, preferably in a pooled block.
+// Such events must be destroyed with deleteEvent() to recycle the block;
+// a plain delete is correct too, it just doesn't recycle it.
+template <typename T, typename... Args>
+T *QEventPool::createEvent(Args &&...args)
+{
+    static_assert(std::is_base_of_v<QEvent, T>);
+    QEventPool *pool = forSize(sizeof(T));
+    if (!pool)
+        return new T(std::forward<Args>(args)...);
+
+    void *memory = pool->allocate();
+    T *event;
+    QT_TRY {
+        event = ::new (memory) T(std::forward<Args>(args)...);
+    } QT_CATCH(...) {
+        pool->deallocate(memory);
+        QT_RETHROW;
+    }
+    static_cast<QEvent *>(event)->m_poolIndex = pool->m_index + 1;
+    return event;
+}
+
+QT_END_NAMESPACE
+
+#endif // QEVENTPOOL_P_H
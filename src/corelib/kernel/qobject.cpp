@@ -607,6 +607,42 @@ QMetaCallEvent::QMetaCallEvent(QtPrivate::QSlotObjectBase *slotO,
     allocArgs();
 }
 
+/*!
+    \internal
+
+    Queued connections create a QMetaCallEvent per emission, usually in
+    another thread than the one deleting it; take them from a pool.
+ */
+void *QMetaCallEvent::operator new(std::size_t size)
+{
+    if (QEventPool *pool = QEventPool::forSize(size))
+        return pool->allocate();
+    return ::operator new(size);
+}
+
+/*!
+    \internal
+ */
+void QMetaCallEvent::operator delete(void *ptr, std::size_t size) noexcept
+{
+    // the block has the right size for the pool even if it was allocated
+    // while pooling was disabled
+    if (QEventPool *pool = QEventPool::forSize(size))
+        pool->deallocate(ptr);
+    else
+        ::operator delete(ptr);
+}
+
+/*!
+    \internal
+ */
+QEventPool::Statistics QMetaCallEvent::poolStatistics()
+{
+    if (QEventPool *pool = QEventPool::forSize(sizeof(QMetaCallEvent)))
+        return pool->statistics();
+    return {};
+}
+
 /*!
     \internal
  */
@@ -1676,6 +1712,14 @@ void QObject::moveToThread(QThread *targetThread)
     }
     d_func()->setThreadData_helper(currentData, targetData, bindingStatus);
 
+    // queued meta calls that were pushed to currentData while the objects
+    // were being moved still need to follow them
+    currentData->metaCallQueue.waitForPushes();
+    const qsizetype targetEventCount = targetData->postEventList.size();
+    currentData->flushMetaCallQueue();
+    if (targetData->postEventList.size() != targetEventCount && targetData->hasEventDispatcher())
+        targetData->eventDispatcher.loadRelaxed()->wakeUp();
+
     locker.unlock();
 
     // now currentData can commit suicide if it wants to
@@ -1711,7 +1755,11 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
             continue;
         if (pe.receiver == q) {
             // move this post event to the targetList
-            targetData->postEventList.addEvent(pe);
+            QEvent *event = pe.event;
+            currentData->postEventList.unindexCompressible(q, event);
+            const qsizetype position = targetData->postEventList.addEvent(pe);
+            if (QCoreApplicationPrivate::isEventCompressionEnabled(event->type()))
+                targetData->postEventList.indexCompressible(position);
             const_cast<QPostEvent &>(pe).event = nullptr;
             ++eventsMoved;
         }
@@ -2373,7 +2421,7 @@ void QObject::deleteLater()
     if (qApp == this)
         qWarning("You are deferring the delete of QCoreApplication, this may not work as expected.");
 #endif
-    QCoreApplication::postEvent(this, new QDeferredDeleteEvent());
+    QCoreApplication::postEvent(this, QEventPool::createEvent<QDeferredDeleteEvent>());
 }
 
 /*!
@@ -3843,7 +3891,7 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
         return;
     }
 
-    QCoreApplication::postEvent(receiver, ev);
+    QCoreApplicationPrivate::postMetaCallEvent(receiver, ev);
 }
 
 template <bool callbacks_enabled>
@@ -62,6 +62,7 @@
 #include "QtCore/qvariant.h"
 #include "QtCore/qproperty.h"
 #include "QtCore/private/qproperty_p.h"
+#include "QtCore/private/qeventpool_p.h"
 
 #include <string>
 
@@ -639,7 +640,13 @@ public:
 
     virtual void placeMetaCall(QObject *object) override;
 
+    static void *operator new(std::size_t size);
+    static void operator delete(void *ptr, std::size_t size) noexcept;
+    static QEventPool::Statistics poolStatistics();
+
 private:
+    friend class QMetaCallEventQueue;
+
     inline void allocArgs();
 
     struct Data {
@@ -652,6 +659,10 @@ private:
     } d;
     // preallocate enough space for three arguments
     alignas(void *) char prealloc_[3 * sizeof(void *) + 3 * sizeof(QMetaType)];
+
+    // links the event while it sits in a thread's QMetaCallEventQueue
+    QMetaCallEvent *nextQueued_ = nullptr;
+    QObject *queuedReceiver_ = nullptr;
 };
 
 class QBoolBlocker
@@ -40,6 +40,7 @@
 
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
+#include <qvarlengtharray.h>
 
 #include "private/qcore_unix_p.h"
 #include "private/qtimerinfo_unix_p.h"
@@ -84,6 +85,7 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = nullptr;
+    nextSequence = 0;
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -171,17 +173,149 @@ void QTimerInfoList::repairTimersIfNeeded()
 #endif
 
 /*
-  insert timer info into list
+  The timers are kept in a d-ary min-heap. A wider heap is shallower than a
+  binary one, which makes the sift operations touch fewer cache lines, at the
+  cost of a few more comparisons per level.
 */
-void QTimerInfoList::timerInsert(QTimerInfo *ti)
+static constexpr qsizetype TimerHeapArity = 4;
+
+/*
+  Timers that are due at the same time fire in the order they were
+  (re)inserted, like they did when the list was kept sorted.
+*/
+static inline bool timerLessThan(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    if (t1->timeout < t2->timeout)
+        return true;
+    if (t2->timeout < t1->timeout)
+        return false;
+    return t1->sequence < t2->sequence;
+}
+
+void QTimerInfoList::heapSiftUp(qsizetype index)
+{
+    QTimerInfo **heap = data();
+    QTimerInfo *t = heap[index];
+    while (index > 0) {
+        const qsizetype parent = (index - 1) / TimerHeapArity;
+        if (!timerLessThan(t, heap[parent]))
+            break;
+        heap[index] = heap[parent];
+        heap[index]->heapIndex = index;
+        index = parent;
+    }
+    heap[index] = t;
+    t->heapIndex = index;
+}
+
+void QTimerInfoList::heapSiftDown(qsizetype index)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
+    QTimerInfo **heap = data();
+    const qsizetype count = size();
+    QTimerInfo *t = heap[index];
+    forever {
+        const qsizetype firstChild = index * TimerHeapArity + 1;
+        if (firstChild >= count)
+            break;
+        const qsizetype lastChild = qMin(firstChild + TimerHeapArity, count);
+        qsizetype smallest = firstChild;
+        for (qsizetype child = firstChild + 1; child < lastChild; ++child) {
+            if (timerLessThan(heap[child], heap[smallest]))
+                smallest = child;
+        }
+        if (!timerLessThan(heap[smallest], t))
             break;
+        heap[index] = heap[smallest];
+        heap[index]->heapIndex = index;
+        index = smallest;
     }
-    insert(index+1, ti);
+    heap[index] = t;
+    t->heapIndex = index;
+}
+
+void QTimerInfoList::heapRemove(QTimerInfo *t)
+{
+    const qsizetype index = t->heapIndex;
+    Q_ASSERT(at(index) == t);
+
+    QTimerInfo *last = takeLast();
+    if (last == t)
+        return;
+
+    data()[index] = last;
+    last->heapIndex = index;
+    if (index > 0 && timerLessThan(last, at((index - 1) / TimerHeapArity)))
+        heapSiftUp(index);
+    else
+        heapSiftDown(index);
+}
+
+void QTimerInfoList::heapify()
+{
+    for (qsizetype i = 0; i < size(); ++i)
+        at(i)->heapIndex = i;
+    if (size() < 2)
+        return;
+    for (qsizetype i = (size() - 2) / TimerHeapArity; i >= 0; --i)
+        heapSiftDown(i);
+}
+
+/*
+  Returns the earliest timer that is not currently being activated, or null.
+  Timers being activated are the ones whose event handler recursed into the
+  event loop, so there are only ever a few of them to skip.
+*/
+QTimerInfo *QTimerInfoList::firstInactiveTimer() const
+{
+    QVarLengthArray<qsizetype, 16> candidates;
+    if (!isEmpty())
+        candidates.append(0);
+
+    while (!candidates.isEmpty()) {
+        qsizetype best = 0;
+        for (qsizetype i = 1; i < candidates.size(); ++i) {
+            if (timerLessThan(at(candidates.at(i)), at(candidates.at(best))))
+                best = i;
+        }
+
+        const qsizetype index = candidates.at(best);
+        QTimerInfo *t = at(index);
+        if (!t->activateRef)
+            return t;
+
+        candidates.remove(best);
+        const qsizetype firstChild = index * TimerHeapArity + 1;
+        const qsizetype lastChild = qMin(firstChild + TimerHeapArity, size());
+        for (qsizetype child = firstChild; child < lastChild; ++child)
+            candidates.append(child);
+    }
+
+    return nullptr;
+}
+
+/*
+  Returns the number of timers in the subtree at \a index that are due.
+*/
+qsizetype QTimerInfoList::countExpiredTimers(qsizetype index, const timespec &currentTime) const
+{
+    if (index >= size() || currentTime < at(index)->timeout)
+        return 0;
+
+    qsizetype count = 1;
+    const qsizetype firstChild = index * TimerHeapArity + 1;
+    for (qsizetype child = firstChild; child < firstChild + TimerHeapArity; ++child)
+        count += countExpiredTimers(child, currentTime);
+    return count;
+}
+
+/*
+  insert timer info into list
+*/
+void QTimerInfoList::timerInsert(QTimerInfo *ti)
+{
+    ti->sequence = nextSequence++;
+    append(ti);
+    heapSiftUp(size() - 1);
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -392,14 +526,7 @@ bool QTimerInfoList::timerWait(timespec &tm)
     repairTimersIfNeeded();
 
     // Find first waiting timer not already active
-    QTimerInfo *t = nullptr;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
-    }
-
+    QTimerInfo *t = firstInactiveTimer();
     if (!t)
       return false;
 
@@ -426,16 +553,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timersById.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -496,6 +620,7 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
             ++t->timeout.tv_sec;
     }
 
+    timersById.insert(timerId, t);
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -510,42 +635,48 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
 
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
-    // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            return true;
-        }
+    QTimerInfo *t = timersById.take(timerId);
+    if (!t) {
+        // id not found
+        return false;
     }
-    // id not found
-    return false;
+
+    // set timer inactive
+    heapRemove(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = nullptr;
+    if (t->activateRef)
+        *(t->activateRef) = nullptr;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
+
+    // compact the remaining timers and restore the heap once at the end
+    QTimerInfo **heap = data();
+    qsizetype kept = 0;
+    for (qsizetype i = 0; i < size(); ++i) {
+        QTimerInfo *t = heap[i];
         if (t->obj == object) {
             // object found
-            removeAt(i);
+            timersById.remove(t->id);
             if (t == firstTimerInfo)
                 firstTimerInfo = nullptr;
             if (t->activateRef)
                 *(t->activateRef) = nullptr;
             delete t;
-            // move back one so that we don't skip the new current item
-            --i;
+        } else {
+            heap[kept++] = t;
         }
     }
+    if (kept != size()) {
+        resize(kept);
+        heapify();
+    }
     return true;
 }
 
@@ -582,11 +713,7 @@ int QTimerInfoList::activateTimers()
 
 
     // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    maxCount = int(countExpiredTimers(0, currentTime));
 
     //fire the timers.
     while (maxCount--) {
@@ -607,9 +734,6 @@ int QTimerInfoList::activateTimers()
             firstTimerInfo = currentTimerInfo;
         }
 
-        // remove from list
-        removeFirst();
-
 #ifdef QTIMERINFO_DEBUG
         float diff;
         if (currentTime < currentTimerInfo->expected) {
@@ -633,8 +757,9 @@ int QTimerInfoList::activateTimers()
         // determine next timeout time
         calculateNextTimeout(currentTimerInfo, currentTime);
 
-        // reinsert timer
-        timerInsert(currentTimerInfo);
+        // move the timer to its new position
+        currentTimerInfo->sequence = nextSequence++;
+        heapSiftDown(currentTimerInfo->heapIndex);
         if (currentTimerInfo->interval > 0)
             n_act++;
 
@@ -56,6 +56,7 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -69,6 +70,8 @@ struct QTimerInfo {
     timespec timeout;  // - when to actually fire
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
+    qsizetype heapIndex; // - position in the QTimerInfoList heap
+    quint64 sequence; // - insertion order, breaks ties between equal timeouts
 
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
@@ -77,6 +80,9 @@ struct QTimerInfo {
 #endif
 };
 
+// The list is kept as a d-ary min-heap ordered by (timeout, sequence), so
+// constFirst() is always the next timer to fire, but the rest of the list is
+// not sorted. Use the member functions to add and remove timers.
 class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
@@ -92,6 +98,16 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     // state variables used by activateTimers()
     QTimerInfo *firstTimerInfo;
 
+    QHash<int, QTimerInfo *> timersById;
+    quint64 nextSequence;
+
+    void heapSiftUp(qsizetype index);
+    void heapSiftDown(qsizetype index);
+    void heapRemove(QTimerInfo *t);
+    void heapify();
+    QTimerInfo *firstInactiveTimer() const;
+    qsizetype countExpiredTimers(qsizetype index, const timespec &currentTime) const;
+
 public:
     QTimerInfoList();
 
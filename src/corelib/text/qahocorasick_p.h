@@ -0,0 +1,300 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QAHOCORASICK_P_H
+#define QAHOCORASICK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of internal files.  This header file may change from version to version
+// without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+
+#include <algorithm>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+// Aho-Corasick automaton over the code units of type Char (uchar or
+// char16_t), which finds all occurrences of a set of patterns in one pass
+// over the text.
+//
+// Code units are first mapped to classes: every unit that occurs in a
+// pattern gets its own class, all others share class 0. The classes are
+// looked up in a table indexed by the unit, which covers the Latin-1 range,
+// or all of UTF-16 if a pattern uses units above it; callers wanting
+// case-insensitive matching remap the table with mapClasses(). Unless that
+// takes too much memory, the transitions of all states are then expanded
+// into a dense table (a DFA), so that every unit of the text costs one
+// lookup. Otherwise the trie keeps sparse transitions and the failure links
+// are followed while scanning.
+template <typename Char>
+class AhoCorasick
+{
+public:
+    // Adds a pattern; empty patterns never match. Call build() when done.
+    void addPattern(const Char *pattern, qsizetype length)
+    {
+        lengths.append(length);
+        const qsizetype offset = units.size();
+        units.resize(offset + length);
+        std::copy_n(pattern, length, units.data() + offset);
+        for (qsizetype i = 0; i < length; ++i)
+            maxUnit = std::max(maxUnit, uint(pattern[i]));
+    }
+
+    void build()
+    {
+        classes.fill(0, maxUnit < 256 ? 256 : 0x10000);
+        numClasses = 1;
+        for (Char c : std::as_const(units)) {
+            if (!classes[c])
+                classes[c] = numClasses++;
+        }
+
+        // the trie; the children are looked up in a hash while inserting
+        QHash<quint64, int> children;
+        QList<int> terminals;
+        terminals.reserve(lengths.size());
+        int states = 1;
+        const Char *pattern = units.constData();
+        for (qsizetype length : std::as_const(lengths)) {
+            int state = 0;
+            for (qsizetype i = 0; i < length; ++i) {
+                const quint64 key = (quint64(state) << 32) | classes[pattern[i]];
+                auto it = children.find(key);
+                if (it == children.end())
+                    it = children.insert(key, states++);
+                state = *it;
+            }
+            terminals.append(state);
+            pattern += length;
+        }
+
+        // ... turned into sorted edge lists per state
+        edgeBegin.fill(0, states + 1);
+        edges.resize(children.size());
+        for (auto it = children.cbegin(), end = children.cend(); it != end; ++it)
+            ++edgeBegin[int(it.key() >> 32) + 1];
+        for (int s = 0; s < states; ++s)
+            edgeBegin[s + 1] += edgeBegin[s];
+        {
+            QList<qsizetype> fill = edgeBegin;
+            for (auto it = children.cbegin(), end = children.cend(); it != end; ++it)
+                edges[fill[int(it.key() >> 32)]++] = { int(it.key() & 0xffffffff), it.value() };
+        }
+        children = {};
+        for (int s = 0; s < states; ++s)
+            std::sort(edges.begin() + edgeBegin[s], edges.begin() + edgeBegin[s + 1]);
+
+        // the patterns ending in each state, in ascending order
+        firstPattern.fill(-1, states);
+        nextPattern.fill(-1, lengths.size());
+        for (qsizetype p = lengths.size() - 1; p >= 0; --p) {
+            const int s = terminals.at(p);
+            if (s == 0)
+                continue;
+            nextPattern[p] = firstPattern[s];
+            firstPattern[s] = p;
+        }
+
+        dense = qint64(states) * numClasses <= MaxDenseTransitions;
+        if (dense)
+            delta.fill(0, qsizetype(states) * numClasses);
+        else
+            delta.fill(0, numClasses);  // the transitions of the root
+        for (qsizetype e = edgeBegin[0]; e < edgeBegin[1]; ++e)
+            delta[edges[e].cls] = edges[e].target;
+
+        // failure links and the transitions, breadth-first so that the
+        // states they refer to are complete
+        fail.fill(0, states);
+        outputs.fill(-1, states);
+        QList<int> queue;
+        queue.reserve(states);
+        queue.append(0);
+        for (qsizetype head = 0; head < queue.size(); ++head) {
+            const int s = queue.at(head);
+            if (s) {
+                outputs[s] = firstPattern[s] >= 0 ? s : outputs[fail[s]];
+                if (dense) {
+                    std::copy_n(delta.constData() + qsizetype(fail[s]) * numClasses, numClasses,
+                                delta.data() + qsizetype(s) * numClasses);
+                }
+            }
+            for (qsizetype e = edgeBegin[s]; e < edgeBegin[s + 1]; ++e) {
+                const Edge edge = edges.at(e);
+                if (s)
+                    fail[edge.target] = dense ? delta[qsizetype(fail[s]) * numClasses + edge.cls]
+                                              : sparseNext(fail[s], edge.cls);
+                if (dense)
+                    delta[qsizetype(s) * numClasses + edge.cls] = edge.target;
+                queue.append(edge.target);
+            }
+        }
+
+        if (dense) {
+            edges = {};
+            edgeBegin = {};
+            fail.squeeze();
+        }
+        units = {};
+    }
+
+    // Makes every code unit c below the size of the class table match like
+    // fold(c). The patterns must have been folded the same way.
+    template <typename Fold>
+    void mapClasses(Fold fold)
+    {
+        const uint size = uint(classes.size());
+        for (uint c = 0; c < size; ++c) {
+            const uint folded = fold(c);
+            if (folded != c)
+                classes[c] = folded < size ? classes.at(folded) : 0;
+        }
+    }
+
+    qsizetype patternCount() const { return lengths.size(); }
+    qsizetype patternLength(qsizetype patternIndex) const { return lengths.at(patternIndex); }
+    qsizetype maximumLength() const
+    {
+        return lengths.isEmpty() ? 0 : *std::max_element(lengths.cbegin(), lengths.cend());
+    }
+
+    // Returns the class of code unit c, which lies outside the table if it
+    // doesn't occur in any pattern.
+    int classOf(uint c) const { return c < uint(classes.size()) ? classes[c] : 0; }
+    bool hasClassTableFor(uint c) const { return c < uint(classes.size()); }
+    const int *classTable() const { return classes.constData(); }
+
+    // Feeds the classes classAt(i) for i in [from, to) to the automaton and
+    // calls onMatch(index, patternIndex) for every match, ordered by where
+    // they end and, for the same end, longest first. onMatch returns the
+    // position to stop at, which lets the caller stop early, and can only
+    // move it closer.
+    template <typename ClassAt, typename OnMatch>
+    void scan(qsizetype from, qsizetype to, ClassAt classAt, OnMatch onMatch) const
+    {
+        if (lengths.isEmpty())
+            return;
+        if (dense)
+            scanImpl<true>(from, to, classAt, onMatch);
+        else
+            scanImpl<false>(from, to, classAt, onMatch);
+    }
+
+private:
+    // beyond this many entries (32 MB), the transitions are kept sparse
+    static constexpr qint64 MaxDenseTransitions = 1 << 23;
+
+    struct Edge
+    {
+        int cls;
+        int target;
+        friend bool operator<(Edge lhs, Edge rhs) noexcept { return lhs.cls < rhs.cls; }
+    };
+
+    int sparseNext(int state, int cls) const
+    {
+        while (state) {
+            const auto begin = edges.cbegin() + edgeBegin[state];
+            const auto end = edges.cbegin() + edgeBegin[state + 1];
+            const auto it = std::lower_bound(begin, end, Edge{ cls, 0 });
+            if (it != end && it->cls == cls)
+                return it->target;
+            state = fail[state];
+        }
+        return delta[cls];
+    }
+
+    template <bool Dense, typename ClassAt, typename OnMatch>
+    void scanImpl(qsizetype from, qsizetype to, ClassAt classAt, OnMatch onMatch) const
+    {
+        const int *transitions = delta.constData();
+        const int *out = outputs.constData();
+        int state = 0;
+        for (qsizetype i = from; i < to; ++i) {
+            const int cls = classAt(i);
+            if constexpr (Dense)
+                state = transitions[qsizetype(state) * numClasses + cls];
+            else
+                state = sparseNext(state, cls);
+            if (Q_LIKELY(out[state] < 0))
+                continue;
+            for (int t = out[state]; t >= 0; t = out[fail[t]]) {
+                for (qsizetype p = firstPattern[t]; p >= 0; p = nextPattern[p])
+                    to = std::min(to, qsizetype(onMatch(i + 1 - lengths[p], p)));
+            }
+        }
+    }
+
+    QList<Char> units;          // the patterns, while building
+    QList<qsizetype> lengths;
+    uint maxUnit = 0;
+
+    QList<int> classes;
+    int numClasses = 0;
+    bool dense = false;
+
+    QList<int> delta;           // all transitions, or only the root's
+    QList<Edge> edges;          // sparse transitions, by state
+    QList<qsizetype> edgeBegin;
+    QList<int> fail;
+    QList<int> outputs;         // the nearest state in the failure chain ending a pattern
+    QList<qsizetype> firstPattern;
+    QList<qsizetype> nextPattern;
+};
+
+} // namespace QtPrivate
+
+QT_END_NAMESPACE
+
+#endif // QAHOCORASICK_P_H
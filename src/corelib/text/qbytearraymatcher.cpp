@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qbytearraymatcher.h"
+#include "qstringsearch_p.h"
 
 #include <limits.h>
 
@@ -87,6 +88,22 @@ static inline qsizetype bm_find(const uchar *cc, qsizetype l, qsizetype index, c
     return -1; // not found
 }
 
+static qsizetype bm_find_filtered(const uchar *cc, qsizetype l, qsizetype index, const uchar *puc,
+                                  qsizetype pl, const uchar *skiptable)
+{
+    if (pl < 2 || pl > QtPrivate::FirstLastFilterMaxNeedleLength || index > l - pl)
+        return bm_find(cc, l, index, puc, pl, skiptable);
+
+    auto verify = [=](qsizetype pos) {
+        return memcmp(cc + pos + 1, puc + 1, pl - 2) == 0;
+    };
+    auto fallback = [=](qsizetype pos) {
+        return bm_find(cc, l, pos, puc, pl, skiptable);
+    };
+    return QtPrivate::findWithFirstLastFilter(cc, l, index, puc, pl, Qt::CaseSensitive,
+                                              verify, fallback);
+}
+
 /*! \class QByteArrayMatcher
     \inmodule QtCore
     \brief The QByteArrayMatcher class holds a sequence of bytes that
@@ -216,8 +233,8 @@ qsizetype QByteArrayMatcher::indexIn(const char *str, qsizetype len, qsizetype f
 {
     if (from < 0)
         from = 0;
-    return bm_find(reinterpret_cast<const uchar *>(str), len, from,
-                   p.p, p.l, p.q_skiptable);
+    return bm_find_filtered(reinterpret_cast<const uchar *>(str), len, from,
+                            p.p, p.l, p.q_skiptable);
 }
 
 /*!
@@ -235,8 +252,8 @@ qsizetype QByteArrayMatcher::indexIn(QByteArrayView data, qsizetype from) const
 {
     if (from < 0)
         from = 0;
-    return bm_find(reinterpret_cast<const uchar *>(data.data()), data.size(), from,
-                   p.p, p.l, p.q_skiptable);
+    return bm_find_filtered(reinterpret_cast<const uchar *>(data.data()), data.size(), from,
+                            p.p, p.l, p.q_skiptable);
 }
 
 /*!
@@ -288,32 +305,17 @@ static qsizetype qFindByteArrayBoyerMoore(
 /*!
     \internal
  */
-qsizetype qFindByteArray(
-    const char *haystack0, qsizetype haystackLen, qsizetype from,
-    const char *needle, qsizetype needleLen)
+static qsizetype qFindByteArrayHashed(
+    const char *haystack0, qsizetype l, qsizetype from,
+    const char *needle, qsizetype sl)
 {
-    const auto l = haystackLen;
-    const auto sl = needleLen;
-    if (from < 0)
-        from += l;
-    if (std::size_t(sl + from) > std::size_t(l))
-        return -1;
-    if (!sl)
-        return from;
-    if (!l)
-        return -1;
-
-    if (sl == 1)
-        return findChar(haystack0, haystackLen, needle[0], from);
-
     /*
       We use the Boyer-Moore algorithm in cases where the overhead
       for the skip table should pay off, otherwise we use a simple
       hash function.
     */
     if (l > 500 && sl > 5)
-        return qFindByteArrayBoyerMoore(haystack0, haystackLen, from,
-                                        needle, needleLen);
+        return qFindByteArrayBoyerMoore(haystack0, l, from, needle, sl);
 
     /*
       We use some hashing for efficiency's sake. Instead of
@@ -343,6 +345,40 @@ qsizetype qFindByteArray(
     return -1;
 }
 
+/*!
+    \internal
+ */
+qsizetype qFindByteArray(
+    const char *haystack0, qsizetype haystackLen, qsizetype from,
+    const char *needle, qsizetype needleLen)
+{
+    const auto l = haystackLen;
+    const auto sl = needleLen;
+    if (from < 0)
+        from += l;
+    if (std::size_t(sl + from) > std::size_t(l))
+        return -1;
+    if (!sl)
+        return from;
+    if (!l)
+        return -1;
+
+    if (sl == 1)
+        return findChar(haystack0, haystackLen, needle[0], from);
+
+    if (sl <= QtPrivate::FirstLastFilterMaxNeedleLength) {
+        auto verify = [=](qsizetype pos) {
+            return memcmp(haystack0 + pos + 1, needle + 1, sl - 2) == 0;
+        };
+        auto fallback = [=](qsizetype pos) {
+            return qFindByteArrayHashed(haystack0, l, pos, needle, sl);
+        };
+        return QtPrivate::findWithFirstLastFilter(haystack0, l, from, needle, sl,
+                                                  Qt::CaseSensitive, verify, fallback);
+    }
+    return qFindByteArrayHashed(haystack0, l, from, needle, sl);
+}
+
 /*!
     \class QStaticByteArrayMatcherBase
     \since 5.9
@@ -422,8 +458,8 @@ qsizetype QStaticByteArrayMatcherBase::indexOfIn(const char *needle, size_t nlen
 {
     if (from < 0)
         from = 0;
-    return bm_find(reinterpret_cast<const uchar *>(haystack), hlen, from,
-                   reinterpret_cast<const uchar *>(needle),   nlen, m_skiptable.data);
+    return bm_find_filtered(reinterpret_cast<const uchar *>(haystack), hlen, from,
+                            reinterpret_cast<const uchar *>(needle), nlen, m_skiptable.data);
 }
 
 /*!
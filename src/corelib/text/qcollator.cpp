@@ -46,6 +46,9 @@
 #include "qlocale_p.h"
 #include "qthreadstorage.h"
 
+#include <algorithm>
+#include <numeric>
+
 QT_BEGIN_NAMESPACE
 
 namespace {
@@ -408,6 +411,37 @@ QCollatorSortKey QCollator::defaultSortKey(QStringView key)
     \note Not supported with the C (a.k.a. POSIX) locale on Darwin.
 */
 
+/*!
+    \since 6.4
+
+    Returns the sort keys of all the \a strings, in the same order.
+
+    Sorting a long list by its keys is much faster than comparing the strings
+    with compare(), which has to work out the collation of both strings for
+    each comparison. Unlike a list of QCollatorSortKey objects, the keys are
+    stored compactly in a single block of memory. Where the collation back-end
+    permits, they are created in parallel using QThreadPool::globalInstance()
+    when there are many strings.
+
+    \snippet code/src_corelib_text_qcollator.cpp 1
+
+    \sa sortKey(), QCollatorSortKeys::sortedIndexes()
+*/
+QCollatorSortKeys QCollator::sortKeys(const QStringList &strings) const
+{
+    if (d->dirty)
+        d->init();
+    QCollatorSortKeys keys(new QCollatorSortKeysPrivate);
+#if QT_CONFIG(icu)
+    d->appendSortKeys(keys.d.data(), strings);
+#else
+    keys.d->keys.reserve(strings.size());
+    for (const QString &string : strings)
+        keys.d->keys.append(sortKey(string));
+#endif
+    return keys;
+}
+
 /*!
     \class QCollatorSortKey
     \inmodule QtCore
@@ -495,4 +529,123 @@ QCollatorSortKey& QCollatorSortKey::operator=(const QCollatorSortKey &other)
     \sa operator<()
 */
 
+/*!
+    \class QCollatorSortKeys
+    \inmodule QtCore
+    \brief The QCollatorSortKeys class holds the sort keys of a list of strings.
+
+    \since 6.4
+
+    QCollatorSortKeys is created by QCollator::sortKeys(). The key of each
+    string is addressed by the position of the string in the list that was
+    passed to that function.
+
+    \reentrant
+    \ingroup i18n
+    \ingroup string-processing
+    \ingroup shared
+
+    \sa QCollator, QCollatorSortKey
+*/
+
+/*!
+    \internal
+*/
+QCollatorSortKeys::QCollatorSortKeys(QCollatorSortKeysPrivate *d)
+    : d(d)
+{
+}
+
+/*!
+    Constructs an empty list of sort keys.
+*/
+QCollatorSortKeys::QCollatorSortKeys()
+    : d(new QCollatorSortKeysPrivate)
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QCollatorSortKeys::QCollatorSortKeys(const QCollatorSortKeys &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Destroys the sort keys.
+*/
+QCollatorSortKeys::~QCollatorSortKeys()
+{
+}
+
+/*!
+    Assigns \a other to this object.
+*/
+QCollatorSortKeys &QCollatorSortKeys::operator=(const QCollatorSortKeys &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    \fn QCollatorSortKeys &QCollatorSortKeys::operator=(QCollatorSortKeys &&other)
+
+    Move-assigns \a other to this object.
+*/
+
+/*!
+    \fn void QCollatorSortKeys::swap(QCollatorSortKeys &other)
+
+    Swaps this object with \a other.
+*/
+
+/*!
+    Returns the number of keys.
+*/
+qsizetype QCollatorSortKeys::size() const
+{
+    return d->size();
+}
+
+/*!
+    \fn bool QCollatorSortKeys::isEmpty() const
+
+    Returns \c true if there are no keys; otherwise returns \c false.
+*/
+
+/*!
+    Compares the keys of the strings at positions \a i and \a j, which must
+    be valid positions.
+
+    Returns a negative value if the first string sorts before the second one,
+    0 if they are equal or a positive value if it sorts after the second one.
+*/
+int QCollatorSortKeys::compare(qsizetype i, qsizetype j) const
+{
+    Q_ASSERT(i >= 0 && i < size());
+    Q_ASSERT(j >= 0 && j < size());
+    return d->compare(i, j);
+}
+
+/*!
+    Returns the positions of the strings, sorted by their keys in \a order.
+    Strings that compare equal keep their relative order.
+*/
+QList<qsizetype> QCollatorSortKeys::sortedIndexes(Qt::SortOrder order) const
+{
+    QList<qsizetype> indexes(size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    if (order == Qt::AscendingOrder) {
+        std::stable_sort(indexes.begin(), indexes.end(), [this](qsizetype lhs, qsizetype rhs) {
+            return d->compare(lhs, rhs) < 0;
+        });
+    } else {
+        std::stable_sort(indexes.begin(), indexes.end(), [this](qsizetype lhs, qsizetype rhs) {
+            return d->compare(rhs, lhs) < 0;
+        });
+    }
+    return indexes;
+}
+
 QT_END_NAMESPACE
@@ -49,6 +49,7 @@ QT_BEGIN_NAMESPACE
 
 class QCollatorPrivate;
 class QCollatorSortKeyPrivate;
+class QCollatorSortKeysPrivate;
 
 class Q_CORE_EXPORT QCollatorSortKey
 {
@@ -74,6 +75,30 @@ private:
     QCollatorSortKey();
 };
 
+class Q_CORE_EXPORT QCollatorSortKeys
+{
+    friend class QCollator;
+public:
+    QCollatorSortKeys();
+    QCollatorSortKeys(const QCollatorSortKeys &other);
+    ~QCollatorSortKeys();
+    QCollatorSortKeys &operator=(const QCollatorSortKeys &other);
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QCollatorSortKeys)
+    void swap(QCollatorSortKeys &other) noexcept
+    { d.swap(other.d); }
+
+    qsizetype size() const;
+    bool isEmpty() const { return size() == 0; }
+
+    int compare(qsizetype i, qsizetype j) const;
+    QList<qsizetype> sortedIndexes(Qt::SortOrder order = Qt::AscendingOrder) const;
+
+private:
+    explicit QCollatorSortKeys(QCollatorSortKeysPrivate *d);
+
+    QExplicitlySharedDataPointer<QCollatorSortKeysPrivate> d;
+};
+
 class Q_CORE_EXPORT QCollator
 {
 public:
@@ -116,6 +141,7 @@ public:
     { return compare(s1, s2) < 0; }
 
     QCollatorSortKey sortKey(const QString &string) const;
+    QCollatorSortKeys sortKeys(const QStringList &strings) const;
 
     static int defaultCompare(QStringView s1, QStringView s2);
     static QCollatorSortKey defaultSortKey(QStringView key);
@@ -127,6 +153,7 @@ private:
 };
 
 Q_DECLARE_SHARED(QCollatorSortKey)
+Q_DECLARE_SHARED(QCollatorSortKeys)
 Q_DECLARE_SHARED(QCollator)
 
 QT_END_NAMESPACE
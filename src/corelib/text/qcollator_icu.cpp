@@ -42,6 +42,11 @@
 #include "qlocale_p.h"
 #include "qstringlist.h"
 #include "qstring.h"
+#if QT_CONFIG(thread)
+#include "qsemaphore.h"
+#include "qthread.h"
+#include "qthreadpool.h"
+#endif
 
 #include <unicode/utypes.h>
 #include <unicode/ucol.h>
@@ -149,6 +154,109 @@ QCollatorSortKey QCollator::sortKey(const QString &string) const
     return QCollatorSortKey(new QCollatorSortKeyPrivate(QByteArray()));
 }
 
+// Appends the '\0'-terminated sort key of string to arena
+static void appendSortKey(QByteArray &arena, const UCollator *collator, bool isC, QStringView string)
+{
+    if (isC) {
+        arena.append(string.toUtf8());
+        arena.append('\0');
+        return;
+    }
+    if (!collator) {
+        arena.append('\0');
+        return;
+    }
+
+    const qsizetype start = arena.size();
+    const qsizetype capacity = 16 + string.size() + (string.size() >> 2);
+    arena.resize(start + capacity);
+    int size = ucol_getSortKey(collator, reinterpret_cast<const UChar *>(string.data()),
+                               string.size(), reinterpret_cast<uint8_t *>(arena.data() + start),
+                               capacity);
+    if (size > capacity) {
+        arena.resize(start + size);
+        size = ucol_getSortKey(collator, reinterpret_cast<const UChar *>(string.data()),
+                               string.size(), reinterpret_cast<uint8_t *>(arena.data() + start),
+                               size);
+    }
+    arena.truncate(start + size);
+}
+
+void QCollatorPrivate::appendSortKeys(QCollatorSortKeysPrivate *keys, const QStringList &strings) const
+{
+    Q_ASSERT(!dirty);
+    struct Chunk
+    {
+        QByteArray arena;
+        QList<qsizetype> ends;
+        bool done = false;
+    };
+    auto fill = [&strings](Chunk &chunk, const UCollator *collator, bool isC,
+                           qsizetype begin, qsizetype end) {
+        chunk.arena.reserve((end - begin) * 16);
+        chunk.ends.reserve(end - begin);
+        for (qsizetype i = begin; i < end; ++i) {
+            appendSortKey(chunk.arena, collator, isC, strings.at(i));
+            chunk.ends.append(chunk.arena.size());
+        }
+        chunk.done = true;
+    };
+
+    // Fewer strings than this per thread do not pay for the thread and the
+    // collator clone.
+    constexpr qsizetype MinimumChunkSize = 2048;
+    qsizetype chunkCount = 1;
+#if QT_CONFIG(thread)
+    if (collator)
+        chunkCount = qBound(1, strings.size() / MinimumChunkSize, qsizetype(QThread::idealThreadCount()));
+#endif
+    QList<Chunk> chunks(chunkCount);
+    auto chunkBegin = [&](qsizetype c) { return strings.size() * c / chunkCount; };
+    const bool cLocale = isC();
+
+#if QT_CONFIG(thread)
+    // A UCollator must not be used by several threads at the same time, so
+    // each of the other threads works with a clone.
+    QSemaphore finished;
+    for (qsizetype i = 1; i < chunkCount; ++i) {
+        auto task = [&, i] {
+            UErrorCode status = U_ZERO_ERROR;
+#  if U_ICU_VERSION_MAJOR_NUM >= 71
+            UCollator *clone = ucol_clone(collator, &status);
+#  else
+            UCollator *clone = ucol_safeClone(collator, nullptr, nullptr, &status);
+#  endif
+            if (U_SUCCESS(status))
+                fill(chunks[i], clone, cLocale, chunkBegin(i), chunkBegin(i + 1));
+            if (clone)
+                ucol_close(clone);
+            finished.release();
+        };
+        if (!QThreadPool::globalInstance()->tryStart(task))
+            task();
+    }
+#endif
+    fill(chunks[0], collator, cLocale, chunkBegin(0), chunkBegin(1));
+#if QT_CONFIG(thread)
+    finished.acquire(int(chunkCount - 1));
+#endif
+
+    qsizetype total = 0;
+    for (qsizetype i = 0; i < chunkCount; ++i) {
+        if (!chunks.at(i).done) // the clone failed
+            fill(chunks[i], collator, cLocale, chunkBegin(i), chunkBegin(i + 1));
+        total += chunks.at(i).arena.size();
+    }
+    keys->arena.reserve(keys->arena.size() + total);
+    keys->offsets.reserve(keys->offsets.size() + strings.size());
+    for (const Chunk &chunk : std::as_const(chunks)) {
+        const qsizetype base = keys->arena.size();
+        keys->arena.append(chunk.arena);
+        for (qsizetype end : chunk.ends)
+            keys->offsets.append(base + end);
+    }
+}
+
 int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
 {
     return qstrcmp(d->m_key, otherKey.d->m_key);
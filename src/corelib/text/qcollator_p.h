@@ -103,7 +103,7 @@ public:
 
     QCollatorPrivate(const QLocale &locale) : locale(locale) {}
     ~QCollatorPrivate() { cleanup(); }
-    bool isC() { return locale.language() == QLocale::C; }
+    bool isC() const { return locale.language() == QLocale::C; }
 
     void clear() {
         cleanup();
@@ -113,6 +113,9 @@ public:
     // Implemented by each back-end, in its own way:
     void init();
     void cleanup();
+#if QT_CONFIG(icu)
+    void appendSortKeys(QCollatorSortKeysPrivate *keys, const QStringList &strings) const;
+#endif
 
 private:
     Q_DISABLE_COPY_MOVE(QCollatorPrivate)
@@ -135,6 +138,30 @@ private:
     Q_DISABLE_COPY_MOVE(QCollatorSortKeyPrivate)
 };
 
+class QCollatorSortKeysPrivate : public QSharedData
+{
+public:
+    QCollatorSortKeysPrivate() = default;
+
+#if QT_CONFIG(icu)
+    qsizetype size() const { return offsets.size() - 1; }
+    int compare(qsizetype i, qsizetype j) const
+    { return qstrcmp(arena.constData() + offsets.at(i), arena.constData() + offsets.at(j)); }
+
+    // The keys of all strings back to back, each one '\0'-terminated, and
+    // where each of them starts, followed by the size of the arena.
+    QByteArray arena;
+    QList<qsizetype> offsets = { 0 };
+#else
+    qsizetype size() const { return keys.size(); }
+    int compare(qsizetype i, qsizetype j) const { return keys.at(i).compare(keys.at(j)); }
+
+    QList<QCollatorSortKey> keys;
+#endif
+
+private:
+    Q_DISABLE_COPY_MOVE(QCollatorSortKeysPrivate)
+};
 
 QT_END_NAMESPACE
 
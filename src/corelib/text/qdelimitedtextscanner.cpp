@@ -0,0 +1,460 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qdelimitedtextscanner.h"
+
+#include <QtCore/qfiledevice.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QBasicDelimitedTextScanner
+    \inmodule QtCore
+    \since 6.4
+    \brief The QBasicDelimitedTextScanner class splits delimited text, such as
+    CSV or TSV data, into records and fields without copying it.
+    \reentrant
+    \ingroup tools
+    \ingroup string-processing
+
+    QBasicDelimitedTextScanner reads the records of a text one by one. The
+    fields of a record are separated by separator(), \c{','} by default, and
+    records are terminated by \c{"\n"}, \c{"\r\n"} or \c{"\r"}. A field that
+    starts with quote(), \c{'"'} by default, can contain separators and line
+    breaks; a quote character inside it is written twice, as described in
+    \l{https://tools.ietf.org/html/rfc4180}{RFC 4180}.
+
+    The fields are returned as views into the scanned text, so the text must
+    outlive them. A field that contains escaped quote characters can't be
+    represented as a view of its value; needsUnquoting() returns \c true for
+    it, and toString() returns its value.
+
+    \snippet code/src_corelib_text_qdelimitedtextscanner.cpp 0
+
+    The scanner doesn't allocate memory, except for growing the list of
+    fields passed to readRecord(). Reusing the same list for all the records
+    avoids that too.
+
+    The \c View template argument is QStringView or QUtf8StringView. Use the
+    QDelimitedTextScanner and QUtf8DelimitedTextScanner aliases instead of
+    naming the template. To read delimited text from a QIODevice, use
+    QDelimitedTextReader.
+
+    Text that doesn't follow the format is accepted: an unterminated quoted
+    field extends to the end of the text, and the text following the closing
+    quote of a field up to the next separator is appended to its value.
+
+    \sa QStringTokenizer, QDelimitedTextReader
+*/
+
+/*!
+    \typealias QDelimitedTextScanner
+    \relates QBasicDelimitedTextScanner
+
+    An alias for \c{QBasicDelimitedTextScanner<QStringView>}.
+*/
+
+/*!
+    \typealias QUtf8DelimitedTextScanner
+    \relates QBasicDelimitedTextScanner
+
+    An alias for \c{QBasicDelimitedTextScanner<QUtf8StringView>}.
+*/
+
+/*!
+    \class QBasicDelimitedTextScanner::Field
+    \inmodule QtCore
+    \since 6.4
+    \brief A field of a record of delimited text.
+
+    \sa QBasicDelimitedTextScanner::readRecord()
+*/
+
+/*!
+    \fn template <typename View> QBasicDelimitedTextScanner<View>::Field::Field()
+
+    Constructs an empty field.
+*/
+
+/*!
+    \fn template <typename View> View QBasicDelimitedTextScanner<View>::Field::rawView() const
+
+    Returns the field as it appears in the text, including the quote
+    characters of a quoted field.
+*/
+
+/*!
+    \fn template <typename View> bool QBasicDelimitedTextScanner<View>::Field::isQuoted() const
+
+    Returns \c true if the field starts with a quote character.
+*/
+
+/*!
+    \fn template <typename View> bool QBasicDelimitedTextScanner<View>::Field::needsUnquoting() const
+
+    Returns \c true if the value of the field can't be returned by view(),
+    because it contains escaped quote characters or is malformed. Use
+    toString() for such fields.
+*/
+
+/*!
+    \fn template <typename View> View QBasicDelimitedTextScanner<View>::Field::view() const
+
+    Returns the value of the field, without its enclosing quote characters,
+    as a view into the scanned text. If needsUnquoting() is \c true, returns
+    rawView() instead.
+
+    \sa toString()
+*/
+
+/*!
+    \fn template <typename View> QString QBasicDelimitedTextScanner<View>::Field::toString() const
+
+    Returns the value of the field, with the enclosing quote characters
+    removed and escaped quote characters unescaped.
+
+    \sa view()
+*/
+
+/*!
+    \fn template <typename View> QBasicDelimitedTextScanner<View>::QBasicDelimitedTextScanner(View text, char separator, char quote)
+
+    Constructs a scanner for the records of \a text, whose fields are
+    separated by \a separator and quoted with \a quote. Both must be ASCII
+    characters, and they must differ.
+*/
+
+/*!
+    \fn template <typename View> View QBasicDelimitedTextScanner<View>::text() const
+
+    Returns the text that is scanned.
+*/
+
+/*!
+    \fn template <typename View> char QBasicDelimitedTextScanner<View>::separator() const
+
+    Returns the character separating the fields of a record.
+*/
+
+/*!
+    \fn template <typename View> char QBasicDelimitedTextScanner<View>::quote() const
+
+    Returns the character enclosing quoted fields.
+*/
+
+/*!
+    \fn template <typename View> qsizetype QBasicDelimitedTextScanner<View>::position() const
+
+    Returns the position in text() of the next record.
+*/
+
+/*!
+    \fn template <typename View> bool QBasicDelimitedTextScanner<View>::atEnd() const
+
+    Returns \c true if all the records have been read.
+*/
+
+/*!
+    \fn template <typename View> bool QBasicDelimitedTextScanner<View>::readRecord(QList<Field> &fields)
+
+    Reads the next record and replaces the contents of \a fields with its
+    fields. Returns \c false, and leaves \a fields empty, if there are no
+    more records.
+
+    An empty line is a record with one empty field.
+*/
+
+template <typename Char, typename Output>
+static Output *unquoteDelimitedFieldHelper(const Char *p, const Char *end, Char quote, Output *out)
+{
+    Q_ASSERT(p != end && *p == quote);
+    for (++p; p != end; *out++ = Output(*p++)) {
+        if (*p == quote && (++p == end || *p != quote))
+            break;
+    }
+    // the text after the closing quote is kept as-is
+    while (p != end)
+        *out++ = Output(*p++);
+    return out;
+}
+
+/*!
+    \internal
+
+    Returns the value of the quoted field \a raw.
+*/
+QString QtPrivate::unquoteDelimitedField(QStringView raw, char quote)
+{
+    QString result(raw.size(), Qt::Uninitialized);
+    char16_t *begin = reinterpret_cast<char16_t *>(result.data());
+    char16_t *end = unquoteDelimitedFieldHelper(raw.utf16(), raw.utf16() + raw.size(),
+                                                char16_t(quote), begin);
+    result.truncate(end - begin);
+    return result;
+}
+
+/*!
+    \internal
+    \overload
+*/
+QString QtPrivate::unquoteDelimitedField(QUtf8StringView raw, char quote)
+{
+    QVarLengthArray<char, 256> buffer(raw.size());
+    const char *data = reinterpret_cast<const char *>(raw.data());
+    char *end = unquoteDelimitedFieldHelper(data, data + raw.size(), quote, buffer.data());
+    return QString::fromUtf8(buffer.data(), end - buffer.data());
+}
+
+class QDelimitedTextReaderPrivate
+{
+public:
+    QDelimitedTextReaderPrivate(QIODevice *device, char separator, char quote)
+        : device(device), separator(separator), quote(quote)
+    {
+        if (device && device->isSequential()) {
+            finishedConnection = QObject::connect(device, &QIODevice::readChannelFinished,
+                                                  [this] { readChannelFinished = true; });
+        }
+    }
+    ~QDelimitedTextReaderPrivate() { QObject::disconnect(finishedConnection); }
+
+    bool fill();
+
+    QIODevice *device;
+    QMetaObject::Connection finishedConnection;
+    QByteArray buffer;
+    qsizetype position = 0;
+    qsizetype chunkSize = 64 * 1024;
+    char separator;
+    char quote;
+    bool deviceAtEnd = false;
+    bool readChannelFinished = false;
+};
+
+/*!
+    \internal
+
+    Drops the records that were read already from the buffer and appends
+    the next chunk of the device to it. Returns \c false if no data could be
+    read.
+*/
+bool QDelimitedTextReaderPrivate::fill()
+{
+    buffer.remove(0, position);
+    position = 0;
+
+    // Read at least as much as is pending, so that scanning a record that is
+    // longer than a chunk stays linear.
+    const qsizetype pending = buffer.size();
+    const qsizetype toRead = qMax(chunkSize, pending);
+    buffer.resize(pending + toRead);
+    const qint64 bytesRead = device->read(buffer.data() + pending, toRead);
+    buffer.resize(pending + qMax(bytesRead, qint64(0)));
+
+    // A sequential device without data available might get more later. It
+    // tells that there is no more by failing to read, or by having emitted
+    // readChannelFinished(). Files, including pipes, block until there is
+    // data, so an empty read from one means the end.
+    if (bytesRead < 0) {
+        deviceAtEnd = true;
+    } else if (!device->isSequential()) {
+        deviceAtEnd = device->atEnd();
+    } else if (bytesRead == 0) {
+        deviceAtEnd = readChannelFinished
+                || (qobject_cast<QFileDevice *>(device) && device->atEnd());
+    }
+    return bytesRead > 0;
+}
+
+/*!
+    \class QDelimitedTextReader
+    \inmodule QtCore
+    \since 6.4
+    \brief The QDelimitedTextReader class reads delimited text, such as CSV or
+    TSV data, from a QIODevice.
+    \reentrant
+    \ingroup io
+    \ingroup string-processing
+
+    QDelimitedTextReader reads the data of a device in chunks, and splits it
+    into records and fields like QUtf8DelimitedTextScanner does. The data
+    must be encoded in UTF-8, or another encoding compatible with ASCII.
+
+    \snippet code/src_corelib_text_qdelimitedtextscanner.cpp 1
+
+    The fields returned by readRecord() are views into the internal buffer of
+    the reader and are only valid until the next call to readRecord(). The
+    buffer holds the current chunk and is only reallocated for records that
+    are longer than a chunk, so reading a large file with the same list of
+    fields for every record allocates very little memory.
+
+    On a sequential device, such as a socket, readRecord() returns \c false
+    when the device doesn't have a complete record available yet; call it
+    again once more data arrived. The last record, if it isn't terminated by
+    a line break, is returned once the device has no more data: when reading
+    from it fails, after it emitted \l{QIODevice::}{readChannelFinished()},
+    or, for a QFileDevice such as a pipe or \c stdin, when reading returns
+    no data.
+
+    \sa QBasicDelimitedTextScanner, QTextStream
+*/
+
+/*!
+    \typealias QDelimitedTextReader::Field
+
+    An alias for QUtf8DelimitedTextScanner::Field.
+*/
+
+/*!
+    Constructs a reader for the delimited text in \a device, whose fields are
+    separated by \a separator and quoted with \a quote. Both must be ASCII
+    characters, and they must differ.
+
+    The device must be open for reading.
+*/
+QDelimitedTextReader::QDelimitedTextReader(QIODevice *device, char separator, char quote)
+    : d_ptr(new QDelimitedTextReaderPrivate(device, separator, quote))
+{
+    Q_ASSERT(uchar(separator) < 0x80 && uchar(quote) < 0x80 && separator != quote);
+}
+
+/*!
+    Destroys the reader.
+*/
+QDelimitedTextReader::~QDelimitedTextReader() = default;
+
+/*!
+    Returns the device that is read.
+*/
+QIODevice *QDelimitedTextReader::device() const
+{
+    Q_D(const QDelimitedTextReader);
+    return d->device;
+}
+
+/*!
+    Returns the character separating the fields of a record.
+*/
+char QDelimitedTextReader::separator() const
+{
+    Q_D(const QDelimitedTextReader);
+    return d->separator;
+}
+
+/*!
+    Returns the character enclosing quoted fields.
+*/
+char QDelimitedTextReader::quote() const
+{
+    Q_D(const QDelimitedTextReader);
+    return d->quote;
+}
+
+/*!
+    Returns the number of bytes the reader reads from the device at once.
+    The default is 64K.
+
+    \sa setChunkSize()
+*/
+qsizetype QDelimitedTextReader::chunkSize() const
+{
+    Q_D(const QDelimitedTextReader);
+    return d->chunkSize;
+}
+
+/*!
+    Sets the number of bytes the reader reads from the device at once to
+    \a size.
+
+    \sa chunkSize()
+*/
+void QDelimitedTextReader::setChunkSize(qsizetype size)
+{
+    Q_D(QDelimitedTextReader);
+    d->chunkSize = qMax(size, qsizetype(1));
+}
+
+/*!
+    Reads the next record and replaces the contents of \a fields with its
+    fields. Returns \c false, and leaves \a fields empty, if there is no
+    complete record available.
+
+    The fields are only valid until the next call to this function.
+
+    \sa atEnd()
+*/
+bool QDelimitedTextReader::readRecord(QList<Field> &fields)
+{
+    Q_D(QDelimitedTextReader);
+    fields.clear();
+    if (!d->device)
+        return false;
+
+    for (;;) {
+        const QUtf8StringView pending(d->buffer.constData() + d->position,
+                                      d->buffer.size() - d->position);
+        if (!pending.isEmpty()) {
+            const qsizetype length = QUtf8DelimitedTextScanner::scanRecord(pending, d->separator,
+                                                                           d->quote,
+                                                                           d->deviceAtEnd,
+                                                                           fields);
+            if (length >= 0) {
+                d->position += length;
+                return true;
+            }
+            fields.clear();
+        }
+        if (d->deviceAtEnd || (!d->fill() && !d->deviceAtEnd))
+            return false;
+    }
+}
+
+/*!
+    Returns \c true if all the records of the device have been read.
+*/
+bool QDelimitedTextReader::atEnd() const
+{
+    Q_D(const QDelimitedTextReader);
+    return d->deviceAtEnd && d->position == d->buffer.size();
+}
+
+QT_END_NAMESPACE
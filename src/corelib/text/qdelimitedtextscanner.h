@@ -0,0 +1,223 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QDELIMITEDTEXTSCANNER_H
+#define QDELIMITEDTEXTSCANNER_H
+
+#include <QtCore/qlist.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringview.h>
+#include <QtCore/qutf8stringview.h>
+
+#if 0
+// Workaround for generating forward headers
+#pragma qt_class(QDelimitedTextScanner)
+#pragma qt_class(QUtf8DelimitedTextScanner)
+#endif
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+class QDelimitedTextReader;
+
+namespace QtPrivate {
+[[nodiscard]] Q_CORE_EXPORT QString unquoteDelimitedField(QStringView raw, char quote);
+[[nodiscard]] Q_CORE_EXPORT QString unquoteDelimitedField(QUtf8StringView raw, char quote);
+} // namespace QtPrivate
+
+template <typename View>
+class QBasicDelimitedTextScanner
+{
+    using storage_type = typename View::storage_type;
+public:
+    class Field
+    {
+        friend class QBasicDelimitedTextScanner;
+        constexpr Field(View raw, char quote, bool quoted, bool needsUnquoting) noexcept
+            : m_raw(raw), m_quote(quote), m_quoted(quoted), m_needsUnquoting(needsUnquoting) {}
+    public:
+        constexpr Field() noexcept = default;
+
+        [[nodiscard]] constexpr View rawView() const noexcept { return m_raw; }
+        [[nodiscard]] constexpr bool isQuoted() const noexcept { return m_quoted; }
+        [[nodiscard]] constexpr bool needsUnquoting() const noexcept { return m_needsUnquoting; }
+
+        [[nodiscard]] constexpr View view() const noexcept
+        {
+            return m_quoted && !m_needsUnquoting ? m_raw.sliced(1, m_raw.size() - 2) : m_raw;
+        }
+
+        [[nodiscard]] QString toString() const
+        {
+            return m_needsUnquoting ? QtPrivate::unquoteDelimitedField(m_raw, m_quote)
+                                    : view().toString();
+        }
+
+    private:
+        View m_raw;
+        char m_quote = '"';
+        bool m_quoted = false;
+        bool m_needsUnquoting = false;
+    };
+
+    constexpr explicit QBasicDelimitedTextScanner(View text, char separator = ',',
+                                                  char quote = '"') noexcept
+        : m_text(text), m_separator(separator), m_quote(quote)
+    {
+        Q_ASSERT(uchar(separator) < 0x80 && uchar(quote) < 0x80 && separator != quote);
+    }
+
+    [[nodiscard]] constexpr View text() const noexcept { return m_text; }
+    [[nodiscard]] constexpr char separator() const noexcept { return m_separator; }
+    [[nodiscard]] constexpr char quote() const noexcept { return m_quote; }
+
+    [[nodiscard]] constexpr qsizetype position() const noexcept { return m_pos; }
+    [[nodiscard]] constexpr bool atEnd() const noexcept { return m_pos == m_text.size(); }
+
+    bool readRecord(QList<Field> &fields)
+    {
+        fields.clear();
+        if (atEnd())
+            return false;
+        m_pos += scanRecord(m_text.sliced(m_pos), m_separator, m_quote, true, fields);
+        return true;
+    }
+
+private:
+    friend class QDelimitedTextReader;
+
+    // Splits the record at the start of text into fields. Returns the length of
+    // the record, including its terminator; if the text ends before that, the
+    // record is only complete if final is true, otherwise -1 is returned.
+    static qsizetype scanRecord(View text, char separator, char quote, bool final,
+                                QList<Field> &fields)
+    {
+        const storage_type * const begin = reinterpret_cast<const storage_type *>(text.data());
+        const storage_type * const end = begin + text.size();
+        const storage_type *p = begin;
+        for (;;) {
+            const storage_type * const fieldBegin = p;
+            bool quoted = false;
+            bool needsUnquoting = false;
+            if (p != end && *p == quote) {
+                quoted = true;
+                for (++p; ; ++p) {
+                    while (p != end && *p != quote)
+                        ++p;
+                    if (p == end) {
+                        // unterminated quoted field
+                        if (!final)
+                            return -1;
+                        needsUnquoting = true;
+                        break;
+                    }
+                    ++p;
+                    if (p == end) {
+                        // the closing quote might be the first of an escaped pair
+                        if (!final)
+                            return -1;
+                        break;
+                    }
+                    if (*p != quote)
+                        break;
+                    needsUnquoting = true;
+                }
+            }
+            // text after the closing quote is kept as-is
+            while (p != end && *p != separator && *p != '\n' && *p != '\r') {
+                needsUnquoting = quoted;
+                ++p;
+            }
+            fields.append(Field(View(fieldBegin, p - fieldBegin), quote, quoted, needsUnquoting));
+
+            if (p == end)
+                return final ? p - begin : -1;
+            if (*p == separator) {
+                ++p;
+                continue;
+            }
+            if (*p++ == '\r') {
+                if (p == end && !final)
+                    return -1;
+                if (p != end && *p == '\n')
+                    ++p;
+            }
+            return p - begin;
+        }
+    }
+
+    View m_text;
+    qsizetype m_pos = 0;
+    char m_separator;
+    char m_quote;
+};
+
+using QDelimitedTextScanner = QBasicDelimitedTextScanner<QStringView>;
+using QUtf8DelimitedTextScanner = QBasicDelimitedTextScanner<QUtf8StringView>;
+
+class QDelimitedTextReaderPrivate;
+class Q_CORE_EXPORT QDelimitedTextReader
+{
+    Q_DECLARE_PRIVATE(QDelimitedTextReader)
+public:
+    using Field = QUtf8DelimitedTextScanner::Field;
+
+    explicit QDelimitedTextReader(QIODevice *device, char separator = ',', char quote = '"');
+    ~QDelimitedTextReader();
+
+    QIODevice *device() const;
+    char separator() const;
+    char quote() const;
+
+    qsizetype chunkSize() const;
+    void setChunkSize(qsizetype size);
+
+    bool readRecord(QList<Field> &fields);
+    bool atEnd() const;
+
+private:
+    Q_DISABLE_COPY(QDelimitedTextReader)
+    QScopedPointer<QDelimitedTextReaderPrivate> d_ptr;
+};
+
+QT_END_NAMESPACE
+
+#endif // QDELIMITEDTEXTSCANNER_H
@@ -1986,6 +1986,9 @@ QString QLocale::toString(qlonglong i) const
     int flags = (d->m_numberOptions & OmitGroupSeparator
                  ? 0 : QLocaleData::GroupDigits);
 
+    // The C locale formats like QString::number(), which is faster
+    if (!flags && d->m_data == QLocaleData::c())
+        return QString::number(i);
     return d->m_data->longLongToString(i, -1, 10, -1, flags);
 }
 
@@ -2000,6 +2003,9 @@ QString QLocale::toString(qulonglong i) const
     int flags = (d->m_numberOptions & OmitGroupSeparator
                  ? 0 : QLocaleData::GroupDigits);
 
+    // The C locale formats like QString::number(), which is faster
+    if (!flags && d->m_data == QLocaleData::c())
+        return QString::number(i);
     return d->m_data->unsLongLongToString(i, -1, 10, -1, flags);
 }
 
@@ -2693,6 +2699,12 @@ QString QLocale::toString(double f, char format, int precision) const
         flags |= QLocaleData::ZeroPadExponent;
     if (d->m_numberOptions & IncludeTrailingZeroesAfterDot)
         flags |= QLocaleData::AddTrailingZeroes;
+
+    // The C locale formats like QString::number(), which is faster
+    if (d->m_data == QLocaleData::c()
+            && (flags & ~QLocaleData::CapitalEorX) == QLocaleData::ZeroPadExponent) {
+        return qdtoBasicLatin(f, form, precision, flags & QLocaleData::CapitalEorX);
+    }
     return d->m_data->doubleToString(f, precision, form, -1, flags);
 }
 
@@ -3894,6 +3906,39 @@ bool QLocaleData::numberToCLocale(QStringView s, QLocale::NumberOptions number_o
     auto length = s.size();
     decltype(length) idx = 0;
 
+    // Fast path: in the C locale, a number written in ASCII without group
+    // separators needs no mapping, which saves looking up the locale's symbols
+    // for every character.
+    if (this == c() && !(number_options & (QLocale::RejectLeadingZeroInExponent
+                                           | QLocale::RejectTrailingZeroesAfterDot))) {
+        result->resize(length + 1);
+        char *out = result->data();
+        bool seenDecimalPoint = false;
+        bool seenExponent = false;
+        for (; idx < length; ++idx) {
+            char16_t ch = uc[idx].unicode();
+            if (ch == '.') {
+                // Fail if more than one decimal point or point after e
+                if (seenDecimalPoint || seenExponent)
+                    return false;
+                seenDecimalPoint = true;
+            } else if (ch == 'e' || ch == 'E') {
+                seenExponent = true;
+                ch = 'e';
+            } else if ((ch < '0' || ch > '9') && ch != '+' && ch != '-') {
+                break;
+            }
+            out[idx] = char(ch);
+        }
+        if (idx == length) {
+            out[idx] = '\0';
+            return true;
+        }
+        // something else, such as a group separator, needs the general code
+        result->clear();
+        idx = 0;
+    }
+
     int digitsInGroup = 0;
     int group_cnt = 0; // counts number of group chars
     int decpt_idx = -1;
@@ -56,6 +56,11 @@
 #include <limits>
 #include <charconv>
 
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+// std::to_chars() and std::from_chars() for floating-point types
+#  define QT_SUPPORTS_FLOAT_TO_CHARS
+#endif
+
 #if defined(Q_OS_LINUX) && !defined(__UCLIBC__)
 #    include <fenv.h>
 #endif
@@ -116,6 +121,32 @@ void qt_doubleToAscii(double d, QLocaleData::DoubleForm form, int precision, cha
     if (form == QLocaleData::DFSignificantDigits && precision == 0)
         precision = 1; // 0 significant digits is silently converted to 1
 
+#ifdef QT_SUPPORTS_FLOAT_TO_CHARS
+    if (precision == QLocale::FloatingPointShortest
+            && bufSize >= std::numeric_limits<double>::max_digits10) {
+        // std::to_chars() finds the shortest representation that round-trips
+        // much faster than libdouble-conversion does; its scientific form,
+        // "d.ddde-xx", just has to be split into the digits and the exponent.
+        char scientific[std::numeric_limits<double>::max_digits10 + 8];
+        const auto res = std::to_chars(std::begin(scientific), std::end(scientific),
+                                       std::abs(d), std::chars_format::scientific);
+        Q_ASSERT(res.ec == std::errc{});
+        const char *p = scientific;
+        sign = std::signbit(d);
+        length = 0;
+        for (; *p != 'e'; ++p) {
+            if (*p != '.')
+                buf[length++] = *p;
+        }
+        const bool negativeExponent = *++p == '-';
+        int exponent = 0;
+        for (++p; p != res.ptr; ++p)
+            exponent = exponent * 10 + (*p - '0');
+        decpt = (negativeExponent ? -exponent : exponent) + 1;
+        return;
+    }
+#endif
+
 #if !defined(QT_NO_DOUBLECONVERSION) && !defined(QT_BOOTSTRAPPED)
     // one digit before the decimal dot, counts as significant digit for DoubleToStringConverter
     if (form == QLocaleData::DFExponent && precision >= 0)
@@ -278,6 +309,18 @@ void qt_doubleToAscii(double d, QLocaleData::DoubleForm form, int precision, cha
         --length;
 }
 
+// If a digit before any 'e' is not 0, then a non-zero number was intended.
+static bool hasNonZeroMantissaDigit(const char *num, int length)
+{
+    for (int i = 0; i < length; ++i) {
+        if (num[i] >= '1' && num[i] <= '9')
+            return true;
+        if (num[i] == 'e' || num[i] == 'E')
+            break;
+    }
+    return false;
+}
+
 double qt_asciiToDouble(const char *num, qsizetype numLen, bool &ok, int &processed,
                         StrayCharacterMode strayCharMode)
 {
@@ -320,6 +363,35 @@ double qt_asciiToDouble(const char *num, qsizetype numLen, bool &ok, int &proces
     }
 
     double d = 0.0;
+#ifdef QT_SUPPORTS_FLOAT_TO_CHARS
+    // std::from_chars() is much faster than libdouble-conversion. Use it for
+    // the common case of a plain number that it converts without errors, and
+    // leave all the special cases, like a leading '+', overflow and
+    // underflow, to the general code below. Both round correctly, so they
+    // agree on the result. Only hand it a number that starts with a digit or
+    // '.', as it would also accept spellings of infinity and NaN, like
+    // "-Inf" or "-nan(1)", that we reject.
+    const qsizetype mantissaStart = num[0] == '-' ? 1 : 0;
+    if (mantissaStart < numLen
+            && ((num[mantissaStart] >= '0' && num[mantissaStart] <= '9')
+                || num[mantissaStart] == '.')) {
+        const char *const end = num + numLen;
+        const auto res = std::from_chars(num, end, d);
+        const auto isNumberChar = [](char c) {
+            return (c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E'
+                    || c == '+' || c == '-';
+        };
+        if (res.ec == std::errc{} && res.ptr != num
+                && (res.ptr == end
+                    || (strayCharMode == TrailingJunkAllowed && !isNumberChar(*res.ptr)))) {
+            processed = int(res.ptr - num);
+            if (!isZero(d) || !hasNonZeroMantissaDigit(num, processed))
+                return d;
+        }
+        d = 0.0;
+    }
+#endif
+
 #if !defined(QT_NO_DOUBLECONVERSION) && !defined(QT_BOOTSTRAPPED)
     int conv_flags = double_conversion::StringToDoubleConverter::NO_FLAGS;
     if (strayCharMode == TrailingJunkAllowed) {
@@ -387,16 +459,9 @@ double qt_asciiToDouble(const char *num, qsizetype numLen, bool &ok, int &proces
     Q_ASSERT(strayCharMode == TrailingJunkAllowed || processed == numLen);
 
     // Check if underflow has occurred.
-    if (isZero(d)) {
-        for (int i = 0; i < processed; ++i) {
-            if (num[i] >= '1' && num[i] <= '9') {
-                // if a digit before any 'e' is not 0, then a non-zero number was intended.
-                ok = false;
-                return 0.0;
-            } else if (num[i] == 'e' || num[i] == 'E') {
-                break;
-            }
-        }
+    if (isZero(d) && hasNonZeroMantissaDigit(num, processed)) {
+        ok = false;
+        return 0.0;
     }
     return d;
 }
@@ -0,0 +1,243 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmultibytearraymatcher.h"
+#include "qahocorasick_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class QMultiByteArrayMatcherPrivate : public QSharedData
+{
+public:
+    QByteArrayList patterns;
+    QtPrivate::AhoCorasick<uchar> automaton;
+};
+
+QT_DEFINE_QESDP_SPECIALIZATION_DTOR(QMultiByteArrayMatcherPrivate)
+
+template <typename OnMatch>
+static void scan(const QMultiByteArrayMatcherPrivate *d, QByteArrayView data, qsizetype from,
+                 OnMatch onMatch)
+{
+    // the class table covers all bytes
+    const int *classes = d->automaton.classTable();
+    const uchar *p = reinterpret_cast<const uchar *>(data.data());
+    d->automaton.scan(from, data.size(), [&](qsizetype i) { return classes[p[i]]; }, onMatch);
+}
+
+/*!
+    \class QMultiByteArrayMatcher
+    \inmodule QtCore
+    \since 6.4
+    \brief The QMultiByteArrayMatcher class holds a set of byte sequences
+    that can be matched in a byte array all at once.
+
+    \ingroup tools
+    \ingroup string-processing
+    \reentrant
+
+    Searching a byte array for many patterns with one QByteArrayMatcher per
+    pattern takes one pass over the data for each of them.
+    QMultiByteArrayMatcher compiles all patterns into a single automaton when
+    it is constructed (using the Aho-Corasick algorithm), and then finds the
+    occurrences of all of them in one pass, at a cost that depends on the
+    length of the data and the number of matches, but not on the number of
+    patterns.
+
+    Create the QMultiByteArrayMatcher with the list of patterns, then call
+    matchesIn() to get all occurrences of the patterns in a byte array, or
+    matchIn() or indexIn() to get the first one. Each match reports the
+    position where it starts and the index of the pattern in the list it was
+    constructed with, which also tells where the match ends.
+
+    The object is implicitly shared, so copying it is cheap.
+
+    \sa QByteArrayMatcher, QMultiStringMatcher
+*/
+
+/*!
+    \class QMultiByteArrayMatcher::Match
+    \inmodule QtCore
+    \since 6.4
+    \brief Describes a match of a QMultiByteArrayMatcher.
+
+    \variable QMultiByteArrayMatcher::Match::index
+
+    The position in the byte array where the match starts, or -1 if there
+    was no match.
+
+    \variable QMultiByteArrayMatcher::Match::patternIndex
+
+    The index of the matching pattern in patterns(), or -1 if there was no
+    match.
+*/
+
+/*!
+    \fn QMultiByteArrayMatcher::QMultiByteArrayMatcher()
+
+    Constructs a matcher without patterns, which won't match anything.
+*/
+
+/*!
+    Constructs a matcher that searches for all of \a patterns. Empty patterns
+    never match.
+*/
+QMultiByteArrayMatcher::QMultiByteArrayMatcher(const QByteArrayList &patterns)
+    : d(new QMultiByteArrayMatcherPrivate)
+{
+    d->patterns = patterns;
+    for (const QByteArray &pattern : patterns) {
+        d->automaton.addPattern(reinterpret_cast<const uchar *>(pattern.constData()),
+                                pattern.size());
+    }
+    d->automaton.build();
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QMultiByteArrayMatcher::QMultiByteArrayMatcher(const QMultiByteArrayMatcher &other) = default;
+
+/*!
+    \fn QMultiByteArrayMatcher::QMultiByteArrayMatcher(QMultiByteArrayMatcher &&other)
+
+    Move-constructs a matcher from \a other.
+
+    Note that a moved-from QMultiByteArrayMatcher can only be destroyed or
+    assigned to.
+*/
+
+/*!
+    Destroys the matcher.
+*/
+QMultiByteArrayMatcher::~QMultiByteArrayMatcher() = default;
+
+/*!
+    Assigns \a other to this matcher, and returns a reference to this
+    matcher.
+*/
+QMultiByteArrayMatcher &
+QMultiByteArrayMatcher::operator=(const QMultiByteArrayMatcher &other) = default;
+
+/*!
+    \fn void QMultiByteArrayMatcher::swap(QMultiByteArrayMatcher &other)
+
+    Swaps the matcher \a other with this matcher. This operation is very fast
+    and never fails.
+*/
+
+/*!
+    Returns the patterns this matcher searches for.
+*/
+QByteArrayList QMultiByteArrayMatcher::patterns() const
+{
+    return d ? d->patterns : QByteArrayList();
+}
+
+/*!
+    \fn qsizetype QMultiByteArrayMatcher::indexIn(QByteArrayView data, qsizetype from) const
+
+    Searches \a data from byte position \a from (default 0, i.e. from the
+    first byte), for any of the patterns. Returns the position of the first
+    match, or -1 if no pattern matched.
+
+    \sa matchIn(), matchesIn()
+*/
+
+/*!
+    Searches \a data from byte position \a from (default 0, i.e. from the
+    first byte), for any of the patterns, and returns the match that starts
+    first. If several patterns match at that position, the one that comes
+    first in patterns() is returned. If no pattern matches, the returned
+    match has an index of -1.
+
+    \sa indexIn(), matchesIn()
+*/
+QMultiByteArrayMatcher::Match
+QMultiByteArrayMatcher::matchIn(QByteArrayView data, qsizetype from) const
+{
+    if (from < 0)
+        from = 0;
+    Match best;
+    if (!d || from >= data.size())
+        return best;
+
+    // a match that ends later can still start earlier, but only up to the
+    // length of the longest pattern
+    const qsizetype maxLength = d->automaton.maximumLength();
+    scan(d.data(), data, from, [&](qsizetype index, qsizetype patternIndex) {
+        if (best.index < 0 || index < best.index
+            || (index == best.index && patternIndex < best.patternIndex)) {
+            best = { index, patternIndex };
+        }
+        return best.index + maxLength;
+    });
+    return best;
+}
+
+/*!
+    Searches \a data from byte position \a from (default 0, i.e. from the
+    first byte), for all of the patterns, and returns all matches, including
+    overlapping ones, in one pass over \a data.
+
+    The matches are ordered by the position where they end; matches that end
+    at the same position are ordered from the longest to the shortest
+    pattern, and patterns that are the same by their index.
+
+    \sa matchIn(), indexIn()
+*/
+QList<QMultiByteArrayMatcher::Match>
+QMultiByteArrayMatcher::matchesIn(QByteArrayView data, qsizetype from) const
+{
+    if (from < 0)
+        from = 0;
+    QList<Match> matches;
+    if (!d || from >= data.size())
+        return matches;
+
+    const qsizetype size = data.size();
+    scan(d.data(), data, from, [&](qsizetype index, qsizetype patternIndex) {
+        matches.append({ index, patternIndex });
+        return size;
+    });
+    return matches;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMULTIBYTEARRAYMATCHER_H
+#define QMULTIBYTEARRAYMATCHER_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qbytearraylist.h>
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qshareddata.h>
+
+QT_BEGIN_NAMESPACE
+
+class QMultiByteArrayMatcherPrivate;
+QT_DECLARE_QESDP_SPECIALIZATION_DTOR_WITH_EXPORT(QMultiByteArrayMatcherPrivate, Q_CORE_EXPORT)
+
+class Q_CORE_EXPORT QMultiByteArrayMatcher
+{
+public:
+    struct Match
+    {
+        qsizetype index = -1;
+        qsizetype patternIndex = -1;
+
+        friend constexpr bool operator==(Match lhs, Match rhs) noexcept
+        { return lhs.index == rhs.index && lhs.patternIndex == rhs.patternIndex; }
+        friend constexpr bool operator!=(Match lhs, Match rhs) noexcept
+        { return !(lhs == rhs); }
+    };
+
+    QMultiByteArrayMatcher() noexcept = default;
+    explicit QMultiByteArrayMatcher(const QByteArrayList &patterns);
+    QMultiByteArrayMatcher(const QMultiByteArrayMatcher &other);
+    QMultiByteArrayMatcher(QMultiByteArrayMatcher &&other) noexcept = default;
+    ~QMultiByteArrayMatcher();
+
+    QMultiByteArrayMatcher &operator=(const QMultiByteArrayMatcher &other);
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QMultiByteArrayMatcher)
+
+    void swap(QMultiByteArrayMatcher &other) noexcept { d.swap(other.d); }
+
+    QByteArrayList patterns() const;
+
+    qsizetype indexIn(QByteArrayView data, qsizetype from = 0) const
+    { return matchIn(data, from).index; }
+    Match matchIn(QByteArrayView data, qsizetype from = 0) const;
+    QList<Match> matchesIn(QByteArrayView data, qsizetype from = 0) const;
+
+private:
+    QExplicitlySharedDataPointer<QMultiByteArrayMatcherPrivate> d;
+};
+
+Q_DECLARE_SHARED(QMultiByteArrayMatcher)
+Q_DECLARE_TYPEINFO(QMultiByteArrayMatcher::Match, Q_PRIMITIVE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QMULTIBYTEARRAYMATCHER_H
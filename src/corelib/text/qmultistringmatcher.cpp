@@ -0,0 +1,300 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmultistringmatcher.h"
+#include "qahocorasick_p.h"
+#include "qvarlengtharray.h"
+
+QT_BEGIN_NAMESPACE
+
+class QMultiStringMatcherPrivate : public QSharedData
+{
+public:
+    QStringList patterns;
+    Qt::CaseSensitivity cs = Qt::CaseSensitive;
+    QtPrivate::AhoCorasick<char16_t> automaton;
+};
+
+QT_DEFINE_QESDP_SPECIALIZATION_DTOR(QMultiStringMatcherPrivate)
+
+// Returns the case-folded code unit at position i of str; surrogate pairs
+// are folded as a whole, which doesn't change their length.
+static char16_t foldedUnitAt(const char16_t *str, qsizetype i, qsizetype size)
+{
+    const char16_t c = str[i];
+    if (!QChar::isSurrogate(c))
+        return char16_t(QChar::toCaseFolded(char32_t(c)));
+    if (QChar::isHighSurrogate(c) && i + 1 < size && QChar::isLowSurrogate(str[i + 1]))
+        return QChar::highSurrogate(QChar::toCaseFolded(QChar::surrogateToUcs4(c, str[i + 1])));
+    if (QChar::isLowSurrogate(c) && i > 0 && QChar::isHighSurrogate(str[i - 1]))
+        return QChar::lowSurrogate(QChar::toCaseFolded(QChar::surrogateToUcs4(str[i - 1], c)));
+    return c;
+}
+
+template <typename OnMatch>
+static void scan(const QMultiStringMatcherPrivate *d, QStringView str, qsizetype from,
+                 OnMatch onMatch)
+{
+    const auto &automaton = d->automaton;
+    const char16_t *uc = str.utf16();
+    const qsizetype size = str.size();
+    if (d->cs == Qt::CaseSensitive) {
+        automaton.scan(from, size, [&](qsizetype i) { return automaton.classOf(uc[i]); },
+                       onMatch);
+        return;
+    }
+
+    // the class table already maps the units it covers to their folded
+    // form, except for surrogates, which depend on their neighbours
+    const int *classes = automaton.classTable();
+    automaton.scan(from, size, [&](qsizetype i) {
+        const char16_t c = uc[i];
+        if (Q_LIKELY(automaton.hasClassTableFor(c) && !QChar::isSurrogate(c)))
+            return classes[c];
+        return automaton.classOf(foldedUnitAt(uc, i, size));
+    }, onMatch);
+}
+
+/*!
+    \class QMultiStringMatcher
+    \inmodule QtCore
+    \since 6.4
+    \brief The QMultiStringMatcher class holds a set of character sequences
+    that can be matched in a Unicode string all at once.
+
+    \ingroup tools
+    \ingroup string-processing
+    \reentrant
+
+    Searching a string for many patterns with one QStringMatcher per pattern
+    takes one pass over the string for each of them. QMultiStringMatcher
+    compiles all patterns into a single automaton when it is constructed
+    (using the Aho-Corasick algorithm), and then finds the occurrences of all
+    of them in one pass, at a cost that depends on the length of the string
+    and the number of matches, but not on the number of patterns. This makes
+    it well suited for, say, filtering log lines against a list of keywords.
+
+    Create the QMultiStringMatcher with the list of patterns, then call
+    matchesIn() to get all occurrences of the patterns in a string, or
+    matchIn() or indexIn() to get the first one. Each match reports the
+    position where it starts and the index of the pattern in the list it was
+    constructed with, which also tells where the match ends.
+
+    With Qt::CaseInsensitive, characters are compared by their case folding
+    (see QChar::toCaseFolded()), like QStringMatcher does.
+
+    Constructing the automaton takes time and memory proportional to the
+    total length of the patterns. The object is implicitly shared, so copying
+    it is cheap.
+
+    \sa QStringMatcher, QMultiByteArrayMatcher
+*/
+
+/*!
+    \class QMultiStringMatcher::Match
+    \inmodule QtCore
+    \since 6.4
+    \brief Describes a match of a QMultiStringMatcher.
+
+    \variable QMultiStringMatcher::Match::index
+
+    The position in the string where the match starts, or -1 if there was
+    no match.
+
+    \variable QMultiStringMatcher::Match::patternIndex
+
+    The index of the matching pattern in patterns(), or -1 if there was no
+    match.
+*/
+
+/*!
+    \fn QMultiStringMatcher::QMultiStringMatcher()
+
+    Constructs a matcher without patterns, which won't match anything.
+*/
+
+/*!
+    Constructs a matcher that searches for all of \a patterns, with case
+    sensitivity \a cs. Empty patterns never match.
+*/
+QMultiStringMatcher::QMultiStringMatcher(const QStringList &patterns, Qt::CaseSensitivity cs)
+    : d(new QMultiStringMatcherPrivate)
+{
+    d->patterns = patterns;
+    d->cs = cs;
+    if (cs == Qt::CaseSensitive) {
+        for (const QString &pattern : patterns)
+            d->automaton.addPattern(QStringView(pattern).utf16(), pattern.size());
+        d->automaton.build();
+        return;
+    }
+
+    QVarLengthArray<char16_t> folded;
+    for (const QString &pattern : patterns) {
+        const char16_t *uc = QStringView(pattern).utf16();
+        const qsizetype size = pattern.size();
+        folded.resize(size);
+        for (qsizetype i = 0; i < size; ++i)
+            folded[i] = foldedUnitAt(uc, i, size);
+        d->automaton.addPattern(folded.constData(), size);
+    }
+    d->automaton.build();
+    d->automaton.mapClasses([](uint c) {
+        return QChar::isSurrogate(c) ? c : uint(QChar::toCaseFolded(char32_t(c)));
+    });
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QMultiStringMatcher::QMultiStringMatcher(const QMultiStringMatcher &other) = default;
+
+/*!
+    \fn QMultiStringMatcher::QMultiStringMatcher(QMultiStringMatcher &&other)
+
+    Move-constructs a matcher from \a other.
+
+    Note that a moved-from QMultiStringMatcher can only be destroyed or
+    assigned to.
+*/
+
+/*!
+    Destroys the matcher.
+*/
+QMultiStringMatcher::~QMultiStringMatcher() = default;
+
+/*!
+    Assigns \a other to this matcher, and returns a reference to this
+    matcher.
+*/
+QMultiStringMatcher &QMultiStringMatcher::operator=(const QMultiStringMatcher &other) = default;
+
+/*!
+    \fn void QMultiStringMatcher::swap(QMultiStringMatcher &other)
+
+    Swaps the matcher \a other with this matcher. This operation is very fast
+    and never fails.
+*/
+
+/*!
+    Returns the patterns this matcher searches for.
+*/
+QStringList QMultiStringMatcher::patterns() const
+{
+    return d ? d->patterns : QStringList();
+}
+
+/*!
+    Returns the case sensitivity this matcher was constructed with.
+*/
+Qt::CaseSensitivity QMultiStringMatcher::caseSensitivity() const
+{
+    return d ? d->cs : Qt::CaseSensitive;
+}
+
+/*!
+    \fn qsizetype QMultiStringMatcher::indexIn(QStringView str, qsizetype from) const
+
+    Searches the string \a str from character position \a from (default 0,
+    i.e. from the first character), for any of the patterns. Returns the
+    position of the first match, or -1 if no pattern matched.
+
+    \sa matchIn(), matchesIn()
+*/
+
+/*!
+    Searches the string \a str from character position \a from (default 0,
+    i.e. from the first character), for any of the patterns, and returns the
+    match that starts first. If several patterns match at that position, the
+    one that comes first in patterns() is returned. If no pattern matches,
+    the returned match has an index of -1.
+
+    \sa indexIn(), matchesIn()
+*/
+QMultiStringMatcher::Match QMultiStringMatcher::matchIn(QStringView str, qsizetype from) const
+{
+    if (from < 0)
+        from = 0;
+    Match best;
+    if (!d || from >= str.size())
+        return best;
+
+    // a match that ends later can still start earlier, but only up to the
+    // length of the longest pattern
+    const qsizetype maxLength = d->automaton.maximumLength();
+    scan(d.data(), str, from, [&](qsizetype index, qsizetype patternIndex) {
+        if (best.index < 0 || index < best.index
+            || (index == best.index && patternIndex < best.patternIndex)) {
+            best = { index, patternIndex };
+        }
+        return best.index + maxLength;
+    });
+    return best;
+}
+
+/*!
+    Searches the string \a str from character position \a from (default 0,
+    i.e. from the first character), for all of the patterns, and returns all
+    matches, including overlapping ones, in one pass over \a str.
+
+    The matches are ordered by the position where they end; matches that end
+    at the same position are ordered from the longest to the shortest
+    pattern, and patterns that are the same by their index.
+
+    \sa matchIn(), indexIn()
+*/
+QList<QMultiStringMatcher::Match>
+QMultiStringMatcher::matchesIn(QStringView str, qsizetype from) const
+{
+    if (from < 0)
+        from = 0;
+    QList<Match> matches;
+    if (!d || from >= str.size())
+        return matches;
+
+    const qsizetype size = str.size();
+    scan(d.data(), str, from, [&](qsizetype index, qsizetype patternIndex) {
+        matches.append({ index, patternIndex });
+        return size;
+    });
+    return matches;
+}
+
+QT_END_NAMESPACE
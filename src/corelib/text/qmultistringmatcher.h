@@ -0,0 +1,98 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMULTISTRINGMATCHER_H
+#define QMULTISTRINGMATCHER_H
+
+#include <QtCore/qlist.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qstringview.h>
+
+QT_BEGIN_NAMESPACE
+
+class QMultiStringMatcherPrivate;
+QT_DECLARE_QESDP_SPECIALIZATION_DTOR_WITH_EXPORT(QMultiStringMatcherPrivate, Q_CORE_EXPORT)
+
+class Q_CORE_EXPORT QMultiStringMatcher
+{
+public:
+    struct Match
+    {
+        qsizetype index = -1;
+        qsizetype patternIndex = -1;
+
+        friend constexpr bool operator==(Match lhs, Match rhs) noexcept
+        { return lhs.index == rhs.index && lhs.patternIndex == rhs.patternIndex; }
+        friend constexpr bool operator!=(Match lhs, Match rhs) noexcept
+        { return !(lhs == rhs); }
+    };
+
+    QMultiStringMatcher() noexcept = default;
+    explicit QMultiStringMatcher(const QStringList &patterns,
+                                 Qt::CaseSensitivity cs = Qt::CaseSensitive);
+    QMultiStringMatcher(const QMultiStringMatcher &other);
+    QMultiStringMatcher(QMultiStringMatcher &&other) noexcept = default;
+    ~QMultiStringMatcher();
+
+    QMultiStringMatcher &operator=(const QMultiStringMatcher &other);
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QMultiStringMatcher)
+
+    void swap(QMultiStringMatcher &other) noexcept { d.swap(other.d); }
+
+    QStringList patterns() const;
+    Qt::CaseSensitivity caseSensitivity() const;
+
+    qsizetype indexIn(QStringView str, qsizetype from = 0) const
+    { return matchIn(str, from).index; }
+    Match matchIn(QStringView str, qsizetype from = 0) const;
+    QList<Match> matchesIn(QStringView str, qsizetype from = 0) const;
+
+private:
+    QExplicitlySharedDataPointer<QMultiStringMatcherPrivate> d;
+};
+
+Q_DECLARE_SHARED(QMultiStringMatcher)
+Q_DECLARE_TYPEINFO(QMultiStringMatcher::Match, Q_PRIMITIVE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QMULTISTRINGMATCHER_H
@@ -41,6 +41,7 @@
 
 #include "qregularexpression.h"
 
+#include <QtCore/qcache.h>
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qhashfunctions.h>
 #include <QtCore/qlist.h>
@@ -282,6 +283,11 @@ using namespace Qt::StringLiterals;
     It is possible to pass a starting offset and one or more match options to
     the globalMatch() function, exactly like normal matching with match().
 
+    If only the positions of the matches are needed,
+    QRegularExpression::globalMatchOffsets() returns the start and end
+    offsets of all the captured substrings of every match in a single list,
+    without creating a QRegularExpressionMatch object for each match.
+
     \target partial matching
     \section1 Partial Matching
 
@@ -736,6 +742,20 @@ static int convertToPcreOptions(QRegularExpression::MatchOptions matchOptions)
     return options;
 }
 
+/*
+    A compiled, and if enabled JIT-compiled, pattern. PCRE2 code can be used
+    from several threads at once, so all the QRegularExpression objects with
+    the same pattern and options share one, see compilePattern().
+*/
+struct QRegularExpressionCompiledPattern : QSharedData
+{
+    ~QRegularExpressionCompiledPattern() { pcre2_code_free_16(code); }
+
+    pcre2_code_16 *code = nullptr;
+    int errorCode = 0;
+    qsizetype errorOffset = -1;
+};
+
 struct QRegularExpressionPrivate : QSharedData
 {
     QRegularExpressionPrivate();
@@ -756,6 +776,11 @@ struct QRegularExpressionPrivate : QSharedData
                  qsizetype offset,
                  CheckSubjectStringOption checkSubjectStringOption = CheckSubjectString,
                  const QRegularExpressionMatchPrivate *previous = nullptr) const;
+    int matchAt(const char16_t *subject, qsizetype subjectLength, qsizetype &offset,
+                int pcreOptions, bool previousMatchWasEmpty,
+                pcre2_match_data_16 *matchData) const;
+    QList<qsizetype> globalMatchOffsets(QStringView subject, qsizetype offset,
+                                        QRegularExpression::MatchOptions matchOptions) const;
 
     int captureIndexForName(QStringView name) const;
 
@@ -768,9 +793,10 @@ struct QRegularExpressionPrivate : QSharedData
     // (right after a detach happened).
     mutable QMutex mutex;
 
-    // The PCRE code pointer is reference-counted by the QRegularExpressionPrivate
-    // objects themselves; when the private is copied (i.e. a detach happened)
-    // it is set to nullptr
+    // The PCRE code is owned by the compiled pattern, which is shared with
+    // the cache and the other QRegularExpressionPrivate objects using it;
+    // when the private is copied (i.e. a detach happened) both are reset
+    QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern> compiled;
     pcre2_code_16 *compiledPattern;
     int errorCode;
     qsizetype errorOffset;
@@ -904,7 +930,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
 */
 void QRegularExpressionPrivate::cleanCompiledPattern()
 {
-    pcre2_code_free_16(compiledPattern);
+    compiled.reset();
     compiledPattern = nullptr;
     errorCode = 0;
     errorOffset = -1;
@@ -912,8 +938,61 @@ void QRegularExpressionPrivate::cleanCompiledPattern()
     usingCrLfNewlines = false;
 }
 
+namespace {
+struct CompiledPatternCacheKey
+{
+    QString pattern;
+    QRegularExpression::PatternOptions options;
+
+    friend bool operator==(const CompiledPatternCacheKey &lhs,
+                           const CompiledPatternCacheKey &rhs) noexcept
+    {
+        return lhs.options == rhs.options && lhs.pattern == rhs.pattern;
+    }
+    friend size_t qHash(const CompiledPatternCacheKey &key, size_t seed = 0) noexcept
+    {
+        return qHashMulti(seed, key.pattern, key.options.toInt());
+    }
+};
+
+/*
+    Keeps the most recently compiled patterns, so that creating a
+    QRegularExpression for a pattern that is already in use, for instance
+    for every record that a thread pool processes, or detaching one, doesn't
+    compile and JIT-compile the pattern again. Patterns that are still used
+    stay alive when they are evicted.
+*/
+class CompiledPatternCache
+{
+public:
+    using Pointer = QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern>;
+
+    Pointer find(const CompiledPatternCacheKey &key)
+    {
+        const QMutexLocker lock(&mutex);
+        const Pointer *compiled = cache.object(key);
+        return compiled ? *compiled : Pointer();
+    }
+
+    void insert(const CompiledPatternCacheKey &key, const Pointer &compiled)
+    {
+        const QMutexLocker lock(&mutex);
+        cache.insert(key, new Pointer(compiled));
+    }
+
+private:
+    QBasicMutex mutex;
+    QCache<CompiledPatternCacheKey, Pointer> cache{ 64 };
+};
+Q_GLOBAL_STATIC(CompiledPatternCache, compiledPatternCache)
+} // unnamed namespace
+
 /*!
     \internal
+
+    Compiles the pattern, or takes the compiled pattern from the cache if
+    another QRegularExpression with the same pattern and options compiled it
+    before.
 */
 void QRegularExpressionPrivate::compilePattern()
 {
@@ -925,27 +1004,43 @@ void QRegularExpressionPrivate::compilePattern()
     isDirty = false;
     cleanCompiledPattern();
 
-    int options = convertToPcreOptions(patternOptions);
-    options |= PCRE2_UTF;
+    CompiledPatternCache *cache = compiledPatternCache();
+    CompiledPatternCacheKey key{ pattern, patternOptions };
+    if (cache)
+        compiled = cache->find(key);
 
-    PCRE2_SIZE patternErrorOffset;
-    compiledPattern = pcre2_compile_16(reinterpret_cast<PCRE2_SPTR16>(pattern.constData()),
-                                       pattern.length(),
-                                       options,
-                                       &errorCode,
-                                       &patternErrorOffset,
-                                       nullptr);
+    if (!compiled) {
+        compiled = new QRegularExpressionCompiledPattern;
 
-    if (!compiledPattern) {
-        errorOffset = qsizetype(patternErrorOffset);
-        return;
-    } else {
-        // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
-        errorCode = 0;
+        int options = convertToPcreOptions(patternOptions);
+        options |= PCRE2_UTF;
+
+        PCRE2_SIZE patternErrorOffset;
+        compiled->code = pcre2_compile_16(reinterpret_cast<PCRE2_SPTR16>(pattern.constData()),
+                                          pattern.length(),
+                                          options,
+                                          &compiled->errorCode,
+                                          &patternErrorOffset,
+                                          nullptr);
+
+        if (!compiled->code) {
+            compiled->errorOffset = qsizetype(patternErrorOffset);
+        } else {
+            // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
+            compiled->errorCode = 0;
+            compiledPattern = compiled->code;
+            optimizePattern();
+        }
+
+        if (cache)
+            cache->insert(std::move(key), compiled);
     }
 
-    optimizePattern();
-    getPatternInfo();
+    compiledPattern = compiled->code;
+    errorCode = compiled->errorCode;
+    errorOffset = compiled->errorOffset;
+    if (compiledPattern)
+        getPatternInfo();
 }
 
 /*!
@@ -978,19 +1073,40 @@ void QRegularExpressionPrivate::getPatternInfo()
 
 
 /*
-    Simple "smartpointer" wrapper around a pcre2_jit_stack_16, to be used with
-    QThreadStorage.
+    The PCRE2 objects that a thread needs for matching, which are kept from
+    one match to the next instead of being allocated for each of them: the
+    match context, the match data, which is large enough for the pattern with
+    the most capturing groups matched in the thread so far, and the JIT stack,
+    which is only allocated when the default one on the machine stack turns
+    out to be too small for a pattern, and then grows as needed.
 */
 namespace {
-struct PcreJitStackFree
+struct PcreMatchResources
 {
-    void operator()(pcre2_jit_stack_16 *stack)
+    // The default JIT stack size in PCRE is 32K, the one we allocate starts
+    // at 512K and grows up to 16M.
+    static constexpr size_t JitStackStartSize = 32 * 1024;
+    static constexpr size_t JitStackInitialMaximumSize = 512 * 1024;
+    static constexpr size_t JitStackMaximumSize = 16 * 1024 * 1024;
+
+    ~PcreMatchResources()
     {
-        if (stack)
-            pcre2_jit_stack_free_16(stack);
+        pcre2_match_data_free_16(matchData);
+        pcre2_match_context_free_16(matchContext);
+        pcre2_jit_stack_free_16(jitStack);
     }
+
+    pcre2_match_data_16 *matchDataFor(int capturingCount);
+    pcre2_match_context_16 *context();
+    bool growJitStack();
+
+    pcre2_match_data_16 *matchData = nullptr;
+    uint32_t matchDataPairs = 0;
+    pcre2_match_context_16 *matchContext = nullptr;
+    pcre2_jit_stack_16 *jitStack = nullptr;
+    size_t jitStackSize = 0;
 };
-static thread_local std::unique_ptr<pcre2_jit_stack_16, PcreJitStackFree> jitStacks;
+static thread_local PcreMatchResources pcreMatchResources;
 }
 
 /*!
@@ -998,7 +1114,58 @@ static thread_local std::unique_ptr<pcre2_jit_stack_16, PcreJitStackFree> jitSta
 */
 static pcre2_jit_stack_16 *qtPcreCallback(void *)
 {
-    return jitStacks.get();
+    return pcreMatchResources.jitStack;
+}
+
+/*!
+    \internal
+
+    Returns match data with room for the offsets of \a capturingCount
+    capturing groups and the whole match. A larger block than needed
+    doesn't change the results of a match.
+*/
+pcre2_match_data_16 *PcreMatchResources::matchDataFor(int capturingCount)
+{
+    const uint32_t pairs = uint32_t(capturingCount) + 1;
+    if (pairs > matchDataPairs) {
+        pcre2_match_data_free_16(matchData);
+        matchData = pcre2_match_data_create_16(pairs, nullptr);
+        matchDataPairs = matchData ? pairs : 0;
+    }
+    return matchData;
+}
+
+/*!
+    \internal
+*/
+pcre2_match_context_16 *PcreMatchResources::context()
+{
+    if (!matchContext) {
+        matchContext = pcre2_match_context_create_16(nullptr);
+        if (matchContext)
+            pcre2_jit_stack_assign_16(matchContext, &qtPcreCallback, nullptr);
+    }
+    return matchContext;
+}
+
+/*!
+    \internal
+
+    Replaces the JIT stack with a larger one. Returns \c false if it can't
+    grow any further.
+*/
+bool PcreMatchResources::growJitStack()
+{
+    const size_t size = jitStackSize ? 2 * jitStackSize : JitStackInitialMaximumSize;
+    if (size > JitStackMaximumSize)
+        return false;
+    pcre2_jit_stack_16 *stack = pcre2_jit_stack_create_16(JitStackStartSize, size, nullptr);
+    if (!stack)
+        return false;
+    pcre2_jit_stack_free_16(jitStack);
+    jitStack = stack;
+    jitStackSize = size;
+    return true;
 }
 
 /*!
@@ -1082,23 +1249,20 @@ int QRegularExpressionPrivate::captureIndexForName(QStringView name) const
     \internal
 
     This is a simple wrapper for pcre2_match_16 for handling the case in which the
-    JIT runs out of memory. In that case, we allocate a thread-local JIT stack
+    JIT runs out of memory. In that case, we grow the thread-local JIT stack
     and re-run pcre2_match_16.
 */
 static int safe_pcre2_match_16(const pcre2_code_16 *code,
                                PCRE2_SPTR16 subject, qsizetype length,
                                qsizetype startOffset, int options,
-                               pcre2_match_data_16 *matchData,
-                               pcre2_match_context_16 *matchContext)
+                               pcre2_match_data_16 *matchData)
 {
+    pcre2_match_context_16 *matchContext = pcreMatchResources.context();
     int result = pcre2_match_16(code, subject, length,
                                 startOffset, options, matchData, matchContext);
 
-    if (result == PCRE2_ERROR_JIT_STACKLIMIT && !jitStacks) {
-        // The default JIT stack size in PCRE is 32K,
-        // we allocate from 32K up to 512K.
-        jitStacks.reset(pcre2_jit_stack_create_16(32 * 1024, 512 * 1024, NULL));
-
+    while (result == PCRE2_ERROR_JIT_STACKLIMIT && matchContext
+           && pcreMatchResources.growJitStack()) {
         result = pcre2_match_16(code, subject, length,
                                 startOffset, options, matchData, matchContext);
     }
@@ -1106,6 +1270,52 @@ static int safe_pcre2_match_16(const pcre2_code_16 *code,
     return result;
 }
 
+/*!
+    \internal
+
+    Runs one match of the pattern on \a subject from \a offset, advancing
+    past an empty match at \a offset if \a previousMatchWasEmpty is \c true
+    (see doMatch()). \a offset is updated to where the match was attempted.
+    Returns the result of pcre2_match_16, with the offsets in \a matchData.
+*/
+int QRegularExpressionPrivate::matchAt(const char16_t *subject, qsizetype subjectLength,
+                                       qsizetype &offset, int pcreOptions,
+                                       bool previousMatchWasEmpty,
+                                       pcre2_match_data_16 *matchData) const
+{
+    if (!previousMatchWasEmpty) {
+        return safe_pcre2_match_16(compiledPattern,
+                                   reinterpret_cast<PCRE2_SPTR16>(subject), subjectLength,
+                                   offset, pcreOptions,
+                                   matchData);
+    }
+
+    int result = safe_pcre2_match_16(compiledPattern,
+                                     reinterpret_cast<PCRE2_SPTR16>(subject), subjectLength,
+                                     offset, pcreOptions | PCRE2_NOTEMPTY_ATSTART | PCRE2_ANCHORED,
+                                     matchData);
+
+    if (result == PCRE2_ERROR_NOMATCH) {
+        ++offset;
+
+        if (usingCrLfNewlines
+                && offset < subjectLength
+                && subject[offset - 1] == u'\r'
+                && subject[offset] == u'\n') {
+            ++offset;
+        } else if (offset < subjectLength
+                   && QChar::isLowSurrogate(subject[offset])) {
+            ++offset;
+        }
+
+        result = safe_pcre2_match_16(compiledPattern,
+                                     reinterpret_cast<PCRE2_SPTR16>(subject), subjectLength,
+                                     offset, pcreOptions,
+                                     matchData);
+    }
+    return result;
+}
+
 /*!
     \internal
 
@@ -1177,9 +1387,9 @@ void QRegularExpressionPrivate::doMatch(QRegularExpressionMatchPrivate *priv,
         previousMatchWasEmpty = true;
     }
 
-    pcre2_match_context_16 *matchContext = pcre2_match_context_create_16(nullptr);
-    pcre2_jit_stack_assign_16(matchContext, &qtPcreCallback, nullptr);
-    pcre2_match_data_16 *matchData = pcre2_match_data_create_from_pattern_16(compiledPattern, nullptr);
+    pcre2_match_data_16 *matchData = pcreMatchResources.matchDataFor(capturingCount);
+    if (Q_UNLIKELY(!matchData))
+        return;
 
     // PCRE does not accept a null pointer as subject string, even if
     // its length is zero. We however allow it in input: a QStringView
@@ -1195,38 +1405,8 @@ void QRegularExpressionPrivate::doMatch(QRegularExpressionMatchPrivate *priv,
         return &dummySubject;
     }();
 
-    int result;
-
-    if (!previousMatchWasEmpty) {
-        result = safe_pcre2_match_16(compiledPattern,
-                                     reinterpret_cast<PCRE2_SPTR16>(subjectUtf16), subjectLength,
-                                     offset, pcreOptions,
-                                     matchData, matchContext);
-    } else {
-        result = safe_pcre2_match_16(compiledPattern,
-                                     reinterpret_cast<PCRE2_SPTR16>(subjectUtf16), subjectLength,
-                                     offset, pcreOptions | PCRE2_NOTEMPTY_ATSTART | PCRE2_ANCHORED,
-                                     matchData, matchContext);
-
-        if (result == PCRE2_ERROR_NOMATCH) {
-            ++offset;
-
-            if (usingCrLfNewlines
-                    && offset < subjectLength
-                    && subjectUtf16[offset - 1] == u'\r'
-                    && subjectUtf16[offset] == u'\n') {
-                ++offset;
-            } else if (offset < subjectLength
-                       && QChar::isLowSurrogate(subjectUtf16[offset])) {
-                ++offset;
-            }
-
-            result = safe_pcre2_match_16(compiledPattern,
-                                         reinterpret_cast<PCRE2_SPTR16>(subjectUtf16), subjectLength,
-                                         offset, pcreOptions,
-                                         matchData, matchContext);
-        }
-    }
+    const int result = matchAt(subjectUtf16, subjectLength, offset, pcreOptions,
+                               previousMatchWasEmpty, matchData);
 
 #ifdef QREGULAREXPRESSION_DEBUG
     qDebug() << "Matching" <<  pattern << "against" << subject
@@ -1292,9 +1472,65 @@ void QRegularExpressionPrivate::doMatch(QRegularExpressionMatchPrivate *priv,
             capturedOffsets[0] -= maximumLookBehind;
         }
     }
+}
 
-    pcre2_match_data_free_16(matchData);
-    pcre2_match_context_free_16(matchContext);
+/*!
+    \internal
+
+    Performs a global match on \a subject like QRegularExpressionMatchIterator
+    does, but only collects the offsets of the captures of each match, see
+    QRegularExpression::globalMatchOffsets().
+*/
+QList<qsizetype> QRegularExpressionPrivate::globalMatchOffsets(QStringView subject,
+                                                               qsizetype offset,
+                                                               QRegularExpression::MatchOptions matchOptions) const
+{
+    QList<qsizetype> offsets;
+    const qsizetype subjectLength = subject.size();
+
+    if (offset < 0)
+        offset += subjectLength;
+
+    if (offset < 0 || offset > subjectLength)
+        return offsets;
+
+    if (Q_UNLIKELY(!compiledPattern)) {
+        qtWarnAboutInvalidRegularExpression(pattern, "QRegularExpression::globalMatchOffsets");
+        return offsets;
+    }
+
+    pcre2_match_data_16 *matchData = pcreMatchResources.matchDataFor(capturingCount);
+    if (Q_UNLIKELY(!matchData))
+        return offsets;
+
+    // see doMatch()
+    const char16_t dummySubject = 0;
+    const char16_t * const subjectUtf16 = subject.utf16() ? subject.utf16() : &dummySubject;
+
+    int pcreOptions = convertToPcreOptions(matchOptions);
+    const qsizetype offsetsPerMatch = 2 * (qsizetype(capturingCount) + 1);
+    bool previousMatchWasEmpty = false;
+    for (;;) {
+        const int result = matchAt(subjectUtf16, subjectLength, offset, pcreOptions,
+                                   previousMatchWasEmpty, matchData);
+        if (result <= 0)
+            break;
+
+        // the captures after the last one that participated are unset
+        const PCRE2_SIZE *ovector = pcre2_get_ovector_pointer_16(matchData);
+        const qsizetype first = offsets.size();
+        offsets.resize(first + offsetsPerMatch, -1);
+        for (int i = 0; i < result * 2; ++i)
+            offsets[first + i] = qsizetype(ovector[i]);
+
+        previousMatchWasEmpty = (ovector[0] == ovector[1]);
+        offset = qsizetype(ovector[1]);
+
+        // the first match checked the subject already
+        pcreOptions |= PCRE2_NO_UTF_CHECK;
+    }
+
+    return offsets;
 }
 
 /*!
@@ -1739,6 +1975,36 @@ QRegularExpressionMatchIterator QRegularExpression::globalMatch(QStringView subj
     return QRegularExpressionMatchIterator(*priv);
 }
 
+/*!
+    \since 6.4
+
+    Performs a global match of the regular expression against the given
+    \a subjectView string view, starting at the position \a offset inside the
+    subject and honoring the given \a matchOptions, like globalMatch() does,
+    and returns the offsets of the captured substrings of all matches.
+
+    For every match, the returned list contains \c{2 * (captureCount() + 1)}
+    entries: the start and the end offset of the implicit capturing group 0,
+    which captures the whole match, followed by those of every capturing
+    group of the pattern, in order. Groups that didn't capture anything have
+    -1 as both offsets. The list is empty if there are no matches.
+
+    This avoids creating a QRegularExpressionMatch object for every match, as
+    well as the memory allocations that come with it, and so is the fastest
+    way of finding many matches in a long subject when only their positions
+    are needed. Only normal matching is supported; use globalMatch() for
+    partial matches.
+
+    \sa globalMatch(), captureCount(), {global matching}
+*/
+QList<qsizetype> QRegularExpression::globalMatchOffsets(QStringView subjectView,
+                                                        qsizetype offset,
+                                                        MatchOptions matchOptions) const
+{
+    d.data()->compilePattern();
+    return d->globalMatchOffsets(subjectView, offset, matchOptions);
+}
+
 /*!
     \since 5.4
 
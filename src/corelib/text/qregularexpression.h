@@ -145,6 +145,11 @@ public:
                                                 MatchType matchType       = NormalMatch,
                                                 MatchOptions matchOptions = NoMatchOption) const;
 
+    [[nodiscard]]
+    QList<qsizetype> globalMatchOffsets(QStringView subjectView,
+                                        qsizetype offset          = 0,
+                                        MatchOptions matchOptions = NoMatchOption) const;
+
     void optimize() const;
 
     enum WildcardConversionOption {
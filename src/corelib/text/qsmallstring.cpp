@@ -0,0 +1,289 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsmallstring.h"
+
+#include <private/qstringconverter_p.h>
+
+QT_BEGIN_NAMESPACE
+
+void qt_from_latin1(char16_t *dst, const char *str, size_t size) noexcept;
+
+/*!
+    \class QSmallString
+    \inmodule QtCore
+    \since 6.4
+    \brief The QSmallString class is an immutable Unicode string that stores
+    short text inline.
+    \reentrant
+    \ingroup tools
+    \ingroup shared
+    \ingroup string-processing
+
+    QSmallString holds UTF-16 text, like QString, but strings of up to
+    InlineCapacity code units are kept inside the object itself instead of
+    in a separately allocated, reference-counted buffer. Creating, copying
+    and destroying such a string therefore never allocates memory and never
+    touches an atomic reference count. Longer strings are held in a QString,
+    and share its data when copied.
+
+    This makes QSmallString a good choice for large numbers of short strings
+    that are created once and then mostly compared, hashed or looked up,
+    such as identifiers, keys of a QHash, or the tokens of a parser:
+
+    \snippet code/src_corelib_text_qsmallstring.cpp 0
+
+    A QSmallString cannot be modified after it has been constructed; assign
+    a new value instead. It converts implicitly to QStringView and
+    QAnyStringView, so it can be passed to every function taking one of
+    those. Use toString() to obtain a QString.
+
+    On 64-bit platforms a QSmallString has the size of a QString plus
+    eight bytes, and InlineCapacity is 12.
+
+    \sa QString, QStringView
+*/
+
+/*!
+    \variable QSmallString::InlineCapacity
+
+    The largest number of UTF-16 code units a QSmallString can hold without
+    allocating memory.
+*/
+
+/*!
+    \fn QSmallString::QSmallString()
+
+    Constructs an empty string.
+*/
+
+/*!
+    Constructs a string holding a copy of \a str, converted to UTF-16.
+
+    No memory is allocated if the result is at most InlineCapacity code units
+    long.
+*/
+QSmallString::QSmallString(QAnyStringView str)
+{
+    str.visit([this](auto str) {
+        using View = decltype(str);
+        const qsizetype size = str.size();
+        if constexpr (std::is_same_v<View, QStringView>) {
+            if (size <= InlineCapacity)
+                constructInline(str.utf16(), size);
+            else
+                constructString(str.toString());
+        } else if constexpr (std::is_same_v<View, QLatin1StringView>) {
+            if (size <= InlineCapacity) {
+                qt_from_latin1(m_inline, str.data(), size_t(size));
+                m_inlineSize = qint8(size);
+            } else {
+                constructString(str.toString());
+            }
+        } else {
+            // UTF-8 never needs more UTF-16 code units than it has bytes
+            if (size <= InlineCapacity) {
+                QChar buffer[InlineCapacity];
+                const QChar *end = QUtf8::convertToUnicode(buffer, QByteArrayView(str.data(), size));
+                constructInline(buffer, end - buffer);
+            } else {
+                QString string = str.toString();
+                if (string.size() <= InlineCapacity)
+                    constructInline(string.constData(), string.size());
+                else
+                    constructString(std::move(string));
+            }
+        }
+    });
+}
+
+/*!
+    \fn template <typename String, QSmallString::if_qstring<String> = true> QSmallString::QSmallString(String &&str)
+
+    Constructs a string holding the text of the QString \a str.
+
+    If \a str is longer than InlineCapacity code units, the new string shares
+    its data with \a str; otherwise the text is copied inline.
+*/
+
+/*!
+    \fn QSmallString::QSmallString(const QSmallString &other)
+
+    Constructs a copy of \a other.
+*/
+
+/*!
+    \fn QSmallString::QSmallString(QSmallString &&other)
+
+    Move-constructs a string from \a other. \a other is left empty.
+*/
+
+/*!
+    \fn QSmallString::~QSmallString()
+
+    Destroys the string.
+*/
+
+/*!
+    \fn QSmallString &QSmallString::operator=(const QSmallString &other)
+
+    Assigns \a other to this string and returns a reference to this string.
+*/
+
+/*!
+    \fn QSmallString &QSmallString::operator=(QSmallString &&other)
+
+    Move-assigns \a other to this string and returns a reference to this
+    string. \a other is left empty.
+*/
+
+/*!
+    \fn void QSmallString::swap(QSmallString &other)
+
+    Swaps this string with \a other. This operation is very fast and never
+    fails.
+*/
+
+/*!
+    \fn qsizetype QSmallString::size() const
+    \fn qsizetype QSmallString::length() const
+
+    Returns the number of UTF-16 code units in this string.
+*/
+
+/*!
+    \fn bool QSmallString::isEmpty() const
+
+    Returns \c true if this string has no characters; otherwise returns
+    \c false.
+*/
+
+/*!
+    \fn const QChar *QSmallString::data() const
+    \fn const QChar *QSmallString::constData() const
+
+    Returns a pointer to the characters of this string. The data is not
+    '\\0'-terminated, and is valid only as long as the string is not
+    modified or destroyed.
+
+    \sa utf16(), view()
+*/
+
+/*!
+    \fn const char16_t *QSmallString::utf16() const
+
+    Returns the characters of this string as a pointer to \c{char16_t}.
+    The data is not '\\0'-terminated.
+
+    \sa data()
+*/
+
+/*!
+    \fn QChar QSmallString::at(qsizetype n) const
+    \fn QChar QSmallString::operator[](qsizetype n) const
+
+    Returns the character at index position \a n, which must be a valid index
+    position in the string.
+*/
+
+/*!
+    \fn QSmallString::const_iterator QSmallString::begin() const
+    \fn QSmallString::const_iterator QSmallString::cbegin() const
+
+    Returns an iterator pointing to the first character in the string.
+*/
+
+/*!
+    \fn QSmallString::const_iterator QSmallString::end() const
+    \fn QSmallString::const_iterator QSmallString::cend() const
+
+    Returns an iterator pointing just after the last character in the string.
+*/
+
+/*!
+    \fn QStringView QSmallString::view() const
+
+    Returns a QStringView on this string.
+*/
+
+/*!
+    \fn QString QSmallString::toString() const &
+    \fn QString QSmallString::toString() &&
+
+    Returns the text of this string as a QString. A string longer than
+    InlineCapacity returns its data without copying it.
+*/
+
+/*!
+    \fn void QSmallString::clear()
+
+    Makes this string empty.
+*/
+
+/*!
+    \fn bool QSmallString::operator==(const QSmallString &lhs, const QSmallString &rhs)
+    \fn bool QSmallString::operator!=(const QSmallString &lhs, const QSmallString &rhs)
+    \fn bool QSmallString::operator<(const QSmallString &lhs, const QSmallString &rhs)
+    \fn bool QSmallString::operator<=(const QSmallString &lhs, const QSmallString &rhs)
+    \fn bool QSmallString::operator>(const QSmallString &lhs, const QSmallString &rhs)
+    \fn bool QSmallString::operator>=(const QSmallString &lhs, const QSmallString &rhs)
+
+    Compares \a lhs and \a rhs code unit by code unit, like the corresponding
+    QString operators.
+*/
+
+/*!
+    \fn bool QSmallString::operator==(const QSmallString &lhs, QStringView rhs)
+    \fn bool QSmallString::operator!=(const QSmallString &lhs, QStringView rhs)
+    \fn bool QSmallString::operator==(QStringView lhs, const QSmallString &rhs)
+    \fn bool QSmallString::operator!=(QStringView lhs, const QSmallString &rhs)
+
+    Returns whether \a lhs and \a rhs hold the same text.
+*/
+
+/*!
+    \fn size_t QSmallString::qHash(const QSmallString &key, size_t seed)
+
+    Returns the hash value for \a key, using \a seed to seed the calculation.
+    The value is the same as for a QString or QStringView holding the same
+    text.
+*/
+
+QT_END_NAMESPACE
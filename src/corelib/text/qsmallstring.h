@@ -0,0 +1,217 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSMALLSTRING_H
+#define QSMALLSTRING_H
+
+#include <QtCore/qanystringview.h>
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringview.h>
+
+#include <cstring>
+#include <new>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+class Q_CORE_EXPORT QSmallString
+{
+    template <typename String>
+    using if_qstring = std::enable_if_t<std::is_same_v<std::remove_cv_t<std::remove_reference_t<String>>, QString>, bool>;
+
+public:
+    // As many UTF-16 code units as fit in the room of a QString
+    static constexpr qsizetype InlineCapacity = qsizetype(sizeof(QString) / sizeof(char16_t));
+
+    using value_type = QChar;
+    using size_type = qsizetype;
+    using const_iterator = const QChar *;
+    using iterator = const_iterator;
+
+    QSmallString() noexcept : m_inline{}, m_inlineSize(0) {}
+    explicit QSmallString(QAnyStringView str);
+    template <typename String, if_qstring<String> = true>
+    explicit QSmallString(String &&str)
+    {
+        if (str.size() <= InlineCapacity)
+            constructInline(str.constData(), str.size());
+        else
+            constructString(std::forward<String>(str));
+    }
+
+    QSmallString(const QSmallString &other)
+    {
+        if (other.isInline())
+            copyInline(other);
+        else
+            constructString(other.m_string);
+    }
+    QSmallString(QSmallString &&other) noexcept { moveFrom(other); }
+    ~QSmallString() { destroy(); }
+
+    QSmallString &operator=(const QSmallString &other)
+    {
+        if (this != &other) {
+            QSmallString copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+    QSmallString &operator=(QSmallString &&other) noexcept
+    {
+        if (this != &other) {
+            destroy();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    void swap(QSmallString &other) noexcept
+    {
+        QSmallString tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    [[nodiscard]] qsizetype size() const noexcept
+    { return isInline() ? qsizetype(m_inlineSize) : m_string.size(); }
+    [[nodiscard]] qsizetype length() const noexcept { return size(); }
+    [[nodiscard]] bool isEmpty() const noexcept { return size() == 0; }
+
+    [[nodiscard]] const QChar *data() const noexcept
+    { return isInline() ? reinterpret_cast<const QChar *>(m_inline) : m_string.constData(); }
+    [[nodiscard]] const QChar *constData() const noexcept { return data(); }
+    [[nodiscard]] const char16_t *utf16() const noexcept
+    { return reinterpret_cast<const char16_t *>(data()); }
+
+    [[nodiscard]] QChar at(qsizetype n) const
+    { Q_ASSERT(n >= 0 && n < size()); return data()[n]; }
+    [[nodiscard]] QChar operator[](qsizetype n) const { return at(n); }
+
+    [[nodiscard]] const_iterator begin() const noexcept { return data(); }
+    [[nodiscard]] const_iterator end() const noexcept { return data() + size(); }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] QStringView view() const noexcept { return QStringView(data(), size()); }
+
+    [[nodiscard]] QString toString() const &
+    { return isInline() ? QString(data(), size()) : m_string; }
+    [[nodiscard]] QString toString() &&
+    { return isInline() ? QString(data(), size()) : std::move(m_string); }
+
+    void clear() noexcept { *this = QSmallString(); }
+
+    friend bool operator==(const QSmallString &lhs, const QSmallString &rhs) noexcept
+    { return lhs.view() == rhs.view(); }
+    friend bool operator!=(const QSmallString &lhs, const QSmallString &rhs) noexcept
+    { return lhs.view() != rhs.view(); }
+    friend bool operator<(const QSmallString &lhs, const QSmallString &rhs) noexcept
+    { return lhs.view() < rhs.view(); }
+    friend bool operator<=(const QSmallString &lhs, const QSmallString &rhs) noexcept
+    { return lhs.view() <= rhs.view(); }
+    friend bool operator>(const QSmallString &lhs, const QSmallString &rhs) noexcept
+    { return lhs.view() > rhs.view(); }
+    friend bool operator>=(const QSmallString &lhs, const QSmallString &rhs) noexcept
+    { return lhs.view() >= rhs.view(); }
+
+    friend bool operator==(const QSmallString &lhs, QStringView rhs) noexcept
+    { return lhs.view() == rhs; }
+    friend bool operator!=(const QSmallString &lhs, QStringView rhs) noexcept
+    { return lhs.view() != rhs; }
+    friend bool operator==(QStringView lhs, const QSmallString &rhs) noexcept
+    { return lhs == rhs.view(); }
+    friend bool operator!=(QStringView lhs, const QSmallString &rhs) noexcept
+    { return lhs != rhs.view(); }
+
+    friend size_t qHash(const QSmallString &key, size_t seed = 0) noexcept
+    { return qHash(key.view(), seed); }
+
+private:
+    bool isInline() const noexcept { return m_inlineSize >= 0; }
+
+    void constructInline(const void *str, qsizetype size) noexcept
+    {
+        Q_ASSERT(size <= InlineCapacity);
+        memcpy(m_inline, str, size_t(size) * sizeof(char16_t));
+        m_inlineSize = qint8(size);
+    }
+    void copyInline(const QSmallString &other) noexcept
+    {
+        // copying the whole buffer is cheaper than copying a variable amount
+        memcpy(m_inline, other.m_inline, sizeof(m_inline));
+        m_inlineSize = other.m_inlineSize;
+    }
+    template <typename String>
+    void constructString(String &&str)
+    {
+        new (&m_string) QString(std::forward<String>(str));
+        m_inlineSize = -1;
+    }
+    void moveFrom(QSmallString &other) noexcept
+    {
+        if (other.isInline())
+            copyInline(other);
+        else
+            constructString(std::move(other.m_string));
+        other.destroy();
+        other.m_inlineSize = 0;
+    }
+    void destroy() noexcept
+    {
+        if (!isInline()) {
+            m_string.~QString();
+            m_inlineSize = 0;
+        }
+    }
+
+    union {
+        char16_t m_inline[InlineCapacity];
+        QString m_string;
+    };
+    qint8 m_inlineSize; // -1 when m_string is used
+};
+
+Q_DECLARE_SHARED(QSmallString)
+
+QT_END_NAMESPACE
+
+#endif // QSMALLSTRING_H
@@ -77,6 +77,7 @@
 #include "qstringmatcher.cpp"
 #include "qstringiterator_p.h"
 #include "qstringalgorithms_p.h"
+#include "qstringsearch_p.h"
 #include "qthreadstorage.h"
 
 #include "qbytearraymatcher.h" // Helper for comparison of QLatin1StringView
@@ -189,6 +190,30 @@ static inline qsizetype qFindChar(QStringView str, QChar ch, qsizetype from, Qt:
                 return n - s;
         } else {
             c = foldCase(c);
+#if defined(__SSE2__)
+            if (c < 0x80) {
+                // Only the two ASCII variants of c and non-ASCII characters
+                // (e.g. U+212A KELVIN SIGN folds to 'k') can match.
+                const __m128i lower = _mm_set1_epi16(short(c));
+                const __m128i upper = _mm_set1_epi16(short(c >= 'a' && c <= 'z' ? c - 0x20 : c));
+                const __m128i nonAsciiMask = _mm_set1_epi16(short(0xff80));
+                const __m128i zero = _mm_setzero_si128();
+                for ( ; e - n >= 8; n += 8) {
+                    const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(n));
+                    const __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(data, nonAsciiMask), zero);
+                    const __m128i equal = _mm_or_si128(_mm_cmpeq_epi16(data, lower),
+                                                       _mm_cmpeq_epi16(data, upper));
+                    const __m128i nonAscii = _mm_andnot_si128(ascii, _mm_cmpeq_epi16(zero, zero));
+                    uint mask = uint(_mm_movemask_epi8(_mm_or_si128(equal, nonAscii)));
+                    while (mask) {
+                        const uint idx = qCountTrailingZeroBits(mask) / 2;
+                        if (foldCase(n[idx]) == c)
+                            return n + idx - s;
+                        mask &= ~(3u << (idx * 2));
+                    }
+                }
+            }
+#endif
             --n;
             while (++n != e)
                 if (foldCase(*n) == c)
@@ -1029,6 +1054,63 @@ void qt_to_latin1_unchecked(uchar *dst, const char16_t *src, qsizetype length)
     qt_to_latin1_internal<false>(dst, src, length);
 }
 
+#if defined(__SSE2__)
+// Case-insensitive comparison works on blocks of eight code units: blocks that
+// are entirely ASCII are folded and compared with SIMD instructions, only the
+// others go through the Unicode tables.
+static inline __m128i loadLatin1AsUtf16(const char *str)
+{
+    const __m128i chunk = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(str));
+    return _mm_unpacklo_epi8(chunk, _mm_setzero_si128());
+}
+
+// returns whether all eight code units of \a v are ASCII
+static inline bool isAsciiBlock(__m128i v)
+{
+    const __m128i nonAscii = _mm_and_si128(v, _mm_set1_epi16(short(0xff80)));
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) == 0xffff;
+}
+
+// folds (lowercases) the ASCII letters in \a v, which must be all ASCII
+static inline __m128i asciiFoldCaseBlock(__m128i v)
+{
+    const __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi16(v, _mm_set1_epi16('A' - 1)),
+                                          _mm_cmplt_epi16(v, _mm_set1_epi16('Z' + 1)));
+    return _mm_or_si128(v, _mm_and_si128(isUpper, _mm_set1_epi16(0x20)));
+}
+
+// uppercases the ASCII letters in \a v, which must be all ASCII
+static inline __m128i asciiUpperCaseBlock(__m128i v)
+{
+    const __m128i isLower = _mm_and_si128(_mm_cmpgt_epi16(v, _mm_set1_epi16('a' - 1)),
+                                          _mm_cmplt_epi16(v, _mm_set1_epi16('z' + 1)));
+    return _mm_andnot_si128(_mm_and_si128(isLower, _mm_set1_epi16(0x20)), v);
+}
+
+static inline __m128i asciiConvertCaseBlock(__m128i v, QUnicodeTables::Case which)
+{
+    if (which == QUnicodeTables::LowerCase || which == QUnicodeTables::CaseFold)
+        return asciiFoldCaseBlock(v);
+    return asciiUpperCaseBlock(v);
+}
+
+// Compares two ASCII blocks case-insensitively; returns the difference of
+// the first pair of folded code units that differ, or 0
+static inline int asciiCompareBlock(__m128i a, __m128i b)
+{
+    const __m128i foldedA = asciiFoldCaseBlock(a);
+    const __m128i foldedB = asciiFoldCaseBlock(b);
+    const uint mask = ~uint(_mm_movemask_epi8(_mm_cmpeq_epi16(foldedA, foldedB))) & 0xffff;
+    if (!mask)
+        return 0;
+    alignas(16) char16_t la[8], lb[8];
+    _mm_store_si128(reinterpret_cast<__m128i *>(la), foldedA);
+    _mm_store_si128(reinterpret_cast<__m128i *>(lb), foldedB);
+    const uint idx = qCountTrailingZeroBits(mask) / 2;
+    return la[idx] - lb[idx];
+}
+#endif
+
 // Unicode case-insensitive comparison (argument order matches QStringView)
 Q_NEVER_INLINE static int ucstricmp(qsizetype alen, const char16_t *a, qsizetype blen, const char16_t *b)
 {
@@ -1038,15 +1120,30 @@ Q_NEVER_INLINE static int ucstricmp(qsizetype alen, const char16_t *a, qsizetype
     char32_t alast = 0;
     char32_t blast = 0;
     qsizetype l = qMin(alen, blen);
-    qsizetype i;
-    for (i = 0; i < l; ++i) {
-//         qDebug() << Qt::hex << alast << blast;
-//         qDebug() << Qt::hex << "*a=" << *a << "alast=" << alast << "folded=" << foldCase (*a, alast);
-//         qDebug() << Qt::hex << "*b=" << *b << "blast=" << blast << "folded=" << foldCase (*b, blast);
-        int diff = foldCase(a[i], alast) - foldCase(b[i], blast);
-        if ((diff))
+    qsizetype i = 0;
+    auto compareFolded = [&](qsizetype end) {
+        for ( ; i < end; ++i) {
+            if (int diff = foldCase(a[i], alast) - foldCase(b[i], blast))
+                return diff;
+        }
+        return 0;
+    };
+#if defined(__SSE2__)
+    for ( ; l - i >= 8; ) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        if (isAsciiBlock(_mm_or_si128(va, vb))) {
+            if (int diff = asciiCompareBlock(va, vb))
+                return diff;
+            i += 8;
+            alast = blast = 0;  // no surrogate pair straddles an ASCII block
+        } else if (int diff = compareFolded(i + 8)) {
             return diff;
+        }
     }
+#endif
+    if (int diff = compareFolded(l))
+        return diff;
     if (i == alen) {
         if (i == blen)
             return 0;
@@ -1060,12 +1157,29 @@ Q_NEVER_INLINE static int ucstricmp(qsizetype alen, const char16_t *a, qsizetype
 Q_NEVER_INLINE static int ucstricmp(qsizetype alen, const char16_t *a, qsizetype blen, const char *b)
 {
     qsizetype l = qMin(alen, blen);
-    qsizetype i;
-    for (i = 0; i < l; ++i) {
-        int diff = foldCase(a[i]) - foldCase(char16_t{uchar(b[i])});
-        if ((diff))
+    qsizetype i = 0;
+    auto compareFolded = [&](qsizetype end) {
+        for ( ; i < end; ++i) {
+            if (int diff = foldCase(a[i]) - foldCase(char16_t{uchar(b[i])}))
+                return diff;
+        }
+        return 0;
+    };
+#if defined(__SSE2__)
+    for ( ; l - i >= 8; ) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        const __m128i vb = loadLatin1AsUtf16(b + i);
+        if (isAsciiBlock(_mm_or_si128(va, vb))) {
+            if (int diff = asciiCompareBlock(va, vb))
+                return diff;
+            i += 8;
+        } else if (int diff = compareFolded(i + 8)) {
             return diff;
+        }
     }
+#endif
+    if (int diff = compareFolded(l))
+        return diff;
     if (i == alen) {
         if (i == blen)
             return 0;
@@ -1411,7 +1525,32 @@ static int latin1nicmp(const char *lhsChar, qsizetype lSize, const char *rhsChar
     const uchar *lhs = reinterpret_cast<const uchar *>(lhsChar);
     const uchar *rhs = reinterpret_cast<const uchar *>(rhsChar);
     Q_ASSERT(lhs && rhs); // since both lSize and rSize are positive
-    for (qsizetype i = 0; i < size; i++) {
+    qsizetype i = 0;
+#if defined(__SSE2__)
+    // compare blocks of 16 ASCII characters at once
+    for ( ; size - i >= 16; i += 16) {
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs + i));
+        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs + i));
+        if (_mm_movemask_epi8(_mm_or_si128(l, r))) {
+            for (qsizetype j = i; j < i + 16; ++j) {
+                if (int res = latin1Lower[lhs[j]] - latin1Lower[rhs[j]])
+                    return res;
+            }
+            continue;
+        }
+        auto fold = [](__m128i v) {
+            const __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                                  _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+            return _mm_or_si128(v, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+        };
+        const uint mask = ~uint(_mm_movemask_epi8(_mm_cmpeq_epi8(fold(l), fold(r)))) & 0xffff;
+        if (mask) {
+            const qsizetype idx = i + qCountTrailingZeroBits(mask);
+            return latin1Lower[lhs[idx]] - latin1Lower[rhs[idx]];
+        }
+    }
+#endif
+    for ( ; i < size; i++) {
         if (int res = latin1Lower[lhs[i]] - latin1Lower[rhs[i]])
             return res;
     }
@@ -6619,13 +6758,27 @@ namespace QUnicodeTables {
  */
 template <typename T>
 Q_NEVER_INLINE
-static QString detachAndConvertCase(T &str, QStringIterator it, QUnicodeTables::Case which)
+static QString detachAndConvertCase(T &str, QStringIterator it, const QChar *end,
+                                    QUnicodeTables::Case which)
 {
     Q_ASSERT(!str.isEmpty());
     QString s = std::move(str);         // will copy if T is const QString
     QChar *pp = s.begin() + it.index(); // will detach if necessary
 
     do {
+#if defined(__SSE2__)
+        // convert blocks of eight ASCII characters at once
+        if (end - it.position() >= 8) {
+            const QChar *in = it.position();
+            const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+            if (isAsciiBlock(data)) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(pp), asciiConvertCaseBlock(data, which));
+                pp += 8;
+                it.setPosition(in + 8);
+                continue;
+            }
+        }
+#endif
         const auto folded = fullConvertCase(it.next(), which);
         if (Q_UNLIKELY(folded.size() > 1)) {
             if (folded.chars[0] == *pp && folded.size() == 2) {
@@ -6642,8 +6795,10 @@ static QString detachAndConvertCase(T &str, QStringIterator it, QUnicodeTables::
                 pp = const_cast<QChar *>(s.constBegin()) + outpos + folded.size();
 
                 // Adjust the input iterator if we are performing an in-place conversion
-                if constexpr (!std::is_const<T>::value)
+                if constexpr (!std::is_const<T>::value) {
                     it = QStringIterator(s.constBegin(), inpos + folded.size(), s.constEnd());
+                    end = s.constEnd();
+                }
             }
         } else {
             *pp++ = folded.chars[0];
@@ -6664,11 +6819,21 @@ static QString convertCase(T &str, QUnicodeTables::Case which)
         --e;
 
     QStringIterator it(p, e);
+#if defined(__SSE2__)
+    // skip the ASCII blocks that the conversion leaves unchanged
+    for (const QChar *block = p; e - block >= 8; block += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+        const __m128i converted = asciiConvertCaseBlock(data, which);
+        if (!isAsciiBlock(data) || _mm_movemask_epi8(_mm_cmpeq_epi16(converted, data)) != 0xffff)
+            break;
+        it.setPosition(block + 8);
+    }
+#endif
     while (it.hasNext()) {
         const char32_t uc = it.next();
         if (qGetProp(uc)->cases[which].diff) {
             it.recede();
-            return detachAndConvertCase(str, it, which);
+            return detachAndConvertCase(str, it, e, which);
         }
     }
     return std::move(str);
@@ -10604,21 +10769,11 @@ bool QtPrivate::endsWith(QLatin1StringView haystack, QLatin1StringView needle, Q
     return qt_ends_with_impl(haystack, needle, cs);
 }
 
-qsizetype QtPrivate::findString(QStringView haystack0, qsizetype from, QStringView needle0, Qt::CaseSensitivity cs) noexcept
+static qsizetype qFindStringHashed(QStringView haystack0, qsizetype from, QStringView needle0,
+                                   Qt::CaseSensitivity cs) noexcept
 {
     const qsizetype l = haystack0.size();
     const qsizetype sl = needle0.size();
-    if (from < 0)
-        from += l;
-    if (std::size_t(sl + from) > std::size_t(l))
-        return -1;
-    if (!sl)
-        return from;
-    if (!l)
-        return -1;
-
-    if (sl == 1)
-        return qFindChar(haystack0, needle0[0], from, cs);
 
     /*
         We use the Boyer-Moore algorithm in cases where the overhead
@@ -10679,6 +10834,40 @@ qsizetype QtPrivate::findString(QStringView haystack0, qsizetype from, QStringVi
     return -1;
 }
 
+qsizetype QtPrivate::findString(QStringView haystack0, qsizetype from, QStringView needle0, Qt::CaseSensitivity cs) noexcept
+{
+    const qsizetype l = haystack0.size();
+    const qsizetype sl = needle0.size();
+    if (from < 0)
+        from += l;
+    if (std::size_t(sl + from) > std::size_t(l))
+        return -1;
+    if (!sl)
+        return from;
+    if (!l)
+        return -1;
+
+    if (sl == 1)
+        return qFindChar(haystack0, needle0[0], from, cs);
+
+    if (sl <= QtPrivate::FirstLastFilterMaxNeedleLength) {
+        const char16_t *haystack = haystack0.utf16();
+        const char16_t *needle = needle0.utf16();
+        auto verify = [=](qsizetype pos) {
+            if (cs == Qt::CaseSensitive)
+                return memcmp(haystack + pos + 1, needle + 1, (sl - 2) * sizeof(char16_t)) == 0;
+            return QtPrivate::compareStrings(needle0, QStringView(haystack + pos, sl),
+                                             Qt::CaseInsensitive) == 0;
+        };
+        auto fallback = [=](qsizetype pos) {
+            return qFindStringHashed(haystack0, pos, needle0, cs);
+        };
+        return QtPrivate::findWithFirstLastFilter(haystack, l, from, needle, sl, cs,
+                                                  verify, fallback);
+    }
+    return qFindStringHashed(haystack0, from, needle0, cs);
+}
+
 qsizetype QtPrivate::findString(QStringView haystack, qsizetype from, QLatin1StringView needle, Qt::CaseSensitivity cs) noexcept
 {
     if (haystack.size() < needle.size())
@@ -58,6 +58,8 @@
 #include <bit>
 #endif
 
+#include <array>
+
 QT_BEGIN_NAMESPACE
 
 static_assert(std::is_nothrow_move_constructible_v<QStringEncoder>);
@@ -491,6 +493,263 @@ static void simdCompareAscii(const char8_t *&, const char8_t *, const char16_t *
 }
 #endif
 
+// Multi-byte UTF-8 kernels. Unlike the ASCII ones above, these handle blocks
+// mixing one-, two- and three-byte sequences, which covers everything in the
+// BMP outside the surrogates. Anything else -- four-byte sequences, surrogates,
+// malformed input -- stops them, and the scalar code takes over, so error
+// handling and chunked decoding behave exactly as before. They only need
+// PSHUFB on top of SSE2, so they're dispatched at runtime on SSSE3 (validation
+// needs no PSHUFB at all).
+//
+// There are deliberately no AVX2 or NEON variants. The decoder packs eight
+// characters per step through a 256-entry shuffle table; going wider would need
+// a table 256 times that size (VPSHUFB doesn't cross 128-bit lanes either), so
+// AVX2 buys nothing here. A NEON port (TBL instead of PSHUFB) is left for when
+// it can be measured on ARM. Those platforms keep the ASCII fast paths above
+// and use the scalar code for everything else.
+#if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_SSE2) \
+    && QT_COMPILER_SUPPORTS_HERE(SSSE3) && (defined(__SSSE3__) || !defined(QT_BOOTSTRAPPED))
+static bool hasSimdUtf8() noexcept
+{
+#  ifdef __SSSE3__
+    return true;
+#  else
+    return qCpuHasFeature(SSSE3);
+#  endif
+}
+
+// For each mask of the UTF-16 lanes to keep, a PSHUFB mask packing them to the
+// front of the register.
+static constexpr auto utf8DecodeShuffles = [] {
+    std::array<std::array<uchar, 16>, 256> table = {};
+    for (uint mask = 0; mask < 256; ++mask) {
+        uint j = 0;
+        for (uint i = 0; i < 8; ++i) {
+            if (mask & (1U << i)) {
+                table[mask][j++] = uchar(2 * i);
+                table[mask][j++] = uchar(2 * i + 1);
+            }
+        }
+        while (j < 16)
+            table[mask][j++] = 0x80;
+    }
+    return table;
+}();
+
+// Indexed by the masks of two- and three-byte characters among four UTF-32
+// lanes holding the bytes to write (two-byte mask in the low nibble), a PSHUFB
+// mask packing those bytes, and how many there are.
+struct Utf8EncodeShuffles
+{
+    std::array<std::array<uchar, 16>, 256> shuffles;
+    std::array<uchar, 256> lengths;
+};
+static constexpr auto utf8EncodeShuffles = [] {
+    Utf8EncodeShuffles table = {};
+    for (uint mask = 0; mask < 256; ++mask) {
+        uint j = 0;
+        for (uint i = 0; i < 4; ++i) {
+            const uint length = (mask & (0x10U << i)) ? 3 : (mask & (1U << i)) ? 2 : 1;
+            for (uint k = 0; k < length; ++k)
+                table.shuffles[mask][j++] = uchar(4 * i + k);
+        }
+        table.lengths[mask] = uchar(j);
+        while (j < 16)
+            table.shuffles[mask][j++] = 0x80;
+    }
+    return table;
+}();
+
+// Validates the sequences starting in the first eight bytes of data, or the
+// first sixteen if there are 32 bytes (next is zero otherwise). Returns how
+// many bytes they span, and sets starts to the mask of bytes starting one.
+// Returns 0 if data doesn't begin with a sequence, or any of those sequences
+// isn't a valid one- to three-byte one.
+static inline uint simdUtf8Window(__m128i data, __m128i next, uint startBytes, uint &starts) noexcept
+{
+    const auto bytesMatching = [data, next](char mask, char value) {
+        const __m128i m = _mm_set1_epi8(mask);
+        const __m128i v = _mm_set1_epi8(value);
+        return uint(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(data, m), v)))
+                | uint(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(next, m), v))) << 16;
+    };
+
+    const uint continuation = bytesMatching(char(0xc0), char(0x80));
+    const uint lead2 = bytesMatching(char(0xe0), char(0xc0));
+    const uint lead3 = bytesMatching(char(0xf0), char(0xe0));
+    const uint lead4 = bytesMatching(char(0xf0), char(0xf0)); // or invalid
+
+    starts = ~continuation & ((1U << startBytes) - 1);
+    if (!(starts & 1))
+        return 0;
+    const uint last = qBitScanReverse(starts);
+    const uint length = last + 1 + ((lead2 >> last) & 1) + 2 * ((lead3 >> last) & 1);
+    const uint window = (1U << length) - 1;
+
+    // every lead byte must be followed by exactly its continuation bytes
+    const uint expected = (lead2 << 1) | (lead3 << 1) | (lead3 << 2);
+
+    // C0 and C1 only start overlong sequences; after E0 the next byte must be
+    // at least A0 (not overlong), after ED below A0 (not a surrogate)
+    const uint overlong2 = bytesMatching(char(0xfe), char(0xc0));
+    const uint bit5 = bytesMatching(0x20, 0x20) >> 1;
+    const uint e0 = bytesMatching(char(0xff), char(0xe0));
+    const uint ed = bytesMatching(char(0xff), char(0xed));
+    const uint invalid = lead4 | overlong2 | (e0 & ~bit5) | (ed & bit5);
+
+    if (((continuation ^ expected) | invalid) & window)
+        return 0;
+    return length;
+}
+
+static bool simdValidateUtf8(const uchar *&src, const uchar *end) noexcept
+{
+    const uchar *const start = src;
+    uint starts;
+    while (end - src >= 16) {
+        const bool wide = end - src >= 32;
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i next = wide ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16))
+                                  : _mm_setzero_si128();
+        const uint length = simdUtf8Window(data, next, wide ? 16 : 8, starts);
+        if (!length)
+            break;
+        src += length;
+    }
+    return src != start;
+}
+
+// Decodes the sequences starting in the first eight bytes of data, as found
+// by simdUtf8Window().
+QT_FUNCTION_TARGET(SSSE3)
+static inline void simdDecodeUtf8Lanes(char16_t *&dst, __m128i data, uint starts) noexcept
+{
+    // compute the code point for every lane as if it started a sequence
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i b0 = _mm_unpacklo_epi8(data, zero);
+    const __m128i b1 = _mm_and_si128(_mm_unpacklo_epi8(_mm_srli_si128(data, 1), zero),
+                                     _mm_set1_epi16(0x3f));
+    const __m128i b2 = _mm_and_si128(_mm_unpacklo_epi8(_mm_srli_si128(data, 2), zero),
+                                     _mm_set1_epi16(0x3f));
+    const __m128i cp2 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b0, _mm_set1_epi16(0x1f)), 6),
+                                     b1);
+    const __m128i cp3 = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(b0, 12), _mm_slli_epi16(b1, 6)),
+                                     b2);
+    const __m128i is2 = _mm_cmpeq_epi16(_mm_and_si128(b0, _mm_set1_epi16(0xe0)),
+                                        _mm_set1_epi16(0xc0));
+    const __m128i is3 = _mm_cmpeq_epi16(_mm_and_si128(b0, _mm_set1_epi16(0xf0)),
+                                        _mm_set1_epi16(0xe0));
+    __m128i cp = _mm_andnot_si128(_mm_or_si128(is2, is3), b0);
+    cp = _mm_or_si128(cp, _mm_and_si128(is2, cp2));
+    cp = _mm_or_si128(cp, _mm_and_si128(is3, cp3));
+
+    // and keep the lanes that did
+    const __m128i shuffle = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(utf8DecodeShuffles[starts].data()));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(cp, shuffle));
+    dst += qPopulationCount(starts);
+}
+
+QT_FUNCTION_TARGET(SSSE3)
+static bool simdDecodeUtf8(char16_t *&dst, const uchar *&src, const uchar *end) noexcept
+{
+    const uchar *const start = src;
+    uint starts;
+
+    // Each round decodes the sequences starting in the first sixteen bytes
+    // (eight near the end), eight at a time.
+    while (end - src >= 16) {
+        const bool wide = end - src >= 32;
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i next = wide ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16))
+                                  : _mm_setzero_si128();
+        const uint consumed = simdUtf8Window(data, next, wide ? 16 : 8, starts);
+        if (!consumed)
+            break;
+
+        simdDecodeUtf8Lanes(dst, data, starts & 0xff);
+        if (wide) {
+            const __m128i middle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 8));
+            simdDecodeUtf8Lanes(dst, middle, starts >> 8);
+        }
+        src += consumed;
+    }
+    return src != start;
+}
+
+QT_FUNCTION_TARGET(SSSE3)
+static bool simdEncodeUtf8(uchar *&dst, const char16_t *&src, const char16_t *end) noexcept
+{
+    const char16_t *const start = src;
+    const auto encodeFour = [](uchar *&dst, __m128i chars) QT_FUNCTION_TARGET(SSSE3) {
+        const __m128i is1 = _mm_cmplt_epi32(chars, _mm_set1_epi32(0x80));
+        const __m128i is3 = _mm_cmpgt_epi32(chars, _mm_set1_epi32(0x7ff));
+        const __m128i is2 = _mm_andnot_si128(_mm_or_si128(is1, is3), _mm_set1_epi32(-1));
+
+        // the bytes of every character, in the order they're written
+        const __m128i low6 = _mm_or_si128(_mm_and_si128(chars, _mm_set1_epi32(0x3f)),
+                                          _mm_set1_epi32(0x80));
+        const __m128i mid6 = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(chars, 6),
+                                                        _mm_set1_epi32(0x3f)),
+                                          _mm_set1_epi32(0x80));
+        const __m128i bytes2 = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(chars, 6),
+                                                         _mm_set1_epi32(0xc0)),
+                                            _mm_slli_epi32(low6, 8));
+        const __m128i bytes3 = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(chars, 12),
+                                                         _mm_set1_epi32(0xe0)),
+                                            _mm_or_si128(_mm_slli_epi32(mid6, 8),
+                                                         _mm_slli_epi32(low6, 16)));
+        __m128i bytes = _mm_and_si128(is1, chars);
+        bytes = _mm_or_si128(bytes, _mm_and_si128(is2, bytes2));
+        bytes = _mm_or_si128(bytes, _mm_and_si128(is3, bytes3));
+
+        const uint index = uint(_mm_movemask_ps(_mm_castsi128_ps(is2)))
+                | uint(_mm_movemask_ps(_mm_castsi128_ps(is3))) << 4;
+        const __m128i shuffle = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(utf8EncodeShuffles.shuffles[index].data()));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(bytes, shuffle));
+        dst += utf8EncodeShuffles.lengths[index];
+    };
+
+    // Eight characters need at most 24 bytes, but the unaligned stores write up
+    // to 28; the output buffer has room for three bytes per input character,
+    // so keep two characters in reserve.
+    while (end - src >= 10) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i surrogates = _mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(-0x800)),
+                                                   _mm_set1_epi16(-0x2800));
+        if (_mm_movemask_epi8(surrogates))
+            break;
+
+        encodeFour(dst, _mm_unpacklo_epi16(data, _mm_setzero_si128()));
+        encodeFour(dst, _mm_unpackhi_epi16(data, _mm_setzero_si128()));
+        src += 8;
+    }
+    return src != start;
+}
+#else
+// No multi-byte kernels on this platform, see above.
+static bool hasSimdUtf8() noexcept
+{
+    return false;
+}
+
+static bool simdValidateUtf8(const uchar *&, const uchar *) noexcept
+{
+    return false;
+}
+
+static bool simdDecodeUtf8(char16_t *&, const uchar *&, const uchar *) noexcept
+{
+    return false;
+}
+
+static bool simdEncodeUtf8(uchar *&, const char16_t *&, const char16_t *) noexcept
+{
+    return false;
+}
+#endif
+
 enum { HeaderDone = 1 };
 
 QByteArray QUtf8::convertFromUnicode(QStringView in)
@@ -502,11 +761,14 @@ QByteArray QUtf8::convertFromUnicode(QStringView in)
     uchar *dst = reinterpret_cast<uchar *>(const_cast<char *>(result.constData()));
     const char16_t *src = reinterpret_cast<const char16_t *>(in.data());
     const char16_t *const end = src + len;
+    const bool simdUtf8 = hasSimdUtf8();
 
     while (src != end) {
         const char16_t *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
+        if (simdUtf8 && simdEncodeUtf8(dst, src, end))
+            continue;
 
         do {
             char16_t u = *src++;
@@ -570,10 +832,13 @@ char *QUtf8::convertFromUnicode(char *out, QStringView in, QStringConverter::Sta
         }
     }
 
+    const bool simdUtf8 = hasSimdUtf8();
     while (src != end) {
         const char16_t *nextAscii = end;
         if (simdEncodeAscii(cursor, nextAscii, src, end))
             break;
+        if (simdUtf8 && simdEncodeUtf8(cursor, src, end))
+            continue;
 
         do {
             char16_t uc = *src++;
@@ -657,10 +922,13 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, QByteArrayView in) noexcept
             src += 3;
         }
 
+        const bool simdUtf8 = hasSimdUtf8();
         while (src < end) {
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            if (simdUtf8 && simdDecodeUtf8(dst, src, end))
+                continue;
 
             do {
                 uchar b = *src++;
@@ -762,9 +1030,16 @@ QChar *QUtf8::convertToUnicode(QChar *out, QByteArrayView in, QStringConverter::
     // main body, stateless decoding
     res = 0;
     const uchar *nextAscii = src;
+    const bool simdUtf8 = hasSimdUtf8();
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            if (simdUtf8 && simdDecodeUtf8(dst, src, end)) {
+                nextAscii = src;
+                continue;
+            }
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -816,6 +1091,12 @@ QUtf8::ValidUtf8Result QUtf8::isValidUtf8(QByteArrayView in)
             src = simdFindNonAscii(src, end, nextAscii);
         if (src == end)
             break;
+        if (simdValidateUtf8(src, end)) {
+            // there was a non-ASCII character in the first window
+            isValidAscii = false;
+            nextAscii = src;
+            continue;
+        }
 
         do {
             uchar b = *src++;
@@ -39,6 +39,7 @@
 ****************************************************************************/
 
 #include "qstringmatcher.h"
+#include "qstringsearch_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -128,6 +129,31 @@ static inline qsizetype bm_find(QStringView haystack, qsizetype index, QStringVi
     return -1; // not found
 }
 
+static qsizetype bm_find_filtered(QStringView haystack, qsizetype index, QStringView needle,
+                                  const uchar *skiptable, Qt::CaseSensitivity cs)
+{
+    const qsizetype l = haystack.size();
+    const qsizetype pl = needle.size();
+    if (pl < 2 || pl > QtPrivate::FirstLastFilterMaxNeedleLength || index > l - pl)
+        return bm_find(haystack, index, needle, skiptable, cs);
+
+    const char16_t *uc = haystack.utf16();
+    const char16_t *puc = needle.utf16();
+    auto verify = [=](qsizetype pos) {
+        if (cs == Qt::CaseSensitive)
+            return memcmp(uc + pos + 1, puc + 1, (pl - 2) * sizeof(char16_t)) == 0;
+        for (qsizetype i = 0; i < pl; ++i) {
+            if (foldCase(uc + pos + i, uc) != foldCase(puc + i, puc))
+                return false;
+        }
+        return true;
+    };
+    auto fallback = [=](qsizetype pos) {
+        return bm_find(haystack, pos, needle, skiptable, cs);
+    };
+    return QtPrivate::findWithFirstLastFilter(uc, l, index, puc, pl, cs, verify, fallback);
+}
+
 void QStringMatcher::updateSkipTable()
 {
     bm_init_skiptable(q_sv, q_skiptable, q_cs);
@@ -310,7 +336,7 @@ qsizetype QStringMatcher::indexIn(QStringView str, qsizetype from) const
 {
     if (from < 0)
         from = 0;
-    return bm_find(str, from, q_sv, q_skiptable, q_cs);
+    return bm_find_filtered(str, from, q_sv, q_skiptable, q_cs);
 }
 
 /*!
@@ -0,0 +1,321 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qstringpool.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+
+QT_BEGIN_NAMESPACE
+
+class QStringPoolPrivate
+{
+public:
+    // Each shard has its own lock, so that threads interning different
+    // strings rarely wait for each other.
+    static constexpr int ShardCount = 16;
+
+    struct Shard
+    {
+        mutable QMutex mutex;
+        QMultiHash<size_t, QString> strings;
+        qsizetype characters = 0;
+        quint64 lookups = 0;
+        quint64 hits = 0;
+        quint64 evictions = 0;
+    };
+
+    static size_t hash(QStringView str) noexcept { return qHash(str); }
+    Shard &shard(size_t hash) noexcept { return shards[hash % ShardCount]; }
+    const Shard &shard(size_t hash) const noexcept { return shards[hash % ShardCount]; }
+
+    template <typename String>
+    QString intern(const String &str);
+
+    Shard shards[ShardCount];
+};
+
+template <typename String>
+QString QStringPoolPrivate::intern(const String &str)
+{
+    const QStringView view(str);
+    const size_t h = hash(view);
+    Shard &s = shard(h);
+
+    QMutexLocker locker(&s.mutex);
+    ++s.lookups;
+    for (auto [it, end] = s.strings.equal_range(h); it != end; ++it) {
+        if (*it == view) {
+            ++s.hits;
+            return *it;
+        }
+    }
+
+    QString copy;
+    if constexpr (std::is_same_v<String, QString>) {
+        // share the caller's data, unless it does not own it
+        if (str.data_ptr().isMutable())
+            copy = str;
+    }
+    if (copy.isNull())
+        copy = view.toString();
+    s.characters += copy.size();
+    s.strings.insert(h, copy);
+    return copy;
+}
+
+Q_GLOBAL_STATIC(QStringPool, globalStringPool)
+
+/*!
+    \class QStringPool
+    \inmodule QtCore
+    \since 6.4
+    \brief The QStringPool class keeps a single shared copy of equal strings.
+    \threadsafe
+    \ingroup tools
+    \ingroup string-processing
+
+    Data sets often contain the same short text over and over again: country
+    codes, status values, property or column names. Stored in separate QString
+    objects, each copy has its own allocation. QStringPool interns strings:
+    intern() returns a QString that shares its data with every other string
+    of equal content returned by the same pool, so that each distinct text is
+    held in memory only once.
+
+    \snippet code/src_corelib_text_qstringpool.cpp 0
+
+    The strings returned are ordinary, implicitly shared QString objects.
+    Modifying one detaches it from the pool, as with any other QString.
+
+    A pool keeps the strings it has returned alive. evictUnused() removes all
+    strings that are no longer referenced from outside of the pool; call it
+    from time to time when the set of strings in use changes, for example
+    after a model has been reloaded. statistics() reports how effective the
+    pool is.
+
+    All functions of QStringPool can be called from several threads at the
+    same time. globalInstance() returns a pool shared by the whole
+    application.
+
+    \sa QString, QStringView
+*/
+
+/*!
+    \class QStringPool::Statistics
+    \inmodule QtCore
+    \since 6.4
+    \brief The Statistics struct reports the state of a QStringPool.
+
+    \sa QStringPool::statistics()
+*/
+
+/*!
+    \variable QStringPool::Statistics::count
+
+    The number of distinct strings in the pool.
+*/
+
+/*!
+    \variable QStringPool::Statistics::characters
+
+    The number of UTF-16 code units in all strings of the pool.
+*/
+
+/*!
+    \variable QStringPool::Statistics::lookups
+
+    The number of calls to QStringPool::intern() with a non-empty string.
+*/
+
+/*!
+    \variable QStringPool::Statistics::hits
+
+    The number of calls to QStringPool::intern() that returned a string that
+    was already in the pool.
+*/
+
+/*!
+    \variable QStringPool::Statistics::evictions
+
+    The number of strings removed by QStringPool::evictUnused().
+*/
+
+/*!
+    Constructs an empty pool.
+*/
+QStringPool::QStringPool()
+    : d_ptr(new QStringPoolPrivate)
+{
+}
+
+/*!
+    Destroys the pool. The strings it has returned remain valid.
+*/
+QStringPool::~QStringPool()
+{
+}
+
+/*!
+    Returns the pool shared by the whole application.
+*/
+QStringPool *QStringPool::globalInstance()
+{
+    return globalStringPool();
+}
+
+/*!
+    Returns a string equal to \a str that shares its data with all the
+    strings of the same content returned by this pool. If there is no such
+    string yet, a copy of \a str is added to the pool.
+
+    An empty \a str returns a null string and is not added to the pool.
+*/
+QString QStringPool::intern(QStringView str)
+{
+    if (str.isEmpty())
+        return QString();
+    Q_D(QStringPool);
+    return d->intern(str);
+}
+
+/*!
+    \overload
+
+    If there is no string equal to \a str in the pool yet, \a str itself is
+    added, without copying its data.
+*/
+QString QStringPool::intern(const QString &str)
+{
+    if (str.isEmpty())
+        return str;
+    Q_D(QStringPool);
+    return d->intern(str);
+}
+
+/*!
+    Returns \c true if the pool holds a string equal to \a str; otherwise
+    returns \c false.
+*/
+bool QStringPool::contains(QStringView str) const
+{
+    Q_D(const QStringPool);
+    const size_t h = QStringPoolPrivate::hash(str);
+    const QStringPoolPrivate::Shard &s = d->shard(h);
+    QMutexLocker locker(&s.mutex);
+    for (auto [it, end] = s.strings.equal_range(h); it != end; ++it) {
+        if (*it == str)
+            return true;
+    }
+    return false;
+}
+
+/*!
+    Returns the number of distinct strings in the pool.
+*/
+qsizetype QStringPool::size() const
+{
+    Q_D(const QStringPool);
+    qsizetype count = 0;
+    for (const QStringPoolPrivate::Shard &s : d->shards) {
+        QMutexLocker locker(&s.mutex);
+        count += s.strings.size();
+    }
+    return count;
+}
+
+/*!
+    Returns statistics about the pool and its use.
+*/
+QStringPool::Statistics QStringPool::statistics() const
+{
+    Q_D(const QStringPool);
+    Statistics stats;
+    for (const QStringPoolPrivate::Shard &s : d->shards) {
+        QMutexLocker locker(&s.mutex);
+        stats.count += s.strings.size();
+        stats.characters += s.characters;
+        stats.lookups += s.lookups;
+        stats.hits += s.hits;
+        stats.evictions += s.evictions;
+    }
+    return stats;
+}
+
+/*!
+    Removes all strings that are referenced only by the pool and returns how
+    many were removed. Strings still in use elsewhere stay in the pool.
+*/
+qsizetype QStringPool::evictUnused()
+{
+    Q_D(QStringPool);
+    qsizetype removed = 0;
+    for (QStringPoolPrivate::Shard &s : d->shards) {
+        QMutexLocker locker(&s.mutex);
+        for (auto it = s.strings.begin(); it != s.strings.end();) {
+            // Outside of the lock, the reference count of a string held only
+            // by the pool cannot grow, so this check is not racy.
+            if (it->isDetached()) {
+                s.characters -= it->size();
+                ++s.evictions;
+                ++removed;
+                it = s.strings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return removed;
+}
+
+/*!
+    Removes all strings from the pool. Strings returned earlier remain
+    valid, but are no longer shared with strings returned later.
+*/
+void QStringPool::clear()
+{
+    Q_D(QStringPool);
+    for (QStringPoolPrivate::Shard &s : d->shards) {
+        QMutexLocker locker(&s.mutex);
+        s.strings.clear();
+        s.characters = 0;
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,314 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSTRINGSEARCH_P_H
+#define QSTRINGSEARCH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of internal files.  This header file may change from version to version
+// without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/private/qsimd_p.h>
+#include <QtCore/qalgorithms.h>
+
+#include <type_traits>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+// Substring search with a SIMD filter on the first and the last character of
+// the needle: for a block of haystack positions, the characters at each
+// position and at the position plus the needle length minus one are compared
+// with the needle's at once, and only the positions where both match are
+// checked further. On real text this rejects nearly all positions without
+// looking at them individually, which beats the rolling hash and, for needles
+// that are too short for long Boyer-Moore skips, the skip table too.
+//
+// Needles longer than this are better served by Boyer-Moore.
+constexpr qsizetype FirstLastFilterMaxNeedleLength = 32;
+
+namespace FirstLastFilter {
+#if defined(__SSE2__)
+#  if defined(__AVX2__)
+using Vector = __m256i;
+#  else
+using Vector = __m128i;
+#  endif
+using Mask = uint;
+constexpr int MaskBitsPerByte = 1;
+
+template <typename Char> inline Vector load(const Char *p)
+{
+#  if defined(__AVX2__)
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+#  else
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+#  endif
+}
+
+template <typename Char> inline Vector splat(Char c)
+{
+#  if defined(__AVX2__)
+    if constexpr (sizeof(Char) == 1)
+        return _mm256_set1_epi8(char(c));
+    else
+        return _mm256_set1_epi16(short(c));
+#  else
+    if constexpr (sizeof(Char) == 1)
+        return _mm_set1_epi8(char(c));
+    else
+        return _mm_set1_epi16(short(c));
+#  endif
+}
+
+template <typename Char> inline Vector equal(Vector a, Vector b)
+{
+#  if defined(__AVX2__)
+    if constexpr (sizeof(Char) == 1)
+        return _mm256_cmpeq_epi8(a, b);
+    else
+        return _mm256_cmpeq_epi16(a, b);
+#  else
+    if constexpr (sizeof(Char) == 1)
+        return _mm_cmpeq_epi8(a, b);
+    else
+        return _mm_cmpeq_epi16(a, b);
+#  endif
+}
+
+// all bits set in the lanes that hold a character >= 0x80
+template <typename Char> inline Vector nonAscii(Vector v)
+{
+#  if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    if constexpr (sizeof(Char) == 1)
+        return _mm256_cmpgt_epi8(zero, v);
+    else
+        return _mm256_xor_si256(_mm256_cmpeq_epi16(_mm256_and_si256(v, splat(char16_t(0xff80))), zero),
+                                _mm256_cmpeq_epi16(zero, zero));
+#  else
+    const __m128i zero = _mm_setzero_si128();
+    if constexpr (sizeof(Char) == 1)
+        return _mm_cmplt_epi8(v, zero);
+    else
+        return _mm_xor_si128(_mm_cmpeq_epi16(_mm_and_si128(v, splat(char16_t(0xff80))), zero),
+                             _mm_cmpeq_epi16(zero, zero));
+#  endif
+}
+
+inline Vector bitAnd(Vector a, Vector b)
+{
+#  if defined(__AVX2__)
+    return _mm256_and_si256(a, b);
+#  else
+    return _mm_and_si128(a, b);
+#  endif
+}
+
+inline Vector bitOr(Vector a, Vector b)
+{
+#  if defined(__AVX2__)
+    return _mm256_or_si256(a, b);
+#  else
+    return _mm_or_si128(a, b);
+#  endif
+}
+
+inline Mask movemask(Vector v)
+{
+#  if defined(__AVX2__)
+    return uint(_mm256_movemask_epi8(v));
+#  else
+    return uint(_mm_movemask_epi8(v));
+#  endif
+}
+#elif defined(__ARM_NEON__)
+using Vector = uint8x16_t;
+using Mask = quint64;
+// NEON has no PMOVMSKB; narrowing each 16-bit lane by 4 bits yields a nibble per byte
+constexpr int MaskBitsPerByte = 4;
+
+template <typename Char> inline Vector load(const Char *p)
+{
+    return vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+}
+
+template <typename Char> inline Vector splat(Char c)
+{
+    if constexpr (sizeof(Char) == 1)
+        return vdupq_n_u8(uint8_t(c));
+    else
+        return vreinterpretq_u8_u16(vdupq_n_u16(uint16_t(c)));
+}
+
+template <typename Char> inline Vector equal(Vector a, Vector b)
+{
+    if constexpr (sizeof(Char) == 1)
+        return vceqq_u8(a, b);
+    else
+        return vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+}
+
+template <typename Char> inline Vector nonAscii(Vector v)
+{
+    if constexpr (sizeof(Char) == 1)
+        return vcgeq_u8(v, vdupq_n_u8(0x80));
+    else
+        return vreinterpretq_u8_u16(vcgeq_u16(vreinterpretq_u16_u8(v), vdupq_n_u16(0x80)));
+}
+
+inline Vector bitAnd(Vector a, Vector b) { return vandq_u8(a, b); }
+inline Vector bitOr(Vector a, Vector b) { return vorrq_u8(a, b); }
+
+inline Mask movemask(Vector v)
+{
+    const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+#endif
+} // namespace FirstLastFilter
+
+/*
+    Searches \a haystack of length \a l, starting at \a from, for the needle
+    of length \a sl. The caller guarantees that 2 <= sl and from + sl <= l.
+
+    Positions that pass the filter are handed to \a verify, which returns
+    whether the needle is found there; it may assume that the first and last
+    characters match if \a cs is Qt::CaseSensitive. If \a cs is
+    Qt::CaseInsensitive, the filter accepts the ASCII case variants of the
+    first and last character of the needle as well as any non-ASCII
+    character, so that \a verify sees every position that could match
+    under Unicode case folding; needles that start or end with a non-ASCII
+    character are left to \a fallback.
+
+    \a fallback is called with a haystack position when the filter cannot be
+    used, be it for lack of SIMD support, a haystack that is too short for a
+    single block or a filter that lets through too many false positives
+    (e.g. a needle of characters that are very common in the haystack).
+*/
+template <typename Char, typename Verify, typename Fallback>
+qsizetype findWithFirstLastFilter(const Char *haystack, qsizetype l, qsizetype from,
+                                  const Char *needle, qsizetype sl, Qt::CaseSensitivity cs,
+                                  Verify verify, Fallback fallback)
+{
+    Q_ASSERT(sl >= 2);
+    Q_ASSERT(from >= 0 && from + sl <= l);
+#if defined(__SSE2__) || defined(__ARM_NEON__)
+    using namespace FirstLastFilter;
+    using UChar = std::make_unsigned_t<Char>;
+    constexpr qsizetype Width = sizeof(Vector) / sizeof(Char);
+    constexpr int BitsPerChar = MaskBitsPerByte * sizeof(Char);
+
+    // the last position from which a whole block can be loaded for the
+    // last character of the needle
+    const qsizetype lastBlock = l - sl - Width + 1;
+    if (from > lastBlock)
+        return fallback(from);
+
+    const UChar first = UChar(needle[0]);
+    const UChar last = UChar(needle[sl - 1]);
+    if (cs == Qt::CaseInsensitive && (first >= 0x80 || last >= 0x80))
+        return fallback(from);
+
+    auto asciiUpper = [cs](UChar c) {
+        return UChar(cs == Qt::CaseInsensitive && c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c);
+    };
+    auto asciiLower = [cs](UChar c) {
+        return UChar(cs == Qt::CaseInsensitive && c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+    };
+    const Vector firstLower = splat(asciiLower(first));
+    const Vector firstUpper = splat(asciiUpper(first));
+    const Vector lastLower = splat(asciiLower(last));
+    const Vector lastUpper = splat(asciiUpper(last));
+    auto candidates = [cs](Vector v, Vector lower, Vector upper) {
+        Vector m = equal<Char>(v, lower);
+        if (cs == Qt::CaseInsensitive)
+            m = bitOr(bitOr(m, equal<Char>(v, upper)), nonAscii<Char>(v));
+        return m;
+    };
+
+    qsizetype falsePositives = 0;
+    for (qsizetype i = from; ; i += Width) {
+        Mask mask = ~Mask(0);
+        if (i > lastBlock) {
+            // rescan the final block, skipping the positions already seen
+            mask <<= (i - lastBlock) * BitsPerChar;
+            i = lastBlock;
+        }
+        const Vector atFirst = load(haystack + i);
+        const Vector atLast = load(haystack + i + sl - 1);
+        mask &= movemask(bitAnd(candidates(atFirst, firstLower, firstUpper),
+                                candidates(atLast, lastLower, lastUpper)));
+        while (mask) {
+            const qsizetype idx = qCountTrailingZeroBits(mask) / BitsPerChar;
+            if (verify(i + idx))
+                return i + idx;
+            ++falsePositives;
+            mask &= ~(((Mask(1) << BitsPerChar) - 1) << (idx * BitsPerChar));
+        }
+        if (i == lastBlock)
+            return -1;
+        if (falsePositives > 32 && falsePositives * 8 > i - from)
+            return fallback(i + Width);
+    }
+#else
+    Q_UNUSED(needle);
+    Q_UNUSED(cs);
+    Q_UNUSED(verify);
+    Q_UNUSED(l);
+    Q_UNUSED(sl);
+    return fallback(from);
+#endif
+}
+
+} // namespace QtPrivate
+
+QT_END_NAMESPACE
+
+#endif // QSTRINGSEARCH_P_H
@@ -0,0 +1,148 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qboundedqueue_impl.h"
+
+#include <qthread.h>
+
+#include <private/qsimd_p.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+/*!
+    \internal
+
+    Tells the processor that the calling thread is spinning, waiting for
+    another thread to finish its part of a queue operation.
+*/
+void boundedQueuePause() noexcept
+{
+#if defined(Q_PROCESSOR_X86)
+    _mm_pause();
+#elif defined(Q_PROCESSOR_ARM) && defined(Q_CC_GNU) && (defined(Q_PROCESSOR_ARM_64) || Q_PROCESSOR_ARM >= 7)
+    asm volatile("yield");
+#endif
+}
+
+/*!
+    \internal
+
+    Returns how many times waitFor() retries the operation before it
+    blocks. Spinning only helps if the other side can run meanwhile.
+*/
+int BoundedQueueWaiter::spinCount() noexcept
+{
+    Q_CONSTINIT static QBasicAtomicInt count = Q_BASIC_ATOMIC_INITIALIZER(-1);
+    int n = count.loadRelaxed();
+    if (n < 0) {
+        n = QThread::idealThreadCount() > 1 ? 64 : 0;
+        count.storeRelaxed(n);
+    }
+    return n;
+}
+
+/*!
+    \internal
+
+    Registers the calling thread as waiting for the current epoch to end,
+    and returns the epoch as a ticket for wait() or cancelWait().
+*/
+quint32 BoundedQueueWaiter::prepareWait()
+{
+    QMutexLocker locker(&mutex);
+    waiters.storeRelaxed(waiters.loadRelaxed() + 1);
+    return epoch;
+}
+
+/*!
+    \internal
+
+    Unregisters the calling thread, which no longer needs to wait, unless
+    wakeAll() already ended the epoch of the \a ticket.
+*/
+void BoundedQueueWaiter::cancelWait(quint32 ticket)
+{
+    QMutexLocker locker(&mutex);
+    if (epoch == ticket)
+        waiters.storeRelaxed(waiters.loadRelaxed() - 1);
+}
+
+/*!
+    \internal
+
+    Blocks until wakeAll() ends the epoch of the \a ticket, or until the
+    \a deadline expires. Returns \c false if the deadline expired.
+*/
+bool BoundedQueueWaiter::wait(quint32 ticket, QDeadlineTimer deadline)
+{
+    QMutexLocker locker(&mutex);
+    while (epoch == ticket) {
+        if (!condition.wait(&mutex, deadline)) {
+            if (epoch != ticket)
+                break;
+            waiters.storeRelaxed(waiters.loadRelaxed() - 1);
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Wakes all threads blocked in wait(), and makes the ones that are
+    about to block return immediately. notify() does not call this
+    function again until another thread calls prepareWait().
+*/
+void BoundedQueueWaiter::wakeAll()
+{
+    QMutexLocker locker(&mutex);
+    if (waiters.loadRelaxed() == 0)
+        return;
+    ++epoch;
+    waiters.storeRelaxed(0);
+    condition.wakeAll();
+}
+
+} // namespace QtPrivate
+
+QT_END_NAMESPACE
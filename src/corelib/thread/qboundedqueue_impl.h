@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#if 0
+#pragma qt_sync_skip_header_check
+#pragma qt_sync_stop_processing
+#endif
+
+#ifndef QBOUNDEDQUEUE_IMPL_H
+#define QBOUNDEDQUEUE_IMPL_H
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qwaitcondition.h>
+
+#include <atomic>
+
+QT_REQUIRE_CONFIG(thread);
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+// The alignment of the parts of a queue that different threads write to,
+// so that they don't share a cache line.
+constexpr size_t BoundedQueueAlignment = 64;
+
+Q_CORE_EXPORT void boundedQueuePause() noexcept;
+
+// Blocks the threads that wait for a queue to become non-empty, or
+// non-full. The other side calls notify() after every change, which costs
+// a fence but no system call unless a thread is waiting.
+class Q_CORE_EXPORT BoundedQueueWaiter
+{
+public:
+    BoundedQueueWaiter() = default;
+    Q_DISABLE_COPY_MOVE(BoundedQueueWaiter)
+
+    void notify() noexcept
+    {
+        // pairs with the fence in waitFor(): either we see the waiter, or
+        // it sees the change that we made before calling notify()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (Q_UNLIKELY(waiters.loadRelaxed() != 0))
+            wakeAll();
+    }
+
+    // Calls tryOperation() until it returns true, or until the deadline
+    // expires. Returns the result of the last call.
+    template <typename Operation>
+    bool waitFor(Operation tryOperation, QDeadlineTimer deadline)
+    {
+        if (tryOperation())
+            return true;
+        for (int i = spinCount(); i > 0; --i) {
+            boundedQueuePause();
+            if (tryOperation())
+                return true;
+        }
+        for (;;) {
+            const quint32 ticket = prepareWait();
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (tryOperation()) {
+                cancelWait(ticket);
+                return true;
+            }
+            if (!wait(ticket, deadline))
+                return tryOperation();
+        }
+    }
+
+private:
+    static int spinCount() noexcept;
+    quint32 prepareWait();
+    void cancelWait(quint32 ticket);
+    bool wait(quint32 ticket, QDeadlineTimer deadline);
+    void wakeAll();
+
+    // waiters counts the threads that wait for the current epoch to end;
+    // both are only modified with mutex locked
+    QAtomicInt waiters;
+    quint32 epoch = 0;
+    QMutex mutex;
+    QWaitCondition condition;
+};
+
+} // namespace QtPrivate
+
+QT_END_NAMESPACE
+
+#endif // QBOUNDEDQUEUE_IMPL_H
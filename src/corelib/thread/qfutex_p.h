@@ -161,6 +161,16 @@ namespace QtLinuxFutex {
     {
         _q_futex(addr(&futex1), FUTEX_WAKE_OP, wake1, wake2, addr(&futex2), op);
     }
+    // wakes up to \a wake threads waiting on \a futex and moves up to
+    // \a requeue others to wait on \a target instead, provided \a futex
+    // still has \a expectedValue; returns false if it didn't
+    template <typename Atomic, typename Target> inline
+    bool futexCmpRequeue(Atomic &futex, typename Atomic::Type expectedValue, int wake,
+                         int requeue, Target &target)
+    {
+        return _q_futex(addr(&futex), FUTEX_CMP_REQUEUE, wake, quintptr(requeue),
+                        addr(&target), int(expectedValue)) >= 0;
+    }
 }
 namespace QtFutex = QtLinuxFutex;
 QT_END_NAMESPACE
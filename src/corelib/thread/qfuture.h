@@ -50,6 +50,11 @@
 
 #include <type_traits>
 
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <optional>
+#endif
+
 QT_REQUIRE_CONFIG(future);
 
 QT_BEGIN_NAMESPACE
@@ -175,6 +180,9 @@ QT_WARNING_POP
     template<class Function>
     QFuture<ResultType<Function>> then(QObject *context, Function &&function);
 
+    template<class Function>
+    QFuture<ResultType<Function>> then(QtFuture::Executor *executor, Function &&function);
+
 #ifndef QT_NO_EXCEPTIONS
     template<class Function,
              typename = std::enable_if_t<!QtPrivate::ArgResolver<Function>::HasExtraArgs>>
@@ -191,6 +199,10 @@ QT_WARNING_POP
     template<class Function, typename = std::enable_if_t<std::is_invocable_r_v<T, Function>>>
     QFuture<T> onCanceled(QObject *context, Function &&handler);
 
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+    QtPrivate::FutureAwaiter<T> operator co_await() const;
+#endif
+
     class const_iterator
     {
     public:
@@ -317,6 +329,9 @@ private:
     template<typename ResultType>
     friend struct QtPrivate::WhenAnyContext;
 
+    template<class U>
+    friend class QtPrivate::FutureAwaiter;
+
     using QFuturePrivate =
             std::conditional_t<std::is_same_v<T, void>, QFutureInterfaceBase, QFutureInterface<T>>;
 
@@ -388,6 +403,17 @@ QFuture<typename QFuture<T>::template ResultType<Function>> QFuture<T>::then(QOb
     return promise.future();
 }
 
+template<class T>
+template<class Function>
+QFuture<typename QFuture<T>::template ResultType<Function>>
+QFuture<T>::then(QtFuture::Executor *executor, Function &&function)
+{
+    QFutureInterface<ResultType<Function>> promise(QFutureInterfaceBase::State::Pending);
+    QtPrivate::Continuation<std::decay_t<Function>, ResultType<Function>, T>::create(
+            std::forward<Function>(function), this, promise, executor);
+    return promise.future();
+}
+
 #ifndef QT_NO_EXCEPTIONS
 template<class T>
 template<class Function, typename>
@@ -540,6 +566,185 @@ QFuture<std::variant<std::decay_t<Futures>...>> whenAny(Futures &&... futures);
 
 } // namespace QtFuture
 
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+namespace QtPrivate {
+
+template<class T>
+class FutureAwaiter
+{
+public:
+    explicit FutureAwaiter(const QFuture<T> &future) : future(future) { }
+
+    bool await_ready() const { return future.isFinished(); }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        future.d.resumeWhenFinished(
+                [](void *frame) { std::coroutine_handle<>::from_address(frame).resume(); },
+                handle.address());
+    }
+
+    T await_resume()
+    {
+        // rethrows a stored exception
+        future.waitForFinished();
+        if constexpr (!std::is_void_v<T>) {
+            static_assert(std::is_default_constructible_v<T>,
+                          "co_await needs a default-constructible result type, "
+                          "to resume the coroutine when the future is canceled.");
+            if (future.resultCount() == 0)
+                return T();
+            if constexpr (std::is_copy_constructible_v<T>)
+                return future.result();
+            else
+                return future.takeResult();
+        }
+    }
+
+private:
+    QFuture<T> future;
+};
+
+template<class Result>
+class SignalAwaiter
+{
+public:
+    using Value = std::conditional_t<std::is_void_v<Result>, bool, std::optional<Result>>;
+
+    template<class Sender, class Signal>
+    SignalAwaiter(Sender *sender, Signal signal, QObject *context)
+        : state(std::make_shared<State>())
+    {
+        if (!sender || !context) {
+            state->status.storeRelaxed(Finished);
+            return;
+        }
+
+        auto s = state;
+        if constexpr (std::is_void_v<Result>) {
+            state->connections[0] = QObject::connect(sender, signal, context, [s]() {
+                if (s->isFinished())
+                    return;
+                s->value = true;
+                s->finish();
+            });
+        } else if constexpr (QtPrivate::ArgResolver<Signal>::HasExtraArgs) {
+            state->connections[0] =
+                    QObject::connect(sender, signal, context, [s](auto... values) {
+                        if (s->isFinished())
+                            return;
+                        s->value.emplace(QtPrivate::createTuple(std::move(values)...));
+                        s->finish();
+                    });
+        } else {
+            state->connections[0] =
+                    QObject::connect(sender, signal, context, [s](Result value) {
+                        if (s->isFinished())
+                            return;
+                        s->value.emplace(std::move(value));
+                        s->finish();
+                    });
+        }
+
+        if (!state->connections[0]) {
+            state->status.storeRelaxed(Finished);
+            return;
+        }
+
+        // Give up when either side goes away. All three slots run in the
+        // context's thread, so they can't race with each other.
+        auto abandon = [s]() {
+            if (!s->isFinished())
+                s->finish();
+        };
+        state->connections[1] = QObject::connect(sender, &QObject::destroyed, context, abandon);
+        if (context != sender) {
+            state->connections[2] =
+                    QObject::connect(context, &QObject::destroyed, context, abandon);
+        }
+    }
+
+    SignalAwaiter(SignalAwaiter &&other) noexcept = default;
+    SignalAwaiter &operator=(SignalAwaiter &&other) = delete;
+
+    ~SignalAwaiter()
+    {
+        if (!state)
+            return;
+        state->disconnect();
+        state->status.fetchAndOrOrdered(Detached);
+    }
+
+    bool await_ready() const { return state->isFinished(); }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        state->handle = handle;
+        return !(state->status.fetchAndOrOrdered(Suspended) & Finished);
+    }
+
+    Value await_resume() { return std::move(state->value); }
+
+private:
+    enum Status { Finished = 0x1, Suspended = 0x2, Detached = 0x4 };
+
+    struct State
+    {
+        QMetaObject::Connection connections[3];
+        Value value = {};
+        std::coroutine_handle<> handle;
+        QAtomicInt status;
+
+        bool isFinished() const { return status.loadAcquire() & Finished; }
+
+        void disconnect()
+        {
+            for (const auto &connection : connections)
+                QObject::disconnect(connection);
+        }
+
+        void finish()
+        {
+            disconnect();
+            const int previous = status.fetchAndOrOrdered(Finished);
+            if ((previous & (Suspended | Detached)) == Suspended)
+                std::exchange(handle, nullptr).resume();
+        }
+    };
+
+    // Shared with the slots, which queued calls can keep alive past the
+    // lifetime of the awaiter.
+    std::shared_ptr<State> state;
+};
+
+} // namespace QtPrivate
+
+template<class T>
+QtPrivate::FutureAwaiter<T> QFuture<T>::operator co_await() const
+{
+    return QtPrivate::FutureAwaiter<T>(*this);
+}
+
+namespace QtFuture {
+
+template<class Sender, class Signal, typename = QtPrivate::EnableIfInvocable<Sender, Signal>>
+static QtPrivate::SignalAwaiter<ArgsType<Signal>> nextSignal(Sender *sender, Signal signal,
+                                                             QObject *context)
+{
+    return QtPrivate::SignalAwaiter<ArgsType<Signal>>(sender, signal, context);
+}
+
+template<class Sender, class Signal, typename = QtPrivate::EnableIfInvocable<Sender, Signal>>
+static QtPrivate::SignalAwaiter<ArgsType<Signal>> nextSignal(Sender *sender, Signal signal)
+{
+    return QtPrivate::SignalAwaiter<ArgsType<Signal>>(sender, signal, sender);
+}
+
+} // namespace QtFuture
+
+#endif // __cpp_impl_coroutine
+
 Q_DECLARE_SEQUENTIAL_ITERATOR(Future)
 
 QT_END_NAMESPACE
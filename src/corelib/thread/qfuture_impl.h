@@ -69,6 +69,15 @@ namespace QtFuture {
 
 enum class Launch { Sync, Async, Inherit };
 
+class Q_CORE_EXPORT Executor
+{
+public:
+    virtual ~Executor();
+    virtual void execute(QRunnable *runnable) = 0;
+};
+
+Q_CORE_EXPORT Executor *inlineExecutor();
+
 template<class T>
 struct WhenAnyResult
 {
@@ -338,6 +347,10 @@ public:
     static void create(F &&func, QFuture<ParentResultType> *f, QFutureInterface<ResultType> &fi,
                        QObject *context);
 
+    template<typename F = Function>
+    static void create(F &&func, QFuture<ParentResultType> *f, QFutureInterface<ResultType> &fi,
+                       QtFuture::Executor *executor);
+
 private:
     void fulfillPromiseWithResult();
     void fulfillVoidPromise();
@@ -406,6 +419,37 @@ private:
     QThreadPool *threadPool;
 };
 
+template<typename Function, typename ResultType, typename ParentResultType>
+class ExecutorContinuation final : public QRunnable,
+                                   public Continuation<Function, ResultType, ParentResultType>
+{
+public:
+    template<typename F = Function>
+    ExecutorContinuation(F &&func, const QFuture<ParentResultType> &f, QPromise<ResultType> &&p,
+                         QtFuture::Executor *e)
+        : Continuation<Function, ResultType, ParentResultType>(std::forward<F>(func), f,
+                                                               std::move(p)),
+          executor(e)
+    {
+    }
+
+    ~ExecutorContinuation() override = default;
+
+private:
+    void runImpl() override // from Continuation
+    {
+        executor->execute(this);
+    }
+
+    void run() override // from QRunnable
+    {
+        this->runFunction();
+    }
+
+private:
+    QtFuture::Executor *executor;
+};
+
 #ifndef QT_NO_EXCEPTIONS
 
 template<class Function, class ResultType>
@@ -566,24 +610,20 @@ void Continuation<Function, ResultType, ParentResultType>::create(F &&func,
     auto continuation = [func = std::forward<F>(func), fi, promise = QPromise(fi), pool,
                          launchAsync](const QFutureInterfaceBase &parentData) mutable {
         const auto parent = QFutureInterface<ParentResultType>(parentData).future();
-        Continuation<Function, ResultType, ParentResultType> *continuationJob = nullptr;
         if (launchAsync) {
             auto asyncJob = new AsyncContinuation<Function, ResultType, ParentResultType>(
                     std::forward<Function>(func), parent, std::move(promise), pool);
             fi.setRunnable(asyncJob);
-            continuationJob = asyncJob;
+            // If continuation is successfully launched, AsyncContinuation will be deleted
+            // by the QThreadPool which has started it.
+            if (!asyncJob->execute())
+                delete asyncJob;
         } else {
-            continuationJob = new SyncContinuation<Function, ResultType, ParentResultType>(
+            // Synchronous continuation will be executed immediately, so it doesn't need
+            // to outlive this call. This saves an allocation per step of a chain.
+            SyncContinuation<Function, ResultType, ParentResultType> syncJob(
                     std::forward<Function>(func), parent, std::move(promise));
-        }
-
-        bool isLaunched = continuationJob->execute();
-        // If continuation is successfully launched, AsyncContinuation will be deleted
-        // by the QThreadPool which has started it. Synchronous continuation will be
-        // executed immediately, so it's safe to always delete it here.
-        if (!(launchAsync && isLaunched)) {
-            delete continuationJob;
-            continuationJob = nullptr;
+            syncJob.execute();
         }
     };
     f->d.setContinuation(ContinuationWrapper(std::move(continuation)), fi.d);
@@ -642,6 +682,28 @@ void Continuation<Function, ResultType, ParentResultType>::create(F &&func,
     f->d.setContinuation(ContinuationWrapper(std::move(continuation)), fi.d);
 }
 
+template<typename Function, typename ResultType, typename ParentResultType>
+template<typename F>
+void Continuation<Function, ResultType, ParentResultType>::create(F &&func,
+                                                                  QFuture<ParentResultType> *f,
+                                                                  QFutureInterface<ResultType> &fi,
+                                                                  QtFuture::Executor *executor)
+{
+    Q_ASSERT(f);
+    Q_ASSERT(executor);
+
+    auto continuation = [func = std::forward<F>(func), promise = QPromise(fi),
+                         executor](const QFutureInterfaceBase &parentData) mutable {
+        const auto parent = QFutureInterface<ParentResultType>(parentData).future();
+        auto continuationJob = new ExecutorContinuation<Function, ResultType, ParentResultType>(
+                std::forward<Function>(func), parent, std::move(promise), executor);
+        // If continuation is successfully launched, the executor owns it.
+        if (!continuationJob->execute())
+            delete continuationJob;
+    };
+    f->d.setContinuation(ContinuationWrapper(std::move(continuation)), fi.d);
+}
+
 template<typename Function, typename ResultType, typename ParentResultType>
 void Continuation<Function, ResultType, ParentResultType>::fulfillPromiseWithResult()
 {
@@ -41,7 +41,9 @@
 #include "qfuture.h"
 #include "qfutureinterface_p.h"
 
+#include <QtCore/qabstracteventdispatcher.h>
 #include <QtCore/qatomic.h>
+#include <QtCore/qpointer.h>
 #include <QtCore/qthread.h>
 #include <private/qthreadpool_p.h>
 
@@ -867,7 +869,14 @@ void QFutureInterfaceBase::cleanContinuation()
     // Clear the continuation, to make sure it doesn't keep any ref-counted
     // copies of this, so that the allocated memory can be freed.
     QMutexLocker lock(&d->continuationMutex);
-    d->continuation = nullptr;
+    auto fn = std::exchange(d->continuation, nullptr);
+
+    // A suspended coroutine must still be resumed, or it would never finish;
+    // it sees the future as canceled.
+    if (fn && d->continuationResumesCoroutine) {
+        lock.unlock();
+        fn(*this);
+    }
 }
 
 void QFutureInterfaceBase::runContinuation() const
@@ -880,6 +889,40 @@ void QFutureInterfaceBase::runContinuation() const
     }
 }
 
+/*!
+    \internal
+
+    Arranges for \a resume to be called with \a frame once the future has
+    finished. This is the type-erased half of \c{co_await} on a QFuture, and
+    takes the continuation slot, like setContinuation().
+
+    The call is posted to the event dispatcher of the thread that calls this
+    function, so that the coroutine resumes where it was suspended. If the
+    future finishes in that same thread, or the thread has no event dispatcher,
+    \a resume is called directly from the thread finishing the future.
+
+    Unlike other continuations, \a resume is also called if the QPromise is
+    destroyed without finishing the future; the coroutine then sees a canceled
+    future.
+*/
+void QFutureInterfaceBase::resumeWhenFinished(void (*resume)(void *), void *frame)
+{
+    QThread *thread = QThread::currentThread();
+    QPointer<QAbstractEventDispatcher> dispatcher = QAbstractEventDispatcher::instance(thread);
+    {
+        QMutexLocker lock(&d->continuationMutex);
+        d->continuationResumesCoroutine = true;
+    }
+    setContinuation([resume, frame, thread, dispatcher](const QFutureInterfaceBase &) {
+        if (!dispatcher || QThread::currentThread() == thread) {
+            resume(frame);
+            return;
+        }
+        QMetaObject::invokeMethod(
+                dispatcher.data(), [resume, frame] { resume(frame); }, Qt::QueuedConnection);
+    });
+}
+
 bool QFutureInterfaceBase::isChainCanceled() const
 {
     if (isCanceled())
@@ -908,4 +951,26 @@ bool QFutureInterfaceBase::launchAsync() const
     return d->launchAsync;
 }
 
+QtFuture::Executor::~Executor() = default;
+
+namespace {
+class InlineExecutor final : public QtFuture::Executor
+{
+public:
+    void execute(QRunnable *runnable) override
+    {
+        const bool autoDelete = runnable->autoDelete();
+        runnable->run();
+        if (autoDelete)
+            delete runnable;
+    }
+};
+} // unnamed namespace
+
+QtFuture::Executor *QtFuture::inlineExecutor()
+{
+    static InlineExecutor executor;
+    return &executor;
+}
+
 QT_END_NAMESPACE
@@ -74,6 +74,9 @@ class CanceledHandler;
 template<class Function, class ResultType>
 class FailureHandler;
 #endif
+
+template<class T>
+class FutureAwaiter;
 }
 
 class Q_CORE_EXPORT QFutureInterfaceBase
@@ -212,6 +215,9 @@ private:
     friend class QtPrivate::FailureHandler;
 #endif
 
+    template<class T>
+    friend class QtPrivate::FutureAwaiter;
+
     template<class T>
     friend class QPromise;
 
@@ -221,6 +227,7 @@ protected:
                          QFutureInterfaceBasePrivate *continuationFutureData);
     void cleanContinuation();
     void runContinuation() const;
+    void resumeWhenFinished(void (*resume)(void *), void *frame);
 
     void setLaunchAsync(bool value);
     bool launchAsync() const;
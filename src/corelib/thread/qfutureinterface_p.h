@@ -206,6 +206,7 @@ public:
 
     int m_expectedResultCount = 0;
     bool launchAsync = false;
+    bool continuationResumesCoroutine = false;
     bool isValid = false;
     bool hasException = false;
 
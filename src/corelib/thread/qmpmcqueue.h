@@ -0,0 +1,217 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QMPMCQUEUE_H
+#define QMPMCQUEUE_H
+
+#include <QtCore/qboundedqueue_impl.h>
+#include <QtCore/qmath.h>
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+QT_REQUIRE_CONFIG(thread);
+
+QT_BEGIN_NAMESPACE
+
+template <typename T>
+class QMpmcQueue
+{
+    static_assert(std::is_nothrow_move_constructible_v<T>, "QMpmcQueue requires a type with a non-throwing move constructor");
+    static_assert(std::is_nothrow_destructible_v<T>, "Types with throwing destructors are not supported in Qt containers.");
+
+    // A position is made of the index of a slot in its low bits, and of a
+    // lap counter above them, which keeps increasing as the positions wrap
+    // around the buffer. A slot's stamp tells what it waits for: the stamp
+    // is equal to the position at which it can be written, and to that
+    // position plus one once it holds an element that can be read.
+    struct Slot
+    {
+        QAtomicInteger<quintptr> stamp;
+        alignas(T) unsigned char storage[sizeof(T)];
+        T *value() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    struct alignas(QtPrivate::BoundedQueueAlignment) Position
+    {
+        QAtomicInteger<quintptr> value;
+    };
+
+    const quintptr slotCount;
+    const quintptr oneLap;
+    const std::unique_ptr<Slot[]> buffer;
+    Position enqueuePosition;
+    Position dequeuePosition;
+    alignas(QtPrivate::BoundedQueueAlignment) QtPrivate::BoundedQueueWaiter notEmpty;
+    alignas(QtPrivate::BoundedQueueAlignment) QtPrivate::BoundedQueueWaiter notFull;
+
+public:
+    using value_type = T;
+    using size_type = qsizetype;
+
+    explicit QMpmcQueue(qsizetype capacity)
+        : slotCount(quintptr(qMax(capacity, qsizetype(1)))),
+          oneLap(quintptr(qNextPowerOfTwo(quint64(slotCount)))),
+          buffer(new Slot[slotCount])
+    {
+        Q_ASSERT(capacity > 0);
+        for (quintptr i = 0; i < slotCount; ++i)
+            buffer[i].stamp.storeRelaxed(i);
+    }
+    Q_DISABLE_COPY_MOVE(QMpmcQueue)
+    ~QMpmcQueue()
+    {
+        const quintptr end = enqueuePosition.value.loadRelaxed();
+        for (quintptr position = dequeuePosition.value.loadRelaxed(); position != end; position = next(position))
+            buffer[position & (oneLap - 1)].value()->~T();
+    }
+
+    qsizetype capacity() const noexcept { return qsizetype(slotCount); }
+    qsizetype size() const noexcept
+    {
+        for (;;) {
+            const quintptr end = enqueuePosition.value.loadAcquire();
+            const quintptr begin = dequeuePosition.value.loadAcquire();
+            // retry until both positions belong to the same moment
+            if (enqueuePosition.value.loadAcquire() != end)
+                continue;
+            const quintptr first = begin & (oneLap - 1);
+            const quintptr last = end & (oneLap - 1);
+            if (first < last)
+                return qsizetype(last - first);
+            if (first > last)
+                return qsizetype(slotCount - first + last);
+            return begin == end ? 0 : qsizetype(slotCount);
+        }
+    }
+    bool isEmpty() const noexcept { return size() == 0; }
+
+    bool tryEnqueue(const T &value) { return tryEnqueue(T(value)); }
+    bool tryEnqueue(T &&value)
+    {
+        quintptr position = enqueuePosition.value.loadRelaxed();
+        for (;;) {
+            Slot &slot = buffer[position & (oneLap - 1)];
+            const quintptr stamp = slot.stamp.loadAcquire();
+            if (stamp == position) {
+                if (enqueuePosition.value.testAndSetOrdered(position, next(position), position)) {
+                    new (slot.storage) T(std::move(value));
+                    slot.stamp.storeRelease(position + 1);
+                    notEmpty.notify();
+                    return true;
+                }
+            } else if (stamp + oneLap == position + 1) {
+                // the slot still holds the element of the previous lap
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (dequeuePosition.value.loadRelaxed() + oneLap == position)
+                    return false;
+                // a consumer is reading it
+                QtPrivate::boundedQueuePause();
+                position = enqueuePosition.value.loadRelaxed();
+            } else {
+                // another producer took the position
+                position = enqueuePosition.value.loadRelaxed();
+            }
+        }
+    }
+    template <typename ...Args>
+    bool tryEmplace(Args &&... args) { return tryEnqueue(T(std::forward<Args>(args)...)); }
+    bool tryEnqueue(const T &value, QDeadlineTimer deadline) { return tryEnqueue(T(value), deadline); }
+    bool tryEnqueue(T &&value, QDeadlineTimer deadline)
+    {
+        // value is only moved from by the call that succeeds
+        return notFull.waitFor([&] { return tryEnqueue(std::move(value)); }, deadline);
+    }
+    void enqueue(const T &value) { tryEnqueue(T(value), QDeadlineTimer::Forever); }
+    void enqueue(T &&value) { tryEnqueue(std::move(value), QDeadlineTimer::Forever); }
+
+    std::optional<T> tryDequeue()
+    {
+        quintptr position = dequeuePosition.value.loadRelaxed();
+        for (;;) {
+            Slot &slot = buffer[position & (oneLap - 1)];
+            const quintptr stamp = slot.stamp.loadAcquire();
+            if (stamp == position + 1) {
+                if (dequeuePosition.value.testAndSetOrdered(position, next(position), position)) {
+                    T *value = slot.value();
+                    std::optional<T> result(std::move(*value));
+                    value->~T();
+                    slot.stamp.storeRelease(position + oneLap);
+                    notFull.notify();
+                    return result;
+                }
+            } else if (stamp == position) {
+                // nothing was written at this position yet
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (enqueuePosition.value.loadRelaxed() == position)
+                    return std::nullopt;
+                // a producer is writing it
+                QtPrivate::boundedQueuePause();
+                position = dequeuePosition.value.loadRelaxed();
+            } else {
+                // another consumer took the position
+                position = dequeuePosition.value.loadRelaxed();
+            }
+        }
+    }
+    std::optional<T> tryDequeue(QDeadlineTimer deadline)
+    {
+        std::optional<T> result;
+        notEmpty.waitFor([&] { return (result = tryDequeue()).has_value(); }, deadline);
+        return result;
+    }
+    T dequeue() { return *tryDequeue(QDeadlineTimer::Forever); }
+
+private:
+    quintptr next(quintptr position) const noexcept
+    {
+        // past the last slot, the next lap starts over at index 0
+        if ((position & (oneLap - 1)) + 1 < slotCount)
+            return position + 1;
+        return (position & ~(oneLap - 1)) + oneLap;
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QMPMCQUEUE_H
@@ -142,6 +142,7 @@ private:
 
     friend class QMutex;
     friend class QMutexPrivate;
+    friend class QWaitConditionPrivate;
 };
 
 class Q_CORE_EXPORT QMutex : public QBasicMutex
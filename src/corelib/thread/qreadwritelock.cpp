@@ -120,7 +120,7 @@ inline bool isUncontendedLocked(const QReadWriteLockPrivate *d)
     to lock for reading in a thread that already has locked for
     writing (and vice versa).
 
-    \sa QReadLocker, QWriteLocker, QMutex, QSemaphore
+    \sa QReadLocker, QWriteLocker, QMutex, QSemaphore, QShardedReadWriteLock
 */
 
 /*!
@@ -0,0 +1,462 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qshardedreadwritelock.h"
+
+#include "qdeadlinetimer.h"
+#include "qmath.h"
+#include "qthread.h"
+#include "private/qlocking_p.h"
+#include "private/qwaitcondition_p.h"
+
+#include <atomic>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*
+ * Implementation details of QShardedReadWriteLock:
+ *
+ * Every reader increments the counter of its slot and then checks state;
+ * every writer publishes its state and then sums up the counters. Both sides
+ * use sequentially consistent operations, so at least one of them sees the
+ * other. A reader that finds a writer in its way takes its increment back
+ * and continues in lockForReadSlow(), where it waits on readerCond.
+ *
+ * Only the sum of all counters is meaningful: a read lock may be released
+ * from another thread than the one that acquired it, in which case one slot
+ * goes up and another one goes down. The slot only decides which cache line
+ * a thread writes to.
+ *
+ * All changes of state happen with mutex locked, so readers and writers on
+ * their slow paths can wait for each other on the condition variables.
+ */
+
+namespace {
+std::atomic<quint32> nextSlotHint = { 0 };
+// assigned round-robin, so that the first slotCount() threads that take a
+// read lock all get a slot of their own
+thread_local const quint32 slotHint = nextSlotHint.fetch_add(1, std::memory_order_relaxed);
+
+quint32 slotMaskFor(int slotCount)
+{
+    enum { MaxSlots = 64 };
+    if (slotCount <= 0)
+        slotCount = QThread::idealThreadCount();
+    return qNextPowerOfTwo(quint32(qBound(1, slotCount, int(MaxSlots)) - 1)) - 1;
+}
+
+template <typename Condition, typename Lock>
+void waitUntil(Condition &cond, Lock &lock, const QDeadlineTimer &deadline)
+{
+    if (deadline.isForever())
+        cond.wait(lock);
+    else
+        cond.wait_for(lock, deadline.remainingTimeAsDuration());
+}
+
+QDeadlineTimer deadlineFor(int timeout)
+{
+    return timeout < 0 ? QDeadlineTimer(QDeadlineTimer::Forever) : QDeadlineTimer(timeout);
+}
+} // unnamed namespace
+
+class QShardedReadWriteLockPrivate
+{
+public:
+    using Policy = QShardedReadWriteLock::Policy;
+
+    // WriterClaiming is only used with the ReaderBiased policy, where readers
+    // may still arrive while a writer is pending: the writer checks the
+    // counters once more after it stopped new readers from entering.
+    enum State { NoWriter, WriterPending, WriterClaiming, WriterActive };
+    struct alignas(64) Slot
+    {
+        std::atomic<int> readers = { 0 };
+    };
+
+    QShardedReadWriteLockPrivate(Policy p, int slotCount)
+        : readerSlots(new Slot[slotMaskFor(slotCount) + 1]),
+          slotMask(slotMaskFor(slotCount)),
+          policy(p)
+    {
+    }
+
+    Slot &currentSlot() const noexcept { return readerSlots[slotHint & slotMask]; }
+    bool readerMayEnter(int s) const noexcept
+    {
+        return s == NoWriter || (s == WriterPending && policy == QShardedReadWriteLock::ReaderBiased);
+    }
+
+    bool tryLockForReadFast() noexcept;
+    bool lockForReadSlow(int timeout);
+    bool lockForWrite(int timeout);
+    void unlockRead();
+    void unlockWrite();
+    bool readersDrained() const noexcept;
+
+    const std::unique_ptr<Slot[]> readerSlots;
+    const quint32 slotMask;
+    const Policy policy;
+    std::atomic<int> state = { NoWriter };
+
+    QtPrivate::mutex mutex;
+    QtPrivate::condition_variable readerCond;
+    QtPrivate::condition_variable writerCond;
+    QtPrivate::condition_variable drainCond;
+};
+
+bool QShardedReadWriteLockPrivate::readersDrained() const noexcept
+{
+    int readers = 0;
+    for (quint32 i = 0; i <= slotMask; ++i)
+        readers += readerSlots[i].readers.load(std::memory_order_seq_cst);
+    Q_ASSERT(readers >= 0);
+    return readers == 0;
+}
+
+bool QShardedReadWriteLockPrivate::tryLockForReadFast() noexcept
+{
+    currentSlot().readers.fetch_add(1, std::memory_order_seq_cst);
+    if (Q_LIKELY(readerMayEnter(state.load(std::memory_order_seq_cst))))
+        return true;
+    unlockRead();
+    return false;
+}
+
+bool QShardedReadWriteLockPrivate::lockForReadSlow(int timeout)
+{
+    const QDeadlineTimer deadline = deadlineFor(timeout);
+    auto lock = qt_unique_lock(mutex);
+    while (true) {
+        if (readerMayEnter(state.load(std::memory_order_relaxed))) {
+            // the writer can't change state before we unlock the mutex
+            currentSlot().readers.fetch_add(1, std::memory_order_seq_cst);
+            return true;
+        }
+        if (deadline.hasExpired())
+            return false;
+        waitUntil(readerCond, lock, deadline);
+    }
+}
+
+bool QShardedReadWriteLockPrivate::lockForWrite(int timeout)
+{
+    const QDeadlineTimer deadline = deadlineFor(timeout);
+    auto lock = qt_unique_lock(mutex);
+    while (state.load(std::memory_order_relaxed) != NoWriter) {
+        if (deadline.hasExpired())
+            return false;
+        waitUntil(writerCond, lock, deadline);
+    }
+
+    state.store(WriterPending, std::memory_order_seq_cst);
+    while (true) {
+        if (readersDrained()) {
+            if (policy == QShardedReadWriteLock::WriterPreferring)
+                break;
+            // readers were still allowed in until now; stop them and look again
+            state.store(WriterClaiming, std::memory_order_seq_cst);
+            if (readersDrained())
+                break;
+            state.store(WriterPending, std::memory_order_seq_cst);
+            readerCond.notify_all();
+        }
+        if (deadline.hasExpired()) {
+            state.store(NoWriter, std::memory_order_seq_cst);
+            readerCond.notify_all();
+            writerCond.notify_one();
+            return false;
+        }
+        waitUntil(drainCond, lock, deadline);
+    }
+    state.store(WriterActive, std::memory_order_seq_cst);
+    return true;
+}
+
+void QShardedReadWriteLockPrivate::unlockRead()
+{
+    currentSlot().readers.fetch_sub(1, std::memory_order_seq_cst);
+    if (Q_UNLIKELY(state.load(std::memory_order_seq_cst) != NoWriter)) {
+        // a writer may be waiting for the readers to drain
+        const auto lock = qt_scoped_lock(mutex);
+        drainCond.notify_one();
+    }
+}
+
+void QShardedReadWriteLockPrivate::unlockWrite()
+{
+    const auto lock = qt_scoped_lock(mutex);
+    Q_ASSERT(state.load(std::memory_order_relaxed) == WriterActive);
+    state.store(NoWriter, std::memory_order_seq_cst);
+    readerCond.notify_all();
+    writerCond.notify_one();
+}
+
+/*!
+    \class QShardedReadWriteLock
+    \inmodule QtCore
+    \since 6.4
+    \brief The QShardedReadWriteLock class provides a read-write lock whose
+    read side scales with the number of threads.
+
+    \threadsafe
+
+    \ingroup thread
+
+    Like QReadWriteLock, QShardedReadWriteLock lets many threads read
+    shared data at the same time, while a thread that writes to the data
+    has exclusive access. It is meant for data that many threads read
+    concurrently and that is seldom written, such as a cache or a
+    configuration that a pool of worker threads looks things up in.
+
+    \snippet code/src_corelib_thread_qshardedreadwritelock.cpp 0
+
+    QReadWriteLock counts its readers in a single atomic variable, so
+    threads that only take read locks still all write to the same cache
+    line, and slow each other down on machines with many cores.
+    QShardedReadWriteLock spreads its readers over slotCount() counters
+    instead, each in a cache line of its own, and assigns one of them to
+    every thread. Taking and releasing a read lock only touches that
+    thread's counter, as long as no writer is around. In exchange, a writer
+    has to wait until the counters of all slots have drained, and each lock
+    uses more memory: a cache line for every slot.
+
+    The policy() decides what happens to new readers while a writer waits
+    for the lock. With WriterPreferring, the default, they wait until the
+    writer is done, so that writers are never starved. With ReaderBiased,
+    they still get the lock until the writer actually holds it, which gives
+    the best read throughput, but a steady stream of readers can delay a
+    writer indefinitely.
+
+    The lock is not recursive. With the WriterPreferring policy, taking a
+    second read lock in a thread that already holds one can deadlock if a
+    writer started waiting in between, as with a non-recursive
+    QReadWriteLock.
+
+    QShardedReadWriteLock can be used with std::unique_lock for writing and
+    std::shared_lock for reading.
+
+    \sa QReadWriteLock
+*/
+
+/*!
+    \enum QShardedReadWriteLock::Policy
+
+    This enum describes how readers and writers that wait for the lock are
+    served.
+
+    \value WriterPreferring New readers wait as soon as a writer is waiting
+           for the lock, so that writers are never starved.
+    \value ReaderBiased New readers only wait while a writer holds the lock.
+           This gives the best read throughput, but a steady stream of
+           readers can delay a writer indefinitely.
+*/
+
+/*!
+    Constructs a lock with the given \a policy, spreading readers over
+    \a slotCount counters. The count is rounded up to a power of two and
+    limited to 64; if it is 0 or less, QThread::idealThreadCount() is used.
+
+    \sa slotCount()
+*/
+QShardedReadWriteLock::QShardedReadWriteLock(Policy policy, int slotCount)
+    : d(new QShardedReadWriteLockPrivate(policy, slotCount))
+{
+}
+
+/*!
+    Destroys the lock. It must not be locked.
+*/
+QShardedReadWriteLock::~QShardedReadWriteLock()
+{
+    Q_ASSERT(d->state.load(std::memory_order_relaxed) == QShardedReadWriteLockPrivate::NoWriter);
+    Q_ASSERT(d->readersDrained());
+    delete d;
+}
+
+/*!
+    Returns the policy with which the lock was constructed.
+*/
+QShardedReadWriteLock::Policy QShardedReadWriteLock::policy() const noexcept
+{
+    return d->policy;
+}
+
+/*!
+    Returns the number of counters over which the lock spreads its readers.
+*/
+int QShardedReadWriteLock::slotCount() const noexcept
+{
+    return int(d->slotMask + 1);
+}
+
+/*!
+    Locks the lock for reading. Many threads can hold read locks at the same
+    time; this blocks while a writer holds the lock, and also while one is
+    waiting for it if the policy is WriterPreferring.
+
+    \sa unlock(), lockForWrite(), tryLockForRead()
+*/
+void QShardedReadWriteLock::lockForRead()
+{
+    if (Q_UNLIKELY(!d->tryLockForReadFast()))
+        d->lockForReadSlow(-1);
+}
+
+/*!
+    \overload
+
+    Attempts to lock for reading without blocking. Returns \c true if the
+    lock was obtained.
+*/
+bool QShardedReadWriteLock::tryLockForRead()
+{
+    return tryLockForRead(0);
+}
+
+/*!
+    Attempts to lock for reading, waiting at most \a timeout milliseconds
+    (forever if \a timeout is negative). Returns \c true if the lock was
+    obtained.
+
+    \sa unlock(), lockForRead()
+*/
+bool QShardedReadWriteLock::tryLockForRead(int timeout)
+{
+    return Q_LIKELY(d->tryLockForReadFast()) || d->lockForReadSlow(timeout);
+}
+
+/*!
+    Locks the lock for writing, blocking until all readers and any other
+    writer have released it.
+
+    \sa unlock(), lockForRead(), tryLockForWrite()
+*/
+void QShardedReadWriteLock::lockForWrite()
+{
+    d->lockForWrite(-1);
+}
+
+/*!
+    \overload
+
+    Attempts to lock for writing without blocking. Returns \c true if the
+    lock was obtained.
+*/
+bool QShardedReadWriteLock::tryLockForWrite()
+{
+    return tryLockForWrite(0);
+}
+
+/*!
+    Attempts to lock for writing, waiting at most \a timeout milliseconds
+    (forever if \a timeout is negative). Returns \c true if the lock was
+    obtained.
+
+    \sa unlock(), lockForWrite()
+*/
+bool QShardedReadWriteLock::tryLockForWrite(int timeout)
+{
+    return d->lockForWrite(timeout);
+}
+
+/*!
+    Releases the lock, which the caller must have locked for reading or
+    writing.
+
+    \sa lockForRead(), lockForWrite()
+*/
+void QShardedReadWriteLock::unlock()
+{
+    // while a writer holds the lock, there are no readers that could unlock
+    if (d->state.load(std::memory_order_relaxed) == QShardedReadWriteLockPrivate::WriterActive)
+        d->unlockWrite();
+    else
+        d->unlockRead();
+}
+
+/*!
+    \fn void QShardedReadWriteLock::lock()
+
+    Locks the lock for writing. This function is provided for
+    compatibility with std::unique_lock.
+
+    \sa lockForWrite()
+*/
+
+/*!
+    \fn bool QShardedReadWriteLock::try_lock()
+
+    Attempts to lock for writing without blocking, and returns \c true if
+    the lock was obtained. This function is provided for compatibility with
+    std::unique_lock.
+
+    \sa tryLockForWrite()
+*/
+
+/*!
+    \fn void QShardedReadWriteLock::lock_shared()
+
+    Locks the lock for reading. This function is provided for
+    compatibility with std::shared_lock.
+
+    \sa lockForRead()
+*/
+
+/*!
+    \fn bool QShardedReadWriteLock::try_lock_shared()
+
+    Attempts to lock for reading without blocking, and returns \c true if
+    the lock was obtained. This function is provided for compatibility with
+    std::shared_lock.
+
+    \sa tryLockForRead()
+*/
+
+/*!
+    \fn void QShardedReadWriteLock::unlock_shared()
+
+    Releases a read lock. This function is provided for compatibility with
+    std::shared_lock.
+
+    \sa unlock()
+*/
+
+QT_END_NAMESPACE
@@ -0,0 +1,174 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSPSCQUEUE_H
+#define QSPSCQUEUE_H
+
+#include <QtCore/qboundedqueue_impl.h>
+
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+QT_REQUIRE_CONFIG(thread);
+
+QT_BEGIN_NAMESPACE
+
+template <typename T>
+class QSpscQueue
+{
+    static_assert(std::is_nothrow_move_constructible_v<T>, "QSpscQueue requires a type with a non-throwing move constructor");
+    static_assert(std::is_nothrow_destructible_v<T>, "Types with throwing destructors are not supported in Qt containers.");
+
+    struct Slot
+    {
+        alignas(T) unsigned char storage[sizeof(T)];
+        T *value() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    // Each side owns its index, and keeps the last index of the other side
+    // that it has read, so that it only reads the other side's cache line
+    // when the queue looks full, or empty.
+    struct alignas(QtPrivate::BoundedQueueAlignment) Side
+    {
+        QAtomicInteger<quintptr> index;
+        quintptr otherIndex = 0;
+    };
+
+    // one slot stays empty, to tell a full queue from an empty one
+    const quintptr slotCount;
+    const std::unique_ptr<Slot[]> buffer;
+    Side producer;
+    Side consumer;
+    alignas(QtPrivate::BoundedQueueAlignment) QtPrivate::BoundedQueueWaiter notEmpty;
+    alignas(QtPrivate::BoundedQueueAlignment) QtPrivate::BoundedQueueWaiter notFull;
+
+public:
+    using value_type = T;
+    using size_type = qsizetype;
+
+    explicit QSpscQueue(qsizetype capacity)
+        : slotCount(quintptr(qMax(capacity, qsizetype(1))) + 1),
+          buffer(new Slot[slotCount])
+    {
+        Q_ASSERT(capacity > 0);
+    }
+    Q_DISABLE_COPY_MOVE(QSpscQueue)
+    ~QSpscQueue()
+    {
+        const quintptr end = producer.index.loadRelaxed();
+        for (quintptr i = consumer.index.loadRelaxed(); i != end; i = next(i))
+            buffer[i].value()->~T();
+    }
+
+    qsizetype capacity() const noexcept { return qsizetype(slotCount - 1); }
+    qsizetype size() const noexcept
+    {
+        const quintptr read = consumer.index.loadAcquire();
+        const quintptr write = producer.index.loadAcquire();
+        return qsizetype(write >= read ? write - read : slotCount - read + write);
+    }
+    bool isEmpty() const noexcept { return size() == 0; }
+
+    // called by the producer thread only
+    bool tryEnqueue(const T &value) { return tryEmplace(value); }
+    bool tryEnqueue(T &&value) { return tryEmplace(std::move(value)); }
+    template <typename ...Args>
+    bool tryEmplace(Args &&... args)
+    {
+        const quintptr write = producer.index.loadRelaxed();
+        const quintptr nextWrite = next(write);
+        if (nextWrite == producer.otherIndex) {
+            producer.otherIndex = consumer.index.loadAcquire();
+            if (nextWrite == producer.otherIndex)
+                return false;
+        }
+        new (buffer[write].storage) T(std::forward<Args>(args)...);
+        producer.index.storeRelease(nextWrite);
+        notEmpty.notify();
+        return true;
+    }
+    bool tryEnqueue(const T &value, QDeadlineTimer deadline)
+    {
+        return notFull.waitFor([&] { return tryEmplace(value); }, deadline);
+    }
+    bool tryEnqueue(T &&value, QDeadlineTimer deadline)
+    {
+        // value is only moved from by the call that succeeds
+        return notFull.waitFor([&] { return tryEmplace(std::move(value)); }, deadline);
+    }
+    void enqueue(const T &value) { tryEnqueue(value, QDeadlineTimer::Forever); }
+    void enqueue(T &&value) { tryEnqueue(std::move(value), QDeadlineTimer::Forever); }
+
+    // called by the consumer thread only
+    std::optional<T> tryDequeue()
+    {
+        const quintptr read = consumer.index.loadRelaxed();
+        if (read == consumer.otherIndex) {
+            consumer.otherIndex = producer.index.loadAcquire();
+            if (read == consumer.otherIndex)
+                return std::nullopt;
+        }
+        T *value = buffer[read].value();
+        std::optional<T> result(std::move(*value));
+        value->~T();
+        consumer.index.storeRelease(next(read));
+        notFull.notify();
+        return result;
+    }
+    std::optional<T> tryDequeue(QDeadlineTimer deadline)
+    {
+        std::optional<T> result;
+        notEmpty.waitFor([&] { return (result = tryDequeue()).has_value(); }, deadline);
+        return result;
+    }
+    T dequeue() { return *tryDequeue(QDeadlineTimer::Forever); }
+
+private:
+    quintptr next(quintptr index) const noexcept
+    {
+        return index + 1 == slotCount ? 0 : index + 1;
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QSPSCQUEUE_H
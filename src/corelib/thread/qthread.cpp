@@ -94,12 +94,13 @@ QThreadData::~QThreadData()
     thread.storeRelease(nullptr);
     delete t;
 
+    flushMetaCallQueue();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
             --pe.receiver->d_func()->postedEvents;
             pe.event->m_posted = false;
-            delete pe.event;
+            QEventPool::deleteEvent(pe.event);
         }
     }
 
@@ -122,6 +123,62 @@ void QThreadData::deref()
 #endif
 }
 
+/*!
+    \internal
+
+    Returns the pending event that a new event of \a type for \a receiver
+    would replace, or \nullptr if there is none. The caller must hold the
+    mutex. The position stored in the index is checked first; if an insertion
+    or removal moved the event, the list is searched and the hint updated, so
+    the common case of a consumer that is flooded by one producer stays
+    constant-time.
+*/
+QPostEvent *QPostEventList::findCompressible(QObject *receiver, int type)
+{
+    auto it = compressionIndex.find({ receiver, type });
+    if (it == compressionIndex.end())
+        return nullptr;
+
+    const auto matches = [&](const QPostEvent &pe) {
+        return pe.event == it->event && pe.receiver == receiver;
+    };
+    const qsizetype hint = it->position - erasedCount;
+    if (hint >= startOffset && hint < size() && matches(at(hint)))
+        return data() + hint;
+
+    for (qsizetype i = startOffset; i < size(); ++i) {
+        if (matches(at(i))) {
+            it->position = i + erasedCount;
+            return data() + i;
+        }
+    }
+    // the event is gone without having been unindexed; don't keep a
+    // dangling pointer around
+    compressionIndex.erase(it);
+    return nullptr;
+}
+
+/*!
+    \internal
+
+    Moves the events pushed to metaCallQueue into postEventList. The caller
+    must hold postEventList.mutex.
+
+    An event whose receiver has meanwhile been moved to another thread is
+    added to that thread's list instead. This only happens while
+    QObject::moveToThread() holds the mutexes of both threads.
+*/
+void QThreadData::flushMetaCallQueue()
+{
+    metaCallQueue.takeAll([this](QObject *receiver, QMetaCallEvent *event) {
+        QThreadData *data = QObjectPrivate::get(receiver)->threadData.loadRelaxed();
+        if (!data)
+            data = this;
+        data->postEventList.addEvent(QPostEvent(receiver, event, Qt::NormalEventPriority));
+        data->canWait = false;
+    });
+}
+
 QAbstractEventDispatcher *QThreadData::createEventDispatcher()
 {
     QAbstractEventDispatcher *ed = QThreadPrivate::createEventDispatcher(this);
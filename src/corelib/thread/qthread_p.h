@@ -60,12 +60,14 @@
 #if QT_CONFIG(thread)
 #include "QtCore/qwaitcondition.h"
 #endif
+#include "QtCore/qhash.h"
 #include "QtCore/qmap.h"
 #include "QtCore/qcoreapplication.h"
 #include "private/qobject_p.h"
 
 #include <algorithm>
 #include <atomic>
+#include <utility>
 
 QT_BEGIN_NAMESPACE
 
@@ -107,9 +109,25 @@ public:
 
     QMutex mutex;
 
+    // Index of the pending events whose type has compression enabled (see
+    // QCoreApplication::setEventCompressionEnabled()), by receiver and type.
+    // Positions count from the first event ever added to the list, see
+    // erasedCount; they are only hints, which go stale when events are
+    // inserted by priority or removed from the middle of the list.
+    struct CompressionEntry
+    {
+        QEvent *event;
+        qsizetype position;
+    };
+    using CompressionKey = std::pair<QObject *, int>;
+    QHash<CompressionKey, CompressionEntry> compressionIndex;
+    // number of events erased from the front of the list
+    qsizetype erasedCount = 0;
+
     inline QPostEventList() : QList<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0) { }
 
-    void addEvent(const QPostEvent &ev)
+    // returns the position of the added event
+    qsizetype addEvent(const QPostEvent &ev)
     {
         int priority = ev.priority;
         if (isEmpty() ||
@@ -118,21 +136,132 @@ public:
             // optimization: we can simply append if the last event in
             // the queue has higher or equal priority
             append(ev);
+            return size() - 1;
         } else {
             // insert event in descending priority order, using upper
             // bound for a given priority (to ensure proper ordering
             // of events with the same priority)
             QPostEventList::iterator at = std::upper_bound(begin() + insertionOffset, end(), ev);
-            insert(at, ev);
+            at = insert(at, ev);
+            return at - begin();
         }
     }
 
+    QPostEvent *findCompressible(QObject *receiver, int type);
+    void indexCompressible(qsizetype position)
+    {
+        const QPostEvent &pe = at(position);
+        compressionIndex.insert({ pe.receiver, pe.event->type() },
+                                { pe.event, position + erasedCount });
+    }
+    void unindexCompressible(QObject *receiver, QEvent *event)
+    {
+        if (compressionIndex.isEmpty())
+            return;
+        auto it = compressionIndex.find({ receiver, event->type() });
+        if (it != compressionIndex.end() && it->event == event)
+            compressionIndex.erase(it);
+    }
+
 private:
     //hides because they do not keep that list sorted. addEvent must be used
     using QList<QPostEvent>::append;
     using QList<QPostEvent>::insert;
 };
 
+// Lock-free multi-producer queue for the QMetaCallEvents of queued
+// connections. Emitting threads push without taking the post event list
+// mutex; whoever holds that mutex moves the whole batch into the post event
+// list in one go (see QThreadData::flushMetaCallQueue()).
+class QMetaCallEventQueue
+{
+public:
+    struct Statistics
+    {
+        quint64 events = 0;
+        quint64 batches = 0;
+        quint64 wakeUps = 0;
+    };
+
+    // Producers bracket their push with beginPush() and endPush(), so that
+    // QObject::moveToThread() can wait for pushes to a thread the receiver
+    // is leaving before it moves the receiver's pending events.
+    void beginPush() noexcept
+    {
+        pushing.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    void endPush() noexcept { pushing.fetch_sub(1, std::memory_order_release); }
+    void waitForPushes() const noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (pushing.load(std::memory_order_acquire))
+            QThread::yieldCurrentThread();
+    }
+
+    // Returns true if the queue was empty, i.e. the consumer must be woken up.
+    bool push(QObject *receiver, QMetaCallEvent *event) noexcept
+    {
+        event->queuedReceiver_ = receiver;
+        QMetaCallEvent *first = head.load(std::memory_order_relaxed);
+        do {
+            event->nextQueued_ = first;
+        } while (!head.compare_exchange_weak(first, event, std::memory_order_release,
+                                             std::memory_order_relaxed));
+        return first == nullptr;
+    }
+
+    bool isEmpty() const noexcept { return head.load(std::memory_order_acquire) == nullptr; }
+
+    // Calls f(receiver, event) for every queued event, in the order they were pushed.
+    template <typename Function>
+    void takeAll(Function f)
+    {
+        QMetaCallEvent *event = head.exchange(nullptr, std::memory_order_acquire);
+        if (!event)
+            return;
+
+        // the queue is a stack, reverse it
+        QMetaCallEvent *first = nullptr;
+        quint64 count = 0;
+        while (event) {
+            QMetaCallEvent *next = event->nextQueued_;
+            event->nextQueued_ = first;
+            first = event;
+            event = next;
+            ++count;
+        }
+        events.store(events.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        batches.store(batches.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        while (first) {
+            QMetaCallEvent *next = first->nextQueued_;
+            first->nextQueued_ = nullptr;
+            f(std::exchange(first->queuedReceiver_, nullptr), first);
+            first = next;
+        }
+    }
+
+    void countWakeUp() noexcept { wakeUps.fetch_add(1, std::memory_order_relaxed); }
+
+    Statistics statistics() const noexcept
+    {
+        Statistics stats;
+        stats.events = events.load(std::memory_order_relaxed);
+        stats.batches = batches.load(std::memory_order_relaxed);
+        stats.wakeUps = wakeUps.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    std::atomic<QMetaCallEvent *> head = nullptr;
+    std::atomic<int> pushing = 0;
+    // events and batches are only written with the post event list mutex held
+    std::atomic<quint64> events = 0;
+    std::atomic<quint64> batches = 0;
+    std::atomic<quint64> wakeUps = 0;
+};
+
 #if QT_CONFIG(thread)
 
 class Q_CORE_EXPORT QDaemonThread : public QThread
@@ -294,9 +423,11 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && metaCallQueue.isEmpty();
     }
 
+    void flushMetaCallQueue();
+
     // This class provides per-thread (by way of being a QThreadData
     // member) storage for qFlagLocation()
     class FlaggedDebugSignatures
@@ -326,6 +457,7 @@ public:
 
     QStack<QEventLoop *> eventLoops;
     QPostEventList postEventList;
+    QMetaCallEventQueue metaCallQueue;
     QAtomicPointer<QThread> thread;
     QAtomicPointer<void> threadId;
     QAtomicPointer<QAbstractEventDispatcher> eventDispatcher;
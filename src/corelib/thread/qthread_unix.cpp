@@ -56,6 +56,9 @@
 #endif
 
 #include <private/qeventdispatcher_unix_p.h>
+#if defined(Q_OS_LINUX)
+#  include <private/qeventdispatcher_epoll_p.h>
+#endif
 
 #include "qthreadstorage.h"
 
@@ -256,15 +259,22 @@ QAbstractEventDispatcher *QThreadPrivate::createEventDispatcher(QThreadData *dat
         return new QEventDispatcherUNIX;
 #elif defined(Q_OS_WASM)
     return new QEventDispatcherWasm();
-#elif !defined(QT_NO_GLIB)
+#else
+#  if defined(Q_OS_LINUX)
+    if (qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") > 0
+        && QEventDispatcherEpoll::isSupported()) {
+        const bool useTimerFd = qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL_TIMERFD") > 0;
+        return new QEventDispatcherEpoll(useTimerFd ? QEventDispatcherEpoll::TimerFd
+                                                    : QEventDispatcherEpoll::PollTimeout);
+    }
+#  endif
+#  if !defined(QT_NO_GLIB)
     const bool isQtMainThread = data->thread.loadAcquire() == QCoreApplicationPrivate::mainThread();
     if (qEnvironmentVariableIsEmpty("QT_NO_GLIB")
         && (isQtMainThread || qEnvironmentVariableIsEmpty("QT_NO_THREADED_GLIB"))
         && QEventDispatcherGlib::versionSupported())
         return new QEventDispatcherGlib;
-    else
-        return new QEventDispatcherUNIX;
-#else
+#  endif
     return new QEventDispatcherUNIX;
 #endif
 }
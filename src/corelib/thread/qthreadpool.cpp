@@ -63,8 +63,13 @@ public:
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+    int homeQueue;
+    // where in the other worker queues to look for work next
+    uint nextVictim = 0;
 };
 
+Q_CONSTINIT static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+
 /*
     QThreadPool private class.
 */
@@ -74,7 +79,7 @@ public:
     \internal
 */
 QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
-    :manager(manager), runnable(nullptr)
+    :manager(manager), runnable(nullptr), homeQueue(manager->nextHomeQueue++)
 {
     setStackSize(manager->stackSize);
 }
@@ -84,6 +89,8 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    currentPoolThread = this;
+
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -91,27 +98,34 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                // If autoDelete() is false, r might already be deleted after run(), so check status now.
-                const bool del = r->autoDelete();
-
-                // run the task
                 locker.unlock();
+                do {
+                    // If autoDelete() is false, r might already be deleted after run(), so check status now.
+                    const bool del = r->autoDelete();
+
+                    // run the task
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        registerThreadInactive();
+                        throw;
+                    }
 #endif
 
-                if (del)
-                    delete r;
+                    if (del)
+                        delete r;
+
+                    // in work-stealing mode, keep going without the pool mutex
+                    r = manager->workStealing.load(std::memory_order_acquire)
+                            ? manager->takeWorkerTask(this, QThreadPoolPrivate::ProbeSomeQueues)
+                            : nullptr;
+                } while (r);
                 locker.relock();
             }
 
@@ -119,17 +133,21 @@ void QThreadPoolThread::run()
             if (manager->tooManyThreadsActive())
                 break;
 
-            // all work is done, time to wait for more
-            if (manager->queue.isEmpty())
-                break;
+            if (!manager->queue.isEmpty()) {
+                QueuePage *page = manager->queue.first();
+                r = page->pop();
 
-            QueuePage *page = manager->queue.first();
-            r = page->pop();
-
-            if (page->isFinished()) {
-                manager->queue.removeFirst();
-                delete page;
+                if (page->isFinished()) {
+                    manager->queue.removeFirst();
+                    delete page;
+                }
+            } else {
+                r = manager->takeWorkerTask(this, QThreadPoolPrivate::ScanAllQueues);
             }
+
+            // all work is done, time to wait for more
+            if (!r)
+                break;
         } while (true);
 
         // this thread is about to be deleted, do not wait or expire
@@ -141,10 +159,20 @@ void QThreadPoolThread::run()
         // if too many threads are active, expire this thread
         if (manager->tooManyThreadsActive()) {
             manager->expiredThreads.enqueue(this);
+            manager->updateSaturation();
             registerThreadInactive();
             return;
         }
         manager->waitingThreads.enqueue(this);
+        manager->updateSaturation();
+        // Runnables can be added to the worker queues without the mutex. The
+        // start() that added one either sees us as waiting now, and wakes a
+        // thread up, or added it before we check here.
+        if (manager->workerTaskCount() > 0) {
+            manager->waitingThreads.removeOne(this);
+            manager->updateSaturation();
+            continue;
+        }
         registerThreadInactive();
         // wait for work, exiting after the expiry timeout is reached
         runnableReady.wait(locker.mutex(), QDeadlineTimer(manager->expiryTimeout));
@@ -155,6 +183,7 @@ void QThreadPoolThread::run()
         }
         if (manager->waitingThreads.removeOne(this)) {
             manager->expiredThreads.enqueue(this);
+            manager->updateSaturation();
             return;
         }
         ++manager->activeThreads;
@@ -174,9 +203,14 @@ void QThreadPoolThread::registerThreadInactive()
 QThreadPoolPrivate:: QThreadPoolPrivate()
 { }
 
+/*
+    \internal
+
+    Starts \a task on an available thread. In work-stealing mode, \a task may
+    be null, the thread then picks its runnables from the worker queues.
+*/
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
 {
-    Q_ASSERT(task != nullptr);
     if (allThreads.isEmpty()) {
         // always create at least one thread
         startThread(task);
@@ -189,8 +223,10 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
 
     if (!waitingThreads.isEmpty()) {
         // recycle an available thread
-        enqueueTask(task);
+        if (task)
+            enqueueTask(task);
         waitingThreads.takeFirst()->runnableReady.wakeOne();
+        updateSaturation();
         return true;
     }
 
@@ -208,6 +244,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         thread->wait();
         Q_ASSERT(thread->isFinished());
         thread->start(threadPriority);
+        updateSaturation();
         return true;
     }
 
@@ -221,17 +258,22 @@ inline bool comparePriority(int priority, const QueuePage *p)
     return p->priority() < priority;
 }
 
-void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
+void QThreadPoolPrivate::enqueueInPages(QList<QueuePage *> &pages, QRunnable *runnable, int priority)
 {
     Q_ASSERT(runnable != nullptr);
-    for (QueuePage *page : qAsConst(queue)) {
+    for (QueuePage *page : qAsConst(pages)) {
         if (page->priority() == priority && !page->isFull()) {
             page->push(runnable);
             return;
         }
     }
-    auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
-    queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
+    auto it = std::upper_bound(pages.constBegin(), pages.constEnd(), priority, comparePriority);
+    pages.insert(std::distance(pages.constBegin(), it), new QueuePage(runnable, priority));
+}
+
+void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
+{
+    enqueueInPages(queue, runnable, priority);
 }
 
 int QThreadPoolPrivate::activeThreadCount() const
@@ -257,6 +299,13 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
             delete page;
         }
     }
+
+    // wake up or start a thread for each runnable in the worker queues,
+    // they take the runnables from there themselves
+    for (int pending = workerTaskCount(); pending > 0; --pending) {
+        if (!tryStart(nullptr))
+            break;
+    }
 }
 
 bool QThreadPoolPrivate::areAllThreadsActive() const
@@ -276,7 +325,6 @@ bool QThreadPoolPrivate::tooManyThreadsActive() const
 */
 void QThreadPoolPrivate::startThread(QRunnable *runnable)
 {
-    Q_ASSERT(runnable != nullptr);
     auto thread = std::make_unique<QThreadPoolThread>(this);
     if (objectName.isEmpty())
         objectName = u"Thread (pooled)"_qs;
@@ -287,6 +335,188 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
 
     thread->runnable = runnable;
     thread.release()->start(threadPriority);
+    updateSaturation();
+}
+
+/*!
+    \internal
+
+    Records whether all threads we may use are running. As long as that is
+    the case, start() does not need to lock the mutex in work-stealing mode,
+    since the running threads check the worker queues before going idle.
+    Must be called with the mutex locked, after any change affecting
+    areAllThreadsActive().
+*/
+void QThreadPoolPrivate::updateSaturation()
+{
+    saturated.store(!allThreads.isEmpty() && areAllThreadsActive());
+}
+
+/*!
+    \internal
+
+    Creates one worker queue per thread the pool may use, unless they
+    already exist. Must be called with the mutex locked.
+*/
+void QThreadPoolPrivate::enableWorkerQueues()
+{
+    if (!workerQueues) {
+        workerQueueCount = maxThreadCount();
+        workerQueues.reset(new QThreadPoolWorkerQueue[workerQueueCount]);
+    }
+    workStealing.store(true, std::memory_order_release);
+}
+
+/*!
+    \internal
+
+    Adds \a runnable to a worker queue: the calling thread's own one if it
+    belongs to this pool, otherwise the queues are used round-robin.
+*/
+void QThreadPoolPrivate::enqueueWorkerTask(QRunnable *runnable, int priority)
+{
+    QThreadPoolThread *self = currentPoolThread;
+    const uint index = (self && self->manager == this)
+            ? uint(self->homeQueue)
+            : nextSubmitQueue.fetch_add(1, std::memory_order_relaxed);
+
+    QThreadPoolWorkerQueue &workerQueue = workerQueues[index % uint(workerQueueCount)];
+    QMutexLocker locker(&workerQueue.mutex);
+    enqueueInPages(workerQueue.pages, runnable, priority);
+    workerQueue.updateTopPriority();
+    workerQueue.count.fetch_add(1);
+}
+
+/*!
+    \internal
+
+    Takes the highest priority runnable from \a workerQueue, or returns null
+    if it is empty.
+*/
+static QRunnable *takeFirstWorkerTask(QThreadPoolWorkerQueue &workerQueue)
+{
+    QMutexLocker locker(&workerQueue.mutex);
+    if (workerQueue.pages.isEmpty())
+        return nullptr;
+
+    QueuePage *page = workerQueue.pages.constFirst();
+    QRunnable *runnable = page->pop();
+    if (page->isFinished()) {
+        workerQueue.pages.removeFirst();
+        delete page;
+    }
+    workerQueue.updateTopPriority();
+    workerQueue.count.fetch_sub(1);
+    return runnable;
+}
+
+/*!
+    \internal
+
+    Takes the next runnable for \a thread from the worker queues, or returns
+    null if there is none. The thread's own queue comes first. Otherwise, it
+    steals from the queue with the highest priority runnable among a few of
+    the others if \a mode is ProbeSomeQueues, so that busy threads don't all
+    walk every queue, or among all of them if \a mode is ScanAllQueues, which
+    a thread does before going idle. Does not need the mutex if work stealing
+    is enabled.
+*/
+QRunnable *QThreadPoolPrivate::takeWorkerTask(QThreadPoolThread *thread, StealMode mode)
+{
+    if (!workerQueueCount)
+        return nullptr;
+
+    const int home = int(uint(thread->homeQueue) % uint(workerQueueCount));
+    QThreadPoolWorkerQueue &own = workerQueues[home];
+    if (own.count.load(std::memory_order_relaxed) > 0) {
+        if (QRunnable *runnable = takeFirstWorkerTask(own))
+            return runnable;
+    }
+
+    const int others = workerQueueCount - 1;
+    const int probes = mode == ScanAllQueues ? others : qMin(2, others);
+    for (;;) {
+        QThreadPoolWorkerQueue *best = nullptr;
+        int bestPriority = INT_MIN;
+        for (int i = 0; i < probes; ++i) {
+            const int victim = home + 1 + int((thread->nextVictim + uint(i)) % uint(others));
+            QThreadPoolWorkerQueue &candidate = workerQueues[victim % workerQueueCount];
+            const int priority = candidate.topPriority.load(std::memory_order_relaxed);
+            if (priority > bestPriority) {
+                best = &candidate;
+                bestPriority = priority;
+            }
+        }
+        thread->nextVictim += uint(probes);
+        if (!best)
+            return nullptr;
+        if (QRunnable *runnable = takeFirstWorkerTask(*best))
+            return runnable;
+        // somebody else got there first
+    }
+}
+
+/*!
+    \internal
+
+    Returns the number of runnables in the worker queues. They change without
+    the mutex, so this is only exact while nobody adds or takes any.
+*/
+int QThreadPoolPrivate::workerTaskCount() const
+{
+    int count = 0;
+    for (int i = 0; i < workerQueueCount; ++i)
+        count += workerQueues[i].count.load();
+    return count;
+}
+
+/*!
+    \internal
+
+    Removes \a runnable from the worker queues, if it is found there.
+*/
+bool QThreadPoolPrivate::tryTakeWorkerTask(QRunnable *runnable)
+{
+    for (int i = 0; i < workerQueueCount; ++i) {
+        QThreadPoolWorkerQueue &workerQueue = workerQueues[i];
+        QMutexLocker locker(&workerQueue.mutex);
+        for (QueuePage *page : qAsConst(workerQueue.pages)) {
+            if (page->tryTake(runnable)) {
+                if (page->isFinished()) {
+                    workerQueue.pages.removeOne(page);
+                    delete page;
+                }
+                workerQueue.updateTopPriority();
+                workerQueue.count.fetch_sub(1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/*!
+    \internal
+
+    Empties the worker queues, returning the runnables that were queued.
+*/
+QList<QRunnable *> QThreadPoolPrivate::takeAllWorkerTasks()
+{
+    QList<QRunnable *> runnables;
+    for (int i = 0; i < workerQueueCount; ++i) {
+        QThreadPoolWorkerQueue &workerQueue = workerQueues[i];
+        QMutexLocker locker(&workerQueue.mutex);
+        int taken = 0;
+        for (QueuePage *page : qAsConst(workerQueue.pages)) {
+            for (; !page->isFinished(); ++taken)
+                runnables.append(page->pop());
+            delete page;
+        }
+        workerQueue.pages.clear();
+        workerQueue.updateTopPriority();
+        workerQueue.count.fetch_sub(taken);
+    }
+    return runnables;
 }
 
 /*!
@@ -314,6 +544,7 @@ void QThreadPoolPrivate::reset()
     }
 
     mutex.lock();
+    updateSaturation();
 }
 
 /*!
@@ -323,10 +554,13 @@ void QThreadPoolPrivate::reset()
 */
 bool QThreadPoolPrivate::waitForDone(const QDeadlineTimer &timer)
 {
-    while (!(queue.isEmpty() && activeThreads == 0) && !timer.hasExpired())
+    const auto isDone = [this] {
+        return queue.isEmpty() && workerTaskCount() == 0 && activeThreads == 0;
+    };
+    while (!isDone() && !timer.hasExpired())
         noActiveThreads.wait(&mutex, timer);
 
-    return queue.isEmpty() && activeThreads == 0;
+    return isDone();
 }
 
 bool QThreadPoolPrivate::waitForDone(int msecs)
@@ -357,6 +591,13 @@ void QThreadPoolPrivate::clear()
         }
         delete page;
     }
+
+    const QList<QRunnable *> workerTasks = takeAllWorkerTasks();
+    locker.unlock();
+    for (QRunnable *r : workerTasks) {
+        if (r->autoDelete())
+            delete r;
+    }
 }
 
 /*!
@@ -394,7 +635,7 @@ bool QThreadPool::tryTake(QRunnable *runnable)
         }
     }
 
-    return false;
+    return d->tryTakeWorkerTask(runnable);
 }
 
     /*!
@@ -493,6 +734,7 @@ QThreadPool::~QThreadPool()
     Q_D(QThreadPool);
     waitForDone();
     Q_ASSERT(d->queue.isEmpty());
+    Q_ASSERT(d->workerTaskCount() == 0);
     Q_ASSERT(d->allThreads.isEmpty());
 }
 
@@ -531,6 +773,16 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (d->workStealing.load(std::memory_order_acquire)) {
+        d->enqueueWorkerTask(runnable, priority);
+        // if all threads are busy, one of them will pick the runnable up
+        if (!d->saturated.load()) {
+            QMutexLocker locker(&d->mutex);
+            d->tryToStartMoreThreads();
+        }
+        return;
+    }
+
     QMutexLocker locker(&d->mutex);
 
     if (!d->tryStart(runnable))
@@ -664,9 +916,60 @@ void QThreadPool::setMaxThreadCount(int maxThreadCount)
         return;
 
     d->requestedMaxThreadCount = maxThreadCount;
+    d->updateSaturation();
     d->tryToStartMoreThreads();
 }
 
+/*! \property QThreadPool::workStealingEnabled
+    \brief whether the thread pool uses per-thread queues.
+    \since 6.4
+
+    By default, all runnables that cannot be started right away are kept in
+    a single queue protected by the thread pool's lock, which every call to
+    start() and every thread looking for more work has to acquire. With many
+    threads running short runnables, that lock becomes a bottleneck.
+
+    When this property is \c true, each thread gets its own queue instead.
+    start() adds the runnable to the calling thread's queue if it is called
+    from one of the pool's threads, and distributes runnables over the queues
+    otherwise; it only needs the thread pool's lock when there are idle
+    threads to wake up. A thread runs the runnables from its own queue, and
+    takes runnables from the other threads' queues when its own queue is
+    empty.
+
+    Priorities are only respected within each queue: a thread runs the
+    runnables in its own queue in priority order, and when stealing, prefers
+    the higher priority one among the few other queues it looks at, but a
+    lower priority runnable may start before a higher priority one queued for
+    another thread. Runnables of the same priority are no longer guaranteed to
+    start in the order they were passed to start().
+
+    The maximum thread count is only re-checked when a thread runs out of
+    work, so lowering it, or reserving threads with reserveThread(), takes
+    effect more slowly.
+
+    The default is \c false.
+*/
+
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.load(std::memory_order_relaxed);
+}
+
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    if (enabled) {
+        d->enableWorkerQueues();
+    } else {
+        // runnables left in the worker queues are still run, since the
+        // threads always look there after the shared queue
+        d->workStealing.store(false, std::memory_order_release);
+    }
+}
+
 /*! \property QThreadPool::activeThreadCount
 
     \brief the number of active threads in the thread pool.
@@ -704,6 +1007,7 @@ void QThreadPool::reserveThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     ++d->reservedThreads;
+    d->updateSaturation();
 }
 
 /*! \property QThreadPool::stackSize
@@ -773,6 +1077,7 @@ void QThreadPool::releaseThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     --d->reservedThreads;
+    d->updateSaturation();
     d->tryToStartMoreThreads();
 }
 
@@ -804,6 +1109,7 @@ void QThreadPool::startOnReservedThread(QRunnable *runnable)
     QMutexLocker locker(&d->mutex);
     Q_ASSERT(d->reservedThreads > 0);
     --d->reservedThreads;
+    d->updateSaturation();
 
     if (!d->tryStart(runnable)) {
         // This can only happen if we reserved max threads,
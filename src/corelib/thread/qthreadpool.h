@@ -61,6 +61,7 @@ class Q_CORE_EXPORT QThreadPool : public QObject
     Q_PROPERTY(int activeThreadCount READ activeThreadCount)
     Q_PROPERTY(uint stackSize READ stackSize WRITE setStackSize)
     Q_PROPERTY(QThread::Priority threadPriority READ threadPriority WRITE setThreadPriority)
+    Q_PROPERTY(bool workStealingEnabled READ isWorkStealingEnabled WRITE setWorkStealingEnabled)
     friend class QFutureInterfaceBase;
 
 public:
@@ -92,6 +93,9 @@ public:
     void setThreadPriority(QThread::Priority priority);
     QThread::Priority threadPriority() const;
 
+    bool isWorkStealingEnabled() const;
+    void setWorkStealingEnabled(bool enabled);
+
     void reserveThread();
     void releaseThread();
 
@@ -60,6 +60,10 @@
 #include "QtCore/qqueue.h"
 #include "private/qobject_p.h"
 
+#include <atomic>
+#include <climits>
+#include <memory>
+
 QT_REQUIRE_CONFIG(thread);
 
 QT_BEGIN_NAMESPACE
@@ -143,6 +147,25 @@ private:
     QRunnable *m_entries[MaxPageSize];
 };
 
+// One queue per worker in work-stealing mode. Padded to a cache line so that
+// workers pushing to and popping from their own queue don't disturb others.
+struct alignas(64) QThreadPoolWorkerQueue
+{
+    QMutex mutex;
+    QList<QueuePage *> pages;
+    // priority of the first page, or INT_MIN if empty; read without the mutex
+    std::atomic<int> topPriority = INT_MIN;
+    // number of runnables queued; also read without the mutex
+    std::atomic<int> count = 0;
+
+    void updateTopPriority()
+    {
+        // INT_MIN is reserved for empty queues
+        topPriority.store(pages.isEmpty() ? INT_MIN : qMax(pages.constFirst()->priority(), INT_MIN + 1),
+                          std::memory_order_relaxed);
+    }
+};
+
 class QThreadPoolThread;
 class Q_CORE_EXPORT QThreadPoolPrivate : public QObjectPrivate
 {
@@ -154,6 +177,7 @@ public:
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    static void enqueueInPages(QList<QueuePage *> &pages, QRunnable *runnable, int priority);
     int activeThreadCount() const;
 
     void tryToStartMoreThreads();
@@ -170,6 +194,15 @@ public:
     void stealAndRunRunnable(QRunnable *runnable);
     void deletePageIfFinished(QueuePage *page);
 
+    void updateSaturation();
+    void enableWorkerQueues();
+    void enqueueWorkerTask(QRunnable *runnable, int priority);
+    enum StealMode { ProbeSomeQueues, ScanAllQueues };
+    QRunnable *takeWorkerTask(QThreadPoolThread *thread, StealMode mode);
+    int workerTaskCount() const;
+    bool tryTakeWorkerTask(QRunnable *runnable);
+    QList<QRunnable *> takeAllWorkerTasks();
+
     mutable QMutex mutex;
     QSet<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -184,6 +217,17 @@ public:
     int activeThreads = 0;
     uint stackSize = 0;
     QThread::Priority threadPriority = QThread::InheritPriority;
+
+    // work-stealing mode; the queues are never deallocated once created, so
+    // that start() can use them without holding the mutex
+    std::unique_ptr<QThreadPoolWorkerQueue[]> workerQueues;
+    int workerQueueCount = 0;
+    int nextHomeQueue = 0;
+    std::atomic<bool> workStealing = false;
+    std::atomic<uint> nextSubmitQueue = 0;
+    // whether all threads we may use are busy, and will look for more work
+    // in the worker queues before going idle
+    std::atomic<bool> saturated = false;
 };
 
 QT_END_NAMESPACE
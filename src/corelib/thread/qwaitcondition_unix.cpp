@@ -45,17 +45,24 @@
 #include "qatomic.h"
 #include "qstring.h"
 #include "qdeadlinetimer.h"
+#include "qthread.h"
 #include "private/qdeadlinetimer_p.h"
 #include "qelapsedtimer.h"
 #include "private/qcore_unix_p.h"
 
 #include "qmutex_p.h"
 #include "qreadwritelock_p.h"
+#include "qfutex_p.h"
 
+#include <atomic>
 #include <errno.h>
 #include <sys/time.h>
 #include <time.h>
 
+#if defined(Q_OS_LINUX) && defined(QT_ALWAYS_USE_FUTEX)
+#  define QT_WAITCONDITION_USE_FUTEX
+#endif
+
 QT_BEGIN_NAMESPACE
 
 #ifdef Q_OS_ANDROID
@@ -114,6 +121,249 @@ void qt_abstime_for_timeout(timespec *ts, QDeadlineTimer deadline)
 #endif
 }
 
+#ifdef QT_WAITCONDITION_USE_FUTEX
+
+/*
+ * QWaitCondition implementation with futexes (Linux)
+ *
+ * Waiters sleep on a sequence number, which every wake advances, so a wake
+ * that happens between unlocking the user's mutex and sleeping makes futex(2)
+ * return immediately. Like the pthread implementation, we count waiters and
+ * pending wakeups, so that wakeOne() wakes exactly one waiter and a return
+ * from futex(2) that was not caused by a wake doesn't count as one. The
+ * sequence number and both counters share one 64-bit atomic, so a waiter
+ * only ever consumes a wakeup from a wake that happened after it started
+ * waiting: a thread that calls wakeOne() and then wait() itself must not
+ * steal the wakeup it just posted. Both wake functions return without a
+ * system call when nobody is waiting.
+ *
+ * If all waiters use the same QMutex, wakeAll() doesn't wake them all just to
+ * have them fight for the mutex: it wakes one and requeues the others onto the
+ * mutex's futex word, so each one is woken when the previous unlocks the
+ * mutex. This only works if the waiters that were around for a requeue then
+ * lock the mutex through QBasicMutex::lockInternal(), which leaves it marked
+ * as contended, so that each unlock wakes the next requeued thread; the
+ * requeues counter tells them. A thread that starts waiting during a requeue
+ * must not be moved along with the others: it would be woken by the mutex
+ * without being entitled to a wakeup and break the chain. So wakeAll() makes
+ * the sequence number odd for the duration of the requeue, and new waiters
+ * don't go to sleep while it is.
+ */
+
+class QWaitConditionPrivate
+{
+public:
+    // bits 0-31: sequence number (the futex word), bits 32-47: waiters,
+    // bits 48-63: wakeups that waiters have yet to consume
+    QBasicAtomicInteger<quint64> state = Q_BASIC_ATOMIC_INITIALIZER(0);
+    // the mutex that all waiters so far used, or noRequeue()
+    QBasicAtomicPointer<QBasicMutex> requeueMutex = Q_BASIC_ATOMIC_INITIALIZER(nullptr);
+    // incremented by every wakeAll() that requeues
+    QBasicAtomicInteger<quint32> requeues = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+    struct Waiter
+    {
+        quint32 sequence;
+        quint32 requeues;
+    };
+
+    static constexpr quint64 OneWaiter = Q_UINT64_C(1) << 32;
+    static constexpr quint64 OneWakeup = Q_UINT64_C(1) << 48;
+    static constexpr quint64 WakeupsMask = Q_UINT64_C(0xffff) << 48;
+    static quint32 sequence(quint64 v) { return quint32(v); }
+    static quint32 waiters(quint64 v) { return quint16(v >> 32); }
+    static quint32 wakeups(quint64 v) { return quint16(v >> 48); }
+    static quint64 advance(quint64 v, quint32 n)
+    {
+        return (v & ~Q_UINT64_C(0xffffffff)) | quint32(v + n);
+    }
+    // whether v's sequence number is past seq, i.e. a wake (or the start of
+    // a requeue) happened since a waiter that got seq entered; we compare
+    // the difference, as the sequence number wraps around
+    static bool isAfter(quint64 v, quint32 seq) { return qint32(sequence(v) - seq) > 0; }
+    static QBasicMutex *noRequeue() { return reinterpret_cast<QBasicMutex *>(quintptr(1)); }
+
+    // called with the user's lock held
+    Waiter enter(QBasicMutex *mutex)
+    {
+        QBasicMutex *current = requeueMutex.loadRelaxed();
+        if (!current && requeueMutex.testAndSetRelaxed(nullptr, mutex, current))
+            current = mutex;
+        if (current != mutex)
+            requeueMutex.storeRelaxed(noRequeue());
+
+        // pairs with wakeAll(): if it counts us as a waiter, it also sees our
+        // requeueMutex update
+        quint32 seq = sequence(state.fetchAndAddOrdered(OneWaiter));
+        // an odd sequence number means a wakeAll() is requeueing the waiters
+        // it woke; we're not one of them and the step that ends the requeue
+        // is no wake for us either
+        if (seq & 1)
+            ++seq;
+        return { seq, requeues.loadRelaxed() };
+    }
+
+    // called with the user's lock released
+    bool wait(const Waiter &waiter, QDeadlineTimer deadline)
+    {
+        forever {
+            // a waiter that entered during a requeue has a sequence number
+            // ahead of the odd one, so it can't take a wakeup meant for the
+            // requeued waiters
+            quint64 v = state.loadAcquire();
+            while (isAfter(v, waiter.sequence) && wakeups(v) > 0) {
+                if (state.testAndSetAcquire(v, v - OneWakeup - OneWaiter, v))
+                    return true;
+            }
+
+            if (sequence(v) & 1) {
+                // a requeue is in progress, which would move us too
+                QThread::yieldCurrentThread();
+                continue;
+            }
+
+            if (deadline.isForever()) {
+                QtFutex::futexWait(state, sequence(v));
+            } else {
+                const qint64 remaining = deadline.remainingTimeNSecs();
+                if (remaining <= 0 || !QtFutex::futexWait(state, sequence(v), remaining)) {
+                    // timed out, unless a wakeup for us came in meanwhile:
+                    // then we take it, so that wakeups never outnumber the
+                    // waiters they were meant for
+                    v = state.loadRelaxed();
+                    forever {
+                        const bool woken = isAfter(v, waiter.sequence) && wakeups(v) > 0;
+                        const quint64 next = v - OneWaiter - (woken ? OneWakeup : 0);
+                        if (state.testAndSetAcquire(v, next, v))
+                            return woken;
+                    }
+                }
+            }
+        }
+    }
+
+    void relock(QBasicMutex *mutex, const Waiter &waiter)
+    {
+        if (requeues.loadAcquire() == waiter.requeues) {
+            mutex->lock();
+        } else {
+            // other waiters may sleep on the mutex's futex word now; this
+            // marks the mutex as contended, so our unlock will wake one
+            mutex->lockInternal();
+        }
+    }
+
+    void wakeOne()
+    {
+        quint64 v = state.loadRelaxed();
+        do {
+            if (wakeups(v) >= waiters(v))
+                return;
+        } while (!state.testAndSetRelease(v, advance(v, 2) + OneWakeup, v));
+        QtFutex::futexWakeOne(state);
+    }
+
+    void wakeAll()
+    {
+        // only one requeue at a time: if the sequence number is odd already,
+        // we keep it that way and just wake everybody
+        const QBasicMutex *current = requeueMutex.loadRelaxed();
+        const bool mayRequeue = current && current != noRequeue();
+        bool requeue;
+        quint64 v = state.loadRelaxed();
+        quint64 next;
+        do {
+            if (wakeups(v) >= waiters(v))
+                return;
+            requeue = mayRequeue && !(sequence(v) & 1);
+            next = advance(v, requeue ? 1 : 2) & ~WakeupsMask;
+            next |= quint64(waiters(v)) << 48;
+        } while (!state.testAndSetOrdered(v, next, v));
+
+        if (requeue) {
+            // all the waiters we counted have published their mutex by now
+            QBasicMutex *mutex = requeueMutex.loadRelaxed();
+            if (mutex != noRequeue()) {
+                requeues.fetchAndAddRelease(1);
+                requeue = QtFutex::futexCmpRequeue(state, sequence(next), 1, INT_MAX,
+                                                   mutex->d_ptr);
+            } else {
+                requeue = false;
+            }
+
+            // end the requeue, letting new waiters sleep again
+            v = next;
+            while (!state.testAndSetRelease(v, advance(v, 1), v))
+                ;
+            if (requeue)
+                return;
+        }
+        QtFutex::futexWakeAll(state);
+    }
+};
+
+QWaitCondition::QWaitCondition()
+{
+    d = new QWaitConditionPrivate;
+}
+
+QWaitCondition::~QWaitCondition()
+{
+    delete d;
+}
+
+void QWaitCondition::wakeOne()
+{
+    d->wakeOne();
+}
+
+void QWaitCondition::wakeAll()
+{
+    d->wakeAll();
+}
+
+bool QWaitCondition::wait(QMutex *mutex, QDeadlineTimer deadline)
+{
+    if (!mutex)
+        return false;
+
+    const QWaitConditionPrivate::Waiter waiter = d->enter(mutex);
+    mutex->unlock();
+
+    bool returnValue = d->wait(waiter, deadline);
+
+    d->relock(mutex, waiter);
+
+    return returnValue;
+}
+
+bool QWaitCondition::wait(QReadWriteLock *readWriteLock, QDeadlineTimer deadline)
+{
+    if (!readWriteLock)
+        return false;
+    auto previousState = readWriteLock->stateForWaitCondition();
+    if (previousState == QReadWriteLock::Unlocked)
+        return false;
+    if (previousState == QReadWriteLock::RecursivelyLocked) {
+        qWarning("QWaitCondition: cannot wait on QReadWriteLocks with recursive lockForWrite()");
+        return false;
+    }
+
+    const QWaitConditionPrivate::Waiter waiter = d->enter(QWaitConditionPrivate::noRequeue());
+    readWriteLock->unlock();
+
+    bool returnValue = d->wait(waiter, deadline);
+
+    if (previousState == QReadWriteLock::LockedForWrite)
+        readWriteLock->lockForWrite();
+    else
+        readWriteLock->lockForRead();
+
+    return returnValue;
+}
+
+#else // !QT_WAITCONDITION_USE_FUTEX
+
 class QWaitConditionPrivate
 {
 public:
@@ -201,13 +451,6 @@ void QWaitCondition::wakeAll()
     report_error(pthread_mutex_unlock(&d->mutex), "QWaitCondition::wakeAll()", "mutex unlock");
 }
 
-bool QWaitCondition::wait(QMutex *mutex, unsigned long time)
-{
-    if (time == std::numeric_limits<unsigned long>::max())
-        return wait(mutex, QDeadlineTimer(QDeadlineTimer::Forever));
-    return wait(mutex, QDeadlineTimer(time));
-}
-
 bool QWaitCondition::wait(QMutex *mutex, QDeadlineTimer deadline)
 {
     if (!mutex)
@@ -224,13 +467,6 @@ bool QWaitCondition::wait(QMutex *mutex, QDeadlineTimer deadline)
     return returnValue;
 }
 
-bool QWaitCondition::wait(QReadWriteLock *readWriteLock, unsigned long time)
-{
-    if (time == std::numeric_limits<unsigned long>::max())
-        return wait(readWriteLock, QDeadlineTimer(QDeadlineTimer::Forever));
-    return wait(readWriteLock, QDeadlineTimer(time));
-}
-
 bool QWaitCondition::wait(QReadWriteLock *readWriteLock, QDeadlineTimer deadline)
 {
     if (!readWriteLock)
@@ -258,4 +494,20 @@ bool QWaitCondition::wait(QReadWriteLock *readWriteLock, QDeadlineTimer deadline
     return returnValue;
 }
 
+#endif // QT_WAITCONDITION_USE_FUTEX
+
+bool QWaitCondition::wait(QMutex *mutex, unsigned long time)
+{
+    if (time == std::numeric_limits<unsigned long>::max())
+        return wait(mutex, QDeadlineTimer(QDeadlineTimer::Forever));
+    return wait(mutex, QDeadlineTimer(time));
+}
+
+bool QWaitCondition::wait(QReadWriteLock *readWriteLock, unsigned long time)
+{
+    if (time == std::numeric_limits<unsigned long>::max())
+        return wait(readWriteLock, QDeadlineTimer(QDeadlineTimer::Forever));
+    return wait(readWriteLock, QDeadlineTimer(time));
+}
+
 QT_END_NAMESPACE
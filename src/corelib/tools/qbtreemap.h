@@ -0,0 +1,1195 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QBTREEMAP_H
+#define QBTREEMAP_H
+
+#include <QtCore/qcontainertools_impl.h>
+#include <QtCore/qiterator.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qrefcount.h>
+#include <QtCore/qscopeguard.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+
+class tst_QBTreeMap; // for befriending
+
+QT_BEGIN_NAMESPACE
+
+namespace QBTreeMapPrivate {
+
+// Nodes are sized for about this many bytes of keys and values, so that
+// a search inside a node touches only a few cache lines.
+constexpr size_t NodeBytes = 512;
+
+template <typename Key, typename T>
+struct Leaf
+{
+    static constexpr int Capacity = qBound(4, int(NodeBytes / (sizeof(Key) + sizeof(T))), 64);
+    static constexpr int MinCount = Capacity / 2;
+
+    Leaf *prev = nullptr;
+    Leaf *next = nullptr;
+    int count = 0;
+    alignas(Key) unsigned char keyStorage[Capacity * sizeof(Key)];
+    alignas(T) unsigned char valueStorage[Capacity * sizeof(T)];
+
+    Leaf() noexcept = default;
+    Q_DISABLE_COPY_MOVE(Leaf)
+    ~Leaf()
+    {
+        std::destroy_n(keys(), count);
+        std::destroy_n(values(), count);
+    }
+
+    Key *keys() noexcept { return reinterpret_cast<Key *>(keyStorage); }
+    const Key *keys() const noexcept { return reinterpret_cast<const Key *>(keyStorage); }
+    T *values() noexcept { return reinterpret_cast<T *>(valueStorage); }
+    const T *values() const noexcept { return reinterpret_cast<const T *>(valueStorage); }
+};
+
+template <typename Key>
+struct Inner
+{
+    static constexpr int Capacity = qBound(4, int(NodeBytes / (sizeof(Key) + sizeof(void *))), 64);
+    static constexpr int MinCount = Capacity / 2;
+
+    // The number of keys; there is one child more than there are keys.
+    // Everything in children[i] is less than keys[i], and not less than
+    // keys[i - 1]. There is room for one key and child more than the
+    // capacity, so that a full node can take in the separator of a split
+    // child before being split itself.
+    int count = 0;
+    alignas(Key) unsigned char keyStorage[(Capacity + 1) * sizeof(Key)];
+    void *children[Capacity + 2] = {};
+
+    Inner() noexcept = default;
+    Q_DISABLE_COPY_MOVE(Inner)
+    ~Inner() { std::destroy_n(keys(), count); }
+
+    Key *keys() noexcept { return reinterpret_cast<Key *>(keyStorage); }
+    const Key *keys() const noexcept { return reinterpret_cast<const Key *>(keyStorage); }
+};
+
+template <typename Key, typename T>
+struct Data
+{
+    using Leaf = QBTreeMapPrivate::Leaf<Key, T>;
+    using Inner = QBTreeMapPrivate::Inner<Key>;
+
+    // Every inner node but the last one on its level has at least three
+    // children, so this is more levels than any tree that fits into memory.
+    static constexpr int MaxDepth = 48;
+
+    struct Position
+    {
+        Leaf *leaf = nullptr;
+        int index = 0;
+    };
+
+    // The inner nodes on the way from the root down to a leaf, and the
+    // index of the child taken in each of them, by level. Leaves are
+    // level 0, the root is level 'depth'.
+    struct Path
+    {
+        Inner *nodes[MaxDepth + 1];
+        int indexes[MaxDepth + 1];
+    };
+
+    // The nodes a split is going to need are allocated before the tree is
+    // modified, so that running out of memory leaves the tree untouched.
+    struct SpareNodes
+    {
+        Leaf *leaf = nullptr;
+        Inner *inners[MaxDepth + 1] = {};
+        int innerCount = 0;
+
+        SpareNodes() noexcept = default;
+        Q_DISABLE_COPY_MOVE(SpareNodes)
+        ~SpareNodes()
+        {
+            delete leaf;
+            for (int i = 0; i < innerCount; ++i)
+                delete inners[i];
+        }
+        Inner *takeInner() noexcept
+        {
+            Q_ASSERT(innerCount > 0);
+            return std::exchange(inners[--innerCount], nullptr);
+        }
+    };
+
+    QtPrivate::RefCount ref = {{1}};
+    size_t size = 0;
+    int depth = 0;
+    void *root = nullptr;
+    Leaf *first = nullptr;
+    Leaf *last = nullptr;
+
+    Data() noexcept = default;
+    Data(const Data &other)
+        : size(other.size), depth(other.depth)
+    {
+        if (other.root)
+            root = copyNode(other.root, other.depth);
+    }
+    ~Data()
+    {
+        if (root)
+            freeNode(root, depth);
+    }
+
+    static Data *detached(Data *d)
+    {
+        if (!d)
+            return new Data;
+        Data *dd = new Data(*d);
+        if (!d->ref.deref())
+            delete d;
+        return dd;
+    }
+
+    // Copies the subtree, appending its leaves to the list of leaves.
+    void *copyNode(const void *node, int level)
+    {
+        if (level == 0) {
+            const Leaf *from = static_cast<const Leaf *>(node);
+            Leaf *to = new Leaf;
+            auto cleanup = qScopeGuard([to] { delete to; });
+            for (int i = 0; i < from->count; ++i) {
+                new (to->keys() + i) Key(from->keys()[i]);
+                auto destroyKey = qScopeGuard([to, i] { std::destroy_at(to->keys() + i); });
+                new (to->values() + i) T(from->values()[i]);
+                destroyKey.dismiss();
+                ++to->count;
+            }
+            cleanup.dismiss();
+            to->prev = last;
+            (last ? last->next : first) = to;
+            last = to;
+            return to;
+        }
+
+        const Inner *from = static_cast<const Inner *>(node);
+        Inner *to = new Inner;
+        auto cleanup = qScopeGuard([to, level] { freeNode(to, level); });
+        to->children[0] = copyNode(from->children[0], level - 1);
+        for (int i = 0; i < from->count; ++i) {
+            new (to->keys() + i) Key(from->keys()[i]);
+            ++to->count;
+            to->children[i + 1] = copyNode(from->children[i + 1], level - 1);
+        }
+        cleanup.dismiss();
+        return to;
+    }
+
+    static void freeNode(void *node, int level) noexcept
+    {
+        if (level == 0) {
+            delete static_cast<Leaf *>(node);
+            return;
+        }
+        Inner *inner = static_cast<Inner *>(node);
+        for (int i = 0; i <= inner->count; ++i) {
+            if (inner->children[i]) // null only in a copy that failed half-way
+                freeNode(inner->children[i], level - 1);
+        }
+        delete inner;
+    }
+
+    static bool lessThan(const Key &lhs, const Key &rhs)
+    {
+        return std::less<Key>()(lhs, rhs);
+    }
+    static int lowerBoundIn(const Leaf *leaf, const Key &key)
+    {
+        return int(std::lower_bound(leaf->keys(), leaf->keys() + leaf->count, key, std::less<Key>()) - leaf->keys());
+    }
+    static int upperBoundIn(const Leaf *leaf, const Key &key)
+    {
+        return int(std::upper_bound(leaf->keys(), leaf->keys() + leaf->count, key, std::less<Key>()) - leaf->keys());
+    }
+    static int childIndex(const Inner *inner, const Key &key)
+    {
+        // a key equal to a separator lives in the subtree to its right
+        return int(std::upper_bound(inner->keys(), inner->keys() + inner->count, key, std::less<Key>()) - inner->keys());
+    }
+    static Position normalized(Leaf *leaf, int index) noexcept
+    {
+        if (index == leaf->count)
+            return { leaf->next, 0 };
+        return { leaf, index };
+    }
+
+    Leaf *findLeaf(const Key &key, Path *path = nullptr) const
+    {
+        Q_ASSERT(root);
+        void *node = root;
+        for (int level = depth; level > 0; --level) {
+            Inner *inner = static_cast<Inner *>(node);
+            const int i = childIndex(inner, key);
+            if (path) {
+                path->nodes[level] = inner;
+                path->indexes[level] = i;
+            }
+            node = inner->children[i];
+        }
+        return static_cast<Leaf *>(node);
+    }
+
+    Position begin() const noexcept { return { first, 0 }; }
+
+    Position find(const Key &key) const
+    {
+        if (!root)
+            return {};
+        Leaf *leaf = findLeaf(key);
+        const int i = lowerBoundIn(leaf, key);
+        if (i < leaf->count && !lessThan(key, leaf->keys()[i]))
+            return { leaf, i };
+        return {};
+    }
+    Position lowerBound(const Key &key) const
+    {
+        if (!root)
+            return {};
+        Leaf *leaf = findLeaf(key);
+        return normalized(leaf, lowerBoundIn(leaf, key));
+    }
+    Position upperBound(const Key &key) const
+    {
+        if (!root)
+            return {};
+        Leaf *leaf = findLeaf(key);
+        return normalized(leaf, upperBoundIn(leaf, key));
+    }
+
+    // Returns the position of key, or the one at which it is to be
+    // inserted, and fills in the path down to it.
+    Position findForInsert(const Key &key, Path &path, bool *found) const
+    {
+        *found = false;
+        if (!root)
+            return {};
+        if (lessThan(last->keys()[last->count - 1], key)) {
+            // Appending, as when filling the map in key order: the last leaf
+            // takes the key, and the path to it needs no comparisons.
+            void *node = root;
+            for (int level = depth; level > 0; --level) {
+                Inner *inner = static_cast<Inner *>(node);
+                path.nodes[level] = inner;
+                path.indexes[level] = inner->count;
+                node = inner->children[inner->count];
+            }
+            Q_ASSERT(node == last);
+            return { last, last->count };
+        }
+        Leaf *leaf = findLeaf(key, &path);
+        const int i = lowerBoundIn(leaf, key);
+        *found = i < leaf->count && !lessThan(key, leaf->keys()[i]);
+        return { leaf, i };
+    }
+
+    static void insertInLeaf(Leaf *leaf, int index, Key &&key, T &&value) noexcept
+    {
+        Q_ASSERT(leaf->count < Leaf::Capacity);
+        const int n = leaf->count - index;
+        QtPrivate::q_relocate_overlap_n(leaf->keys() + index, n, leaf->keys() + index + 1);
+        QtPrivate::q_relocate_overlap_n(leaf->values() + index, n, leaf->values() + index + 1);
+        new (leaf->keys() + index) Key(std::move(key));
+        new (leaf->values() + index) T(std::move(value));
+        ++leaf->count;
+    }
+
+    // Inserts a new entry at pos, as returned by findForInsert(), and
+    // returns where it ended up.
+    Position insert(Path &path, Position pos, Key &&key, T &&value)
+    {
+        if (!root) {
+            Leaf *leaf = new Leaf;
+            root = first = last = leaf;
+            pos = { leaf, 0 };
+        }
+        if (pos.leaf->count < Leaf::Capacity) {
+            insertInLeaf(pos.leaf, pos.index, std::move(key), std::move(value));
+            ++size;
+            return pos;
+        }
+
+        // The leaf is full and is split in two. When appending, the left
+        // one is kept full, so that maps filled in key order end up with
+        // full leaves rather than half-full ones.
+        Leaf *leaf = pos.leaf;
+        const bool appending = pos.index == leaf->count && !leaf->next;
+        const int keep = appending ? Leaf::Capacity : Leaf::Capacity / 2;
+
+        SpareNodes spare;
+        allocateForSplit(path, spare);
+        Key separator = appending ? key : leaf->keys()[keep];
+
+        Leaf *right = std::exchange(spare.leaf, nullptr);
+        right->count = leaf->count - keep;
+        QtPrivate::q_uninitialized_relocate_n(leaf->keys() + keep, right->count, right->keys());
+        QtPrivate::q_uninitialized_relocate_n(leaf->values() + keep, right->count, right->values());
+        leaf->count = keep;
+        right->prev = leaf;
+        right->next = leaf->next;
+        (leaf->next ? leaf->next->prev : last) = right;
+        leaf->next = right;
+
+        Position result;
+        if (!appending && pos.index <= keep)
+            result = { leaf, pos.index };
+        else
+            result = { right, pos.index - keep };
+        insertInLeaf(result.leaf, result.index, std::move(key), std::move(value));
+        ++size;
+
+        insertChild(path, std::move(separator), right, appending, spare);
+        return result;
+    }
+
+    void allocateForSplit(const Path &path, SpareNodes &spare) const
+    {
+        spare.leaf = new Leaf;
+        int level = 1;
+        while (level <= depth && path.nodes[level]->count == Inner::Capacity) {
+            spare.inners[spare.innerCount++] = new Inner;
+            ++level;
+        }
+        if (level > depth) // the root is split, too
+            spare.inners[spare.innerCount++] = new Inner;
+    }
+
+    // Inserts the separator and the new right half of a split node into the
+    // parent of the node, splitting the parents as needed.
+    void insertChild(const Path &path, Key &&separator, void *child, bool appending, SpareNodes &spare) noexcept
+    {
+        for (int level = 1; level <= depth; ++level) {
+            Inner *inner = path.nodes[level];
+            const int i = path.indexes[level];
+            QtPrivate::q_relocate_overlap_n(inner->keys() + i, inner->count - i, inner->keys() + i + 1);
+            new (inner->keys() + i) Key(std::move(separator));
+            std::memmove(inner->children + i + 2, inner->children + i + 1, (inner->count - i) * sizeof(void *));
+            inner->children[i + 1] = child;
+            if (++inner->count <= Inner::Capacity)
+                return;
+
+            // keys[keep] moves up, the keys after it go to the right half
+            const int keep = appending ? Inner::Capacity - 1 : Inner::Capacity / 2;
+            Inner *right = spare.takeInner();
+            right->count = inner->count - keep - 1;
+            QtPrivate::q_uninitialized_relocate_n(inner->keys() + keep + 1, right->count, right->keys());
+            std::memcpy(right->children, inner->children + keep + 1, (right->count + 1) * sizeof(void *));
+            separator = std::move(inner->keys()[keep]);
+            std::destroy_at(inner->keys() + keep);
+            inner->count = keep;
+            child = right;
+        }
+
+        // the root was split: the tree grows by one level
+        Q_ASSERT(depth < MaxDepth);
+        Inner *newRoot = spare.takeInner();
+        new (newRoot->keys()) Key(std::move(separator));
+        newRoot->count = 1;
+        newRoot->children[0] = root;
+        newRoot->children[1] = child;
+        root = newRoot;
+        ++depth;
+    }
+
+    // Erases key, if present, and returns whether it was. The position of
+    // the entry that followed it is stored in next.
+    bool erase(const Key &key, Position *next = nullptr)
+    {
+        if (!root)
+            return false;
+        Path path;
+        Leaf *leaf = findLeaf(key, &path);
+        const int i = lowerBoundIn(leaf, key);
+        if (i == leaf->count || lessThan(key, leaf->keys()[i]))
+            return false;
+        const Position p = eraseAt(path, { leaf, i });
+        if (next)
+            *next = p;
+        return true;
+    }
+
+    Position eraseAt(Path &path, Position pos)
+    {
+        Leaf *leaf = pos.leaf;
+        const int i = pos.index;
+        std::destroy_at(leaf->keys() + i);
+        std::destroy_at(leaf->values() + i);
+        const int n = leaf->count - i - 1;
+        QtPrivate::q_relocate_overlap_n(leaf->keys() + i + 1, n, leaf->keys() + i);
+        QtPrivate::q_relocate_overlap_n(leaf->values() + i + 1, n, leaf->values() + i);
+        --leaf->count;
+        --size;
+
+        if (depth == 0) {
+            if (leaf->count == 0) {
+                delete leaf;
+                root = first = last = nullptr;
+                return {};
+            }
+            return normalized(leaf, i);
+        }
+        if (leaf->count >= Leaf::MinCount)
+            return normalized(leaf, i);
+        return rebalanceLeaf(path, pos);
+    }
+
+    // Refills a leaf that has too few entries left from a sibling, or merges
+    // it with one. Keeps track of where the entry at pos ends up.
+    Position rebalanceLeaf(Path &path, Position pos)
+    {
+        Leaf *leaf = pos.leaf;
+        Inner *parent = path.nodes[1];
+        const int i = path.indexes[1];
+        Leaf *left = i > 0 ? static_cast<Leaf *>(parent->children[i - 1]) : nullptr;
+        Leaf *right = i < parent->count ? static_cast<Leaf *>(parent->children[i + 1]) : nullptr;
+
+        // The separator is updated first: if copying the key throws, the
+        // tree is left with a small, but valid leaf.
+        if (left && left->count > Leaf::MinCount) {
+            parent->keys()[i - 1] = left->keys()[left->count - 1];
+            QtPrivate::q_relocate_overlap_n(leaf->keys(), leaf->count, leaf->keys() + 1);
+            QtPrivate::q_relocate_overlap_n(leaf->values(), leaf->count, leaf->values() + 1);
+            --left->count;
+            QtPrivate::q_uninitialized_relocate_n(left->keys() + left->count, 1, leaf->keys());
+            QtPrivate::q_uninitialized_relocate_n(left->values() + left->count, 1, leaf->values());
+            ++leaf->count;
+            return normalized(leaf, pos.index + 1);
+        }
+        if (right && right->count > Leaf::MinCount) {
+            parent->keys()[i] = right->keys()[1];
+            QtPrivate::q_uninitialized_relocate_n(right->keys(), 1, leaf->keys() + leaf->count);
+            QtPrivate::q_uninitialized_relocate_n(right->values(), 1, leaf->values() + leaf->count);
+            ++leaf->count;
+            --right->count;
+            QtPrivate::q_relocate_overlap_n(right->keys() + 1, right->count, right->keys());
+            QtPrivate::q_relocate_overlap_n(right->values() + 1, right->count, right->values());
+            return normalized(leaf, pos.index);
+        }
+
+        if (left) {
+            pos = { left, left->count + pos.index };
+            mergeLeaves(left, leaf);
+            removeChild(parent, i - 1);
+        } else {
+            mergeLeaves(leaf, right);
+            removeChild(parent, i);
+        }
+        rebalanceInner(path, 1);
+        return normalized(pos.leaf, pos.index);
+    }
+
+    void mergeLeaves(Leaf *into, Leaf *from) noexcept
+    {
+        Q_ASSERT(into->next == from);
+        Q_ASSERT(into->count + from->count <= Leaf::Capacity);
+        QtPrivate::q_uninitialized_relocate_n(from->keys(), from->count, into->keys() + into->count);
+        QtPrivate::q_uninitialized_relocate_n(from->values(), from->count, into->values() + into->count);
+        into->count += from->count;
+        from->count = 0;
+        into->next = from->next;
+        (from->next ? from->next->prev : last) = into;
+        delete from;
+    }
+
+    // Removes keys[k] and children[k + 1] of an inner node.
+    static void removeChild(Inner *inner, int k) noexcept
+    {
+        std::destroy_at(inner->keys() + k);
+        closeGap(inner, k);
+    }
+    // Same, for a keys[k] that has already been moved out.
+    static void closeGap(Inner *inner, int k) noexcept
+    {
+        const int n = inner->count - k - 1;
+        QtPrivate::q_relocate_overlap_n(inner->keys() + k + 1, n, inner->keys() + k);
+        std::memmove(inner->children + k + 1, inner->children + k + 2, n * sizeof(void *));
+        --inner->count;
+    }
+
+    void rebalanceInner(Path &path, int level) noexcept
+    {
+        for (; level < depth; ++level) {
+            Inner *node = path.nodes[level];
+            if (node->count >= Inner::MinCount)
+                return;
+            Inner *parent = path.nodes[level + 1];
+            const int i = path.indexes[level + 1];
+            Inner *left = i > 0 ? static_cast<Inner *>(parent->children[i - 1]) : nullptr;
+            Inner *right = i < parent->count ? static_cast<Inner *>(parent->children[i + 1]) : nullptr;
+
+            if (left && left->count > Inner::MinCount) {
+                // rotate the last child of the left sibling over
+                QtPrivate::q_relocate_overlap_n(node->keys(), node->count, node->keys() + 1);
+                std::memmove(node->children + 1, node->children, (node->count + 1) * sizeof(void *));
+                QtPrivate::q_uninitialized_relocate_n(parent->keys() + i - 1, 1, node->keys());
+                QtPrivate::q_uninitialized_relocate_n(left->keys() + left->count - 1, 1, parent->keys() + i - 1);
+                node->children[0] = left->children[left->count];
+                --left->count;
+                ++node->count;
+                return;
+            }
+            if (right && right->count > Inner::MinCount) {
+                // rotate the first child of the right sibling over
+                QtPrivate::q_uninitialized_relocate_n(parent->keys() + i, 1, node->keys() + node->count);
+                node->children[node->count + 1] = right->children[0];
+                ++node->count;
+                QtPrivate::q_uninitialized_relocate_n(right->keys(), 1, parent->keys() + i);
+                --right->count;
+                QtPrivate::q_relocate_overlap_n(right->keys() + 1, right->count, right->keys());
+                std::memmove(right->children, right->children + 1, (right->count + 1) * sizeof(void *));
+                return;
+            }
+
+            if (left)
+                mergeInner(parent, i - 1);
+            else
+                mergeInner(parent, i);
+        }
+
+        Inner *top = static_cast<Inner *>(root);
+        if (top->count == 0) {
+            // the root has a single child left: the tree shrinks by one level
+            root = top->children[0];
+            delete top;
+            --depth;
+        }
+    }
+
+    // Merges children[k + 1] of parent into children[k], pulling down the
+    // separator between them.
+    static void mergeInner(Inner *parent, int k) noexcept
+    {
+        Inner *into = static_cast<Inner *>(parent->children[k]);
+        Inner *from = static_cast<Inner *>(parent->children[k + 1]);
+        Q_ASSERT(into->count + 1 + from->count <= Inner::Capacity);
+        QtPrivate::q_uninitialized_relocate_n(parent->keys() + k, 1, into->keys() + into->count);
+        QtPrivate::q_uninitialized_relocate_n(from->keys(), from->count, into->keys() + into->count + 1);
+        std::memcpy(into->children + into->count + 1, from->children, (from->count + 1) * sizeof(void *));
+        into->count += 1 + from->count;
+        from->count = 0;
+        delete from;
+        closeGap(parent, k);
+    }
+};
+
+template <typename Key, typename T>
+struct iterator
+{
+    using Data = QBTreeMapPrivate::Data<Key, T>;
+    using Leaf = typename Data::Leaf;
+
+    const Data *d = nullptr;
+    Leaf *leaf = nullptr;
+    int index = 0;
+
+    constexpr iterator() noexcept = default;
+    iterator(const Data *data, typename Data::Position pos) noexcept
+        : d(data), leaf(pos.leaf), index(pos.index)
+    {}
+
+    bool atEnd() const noexcept { return !leaf; }
+    Key &key() const noexcept { return leaf->keys()[index]; }
+    T &value() const noexcept { return leaf->values()[index]; }
+
+    iterator &operator++() noexcept
+    {
+        if (++index == leaf->count) {
+            leaf = leaf->next;
+            index = 0;
+        }
+        return *this;
+    }
+    iterator &operator--() noexcept
+    {
+        if (!leaf) {
+            leaf = d->last;
+            index = leaf->count - 1;
+        } else if (index == 0) {
+            leaf = leaf->prev;
+            index = leaf->count - 1;
+        } else {
+            --index;
+        }
+        return *this;
+    }
+    bool operator==(iterator other) const noexcept
+    { return leaf == other.leaf && index == other.index; }
+    bool operator!=(iterator other) const noexcept
+    { return !(*this == other); }
+};
+
+} // namespace QBTreeMapPrivate
+
+template <class Key, class T>
+class QBTreeMap
+{
+    using Data = QBTreeMapPrivate::Data<Key, T>;
+    friend tst_QBTreeMap;
+
+    Data *d = nullptr;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using difference_type = qptrdiff;
+    using size_type = qsizetype;
+
+    QBTreeMap() noexcept = default;
+    QBTreeMap(std::initializer_list<std::pair<Key, T>> list)
+    {
+        for (auto &p : list)
+            insert(p.first, p.second);
+    }
+    explicit QBTreeMap(const QMap<Key, T> &map)
+    {
+        for (auto it = map.cbegin(), end = map.cend(); it != end; ++it)
+            insert(it.key(), it.value());
+    }
+    QBTreeMap(const QBTreeMap &other) noexcept
+        : d(other.d)
+    {
+        if (d)
+            d->ref.ref();
+    }
+    ~QBTreeMap()
+    {
+        static_assert(std::is_nothrow_destructible_v<Key>, "Types with throwing destructors are not supported in Qt containers.");
+        static_assert(std::is_nothrow_destructible_v<T>, "Types with throwing destructors are not supported in Qt containers.");
+
+        if (d && !d->ref.deref())
+            delete d;
+    }
+
+    QBTreeMap &operator=(const QBTreeMap &other) noexcept
+    {
+        if (d != other.d) {
+            Data *o = other.d;
+            if (o)
+                o->ref.ref();
+            if (d && !d->ref.deref())
+                delete d;
+            d = o;
+        }
+        return *this;
+    }
+
+    QBTreeMap(QBTreeMap &&other) noexcept
+        : d(std::exchange(other.d, nullptr))
+    {
+    }
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_MOVE_AND_SWAP(QBTreeMap)
+
+    void swap(QBTreeMap &other) noexcept { qt_ptr_swap(d, other.d); }
+
+    QMap<Key, T> toMap() const
+    {
+        QMap<Key, T> map;
+        for (auto it = begin(), e = end(); it != e; ++it)
+            map.insert(map.cend(), it.key(), it.value());
+        return map;
+    }
+
+#ifndef Q_CLANG_QDOC
+    template <typename AKey = Key, typename AT = T> friend
+    QTypeTraits::compare_eq_result_container<QBTreeMap, AKey, AT> operator==(const QBTreeMap &lhs, const QBTreeMap &rhs)
+    {
+        if (lhs.d == rhs.d)
+            return true;
+        if (lhs.size() != rhs.size())
+            return false;
+        for (auto l = lhs.begin(), r = rhs.begin(), e = lhs.end(); l != e; ++l, ++r) {
+            if (!(l.key() == r.key()) || !(l.value() == r.value()))
+                return false;
+        }
+        return true;
+    }
+
+    template <typename AKey = Key, typename AT = T> friend
+    QTypeTraits::compare_eq_result_container<QBTreeMap, AKey, AT> operator!=(const QBTreeMap &lhs, const QBTreeMap &rhs)
+    {
+        return !(lhs == rhs);
+    }
+#else
+    friend bool operator==(const QBTreeMap &lhs, const QBTreeMap &rhs);
+    friend bool operator!=(const QBTreeMap &lhs, const QBTreeMap &rhs);
+#endif // Q_CLANG_QDOC
+
+    size_type size() const noexcept { return d ? size_type(d->size) : size_type(0); }
+
+    bool isEmpty() const noexcept { return !d || d->size == 0; }
+
+    void detach()
+    {
+        if (!d || d->ref.isShared())
+            d = Data::detached(d);
+    }
+
+    bool isDetached() const noexcept
+    {
+        return d && !d->ref.isShared();
+    }
+
+    bool isSharedWith(const QBTreeMap &other) const noexcept
+    {
+        return d == other.d;
+    }
+
+    void clear()
+    {
+        if (d && !d->ref.deref())
+            delete d;
+        d = nullptr;
+    }
+
+    size_type remove(const Key &key)
+    {
+        if (!d || !d->find(key).leaf) // prevents detaching a map without key
+            return 0;
+        const auto copy = d->ref.isShared() ? *this : QBTreeMap(); // keep 'key' alive across the detach
+        detach();
+        return d->erase(key) ? 1 : 0;
+    }
+
+    template <typename Predicate>
+    size_type removeIf(Predicate pred)
+    {
+        return QtPrivate::associative_erase_if(*this, pred);
+    }
+
+    T take(const Key &key)
+    {
+        if (!d || !d->find(key).leaf)
+            return T();
+        const auto copy = d->ref.isShared() ? *this : QBTreeMap(); // keep 'key' alive across the detach
+        detach();
+        const auto pos = d->find(key);
+        T result = std::move(pos.leaf->values()[pos.index]);
+        d->erase(key);
+        return result;
+    }
+
+    bool contains(const Key &key) const
+    {
+        return d && d->find(key).leaf;
+    }
+
+    Key key(const T &value, const Key &defaultKey = Key()) const
+    {
+        for (auto it = begin(), e = end(); it != e; ++it) {
+            if (it.value() == value)
+                return it.key();
+        }
+        return defaultKey;
+    }
+
+    T value(const Key &key, const T &defaultValue = T()) const
+    {
+        if (!d)
+            return defaultValue;
+        const auto pos = d->find(key);
+        if (pos.leaf)
+            return pos.leaf->values()[pos.index];
+        return defaultValue;
+    }
+
+    T &operator[](const Key &key)
+    {
+        const auto copy = isDetached() ? QBTreeMap() : *this; // keep 'key' alive across the detach
+        detach();
+        typename Data::Path path;
+        bool found;
+        auto pos = d->findForInsert(key, path, &found);
+        if (!found)
+            pos = d->insert(path, pos, Key(key), T());
+        return pos.leaf->values()[pos.index];
+    }
+
+    T operator[](const Key &key) const
+    {
+        return value(key);
+    }
+
+    QList<Key> keys() const
+    {
+        return QList<Key>(keyBegin(), keyEnd());
+    }
+
+    QList<Key> keys(const T &value) const
+    {
+        QList<Key> result;
+        for (auto it = begin(), e = end(); it != e; ++it) {
+            if (it.value() == value)
+                result.append(it.key());
+        }
+        return result;
+    }
+
+    QList<T> values() const
+    {
+        return QList<T>(begin(), end());
+    }
+
+    size_type count(const Key &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    size_type count() const
+    {
+        return size();
+    }
+
+    inline const Key &firstKey() const { Q_ASSERT(!isEmpty()); return constBegin().key(); }
+    inline const Key &lastKey() const { Q_ASSERT(!isEmpty()); return (--constEnd()).key(); }
+
+    inline T &first() { Q_ASSERT(!isEmpty()); return *begin(); }
+    inline const T &first() const { Q_ASSERT(!isEmpty()); return *constBegin(); }
+    inline T &last() { Q_ASSERT(!isEmpty()); return *(--end()); }
+    inline const T &last() const { Q_ASSERT(!isEmpty()); return *(--constEnd()); }
+
+    class const_iterator;
+
+    class iterator
+    {
+        using piter = QBTreeMapPrivate::iterator<Key, T>;
+        friend class const_iterator;
+        friend class QBTreeMap<Key, T>;
+        piter i;
+        explicit iterator(piter it) noexcept : i(it) { }
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = qptrdiff;
+        using value_type = T;
+        using pointer = T *;
+        using reference = T &;
+
+        constexpr iterator() noexcept = default;
+
+        const Key &key() const noexcept { return i.key(); }
+        T &value() const noexcept { return i.value(); }
+        T &operator*() const noexcept { return i.value(); }
+        T *operator->() const noexcept { return &i.value(); }
+        friend bool operator==(const iterator &lhs, const iterator &rhs) noexcept { return lhs.i == rhs.i; }
+        friend bool operator!=(const iterator &lhs, const iterator &rhs) noexcept { return lhs.i != rhs.i; }
+
+        iterator &operator++() noexcept
+        {
+            ++i;
+            return *this;
+        }
+        iterator operator++(int) noexcept
+        {
+            iterator r = *this;
+            ++i;
+            return r;
+        }
+        iterator &operator--() noexcept
+        {
+            --i;
+            return *this;
+        }
+        iterator operator--(int) noexcept
+        {
+            iterator r = *this;
+            --i;
+            return r;
+        }
+    };
+
+    class const_iterator
+    {
+        using piter = QBTreeMapPrivate::iterator<Key, T>;
+        friend class QBTreeMap<Key, T>;
+        piter i;
+        explicit const_iterator(piter it) noexcept : i(it) { }
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = qptrdiff;
+        using value_type = T;
+        using pointer = const T *;
+        using reference = const T &;
+
+        constexpr const_iterator() noexcept = default;
+        Q_IMPLICIT const_iterator(const iterator &o) noexcept : i(o.i) { }
+
+        const Key &key() const noexcept { return i.key(); }
+        const T &value() const noexcept { return i.value(); }
+        const T &operator*() const noexcept { return i.value(); }
+        const T *operator->() const noexcept { return &i.value(); }
+        friend bool operator==(const const_iterator &lhs, const const_iterator &rhs) noexcept { return lhs.i == rhs.i; }
+        friend bool operator!=(const const_iterator &lhs, const const_iterator &rhs) noexcept { return lhs.i != rhs.i; }
+
+        const_iterator &operator++() noexcept
+        {
+            ++i;
+            return *this;
+        }
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator r = *this;
+            ++i;
+            return r;
+        }
+        const_iterator &operator--() noexcept
+        {
+            --i;
+            return *this;
+        }
+        const_iterator operator--(int) noexcept
+        {
+            const_iterator r = *this;
+            --i;
+            return r;
+        }
+    };
+
+    class key_iterator
+    {
+        const_iterator i;
+
+    public:
+        typedef typename const_iterator::iterator_category iterator_category;
+        typedef typename const_iterator::difference_type difference_type;
+        typedef Key value_type;
+        typedef const Key *pointer;
+        typedef const Key &reference;
+
+        key_iterator() = default;
+        explicit key_iterator(const_iterator o) : i(o) { }
+
+        const Key &operator*() const { return i.key(); }
+        const Key *operator->() const { return &i.key(); }
+        bool operator==(key_iterator o) const { return i == o.i; }
+        bool operator!=(key_iterator o) const { return i != o.i; }
+
+        inline key_iterator &operator++() { ++i; return *this; }
+        inline key_iterator operator++(int) { return key_iterator(i++);}
+        inline key_iterator &operator--() { --i; return *this; }
+        inline key_iterator operator--(int) { return key_iterator(i--); }
+        const_iterator base() const { return i; }
+    };
+
+    typedef QKeyValueIterator<const Key&, const T&, const_iterator> const_key_value_iterator;
+    typedef QKeyValueIterator<const Key&, T&, iterator> key_value_iterator;
+
+    // STL style
+    iterator begin() { detach(); return iterator({ d, d->begin() }); }
+    const_iterator begin() const noexcept { if (!d) return const_iterator(); return const_iterator({ d, d->begin() }); }
+    const_iterator constBegin() const noexcept { return begin(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() { detach(); return iterator({ d, {} }); }
+    const_iterator end() const noexcept { return const_iterator({ d, {} }); }
+    const_iterator constEnd() const noexcept { return end(); }
+    const_iterator cend() const noexcept { return end(); }
+    key_iterator keyBegin() const noexcept { return key_iterator(begin()); }
+    key_iterator keyEnd() const noexcept { return key_iterator(end()); }
+    key_value_iterator keyValueBegin() { return key_value_iterator(begin()); }
+    key_value_iterator keyValueEnd() { return key_value_iterator(end()); }
+    const_key_value_iterator keyValueBegin() const noexcept { return const_key_value_iterator(begin()); }
+    const_key_value_iterator constKeyValueBegin() const noexcept { return const_key_value_iterator(begin()); }
+    const_key_value_iterator keyValueEnd() const noexcept { return const_key_value_iterator(end()); }
+    const_key_value_iterator constKeyValueEnd() const noexcept { return const_key_value_iterator(end()); }
+    auto asKeyValueRange() & { return QtPrivate::QKeyValueRange(*this); }
+    auto asKeyValueRange() const & { return QtPrivate::QKeyValueRange(*this); }
+    auto asKeyValueRange() && { return QtPrivate::QKeyValueRange(std::move(*this)); }
+    auto asKeyValueRange() const && { return QtPrivate::QKeyValueRange(std::move(*this)); }
+
+    iterator erase(const_iterator it)
+    {
+        Q_ASSERT(it != constEnd());
+        const auto copy = d->ref.isShared() ? *this : QBTreeMap(); // keep 'it' valid across the detach
+        detach();
+        typename Data::Position next;
+        d->erase(it.key(), &next);
+        return iterator({ d, next });
+    }
+
+    iterator erase(const_iterator afirst, const_iterator alast)
+    {
+        if (afirst == alast)
+            return afirst == constEnd() ? end() : find(afirst.key());
+        const auto n = std::distance(afirst, alast);
+        iterator it = erase(afirst);
+        for (auto i = n - 1; i > 0; --i)
+            it = erase(it);
+        return it;
+    }
+
+    // more Qt
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+
+    iterator find(const Key &key)
+    {
+        const auto copy = isDetached() ? QBTreeMap() : *this; // keep 'key' alive across the detach
+        detach();
+        return iterator({ d, d->find(key) });
+    }
+
+    const_iterator find(const Key &key) const
+    {
+        if (!d)
+            return const_iterator();
+        return const_iterator({ d, d->find(key) });
+    }
+
+    const_iterator constFind(const Key &key) const
+    {
+        return find(key);
+    }
+
+    iterator lowerBound(const Key &key)
+    {
+        const auto copy = isDetached() ? QBTreeMap() : *this; // keep 'key' alive across the detach
+        detach();
+        return iterator({ d, d->lowerBound(key) });
+    }
+
+    const_iterator lowerBound(const Key &key) const
+    {
+        if (!d)
+            return const_iterator();
+        return const_iterator({ d, d->lowerBound(key) });
+    }
+
+    iterator upperBound(const Key &key)
+    {
+        const auto copy = isDetached() ? QBTreeMap() : *this; // keep 'key' alive across the detach
+        detach();
+        return iterator({ d, d->upperBound(key) });
+    }
+
+    const_iterator upperBound(const Key &key) const
+    {
+        if (!d)
+            return const_iterator();
+        return const_iterator({ d, d->upperBound(key) });
+    }
+
+    iterator insert(const Key &key, const T &value)
+    {
+        return emplace(key, value);
+    }
+
+    void insert(const QBTreeMap &map)
+    {
+        if (map.isEmpty() || map.d == d)
+            return;
+        if (isEmpty()) {
+            *this = map;
+            return;
+        }
+        detach();
+        for (auto it = map.begin(), e = map.end(); it != e; ++it)
+            emplace(it.key(), it.value());
+    }
+
+    template <typename ...Args>
+    iterator emplace(const Key &key, Args &&... args)
+    {
+        Key copy = key;
+        return emplace(std::move(copy), std::forward<Args>(args)...);
+    }
+
+    template <typename ...Args>
+    iterator emplace(Key &&key, Args &&... args)
+    {
+        const auto copy = isDetached() ? QBTreeMap() : *this; // keep 'args' alive across the detach
+        detach();
+        typename Data::Path path;
+        bool found;
+        auto pos = d->findForInsert(key, path, &found);
+        if (found)
+            pos.leaf->values()[pos.index] = T(std::forward<Args>(args)...);
+        else
+            pos = d->insert(path, pos, std::move(key), T(std::forward<Args>(args)...));
+        return iterator({ d, pos });
+    }
+
+    // STL compatibility
+    inline bool empty() const noexcept
+    {
+        return isEmpty();
+    }
+
+    QPair<iterator, iterator> equal_range(const Key &akey)
+    {
+        const auto copy = isDetached() ? QBTreeMap() : *this; // keep 'akey' alive across the detach
+        detach();
+        const auto pos = d->find(akey);
+        if (!pos.leaf)
+            return { end(), end() };
+        iterator it({ d, pos });
+        return { it, std::next(it) };
+    }
+
+    QPair<const_iterator, const_iterator> equal_range(const Key &akey) const
+    {
+        const auto it = find(akey);
+        if (it == end())
+            return { it, it };
+        return { it, std::next(it) };
+    }
+};
+
+template <typename Key, typename T, typename Predicate>
+qsizetype erase_if(QBTreeMap<Key, T> &map, Predicate pred)
+{
+    return QtPrivate::associative_erase_if(map, pred);
+}
+
+QT_END_NAMESPACE
+
+#endif // QBTREEMAP_H
@@ -0,0 +1,343 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qconcurrenthash.h"
+
+#include <private/qlocking_p.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+ * Epoch-based reclamation, as used by QConcurrentHash:
+ *
+ * A global epoch counter only ever grows. A thread that is about to read
+ * shared nodes announces the current epoch in its participant record, and
+ * clears it when it is done; this is what EpochGuard does. Memory that a
+ * writer unlinked is not freed right away, but retired: it is put on the
+ * limbo list of the thread, tagged with the epoch at that time.
+ *
+ * The epoch can only advance from E to E + 1 once every thread that is
+ * reading has announced E. When the epoch reaches E + 2, no reader can
+ * have announced an epoch before E + 1 anymore, and all readers that
+ * announced E + 1 or later started after everything retired in E had
+ * been unlinked. Memory retired in E is then freed.
+ *
+ * The announcement and the unlinking are both followed by a sequentially
+ * consistent fence before the epoch is read, so a reader that announced
+ * an epoch too late to stop it from advancing sees the newer one, and
+ * announces that instead.
+ *
+ * Participant records are never freed: a thread that exits gives its
+ * record back for reuse, and its limbo list to a global list of orphans,
+ * which threads that retire memory collect from time to time.
+ */
+
+namespace QConcurrentHashPrivate {
+
+namespace {
+struct Retired
+{
+    void *object;
+    void (*deleter)(void *);
+    quint64 epoch;
+};
+
+struct alignas(64) Participant
+{
+    QAtomicInteger<quint64> epoch = 0; // 0 while not reading
+    QAtomicInt inUse = 0;
+    Participant *next = nullptr; // in the registry
+
+    // only used by the thread that owns the record
+    int nesting = 0;
+    std::vector<Retired> limbo;
+    size_t collectAt = 0;
+};
+
+enum class ThreadState : quint8 {
+    Uninitialized,
+    Running,
+    Finished
+};
+
+struct Orphans
+{
+    QBasicMutex mutex;
+    std::vector<Retired> retired;
+};
+
+// Every this many retired objects, a thread tries to advance the epoch.
+constexpr size_t CollectInterval = 64;
+
+Q_CONSTINIT static QBasicAtomicInteger<quint64> globalEpoch = Q_BASIC_ATOMIC_INITIALIZER(1);
+Q_CONSTINIT static QBasicAtomicPointer<Participant> registry = Q_BASIC_ATOMIC_INITIALIZER(nullptr);
+Q_CONSTINIT static QBasicAtomicInt orphanCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+Q_GLOBAL_STATIC(Orphans, orphans)
+
+// Trivially destructible, so they remain usable while other thread_local
+// objects are being destroyed at thread exit.
+Q_CONSTINIT static thread_local Participant *currentParticipant = nullptr;
+Q_CONSTINIT static thread_local ThreadState threadState = ThreadState::Uninitialized;
+} // unnamed namespace
+
+static void releaseParticipant(Participant *p);
+
+namespace {
+struct ParticipantCleanup
+{
+    bool active = false;
+
+    ~ParticipantCleanup()
+    {
+        threadState = ThreadState::Finished;
+        if (Participant *p = std::exchange(currentParticipant, nullptr))
+            releaseParticipant(p);
+    }
+};
+
+static thread_local ParticipantCleanup participantCleanup;
+} // unnamed namespace
+
+static Participant *acquireParticipant()
+{
+    if (threadState == ThreadState::Uninitialized) {
+        // registers the destructor of the cleanup object
+        participantCleanup.active = true;
+        threadState = ThreadState::Running;
+    }
+
+    Participant *p = registry.loadAcquire();
+    for (; p; p = p->next) {
+        if (p->inUse.loadRelaxed() == 0 && p->inUse.testAndSetAcquire(0, 1))
+            break;
+    }
+    if (!p) {
+        p = new Participant;
+        p->inUse.storeRelaxed(1);
+        Participant *head = registry.loadRelaxed();
+        do {
+            p->next = head;
+        } while (!registry.testAndSetRelease(head, p, head));
+    }
+    currentParticipant = p;
+    return p;
+}
+
+// Advances the global epoch if all threads that are reading have
+// announced the current one. Returns the epoch.
+static quint64 tryAdvance() noexcept
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const quint64 epoch = globalEpoch.loadRelaxed();
+    for (Participant *p = registry.loadAcquire(); p; p = p->next) {
+        const quint64 e = p->epoch.loadAcquire();
+        if (e && e != epoch)
+            return epoch;
+    }
+    if (globalEpoch.testAndSetOrdered(epoch, epoch + 1))
+        return epoch + 1;
+    return globalEpoch.loadAcquire();
+}
+
+// Removes the objects that were retired at least two epochs ago from the
+// list, and returns them.
+static std::vector<Retired> takeExpired(std::vector<Retired> &list, quint64 epoch)
+{
+    const auto mid = std::partition(list.begin(), list.end(), [epoch](const Retired &r) {
+        return r.epoch + 2 <= epoch;
+    });
+    std::vector<Retired> expired(list.begin(), mid);
+    list.erase(list.begin(), mid);
+    return expired;
+}
+
+// The deleters may retire more objects, so they run after the lists
+// they came from are consistent again, and unlocked.
+static void freeAll(const std::vector<Retired> &expired) noexcept
+{
+    for (const Retired &r : expired)
+        r.deleter(r.object);
+}
+
+static void collectOrphans(quint64 epoch)
+{
+    if (orphanCount.loadRelaxed() == 0 || orphans.isDestroyed())
+        return;
+    Orphans *o = orphans();
+    std::vector<Retired> expired;
+    {
+        std::unique_lock<QBasicMutex> locker(o->mutex, std::try_to_lock);
+        if (!locker.owns_lock())
+            return;
+        expired = takeExpired(o->retired, epoch);
+        orphanCount.storeRelaxed(int(o->retired.size()));
+    }
+    freeAll(expired);
+}
+
+static void collect(Participant *p)
+{
+    const quint64 epoch = tryAdvance();
+    freeAll(takeExpired(p->limbo, epoch));
+    collectOrphans(epoch);
+    p->collectAt = p->limbo.size() + CollectInterval;
+}
+
+static void releaseParticipant(Participant *p)
+{
+    Q_ASSERT(p->nesting == 0);
+    // Advancing twice frees everything, unless other threads are reading.
+    if (!p->limbo.empty()) {
+        tryAdvance();
+        freeAll(takeExpired(p->limbo, tryAdvance()));
+    }
+    if (!p->limbo.empty()) {
+        if (orphans.isDestroyed()) {
+            // the process is exiting: leak what other threads may still read
+            p->limbo.clear();
+        } else {
+            Orphans *o = orphans();
+            const auto locker = qt_scoped_lock(o->mutex);
+            o->retired.insert(o->retired.end(), p->limbo.begin(), p->limbo.end());
+            orphanCount.storeRelaxed(int(o->retired.size()));
+            p->limbo.clear();
+        }
+    }
+    p->collectAt = 0;
+    p->inUse.storeRelease(0);
+}
+
+/*!
+    \internal
+
+    Starts a section in which the calling thread reads nodes that other
+    threads may unlink and retire concurrently. Sections nest.
+*/
+void enterEpoch()
+{
+    Participant *p = currentParticipant;
+    if (!p)
+        p = acquireParticipant();
+    if (p->nesting++)
+        return;
+
+    quint64 epoch = globalEpoch.loadRelaxed();
+    for (;;) {
+        p->epoch.storeRelaxed(epoch);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const quint64 current = globalEpoch.loadRelaxed();
+        if (current == epoch)
+            break;
+        epoch = current;
+    }
+}
+
+/*!
+    \internal
+
+    Ends the section started by the matching call to enterEpoch().
+*/
+void leaveEpoch() noexcept
+{
+    Participant *p = currentParticipant;
+    Q_ASSERT(p && p->nesting > 0);
+    if (--p->nesting)
+        return;
+    p->epoch.storeRelease(0);
+
+    // a thread_local destructor read after the cleanup of this thread
+    if (Q_UNLIKELY(threadState == ThreadState::Finished)) {
+        currentParticipant = nullptr;
+        releaseParticipant(p);
+    }
+}
+
+/*!
+    \internal
+
+    Frees \a object with \a deleter once no thread can be reading it
+    anymore. The object must already be unreachable for new readers.
+*/
+void retire(void *object, void (*deleter)(void *))
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const quint64 epoch = globalEpoch.loadRelaxed();
+
+    if (Q_UNLIKELY(threadState == ThreadState::Finished) && !currentParticipant) {
+        if (orphans.isDestroyed())
+            return; // the process is exiting: leak what other threads may still read
+        Orphans *o = orphans();
+        const auto locker = qt_scoped_lock(o->mutex);
+        o->retired.push_back({ object, deleter, epoch });
+        orphanCount.storeRelaxed(int(o->retired.size()));
+        return;
+    }
+
+    Participant *p = currentParticipant;
+    if (!p)
+        p = acquireParticipant();
+    p->limbo.push_back({ object, deleter, epoch });
+    if (p->limbo.size() >= p->collectAt)
+        collect(p);
+}
+
+/*!
+    \internal
+
+    Frees all retired objects that no thread can be reading anymore. Used
+    by the tests.
+*/
+void reclaimRetired()
+{
+    Participant *p = currentParticipant;
+    if (!p)
+        p = acquireParticipant();
+    tryAdvance();
+    tryAdvance();
+    collect(p);
+}
+
+} // namespace QConcurrentHashPrivate
+
+QT_END_NAMESPACE
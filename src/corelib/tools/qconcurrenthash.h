@@ -0,0 +1,409 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QCONCURRENTHASH_H
+#define QCONCURRENTHASH_H
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmath.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qscopeguard.h>
+
+#include <initializer_list>
+#include <memory>
+
+class tst_QConcurrentHash; // for befriending
+
+QT_BEGIN_NAMESPACE
+
+namespace QConcurrentHashPrivate {
+
+// Epoch-based reclamation of the memory that lock-free readers may still
+// be looking at; see qconcurrenthash.cpp.
+Q_CORE_EXPORT void enterEpoch();
+Q_CORE_EXPORT void leaveEpoch() noexcept;
+Q_CORE_EXPORT void retire(void *object, void (*deleter)(void *));
+Q_CORE_EXPORT void reclaimRetired();
+
+struct EpochGuard
+{
+    Q_DISABLE_COPY_MOVE(EpochGuard)
+    EpochGuard() { enterEpoch(); }
+    ~EpochGuard() { leaveEpoch(); }
+};
+
+// Nodes are never modified once they can be seen by readers, except for
+// their link to the next node. A new value replaces the whole node.
+template <typename Key, typename T>
+struct Node
+{
+    QAtomicPointer<Node> next;
+    const size_t hash;
+    const Key key;
+    const T value;
+
+    template <typename K, typename V>
+    Node(Node *n, size_t h, K &&k, V &&v)
+        : next(n), hash(h), key(std::forward<K>(k)), value(std::forward<V>(v))
+    {}
+
+    static void destroy(void *node) noexcept { delete static_cast<Node *>(node); }
+};
+
+template <typename Key, typename T>
+struct Table
+{
+    using Node = QConcurrentHashPrivate::Node<Key, T>;
+
+    const size_t mask;
+    const std::unique_ptr<QAtomicPointer<Node>[]> buckets;
+
+    explicit Table(size_t bucketCount)
+        : mask(bucketCount - 1), buckets(new QAtomicPointer<Node>[bucketCount])
+    {}
+    Q_DISABLE_COPY_MOVE(Table)
+    ~Table()
+    {
+        for (size_t i = 0; i <= mask; ++i) {
+            Node *n = buckets[i].loadRelaxed();
+            while (n) {
+                Node *next = n->next.loadRelaxed();
+                delete n;
+                n = next;
+            }
+        }
+    }
+
+    size_t bucketCount() const noexcept { return mask + 1; }
+    QAtomicPointer<Node> &bucket(size_t hash) const noexcept { return buckets[hash & mask]; }
+
+    static void destroy(void *table) noexcept { delete static_cast<Table *>(table); }
+};
+
+} // namespace QConcurrentHashPrivate
+
+template <typename Key, typename T>
+class QConcurrentHash
+{
+    using Node = QConcurrentHashPrivate::Node<Key, T>;
+    using Table = QConcurrentHashPrivate::Table<Key, T>;
+    friend tst_QConcurrentHash;
+
+    // Writers lock the stripe of the hash of the key. Every bucket belongs
+    // to a single stripe, since there are always at least as many buckets,
+    // and resizing the table locks all of them.
+    static constexpr int StripeCount = 64;
+    static constexpr size_t MinBuckets = StripeCount;
+
+    struct alignas(64) Stripe
+    {
+        QBasicMutex mutex;
+        QAtomicInteger<qsizetype> size = 0; // only modified with mutex locked
+    };
+
+    QAtomicPointer<Table> d;
+    Stripe stripes[StripeCount];
+    const size_t seed = QHashSeed::globalSeed();
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using size_type = qsizetype;
+
+    QConcurrentHash()
+        : d(new Table(MinBuckets))
+    {}
+    QConcurrentHash(std::initializer_list<std::pair<Key, T>> list)
+        : QConcurrentHash()
+    {
+        reserve(qsizetype(list.size()));
+        for (const auto &p : list)
+            insert(p.first, p.second);
+    }
+    explicit QConcurrentHash(const QHash<Key, T> &hash)
+        : QConcurrentHash()
+    {
+        reserve(hash.size());
+        for (auto it = hash.cbegin(), end = hash.cend(); it != end; ++it)
+            insert(it.key(), it.value());
+    }
+    Q_DISABLE_COPY_MOVE(QConcurrentHash)
+    ~QConcurrentHash()
+    {
+        static_assert(std::is_nothrow_destructible_v<Key>, "Types with throwing destructors are not supported in Qt containers.");
+        static_assert(std::is_nothrow_destructible_v<T>, "Types with throwing destructors are not supported in Qt containers.");
+        delete d.loadRelaxed();
+    }
+
+    qsizetype size() const noexcept
+    {
+        qsizetype n = 0;
+        for (const Stripe &stripe : stripes)
+            n += stripe.size.loadRelaxed();
+        return n;
+    }
+    qsizetype count() const noexcept { return size(); }
+    bool isEmpty() const noexcept { return size() == 0; }
+    bool empty() const noexcept { return isEmpty(); }
+
+    bool contains(const Key &key) const
+    {
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
+        QConcurrentHashPrivate::EpochGuard guard;
+        return findNode(d.loadAcquire(), key, hash) != nullptr;
+    }
+    qsizetype count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+    T value(const Key &key) const
+    {
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
+        QConcurrentHashPrivate::EpochGuard guard;
+        if (const Node *n = findNode(d.loadAcquire(), key, hash))
+            return n->value;
+        return T();
+    }
+    T value(const Key &key, const T &defaultValue) const
+    {
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
+        QConcurrentHashPrivate::EpochGuard guard;
+        if (const Node *n = findNode(d.loadAcquire(), key, hash))
+            return n->value;
+        return defaultValue;
+    }
+    T operator[](const Key &key) const { return value(key); }
+
+    void insert(const Key &key, const T &value) { emplaceImpl(true, key, value); }
+    bool tryInsert(const Key &key, const T &value) { return emplaceImpl(false, key, value); }
+    template <typename ...Args>
+    void emplace(const Key &key, Args &&... args) { emplaceImpl(true, key, T(std::forward<Args>(args)...)); }
+    template <typename ...Args>
+    void emplace(Key &&key, Args &&... args) { emplaceImpl(true, std::move(key), T(std::forward<Args>(args)...)); }
+    template <typename ...Args>
+    bool tryEmplace(const Key &key, Args &&... args) { return emplaceImpl(false, key, T(std::forward<Args>(args)...)); }
+
+    bool remove(const Key &key)
+    {
+        Node *removed = unlink(key);
+        if (!removed)
+            return false;
+        QConcurrentHashPrivate::retire(removed, &Node::destroy);
+        return true;
+    }
+
+    T take(const Key &key)
+    {
+        Node *removed = unlink(key);
+        if (!removed)
+            return T();
+        // other threads may still be reading the node
+        T t = removed->value;
+        QConcurrentHashPrivate::retire(removed, &Node::destroy);
+        return t;
+    }
+
+    void clear()
+    {
+        Table *fresh = new Table(MinBuckets);
+        lockAll();
+        Table *old = d.loadRelaxed();
+        d.storeRelease(fresh);
+        for (Stripe &stripe : stripes)
+            stripe.size.storeRelaxed(0);
+        unlockAll();
+        QConcurrentHashPrivate::retire(old, &Table::destroy);
+    }
+
+    void reserve(qsizetype size)
+    {
+        rehash(nullptr, bucketsFor(size));
+    }
+
+    QList<Key> keys() const
+    {
+        QList<Key> result;
+        forEachNode([&result](const Node *n) { result.append(n->key); });
+        return result;
+    }
+    QList<T> values() const
+    {
+        QList<T> result;
+        forEachNode([&result](const Node *n) { result.append(n->value); });
+        return result;
+    }
+    QHash<Key, T> toHash() const
+    {
+        QHash<Key, T> result;
+        forEachNode([&result](const Node *n) { result.insert(n->key, n->value); });
+        return result;
+    }
+
+private:
+    static size_t bucketsFor(qsizetype size) noexcept
+    {
+        return qMax(MinBuckets, size_t(qNextPowerOfTwo(quint64(qMax(size, qsizetype(1)) - 1))));
+    }
+
+    static const Node *findNode(const Table *t, const Key &key, size_t hash) noexcept
+    {
+        for (const Node *n = t->bucket(hash).loadAcquire(); n; n = n->next.loadAcquire()) {
+            if (n->hash == hash && n->key == key)
+                return n;
+        }
+        return nullptr;
+    }
+
+    Stripe &stripeFor(size_t hash) noexcept { return stripes[hash & (StripeCount - 1)]; }
+
+    // Inserts a node, or replaces the one with the same key if replace is
+    // true. Returns whether a node was added.
+    template <typename K, typename V>
+    bool emplaceImpl(bool replace, K &&key, V &&value)
+    {
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
+        Stripe &stripe = stripeFor(hash);
+        Node *replaced = nullptr;
+        Table *grow = nullptr;
+        {
+            QMutexLocker locker(&stripe.mutex);
+            // resizing needs all stripe locks, so the table is stable here
+            Table *t = d.loadAcquire();
+            QAtomicPointer<Node> *link = &t->bucket(hash);
+            Node *n = link->loadRelaxed();
+            for (; n; link = &n->next, n = n->next.loadRelaxed()) {
+                if (n->hash == hash && n->key == key)
+                    break;
+            }
+            if (n && !replace)
+                return false;
+            if (n) {
+                // readers that are on the old node still find the rest of
+                // the chain through it
+                Node *fresh = new Node(n->next.loadRelaxed(), hash, std::forward<K>(key), std::forward<V>(value));
+                link->storeRelease(fresh);
+                replaced = n;
+            } else {
+                QAtomicPointer<Node> &head = t->bucket(hash);
+                head.storeRelease(new Node(head.loadRelaxed(), hash, std::forward<K>(key), std::forward<V>(value)));
+                const qsizetype size = stripe.size.loadRelaxed() + 1;
+                stripe.size.storeRelaxed(size);
+                // the load factor of the stripe stands for the whole table
+                if (size_t(size) > t->bucketCount() / StripeCount)
+                    grow = t;
+            }
+        }
+        if (replaced)
+            QConcurrentHashPrivate::retire(replaced, &Node::destroy);
+        if (grow)
+            rehash(grow, grow->bucketCount() * 2);
+        return !replaced;
+    }
+
+    Node *unlink(const Key &key)
+    {
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
+        Stripe &stripe = stripeFor(hash);
+        QMutexLocker locker(&stripe.mutex);
+        QAtomicPointer<Node> *link = &d.loadAcquire()->bucket(hash);
+        for (Node *n = link->loadRelaxed(); n; link = &n->next, n = n->next.loadRelaxed()) {
+            if (n->hash == hash && n->key == key) {
+                // the removed node keeps its link, for the readers on it
+                link->storeRelease(n->next.loadRelaxed());
+                stripe.size.storeRelaxed(stripe.size.loadRelaxed() - 1);
+                return n;
+            }
+        }
+        return nullptr;
+    }
+
+    void lockAll() noexcept
+    {
+        // in order; writers never hold more than one stripe otherwise
+        for (Stripe &stripe : stripes)
+            stripe.mutex.lock();
+    }
+    void unlockAll() noexcept
+    {
+        for (Stripe &stripe : stripes)
+            stripe.mutex.unlock();
+    }
+
+    // Replaces the table with one of at least bucketCount buckets, unless
+    // another thread replaced the expected one already. The nodes are
+    // copied: readers may still be following the links of the old ones.
+    void rehash(const Table *expected, size_t bucketCount)
+    {
+        lockAll();
+        auto unlocker = qScopeGuard([this] { unlockAll(); });
+        Table *old = d.loadRelaxed();
+        if ((expected && old != expected) || old->bucketCount() >= bucketCount)
+            return;
+
+        std::unique_ptr<Table> fresh(new Table(bucketCount));
+        for (size_t i = 0; i <= old->mask; ++i) {
+            for (const Node *n = old->buckets[i].loadRelaxed(); n; n = n->next.loadRelaxed()) {
+                QAtomicPointer<Node> &head = fresh->bucket(n->hash);
+                head.storeRelaxed(new Node(head.loadRelaxed(), n->hash, n->key, n->value));
+            }
+        }
+        d.storeRelease(fresh.release());
+        unlocker.dismiss();
+        unlockAll();
+        QConcurrentHashPrivate::retire(old, &Table::destroy);
+    }
+
+    // Visits every node once. Nodes that are inserted or removed during
+    // the traversal may or may not be visited.
+    template <typename Function>
+    void forEachNode(Function f) const
+    {
+        QConcurrentHashPrivate::EpochGuard guard;
+        const Table *t = d.loadAcquire();
+        for (size_t i = 0; i <= t->mask; ++i) {
+            for (const Node *n = t->buckets[i].loadAcquire(); n; n = n->next.loadAcquire())
+                f(n);
+        }
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QCONCURRENTHASH_H
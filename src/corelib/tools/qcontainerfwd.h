@@ -47,13 +47,19 @@
 
 QT_BEGIN_NAMESPACE
 
+template <typename Key, typename T> class QBTreeMap;
 template <typename Key, typename T> class QCache;
+template <typename Key, typename T> class QConcurrentHash;
+template <typename Key, typename T> class QFlatHash;
+template <typename T> class QFlatHashSet;
 template <typename Key, typename T> class QHash;
 template <typename Key, typename T> class QMap;
 template <typename Key, typename T> class QMultiHash;
 template <typename Key, typename T> class QMultiMap;
 template <typename T1, typename T2>
 using QPair = std::pair<T1, T2>;
+template <typename Key, typename T> class QPersistentHash;
+template <typename T> class QPersistentList;
 template <typename T> class QQueue;
 template <typename T> class QSet;
 template <typename T> class QStack;
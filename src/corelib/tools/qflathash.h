@@ -0,0 +1,1130 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qcontainertools_impl.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qiterator.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+#include <QtCore/qsimd.h>
+
+#include <initializer_list>
+#include <new>
+
+class tst_QFlatHash; // for befriending
+
+QT_BEGIN_NAMESPACE
+
+namespace QFlatHashPrivate {
+
+// Each bucket has a control byte: negative for empty or deleted buckets,
+// or the lowest 7 bits of the hash of the key stored in a full bucket.
+// A group of control bytes is matched against a hash at once.
+enum Ctrl : qint8 {
+    Empty = -128,
+    Deleted = -2
+};
+
+struct BitMask
+{
+    uint mask;
+
+    explicit operator bool() const noexcept { return mask != 0; }
+    uint lowestBitSet() const noexcept { return qCountTrailingZeroBits(mask); }
+    void clearLowestBit() noexcept { mask &= mask - 1; }
+    uint trailingZeros() const noexcept { return qCountTrailingZeroBits(mask); }
+    uint leadingZeros() const noexcept { return qCountLeadingZeroBits(quint16(mask)); }
+};
+
+struct Group
+{
+    static constexpr size_t Width = 16;
+
+#if QT_COMPILER_USES(sse2)
+    __m128i ctrl;
+
+    explicit Group(const qint8 *pos) noexcept
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos)))
+    {}
+
+    BitMask match(qint8 h2) const noexcept
+    {
+        return BitMask{ uint(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))) };
+    }
+    BitMask matchEmpty() const noexcept
+    {
+        return match(Empty);
+    }
+    BitMask matchEmptyOrDeleted() const noexcept
+    {
+        // both have the sign bit set and are less than -1
+        return BitMask{ uint(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl))) };
+    }
+    BitMask matchFull() const noexcept
+    {
+        return BitMask{ uint(_mm_movemask_epi8(ctrl)) ^ 0xffffU };
+    }
+#else
+    const qint8 *ctrl;
+
+    explicit Group(const qint8 *pos) noexcept
+        : ctrl(pos)
+    {}
+
+    template <typename Predicate>
+    BitMask matchIf(Predicate pred) const noexcept
+    {
+        uint mask = 0;
+        for (size_t i = 0; i < Width; ++i)
+            mask |= uint(pred(ctrl[i])) << i;
+        return BitMask{ mask };
+    }
+    BitMask match(qint8 h2) const noexcept
+    {
+        return matchIf([h2](qint8 c) { return c == h2; });
+    }
+    BitMask matchEmpty() const noexcept
+    {
+        return match(Empty);
+    }
+    BitMask matchEmptyOrDeleted() const noexcept
+    {
+        return matchIf([](qint8 c) { return c < -1; });
+    }
+    BitMask matchFull() const noexcept
+    {
+        return matchIf([](qint8 c) { return c >= 0; });
+    }
+#endif
+};
+
+// Visits the groups starting at the buckets hash, hash + 1 * Width,
+// hash + 3 * Width, hash + 6 * Width, ... which covers the whole table
+// because the number of buckets is a power of two.
+struct ProbeSequence
+{
+    size_t mask;
+    size_t offset;
+    size_t stride = 0;
+
+    ProbeSequence(size_t hash, size_t bucketMask) noexcept
+        : mask(bucketMask), offset(hash & bucketMask)
+    {}
+
+    size_t bucket(uint i) const noexcept { return (offset + i) & mask; }
+    void next() noexcept
+    {
+        stride += Group::Width;
+        offset = (offset + stride) & mask;
+    }
+};
+
+namespace GrowthPolicy {
+inline constexpr size_t maxNumBuckets() noexcept
+{
+    // leave room for the control bytes and stay a power of two
+    return size_t(1) << (std::numeric_limits<ptrdiff_t>::digits - 5);
+}
+inline constexpr size_t maxLoad(size_t nBuckets) noexcept
+{
+    // the table is allowed to be 7/8 full
+    return nBuckets - nBuckets / 8;
+}
+inline constexpr size_t bucketsForCapacity(size_t requestedCapacity) noexcept
+{
+    if (requestedCapacity <= maxLoad(Group::Width))
+        return Group::Width;
+    if (requestedCapacity >= maxLoad(maxNumBuckets()))
+        return maxNumBuckets();
+    const size_t minimumBuckets = requestedCapacity + (requestedCapacity + 6) / 7;
+    return qNextPowerOfTwo(QIntegerForSize<sizeof(size_t)>::Unsigned(minimumBuckets - 1));
+}
+inline constexpr size_t h1(size_t hash) noexcept
+{
+    return hash >> 7;
+}
+inline constexpr qint8 h2(size_t hash) noexcept
+{
+    return qint8(hash & 0x7f);
+}
+} // namespace GrowthPolicy
+
+template <typename Node>
+struct iterator;
+
+template <typename Node>
+struct Data
+{
+    using Key = typename Node::KeyType;
+    using T = typename Node::ValueType;
+    using iterator = QFlatHashPrivate::iterator<Node>;
+
+    static constexpr size_t NoBucket = ~size_t(0);
+    static constexpr size_t Alignment = qMax(alignof(Node), alignof(std::max_align_t));
+
+    QtPrivate::RefCount ref = {{1}};
+    size_t size = 0;
+    size_t numBuckets = 0;
+    size_t growthLeft = 0;
+    size_t seed = 0;
+    qint8 *ctrl = nullptr;
+    Node *entries = nullptr;
+
+    Data(size_t reserve = 0)
+    {
+        seed = QHashSeed::globalSeed();
+        allocate(GrowthPolicy::bucketsForCapacity(reserve));
+    }
+    Data(const Data &other, size_t reserved = 0)
+        : size(other.size),
+          seed(other.seed)
+    {
+        size_t nBuckets = other.numBuckets;
+        if (reserved)
+            nBuckets = GrowthPolicy::bucketsForCapacity(qMax(size, reserved));
+        allocate(nBuckets);
+
+        if (nBuckets == other.numBuckets) {
+            // same layout, including the deleted buckets
+            memcpy(ctrl, other.ctrl, controlBytes(nBuckets));
+            growthLeft = other.growthLeft;
+            for (size_t bucket = 0; bucket < nBuckets; ++bucket) {
+                if (isFull(bucket))
+                    new (entries + bucket) Node(other.entries[bucket]);
+            }
+        } else {
+            for (size_t bucket = 0; bucket < other.numBuckets; ++bucket) {
+                if (!other.isFull(bucket))
+                    continue;
+                const Node &n = other.entries[bucket];
+                new (entries + claimBucket(QHashPrivate::calculateHash(n.key, seed))) Node(n);
+            }
+            growthLeft = GrowthPolicy::maxLoad(nBuckets) - size;
+        }
+    }
+
+    ~Data()
+    {
+        freeData(ctrl, entries, numBuckets);
+    }
+
+    static Data *detached(Data *d, size_t size = 0)
+    {
+        if (!d)
+            return new Data(size);
+        Data *dd = new Data(*d, size);
+        if (!d->ref.deref())
+            delete d;
+        return dd;
+    }
+
+    static size_t controlBytes(size_t nBuckets) noexcept
+    {
+        // the first Width - 1 control bytes are repeated after the last one,
+        // so that a group can be loaded at any bucket
+        const size_t bytes = nBuckets + Group::Width;
+        return (bytes + alignof(Node) - 1) & ~(alignof(Node) - 1);
+    }
+
+    void allocate(size_t nBuckets)
+    {
+        const size_t bytes = controlBytes(nBuckets);
+        void *memory = ::operator new(bytes + nBuckets * sizeof(Node), std::align_val_t(Alignment));
+        ctrl = static_cast<qint8 *>(memory);
+        memset(ctrl, Empty, bytes);
+        entries = reinterpret_cast<Node *>(ctrl + bytes);
+        numBuckets = nBuckets;
+        growthLeft = GrowthPolicy::maxLoad(nBuckets);
+    }
+
+    static void freeData(qint8 *ctrl, Node *entries, size_t nBuckets) noexcept
+    {
+        if (!ctrl)
+            return;
+        if constexpr (!std::is_trivially_destructible_v<Node>) {
+            for (size_t bucket = 0; bucket < nBuckets; ++bucket) {
+                if (ctrl[bucket] >= 0)
+                    entries[bucket].~Node();
+            }
+        }
+        ::operator delete(ctrl, std::align_val_t(Alignment));
+    }
+
+    bool isFull(size_t bucket) const noexcept
+    {
+        return ctrl[bucket] >= 0;
+    }
+
+    void setCtrl(size_t bucket, qint8 c) noexcept
+    {
+        ctrl[bucket] = c;
+        if (bucket < Group::Width - 1)
+            ctrl[numBuckets + bucket] = c;
+    }
+
+    iterator detachedIterator(iterator other) const noexcept
+    {
+        return iterator{this, other.bucket};
+    }
+
+    iterator begin() const noexcept
+    {
+        iterator it{ this, 0 };
+        if (!isFull(0))
+            ++it;
+        return it;
+    }
+
+    constexpr iterator end() const noexcept
+    {
+        return iterator();
+    }
+
+    void rehash(size_t sizeHint = 0)
+    {
+        resize(GrowthPolicy::bucketsForCapacity(qMax(size, sizeHint)));
+    }
+
+    void resize(size_t nBuckets)
+    {
+        qint8 *oldCtrl = ctrl;
+        Node *oldSlots = entries;
+        size_t oldNumBuckets = numBuckets;
+        allocate(nBuckets);
+
+        for (size_t bucket = 0; bucket < oldNumBuckets; ++bucket) {
+            if (oldCtrl[bucket] < 0)
+                continue;
+            Node &n = oldSlots[bucket];
+            new (entries + claimBucket(QHashPrivate::calculateHash(n.key, seed))) Node(std::move(n));
+            n.~Node();
+        }
+        growthLeft = GrowthPolicy::maxLoad(nBuckets) - size;
+        ::operator delete(oldCtrl, std::align_val_t(Alignment));
+    }
+
+    float loadFactor() const noexcept
+    {
+        return float(size)/numBuckets;
+    }
+    bool shouldGrow() const noexcept
+    {
+        return growthLeft == 0;
+    }
+
+    size_t findBucket(const Key &key, size_t hash) const noexcept
+    {
+        Q_ASSERT(numBuckets > 0);
+        const qint8 h2 = GrowthPolicy::h2(hash);
+        ProbeSequence seq(GrowthPolicy::h1(hash), numBuckets - 1);
+        while (true) {
+            const Group group(ctrl + seq.offset);
+            for (BitMask match = group.match(h2); match; match.clearLowestBit()) {
+                const size_t bucket = seq.bucket(match.lowestBitSet());
+                if (qHashEquals(entries[bucket].key, key))
+                    return bucket;
+            }
+            // the key would have been inserted into the first empty bucket
+            if (group.matchEmpty())
+                return NoBucket;
+            seq.next();
+        }
+    }
+
+    size_t findBucket(const Key &key) const noexcept
+    {
+        return findBucket(key, QHashPrivate::calculateHash(key, seed));
+    }
+
+    Node *findNode(const Key &key) const noexcept
+    {
+        size_t bucket = findBucket(key);
+        return bucket == NoBucket ? nullptr : entries + bucket;
+    }
+
+    size_t findFirstNonFull(size_t hash) const noexcept
+    {
+        ProbeSequence seq(GrowthPolicy::h1(hash), numBuckets - 1);
+        while (true) {
+            const BitMask mask = Group(ctrl + seq.offset).matchEmptyOrDeleted();
+            if (mask)
+                return seq.bucket(mask.lowestBitSet());
+            seq.next();
+        }
+    }
+
+    // marks the bucket for a new key as full; used when rehashing, when the
+    // key is known not to be in the table and there are no deleted buckets
+    size_t claimBucket(size_t hash) noexcept
+    {
+        const size_t bucket = findFirstNonFull(hash);
+        setCtrl(bucket, GrowthPolicy::h2(hash));
+        return bucket;
+    }
+
+    struct InsertionResult
+    {
+        iterator it;
+        bool initialized;
+    };
+
+    InsertionResult findOrInsert(const Key &key)
+    {
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
+        size_t bucket = findBucket(key, hash);
+        if (bucket != NoBucket)
+            return { iterator{this, bucket}, true };
+
+        bucket = findFirstNonFull(hash);
+        if (growthLeft == 0 && ctrl[bucket] != Deleted) {
+            // drop the deleted buckets if they are the reason for running
+            // out of space, otherwise double the number of buckets
+            if (size <= GrowthPolicy::maxLoad(numBuckets) / 2)
+                resize(numBuckets);
+            else
+                resize(numBuckets * 2);
+            bucket = findFirstNonFull(hash);
+        }
+        growthLeft -= ctrl[bucket] == Empty;
+        setCtrl(bucket, GrowthPolicy::h2(hash));
+        ++size;
+        return { iterator{this, bucket}, false };
+    }
+
+    void erase(size_t bucket) noexcept(std::is_nothrow_destructible<Node>::value)
+    {
+        Q_ASSERT(isFull(bucket));
+        entries[bucket].~Node();
+        --size;
+
+        // If the bucket is part of a run of fewer than Width non-empty
+        // buckets, no probe ever went past it without finding an empty
+        // bucket, so it can become empty again. Otherwise, it must stay
+        // occupied by a tombstone not to break the probe sequences.
+        const size_t before = (bucket - Group::Width) & (numBuckets - 1);
+        const BitMask emptyAfter = Group(ctrl + bucket).matchEmpty();
+        const BitMask emptyBefore = Group(ctrl + before).matchEmpty();
+        const bool wasNeverFull = emptyBefore && emptyAfter
+                && emptyAfter.trailingZeros() + emptyBefore.leadingZeros() < Group::Width;
+        setCtrl(bucket, wasNeverFull ? Empty : Deleted);
+        growthLeft += wasNeverFull;
+    }
+};
+
+template <typename Node>
+struct iterator {
+    const Data<Node> *d = nullptr;
+    size_t bucket = 0;
+
+    inline Node *node() const noexcept
+    {
+        Q_ASSERT(d->isFull(bucket));
+        return d->entries + bucket;
+    }
+    bool atEnd() const noexcept { return !d; }
+
+    iterator operator++() noexcept
+    {
+        ++bucket;
+        while (bucket < d->numBuckets) {
+            BitMask full = Group(d->ctrl + bucket).matchFull();
+            const size_t remaining = d->numBuckets - bucket;
+            if (remaining < Group::Width)
+                full.mask &= (1U << remaining) - 1;
+            if (full) {
+                bucket += full.lowestBitSet();
+                return *this;
+            }
+            bucket += Group::Width;
+        }
+        d = nullptr;
+        bucket = 0;
+        return *this;
+    }
+    bool operator==(iterator other) const noexcept
+    { return d == other.d && bucket == other.bucket; }
+    bool operator!=(iterator other) const noexcept
+    { return !(*this == other); }
+};
+
+} // namespace QFlatHashPrivate
+
+template <typename Key, typename T>
+class QFlatHash
+{
+    using Node = QHashPrivate::Node<Key, T>;
+    using Data = QFlatHashPrivate::Data<Node>;
+    friend class QFlatHashSet<Key>;
+    friend tst_QFlatHash;
+
+    Data *d = nullptr;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = T;
+    using size_type = qsizetype;
+    using difference_type = qsizetype;
+    using reference = T &;
+    using const_reference = const T &;
+
+    inline QFlatHash() noexcept = default;
+    inline QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+        : d(new Data(list.size()))
+    {
+        for (auto it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+    QFlatHash(const QFlatHash &other) noexcept
+        : d(other.d)
+    {
+        if (d)
+            d->ref.ref();
+    }
+    ~QFlatHash()
+    {
+        static_assert(std::is_nothrow_destructible_v<Key>, "Types with throwing destructors are not supported in Qt containers.");
+        static_assert(std::is_nothrow_destructible_v<T>, "Types with throwing destructors are not supported in Qt containers.");
+
+        if (d && !d->ref.deref())
+            delete d;
+    }
+
+    QFlatHash &operator=(const QFlatHash &other) noexcept(std::is_nothrow_destructible<Node>::value)
+    {
+        if (d != other.d) {
+            Data *o = other.d;
+            if (o)
+                o->ref.ref();
+            if (d && !d->ref.deref())
+                delete d;
+            d = o;
+        }
+        return *this;
+    }
+
+    QFlatHash(QFlatHash &&other) noexcept
+        : d(std::exchange(other.d, nullptr))
+    {
+    }
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_MOVE_AND_SWAP(QFlatHash)
+#ifdef Q_QDOC
+    template <typename InputIterator>
+    QFlatHash(InputIterator f, InputIterator l);
+#else
+    template <typename InputIterator, QtPrivate::IfAssociativeIteratorHasKeyAndValue<InputIterator> = true>
+    QFlatHash(InputIterator f, InputIterator l)
+        : QFlatHash()
+    {
+        QtPrivate::reserveIfForwardIterator(this, f, l);
+        for (; f != l; ++f)
+            insert(f.key(), f.value());
+    }
+
+    template <typename InputIterator, QtPrivate::IfAssociativeIteratorHasFirstAndSecond<InputIterator> = true>
+    QFlatHash(InputIterator f, InputIterator l)
+        : QFlatHash()
+    {
+        QtPrivate::reserveIfForwardIterator(this, f, l);
+        for (; f != l; ++f)
+            insert(f->first, f->second);
+    }
+#endif
+    void swap(QFlatHash &other) noexcept { qt_ptr_swap(d, other.d); }
+
+#ifndef Q_CLANG_QDOC
+    template <typename AKey = Key, typename AT = T>
+    QTypeTraits::compare_eq_result_container<QFlatHash, AKey, AT> operator==(const QFlatHash &other) const noexcept
+    {
+        if (d == other.d)
+            return true;
+        if (size() != other.size())
+            return false;
+
+        for (const_iterator it = other.begin(); it != other.end(); ++it) {
+            const_iterator i = find(it.key());
+            if (i == end() || !i.i.node()->valuesEqual(it.i.node()))
+                return false;
+        }
+        // all values must be the same as size is the same
+        return true;
+    }
+    template <typename AKey = Key, typename AT = T>
+    QTypeTraits::compare_eq_result_container<QFlatHash, AKey, AT> operator!=(const QFlatHash &other) const noexcept
+    { return !(*this == other); }
+#else
+    bool operator==(const QFlatHash &other) const;
+    bool operator!=(const QFlatHash &other) const;
+#endif // Q_CLANG_QDOC
+
+    inline qsizetype size() const noexcept { return d ? qsizetype(d->size) : 0; }
+    inline bool isEmpty() const noexcept { return !d || d->size == 0; }
+
+    inline qsizetype capacity() const noexcept
+    { return d ? qsizetype(QFlatHashPrivate::GrowthPolicy::maxLoad(d->numBuckets)) : 0; }
+    void reserve(qsizetype size)
+    {
+        if (isDetached())
+            d->rehash(size);
+        else
+            d = Data::detached(d, size_t(size));
+    }
+    inline void squeeze()
+    {
+        if (capacity())
+            reserve(0);
+    }
+
+    inline void detach() { if (!d || d->ref.isShared()) d = Data::detached(d); }
+    inline bool isDetached() const noexcept { return d && !d->ref.isShared(); }
+    bool isSharedWith(const QFlatHash &other) const noexcept { return d == other.d; }
+
+    void clear() noexcept(std::is_nothrow_destructible<Node>::value)
+    {
+        if (d && !d->ref.deref())
+            delete d;
+        d = nullptr;
+    }
+
+    bool remove(const Key &key)
+    {
+        if (isEmpty()) // prevents detaching shared null
+            return false;
+        const size_t bucket = d->findBucket(key);
+        if (bucket == Data::NoBucket)
+            return false;
+        detach(); // keeps the buckets in place
+        d->erase(bucket);
+        return true;
+    }
+    template <typename Predicate>
+    qsizetype removeIf(Predicate pred)
+    {
+        return QtPrivate::associative_erase_if(*this, pred);
+    }
+    T take(const Key &key)
+    {
+        if (isEmpty()) // prevents detaching shared null
+            return T();
+        const size_t bucket = d->findBucket(key);
+        if (bucket == Data::NoBucket)
+            return T();
+        detach(); // keeps the buckets in place
+        T value = d->entries[bucket].takeValue();
+        d->erase(bucket);
+        return value;
+    }
+
+    bool contains(const Key &key) const noexcept
+    {
+        if (!d)
+            return false;
+        return d->findNode(key) != nullptr;
+    }
+    qsizetype count(const Key &key) const noexcept
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+private:
+    T *valueImpl(const Key &key) const noexcept
+    {
+        if (d) {
+            Node *n = d->findNode(key);
+            if (n)
+                return &n->value;
+        }
+        return nullptr;
+    }
+public:
+    T value(const Key &key) const noexcept
+    {
+        if (T *v = valueImpl(key))
+            return *v;
+        else
+            return T();
+    }
+
+    T value(const Key &key, const T &defaultValue) const noexcept
+    {
+        if (T *v = valueImpl(key))
+            return *v;
+        else
+            return defaultValue;
+    }
+
+    T &operator[](const Key &key)
+    {
+        const auto copy = isDetached() ? QFlatHash() : *this; // keep 'key' alive across the detach
+        detach();
+        auto result = d->findOrInsert(key);
+        Q_ASSERT(!result.it.atEnd());
+        if (!result.initialized)
+            Node::createInPlace(result.it.node(), key, T());
+        return result.it.node()->value;
+    }
+
+    const T operator[](const Key &key) const noexcept
+    {
+        return value(key);
+    }
+
+    QList<Key> keys() const { return QList<Key>(keyBegin(), keyEnd()); }
+    QList<T> values() const { return QList<T>(begin(), end()); }
+
+    class const_iterator;
+
+    class iterator
+    {
+        using piter = typename QFlatHashPrivate::iterator<Node>;
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+        friend class QFlatHashSet<Key>;
+        piter i;
+        explicit inline iterator(piter it) noexcept : i(it) { }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        constexpr iterator() noexcept = default;
+
+        inline const Key &key() const noexcept { return i.node()->key; }
+        inline T &value() const noexcept { return i.node()->value; }
+        inline T &operator*() const noexcept { return i.node()->value; }
+        inline T *operator->() const noexcept { return &i.node()->value; }
+        inline bool operator==(const iterator &o) const noexcept { return i == o.i; }
+        inline bool operator!=(const iterator &o) const noexcept { return i != o.i; }
+
+        inline iterator &operator++() noexcept
+        {
+            ++i;
+            return *this;
+        }
+        inline iterator operator++(int) noexcept
+        {
+            iterator r = *this;
+            ++i;
+            return r;
+        }
+
+        inline bool operator==(const const_iterator &o) const noexcept { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const noexcept { return i != o.i; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        using piter = typename QFlatHashPrivate::iterator<Node>;
+        friend class iterator;
+        friend class QFlatHash<Key, T>;
+        friend class QFlatHashSet<Key>;
+        piter i;
+        explicit inline const_iterator(piter it) : i(it) { }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        constexpr const_iterator() noexcept = default;
+        inline const_iterator(const iterator &o) noexcept : i(o.i) { }
+
+        inline const Key &key() const noexcept { return i.node()->key; }
+        inline const T &value() const noexcept { return i.node()->value; }
+        inline const T &operator*() const noexcept { return i.node()->value; }
+        inline const T *operator->() const noexcept { return &i.node()->value; }
+        inline bool operator==(const const_iterator &o) const noexcept { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const noexcept { return i != o.i; }
+
+        inline const_iterator &operator++() noexcept
+        {
+            ++i;
+            return *this;
+        }
+        inline const_iterator operator++(int) noexcept
+        {
+            const_iterator r = *this;
+            ++i;
+            return r;
+        }
+    };
+    friend class const_iterator;
+
+    class key_iterator
+    {
+        const_iterator i;
+
+    public:
+        typedef typename const_iterator::iterator_category iterator_category;
+        typedef qptrdiff difference_type;
+        typedef Key value_type;
+        typedef const Key *pointer;
+        typedef const Key &reference;
+
+        key_iterator() noexcept = default;
+        explicit key_iterator(const_iterator o) noexcept : i(o) { }
+
+        const Key &operator*() const noexcept { return i.key(); }
+        const Key *operator->() const noexcept { return &i.key(); }
+        bool operator==(key_iterator o) const noexcept { return i == o.i; }
+        bool operator!=(key_iterator o) const noexcept { return i != o.i; }
+
+        inline key_iterator &operator++() noexcept { ++i; return *this; }
+        inline key_iterator operator++(int) noexcept { return key_iterator(i++);}
+        const_iterator base() const noexcept { return i; }
+    };
+
+    typedef QKeyValueIterator<const Key&, const T&, const_iterator> const_key_value_iterator;
+    typedef QKeyValueIterator<const Key&, T&, iterator> key_value_iterator;
+
+    // STL style
+    inline iterator begin() { detach(); return iterator(d->begin()); }
+    inline const_iterator begin() const noexcept { return d ? const_iterator(d->begin()): const_iterator(); }
+    inline const_iterator cbegin() const noexcept { return d ? const_iterator(d->begin()): const_iterator(); }
+    inline const_iterator constBegin() const noexcept { return d ? const_iterator(d->begin()): const_iterator(); }
+    inline iterator end() noexcept { return iterator(); }
+    inline const_iterator end() const noexcept { return const_iterator(); }
+    inline const_iterator cend() const noexcept { return const_iterator(); }
+    inline const_iterator constEnd() const noexcept { return const_iterator(); }
+    inline key_iterator keyBegin() const noexcept { return key_iterator(begin()); }
+    inline key_iterator keyEnd() const noexcept { return key_iterator(end()); }
+    inline key_value_iterator keyValueBegin() { return key_value_iterator(begin()); }
+    inline key_value_iterator keyValueEnd() { return key_value_iterator(end()); }
+    inline const_key_value_iterator keyValueBegin() const noexcept { return const_key_value_iterator(begin()); }
+    inline const_key_value_iterator constKeyValueBegin() const noexcept { return const_key_value_iterator(begin()); }
+    inline const_key_value_iterator keyValueEnd() const noexcept { return const_key_value_iterator(end()); }
+    inline const_key_value_iterator constKeyValueEnd() const noexcept { return const_key_value_iterator(end()); }
+    auto asKeyValueRange() & { return QtPrivate::QKeyValueRange(*this); }
+    auto asKeyValueRange() const & { return QtPrivate::QKeyValueRange(*this); }
+    auto asKeyValueRange() && { return QtPrivate::QKeyValueRange(std::move(*this)); }
+    auto asKeyValueRange() const && { return QtPrivate::QKeyValueRange(std::move(*this)); }
+
+    iterator erase(const_iterator it)
+    {
+        Q_ASSERT(it != constEnd());
+        detach();
+        // ensure a valid iterator across the detach:
+        iterator i = iterator{d->detachedIterator(it.i)};
+
+        // erasing does not move any of the other entries
+        d->erase(i.i.bucket);
+        ++i;
+        return i;
+    }
+
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+    inline qsizetype count() const noexcept { return d ? qsizetype(d->size) : 0; }
+    iterator find(const Key &key)
+    {
+        if (isEmpty()) // prevents detaching shared null
+            return end();
+        const size_t bucket = d->findBucket(key);
+        if (bucket == Data::NoBucket)
+            return end();
+        detach(); // keeps the buckets in place
+        return iterator({d, bucket});
+    }
+    const_iterator find(const Key &key) const noexcept
+    {
+        if (isEmpty())
+            return end();
+        const size_t bucket = d->findBucket(key);
+        if (bucket == Data::NoBucket)
+            return end();
+        return const_iterator({d, bucket});
+    }
+    const_iterator constFind(const Key &key) const noexcept
+    {
+        return find(key);
+    }
+    iterator insert(const Key &key, const T &value)
+    {
+        return emplace(key, value);
+    }
+
+    void insert(const QFlatHash &hash)
+    {
+        if (d == hash.d || !hash.d)
+            return;
+        if (!d) {
+            *this = hash;
+            return;
+        }
+
+        detach();
+
+        for (auto it = hash.begin(); it != hash.end(); ++it)
+            emplace(it.key(), it.value());
+    }
+
+    template <typename ...Args>
+    iterator emplace(const Key &key, Args &&... args)
+    {
+        Key copy = key; // Needs to be explicit for MSVC 2019
+        return emplace(std::move(copy), std::forward<Args>(args)...);
+    }
+
+    template <typename ...Args>
+    iterator emplace(Key &&key, Args &&... args)
+    {
+        if (isDetached()) {
+            if (d->shouldGrow()) // Construct the value now so that no dangling references are used
+                return emplace_helper(std::move(key), T(std::forward<Args>(args)...));
+            return emplace_helper(std::move(key), std::forward<Args>(args)...);
+        }
+        // else: we must detach
+        const auto copy = *this; // keep 'args' alive across the detach/growth
+        detach();
+        return emplace_helper(std::move(key), std::forward<Args>(args)...);
+    }
+
+    float load_factor() const noexcept { return d ? d->loadFactor() : 0; }
+    static float max_load_factor() noexcept { return 0.875; }
+    size_t bucket_count() const noexcept { return d ? d->numBuckets : 0; }
+    static size_t max_bucket_count() noexcept { return QFlatHashPrivate::GrowthPolicy::maxNumBuckets(); }
+
+    inline bool empty() const noexcept { return isEmpty(); }
+
+private:
+    template <typename ...Args>
+    iterator emplace_helper(Key &&key, Args &&... args)
+    {
+        auto result = d->findOrInsert(key);
+        if (!result.initialized)
+            Node::createInPlace(result.it.node(), std::move(key), std::forward<Args>(args)...);
+        else
+            result.it.node()->emplaceValue(std::forward<Args>(args)...);
+        return iterator(result.it);
+    }
+};
+
+template <typename Key, typename T, typename Predicate>
+qsizetype erase_if(QFlatHash<Key, T> &hash, Predicate pred)
+{
+    return QtPrivate::associative_erase_if(hash, pred);
+}
+
+template <class T>
+class QFlatHashSet
+{
+    typedef QFlatHash<T, QHashDummyValue> Hash;
+
+public:
+    inline QFlatHashSet() noexcept {}
+    inline QFlatHashSet(std::initializer_list<T> list)
+        : QFlatHashSet(list.begin(), list.end()) {}
+    template <typename InputIterator, QtPrivate::IfIsInputIterator<InputIterator> = true>
+    inline QFlatHashSet(InputIterator first, InputIterator last)
+    {
+        QtPrivate::reserveIfForwardIterator(this, first, last);
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    // compiler-generated copy/move ctor/assignment operators are fine!
+    // compiler-generated destructor is fine!
+
+    inline void swap(QFlatHashSet<T> &other) noexcept { q_hash.swap(other.q_hash); }
+
+#ifndef Q_CLANG_QDOC
+    template <typename U = T>
+    QTypeTraits::compare_eq_result_container<QFlatHashSet, U> operator==(const QFlatHashSet<T> &other) const
+    { return q_hash == other.q_hash; }
+    template <typename U = T>
+    QTypeTraits::compare_eq_result_container<QFlatHashSet, U> operator!=(const QFlatHashSet<T> &other) const
+    { return q_hash != other.q_hash; }
+#else
+    bool operator==(const QFlatHashSet &other) const;
+    bool operator!=(const QFlatHashSet &other) const;
+#endif
+
+    inline qsizetype size() const { return q_hash.size(); }
+
+    inline bool isEmpty() const { return q_hash.isEmpty(); }
+
+    inline qsizetype capacity() const { return q_hash.capacity(); }
+    inline void reserve(qsizetype size) { q_hash.reserve(size); }
+    inline void squeeze() { q_hash.squeeze(); }
+
+    inline void detach() { q_hash.detach(); }
+    inline bool isDetached() const { return q_hash.isDetached(); }
+
+    inline void clear() { q_hash.clear(); }
+
+    inline bool remove(const T &value) { return q_hash.remove(value); }
+
+    template <typename Predicate>
+    qsizetype removeIf(Predicate pred)
+    {
+        qsizetype result = 0;
+        auto it = begin();
+        const auto e = end();
+        while (it != e) {
+            if (pred(*it)) {
+                ++result;
+                it = erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return result;
+    }
+
+    inline bool contains(const T &value) const { return q_hash.contains(value); }
+
+    class const_iterator;
+
+    class iterator
+    {
+        typename Hash::iterator i;
+        friend class const_iterator;
+        friend class QFlatHashSet<T>;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline iterator() {}
+        inline iterator(typename Hash::iterator o) : i(o) {}
+        inline const T &operator*() const { return i.key(); }
+        inline const T *operator->() const { return &i.key(); }
+        inline bool operator==(const iterator &o) const { return i == o.i; }
+        inline bool operator!=(const iterator &o) const { return i != o.i; }
+        inline bool operator==(const const_iterator &o) const
+            { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const
+            { return i != o.i; }
+        inline iterator &operator++() { ++i; return *this; }
+        inline iterator operator++(int) { iterator r = *this; ++i; return r; }
+    };
+
+    class const_iterator
+    {
+        typename Hash::const_iterator i;
+        friend class iterator;
+        friend class QFlatHashSet<T>;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() {}
+        inline const_iterator(typename Hash::const_iterator o) : i(o) {}
+        inline const_iterator(const iterator &o)
+            : i(o.i) {}
+        inline const T &operator*() const { return i.key(); }
+        inline const T *operator->() const { return &i.key(); }
+        inline bool operator==(const const_iterator &o) const { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return i != o.i; }
+        inline const_iterator &operator++() { ++i; return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++i; return r; }
+    };
+
+    // STL style
+    inline iterator begin() { return q_hash.begin(); }
+    inline const_iterator begin() const noexcept { return q_hash.begin(); }
+    inline const_iterator cbegin() const noexcept { return q_hash.begin(); }
+    inline const_iterator constBegin() const noexcept { return q_hash.constBegin(); }
+    inline iterator end() { return q_hash.end(); }
+    inline const_iterator end() const noexcept { return q_hash.end(); }
+    inline const_iterator cend() const noexcept { return q_hash.end(); }
+    inline const_iterator constEnd() const noexcept { return q_hash.constEnd(); }
+
+    iterator erase(const_iterator i)
+    {
+        Q_ASSERT(i != constEnd());
+        return q_hash.erase(i.i);
+    }
+
+    // more Qt
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+    inline qsizetype count() const { return q_hash.count(); }
+    inline iterator insert(const T &value)
+        { return q_hash.insert(value, QHashDummyValue()); }
+    inline iterator insert(T &&value)
+        { return q_hash.emplace(std::move(value), QHashDummyValue()); }
+    iterator find(const T &value) { return q_hash.find(value); }
+    const_iterator find(const T &value) const { return q_hash.find(value); }
+    inline const_iterator constFind(const T &value) const { return find(value); }
+    QList<T> values() const { return QList<T>(begin(), end()); }
+
+    // STL compatibility
+    typedef T key_type;
+    typedef T value_type;
+    typedef value_type *pointer;
+    typedef const value_type *const_pointer;
+    typedef value_type &reference;
+    typedef const value_type &const_reference;
+    typedef qptrdiff difference_type;
+    typedef qsizetype size_type;
+
+    inline bool empty() const { return isEmpty(); }
+
+private:
+    Hash q_hash;
+};
+
+template <typename T, typename Predicate>
+qsizetype erase_if(QFlatHashSet<T> &set, Predicate pred)
+{
+    return set.removeIf(pred);
+}
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_H
@@ -0,0 +1,730 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QPERSISTENTHASH_H
+#define QPERSISTENTHASH_H
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qiterator.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qscopeguard.h>
+
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
+
+class tst_QPersistentHash; // for befriending
+
+QT_BEGIN_NAMESPACE
+
+namespace QPersistentHashPrivate {
+
+// A hash array mapped trie: five bits of the hash of a key select one of
+// 32 slots on each level of the trie, starting with the lowest bits.
+// A node stores the entries of the slots that hold a single key inline,
+// followed by the pointers to the child nodes of the other used slots.
+// Below the last bits of the hash, nodes hold entries with equal hashes.
+constexpr int Bits = 5;
+constexpr int HashBits = std::numeric_limits<size_t>::digits;
+constexpr int MaxDepth = HashBits / Bits + 2;
+
+template <typename Key, typename T>
+struct Entry
+{
+    Key key;
+    T value;
+};
+
+template <typename Key, typename T>
+struct Node
+{
+    using Entry = QPersistentHashPrivate::Entry<Key, T>;
+    static constexpr size_t Alignment = qMax(alignof(Entry), alignof(void *));
+
+    // Nodes are shared between hashes, and never modified while they are.
+    // The reference count is read with acquire semantics, so that the reads
+    // of other threads that released the node happen before it is modified.
+    QAtomicInt ref = 1;
+    quint32 dataMap = 0;
+    quint32 nodeMap = 0;
+    int entryCount = 0;
+    int childCount = 0;
+
+    static constexpr size_t entriesOffset() noexcept
+    {
+        return (sizeof(Node) + alignof(Entry) - 1) & ~(alignof(Entry) - 1);
+    }
+    static constexpr size_t childrenOffset(int entryCount) noexcept
+    {
+        const size_t end = entriesOffset() + entryCount * sizeof(Entry);
+        return (end + alignof(Node *) - 1) & ~(alignof(Node *) - 1);
+    }
+
+    Entry *entries() noexcept
+    { return reinterpret_cast<Entry *>(reinterpret_cast<char *>(this) + entriesOffset()); }
+    const Entry *entries() const noexcept
+    { return reinterpret_cast<const Entry *>(reinterpret_cast<const char *>(this) + entriesOffset()); }
+    Node **children() noexcept
+    { return reinterpret_cast<Node **>(reinterpret_cast<char *>(this) + childrenOffset(entryCount)); }
+    Node *const *children() const noexcept
+    { return reinterpret_cast<Node *const *>(reinterpret_cast<const char *>(this) + childrenOffset(entryCount)); }
+
+    bool isShared() const noexcept { return ref.loadAcquire() != 1; }
+
+    // The entries are left for the caller to construct.
+    static Node *allocate(int entryCount, int childCount)
+    {
+        void *memory = ::operator new(childrenOffset(entryCount) + childCount * sizeof(Node *),
+                                      std::align_val_t(Alignment));
+        Node *node = new (memory) Node;
+        node->entryCount = entryCount;
+        node->childCount = childCount;
+        return node;
+    }
+    static void deallocate(Node *node) noexcept
+    {
+        ::operator delete(node, std::align_val_t(Alignment));
+    }
+
+    static void release(Node *node) noexcept
+    {
+        if (node->ref.deref())
+            return;
+        std::destroy_n(node->entries(), node->entryCount);
+        for (int i = 0; i < node->childCount; ++i)
+            release(node->children()[i]);
+        deallocate(node);
+    }
+
+    static int indexOf(quint32 map, quint32 bit) noexcept
+    {
+        return qPopulationCount(map & (bit - 1));
+    }
+    static quint32 bitFor(size_t hash, int shift) noexcept
+    {
+        return 1U << ((hash >> shift) & ((1U << Bits) - 1));
+    }
+
+    static const Entry *find(const Node *node, const Key &key, size_t hash) noexcept
+    {
+        for (int shift = 0; node; shift += Bits) {
+            if (shift >= HashBits) {
+                for (int i = 0; i < node->entryCount; ++i) {
+                    if (node->entries()[i].key == key)
+                        return node->entries() + i;
+                }
+                return nullptr;
+            }
+            const quint32 bit = bitFor(hash, shift);
+            if (node->dataMap & bit) {
+                const Entry *e = node->entries() + indexOf(node->dataMap, bit);
+                return e->key == key ? e : nullptr;
+            }
+            if (!(node->nodeMap & bit))
+                return nullptr;
+            node = node->children()[indexOf(node->nodeMap, bit)];
+        }
+        return nullptr;
+    }
+
+    // Describes how rebuild() derives a node from another one.
+    struct Change
+    {
+        quint32 dataMap;
+        quint32 nodeMap;
+        int dropEntry = -1;
+        int addEntry = -1;
+        Entry *entry = nullptr;
+        int dropChild = -1;
+        int addChild = -1;
+        Node *child = nullptr;
+    };
+
+    // Replaces the node in slot with one that has the entries and children
+    // that the change describes. The entries are moved over if the node is
+    // not shared, and copied otherwise. Takes over the reference to the new
+    // child; a dropped child is released.
+    static void rebuild(Node *&slot, const Change &change)
+    {
+        Node *from = slot;
+        const bool shared = from->isShared();
+        const int entryCount = from->entryCount + (change.addEntry >= 0) - (change.dropEntry >= 0);
+        const int childCount = from->childCount + (change.addChild >= 0) - (change.dropChild >= 0);
+
+        Node *to = allocate(entryCount, childCount);
+        int built = 0;
+        auto cleanup = qScopeGuard([&] {
+            std::destroy_n(to->entries(), built);
+            deallocate(to);
+        });
+        for (int k = 0; built < entryCount; ++built) {
+            if (built == change.addEntry) {
+                new (to->entries() + built) Entry(std::move(*change.entry));
+                continue;
+            }
+            if (k == change.dropEntry)
+                ++k;
+            Entry &e = from->entries()[k++];
+            if (shared)
+                new (to->entries() + built) Entry(e);
+            else
+                new (to->entries() + built) Entry(std::move(e));
+        }
+        cleanup.dismiss();
+
+        for (int i = 0, k = 0; i < childCount; ++i) {
+            if (i == change.addChild) {
+                to->children()[i] = change.child;
+                continue;
+            }
+            if (k == change.dropChild)
+                ++k;
+            Node *c = from->children()[k++];
+            if (shared)
+                c->ref.ref();
+            to->children()[i] = c;
+        }
+        to->dataMap = change.dataMap;
+        to->nodeMap = change.nodeMap;
+
+        if (shared) {
+            release(from);
+        } else {
+            // the entries were moved out, the children over
+            if (change.dropChild >= 0)
+                release(from->children()[change.dropChild]);
+            std::destroy_n(from->entries(), from->entryCount);
+            deallocate(from);
+        }
+        slot = to;
+    }
+
+    static void detach(Node *&slot)
+    {
+        if (slot->isShared())
+            rebuild(slot, { slot->dataMap, slot->nodeMap });
+    }
+
+    // Creates the subtree that holds two entries whose hashes agree up to
+    // the given shift.
+    static Node *makePair(Entry &&e1, size_t hash1, Entry &&e2, size_t hash2, int shift)
+    {
+        if (shift >= HashBits) {
+            Node *node = allocate(2, 0);
+            new (node->entries()) Entry(std::move(e1));
+            new (node->entries() + 1) Entry(std::move(e2));
+            return node;
+        }
+        const quint32 bit1 = bitFor(hash1, shift);
+        const quint32 bit2 = bitFor(hash2, shift);
+        if (bit1 == bit2) {
+            Node *child = makePair(std::move(e1), hash1, std::move(e2), hash2, shift + Bits);
+            Node *node = allocate(0, 1);
+            node->nodeMap = bit1;
+            node->children()[0] = child;
+            return node;
+        }
+        Node *node = allocate(2, 0);
+        node->dataMap = bit1 | bit2;
+        if (bit1 > bit2)
+            std::swap(e1, e2);
+        new (node->entries()) Entry(std::move(e1));
+        new (node->entries() + 1) Entry(std::move(e2));
+        return node;
+    }
+
+    // Inserts or replaces the entry below the node in slot. Returns whether
+    // an entry was added.
+    static bool insert(Node *&slot, int shift, size_t hash, Entry &&entry, size_t seed)
+    {
+        if (shift >= HashBits) {
+            for (int i = 0; i < slot->entryCount; ++i) {
+                if (slot->entries()[i].key == entry.key) {
+                    detach(slot);
+                    slot->entries()[i].value = std::move(entry.value);
+                    return false;
+                }
+            }
+            rebuild(slot, { 0, 0, -1, slot->entryCount, &entry });
+            return true;
+        }
+
+        const quint32 bit = bitFor(hash, shift);
+        if (slot->dataMap & bit) {
+            const int i = indexOf(slot->dataMap, bit);
+            Entry &e = slot->entries()[i];
+            if (e.key == entry.key) {
+                detach(slot);
+                slot->entries()[i].value = std::move(entry.value);
+                return false;
+            }
+            // the slot needs a child node for both keys
+            Node *child = makePair(Entry(e), QHashPrivate::calculateHash(e.key, seed),
+                                   std::move(entry), hash, shift + Bits);
+            auto cleanup = qScopeGuard([child] { release(child); });
+            Change change = { slot->dataMap & ~bit, slot->nodeMap | bit };
+            change.dropEntry = i;
+            change.addChild = indexOf(slot->nodeMap, bit);
+            change.child = child;
+            rebuild(slot, change);
+            cleanup.dismiss();
+            return true;
+        }
+        if (slot->nodeMap & bit) {
+            detach(slot);
+            return insert(slot->children()[indexOf(slot->nodeMap, bit)], shift + Bits, hash,
+                          std::move(entry), seed);
+        }
+        Change change = { slot->dataMap | bit, slot->nodeMap };
+        change.addEntry = indexOf(slot->dataMap, bit);
+        change.entry = &entry;
+        rebuild(slot, change);
+        return true;
+    }
+
+    // Removes the entry for key, which must be present, below the node in
+    // slot. A child left with a single entry is replaced by it.
+    static void remove(Node *&slot, int shift, const Key &key, size_t hash)
+    {
+        if (shift >= HashBits) {
+            int i = 0;
+            while (!(slot->entries()[i].key == key))
+                ++i;
+            Change change = { 0, 0 };
+            change.dropEntry = i;
+            rebuild(slot, change);
+            return;
+        }
+
+        const quint32 bit = bitFor(hash, shift);
+        if (slot->dataMap & bit) {
+            Change change = { slot->dataMap & ~bit, slot->nodeMap };
+            change.dropEntry = indexOf(slot->dataMap, bit);
+            rebuild(slot, change);
+            return;
+        }
+
+        Q_ASSERT(slot->nodeMap & bit);
+        detach(slot);
+        const int ci = indexOf(slot->nodeMap, bit);
+        Node *&child = slot->children()[ci];
+        remove(child, shift + Bits, key, hash);
+        if (child->entryCount == 1 && child->childCount == 0) {
+            Entry e(std::move(child->entries()[0])); // the child was rebuilt, so it is not shared
+            Change change = { slot->dataMap | bit, slot->nodeMap & ~bit };
+            change.addEntry = indexOf(slot->dataMap, bit);
+            change.entry = &e;
+            change.dropChild = ci;
+            rebuild(slot, change);
+        }
+    }
+};
+
+template <typename Key, typename T>
+class iterator
+{
+    using Node = QPersistentHashPrivate::Node<Key, T>;
+
+    // The nodes on the way from the root to the current entry, and the
+    // index of the next child to visit in each of them.
+    const Node *nodes[MaxDepth];
+    int nextChild[MaxDepth];
+    int depth = -1;
+    int entry = 0;
+
+    // Moves on to the next entry, if the current position has none:
+    // the entries of a node come before the entries of its children.
+    void settle() noexcept
+    {
+        while (depth >= 0) {
+            const Node *node = nodes[depth];
+            if (entry < node->entryCount)
+                return;
+            if (nextChild[depth] < node->childCount) {
+                nodes[depth + 1] = node->children()[nextChild[depth]++];
+                nextChild[++depth] = 0;
+                entry = 0;
+            } else if (--depth >= 0) {
+                entry = nodes[depth]->entryCount;
+            }
+        }
+    }
+
+public:
+    iterator() noexcept = default;
+    explicit iterator(const Node *root) noexcept
+    {
+        if (root) {
+            nodes[0] = root;
+            nextChild[0] = 0;
+            depth = 0;
+            settle();
+        }
+    }
+
+    // Positions the iterator on the entry for key, or at the end.
+    iterator(const Node *node, const Key &key, size_t hash) noexcept
+    {
+        for (int shift = 0; node; shift += Bits) {
+            nodes[++depth] = node;
+            if (shift >= HashBits) {
+                for (entry = 0; entry < node->entryCount; ++entry) {
+                    if (node->entries()[entry].key == key) {
+                        nextChild[depth] = 0;
+                        return;
+                    }
+                }
+                break;
+            }
+            const quint32 bit = Node::bitFor(hash, shift);
+            if (node->dataMap & bit) {
+                entry = Node::indexOf(node->dataMap, bit);
+                if (!(node->entries()[entry].key == key))
+                    break;
+                nextChild[depth] = 0;
+                return;
+            }
+            if (!(node->nodeMap & bit))
+                break;
+            nextChild[depth] = Node::indexOf(node->nodeMap, bit) + 1;
+            node = node->children()[nextChild[depth] - 1];
+        }
+        depth = -1;
+        entry = 0;
+    }
+
+    bool atEnd() const noexcept { return depth < 0; }
+    const typename Node::Entry &operator*() const noexcept { return nodes[depth]->entries()[entry]; }
+
+    iterator &operator++() noexcept
+    {
+        ++entry;
+        settle();
+        return *this;
+    }
+
+    bool operator==(const iterator &other) const noexcept
+    {
+        if (depth != other.depth)
+            return false;
+        return depth < 0 || (nodes[depth] == other.nodes[depth] && entry == other.entry);
+    }
+    bool operator!=(const iterator &other) const noexcept { return !(*this == other); }
+};
+
+} // namespace QPersistentHashPrivate
+
+template <typename Key, typename T>
+class QPersistentHash
+{
+    using Node = QPersistentHashPrivate::Node<Key, T>;
+    using Entry = typename Node::Entry;
+    friend tst_QPersistentHash;
+
+    Node *root = nullptr;
+    qsizetype s = 0;
+    size_t seed = QHashSeed::globalSeed();
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = T;
+    using size_type = qsizetype;
+    using difference_type = qsizetype;
+    using reference = T &;
+    using const_reference = const T &;
+
+    QPersistentHash() noexcept = default;
+    QPersistentHash(std::initializer_list<std::pair<Key, T>> list)
+    {
+        for (const auto &p : list)
+            insert(p.first, p.second);
+    }
+    explicit QPersistentHash(const QHash<Key, T> &hash)
+    {
+        for (auto it = hash.cbegin(), end = hash.cend(); it != end; ++it)
+            insert(it.key(), it.value());
+    }
+    QPersistentHash(const QPersistentHash &other) noexcept
+        : root(other.root), s(other.s), seed(other.seed)
+    {
+        if (root)
+            root->ref.ref();
+    }
+    QPersistentHash(QPersistentHash &&other) noexcept
+        : root(std::exchange(other.root, nullptr)), s(std::exchange(other.s, 0)), seed(other.seed)
+    {}
+    ~QPersistentHash()
+    {
+        static_assert(std::is_nothrow_destructible_v<Key>, "Types with throwing destructors are not supported in Qt containers.");
+        static_assert(std::is_nothrow_destructible_v<T>, "Types with throwing destructors are not supported in Qt containers.");
+        clear();
+    }
+
+    QPersistentHash &operator=(const QPersistentHash &other) noexcept
+    {
+        QPersistentHash copy(other);
+        swap(copy);
+        return *this;
+    }
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_MOVE_AND_SWAP(QPersistentHash)
+
+    void swap(QPersistentHash &other) noexcept
+    {
+        qt_ptr_swap(root, other.root);
+        std::swap(s, other.s);
+        std::swap(seed, other.seed);
+    }
+
+    QHash<Key, T> toHash() const
+    {
+        QHash<Key, T> hash;
+        hash.reserve(s);
+        for (auto it = begin(), e = end(); it != e; ++it)
+            hash.insert(it.key(), it.value());
+        return hash;
+    }
+
+#ifndef Q_CLANG_QDOC
+    template <typename AKey = Key, typename AT = T>
+    QTypeTraits::compare_eq_result_container<QPersistentHash, AKey, AT> operator==(const QPersistentHash &other) const
+    {
+        if (root == other.root)
+            return true;
+        if (s != other.s)
+            return false;
+        for (auto it = other.begin(), e = other.end(); it != e; ++it) {
+            const Entry *entry = findEntry(it.key());
+            if (!entry || !(entry->value == it.value()))
+                return false;
+        }
+        return true;
+    }
+    template <typename AKey = Key, typename AT = T>
+    QTypeTraits::compare_eq_result_container<QPersistentHash, AKey, AT> operator!=(const QPersistentHash &other) const
+    {
+        return !(*this == other);
+    }
+#else
+    bool operator==(const QPersistentHash &other) const;
+    bool operator!=(const QPersistentHash &other) const;
+#endif
+
+    qsizetype size() const noexcept { return s; }
+    qsizetype count() const noexcept { return s; }
+    bool isEmpty() const noexcept { return s == 0; }
+    bool empty() const noexcept { return s == 0; }
+
+    bool isSharedWith(const QPersistentHash &other) const noexcept { return root == other.root; }
+
+    void clear() noexcept
+    {
+        if (root)
+            Node::release(std::exchange(root, nullptr));
+        s = 0;
+    }
+
+    bool contains(const Key &key) const noexcept { return findEntry(key) != nullptr; }
+    qsizetype count(const Key &key) const noexcept { return contains(key) ? 1 : 0; }
+
+    T value(const Key &key) const
+    {
+        const Entry *e = findEntry(key);
+        return e ? e->value : T();
+    }
+    T value(const Key &key, const T &defaultValue) const
+    {
+        const Entry *e = findEntry(key);
+        return e ? e->value : defaultValue;
+    }
+    const T operator[](const Key &key) const { return value(key); }
+
+    QList<Key> keys() const { return QList<Key>(keyBegin(), keyEnd()); }
+    QList<T> values() const { return QList<T>(begin(), end()); }
+
+    void insert(const Key &key, const T &value)
+    {
+        emplace(Key(key), value);
+    }
+
+    template <typename ...Args>
+    void emplace(Key &&key, Args &&... args)
+    {
+        Entry entry{ std::move(key), T(std::forward<Args>(args)...) };
+        const size_t hash = QHashPrivate::calculateHash(entry.key, seed);
+        if (!root) {
+            Node *node = Node::allocate(1, 0);
+            new (node->entries()) Entry(std::move(entry));
+            node->dataMap = Node::bitFor(hash, 0);
+            root = node;
+            s = 1;
+            return;
+        }
+        if (Node::insert(root, 0, hash, std::move(entry), seed))
+            ++s;
+    }
+    template <typename ...Args>
+    void emplace(const Key &key, Args &&... args)
+    {
+        emplace(Key(key), std::forward<Args>(args)...);
+    }
+
+    bool remove(const Key &key)
+    {
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
+        if (!Node::find(root, key, hash)) // prevents copying nodes for nothing
+            return false;
+        const Key copy = key; // key may be stored in a node that is about to go
+        Node::remove(root, 0, copy, hash);
+        if (root->entryCount == 0 && root->childCount == 0)
+            Node::release(std::exchange(root, nullptr));
+        --s;
+        return true;
+    }
+
+    T take(const Key &key)
+    {
+        const Entry *e = findEntry(key);
+        if (!e)
+            return T();
+        T value = e->value;
+        remove(key);
+        return value;
+    }
+
+    class const_iterator
+    {
+        friend class QPersistentHash<Key, T>;
+        using piter = QPersistentHashPrivate::iterator<Key, T>;
+        piter i;
+        explicit const_iterator(piter it) noexcept : i(it) { }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        const_iterator() noexcept = default;
+
+        const Key &key() const noexcept { return (*i).key; }
+        const T &value() const noexcept { return (*i).value; }
+        const T &operator*() const noexcept { return (*i).value; }
+        const T *operator->() const noexcept { return &(*i).value; }
+        bool operator==(const const_iterator &o) const noexcept { return i == o.i; }
+        bool operator!=(const const_iterator &o) const noexcept { return i != o.i; }
+
+        const_iterator &operator++() noexcept
+        {
+            ++i;
+            return *this;
+        }
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator r = *this;
+            ++i;
+            return r;
+        }
+    };
+    using iterator = const_iterator;
+    using ConstIterator = const_iterator;
+    using Iterator = const_iterator;
+
+    class key_iterator
+    {
+        const_iterator i;
+
+    public:
+        typedef typename const_iterator::iterator_category iterator_category;
+        typedef qptrdiff difference_type;
+        typedef Key value_type;
+        typedef const Key *pointer;
+        typedef const Key &reference;
+
+        key_iterator() noexcept = default;
+        explicit key_iterator(const_iterator o) noexcept : i(o) { }
+
+        const Key &operator*() const noexcept { return i.key(); }
+        const Key *operator->() const noexcept { return &i.key(); }
+        bool operator==(key_iterator o) const noexcept { return i == o.i; }
+        bool operator!=(key_iterator o) const noexcept { return i != o.i; }
+
+        inline key_iterator &operator++() noexcept { ++i; return *this; }
+        inline key_iterator operator++(int) noexcept { return key_iterator(i++);}
+        const_iterator base() const noexcept { return i; }
+    };
+
+    typedef QKeyValueIterator<const Key&, const T&, const_iterator> const_key_value_iterator;
+
+    const_iterator begin() const noexcept { return const_iterator(QPersistentHashPrivate::iterator<Key, T>(root)); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator constBegin() const noexcept { return begin(); }
+    const_iterator end() const noexcept { return const_iterator(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_iterator constEnd() const noexcept { return end(); }
+    key_iterator keyBegin() const noexcept { return key_iterator(begin()); }
+    key_iterator keyEnd() const noexcept { return key_iterator(end()); }
+    const_key_value_iterator keyValueBegin() const noexcept { return const_key_value_iterator(begin()); }
+    const_key_value_iterator constKeyValueBegin() const noexcept { return const_key_value_iterator(begin()); }
+    const_key_value_iterator keyValueEnd() const noexcept { return const_key_value_iterator(end()); }
+    const_key_value_iterator constKeyValueEnd() const noexcept { return const_key_value_iterator(end()); }
+    auto asKeyValueRange() const & { return QtPrivate::QKeyValueRange(*this); }
+    auto asKeyValueRange() const && { return QtPrivate::QKeyValueRange(std::move(*this)); }
+
+    const_iterator find(const Key &key) const noexcept
+    {
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
+        return const_iterator(QPersistentHashPrivate::iterator<Key, T>(root, key, hash));
+    }
+    const_iterator constFind(const Key &key) const noexcept { return find(key); }
+
+private:
+    const Entry *findEntry(const Key &key) const noexcept
+    {
+        return root ? Node::find(root, key, QHashPrivate::calculateHash(key, seed)) : nullptr;
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QPERSISTENTHASH_H
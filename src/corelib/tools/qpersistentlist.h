@@ -0,0 +1,581 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QPERSISTENTLIST_H
+#define QPERSISTENTLIST_H
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qcontainertools_impl.h>
+#include <QtCore/qiterator.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qscopeguard.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <memory>
+
+class tst_QPersistentList; // for befriending
+
+QT_BEGIN_NAMESPACE
+
+namespace QPersistentListPrivate {
+
+// The elements are kept in leaves of 32, indexed by a trie of branches
+// with 32 children each. Five bits of the index select the child on each
+// level.
+constexpr int Bits = 5;
+constexpr int Width = 1 << Bits;
+constexpr int Mask = Width - 1;
+
+// Nodes are shared between lists and are never modified while they are:
+// a list that modifies a shared node works on a copy of it, and of all
+// the nodes on the path to it. The reference count is read with acquire
+// semantics, so that the releases of other threads, that may still have
+// read the node, happen before it is modified in place.
+struct Node
+{
+    QAtomicInt ref = 1;
+
+    bool isShared() const noexcept { return ref.loadAcquire() != 1; }
+};
+
+struct Branch : Node
+{
+    Node *children[Width] = {};
+};
+
+template <typename T>
+struct Leaf : Node
+{
+    int count = 0;
+    alignas(T) unsigned char storage[Width * sizeof(T)];
+
+    Leaf() noexcept = default;
+    Q_DISABLE_COPY_MOVE(Leaf)
+    ~Leaf() { std::destroy_n(values(), count); }
+
+    T *values() noexcept { return reinterpret_cast<T *>(storage); }
+    const T *values() const noexcept { return reinterpret_cast<const T *>(storage); }
+};
+
+// Releases a reference to the node at the given level (0 for leaves),
+// freeing the node and releasing its children when it was the last one.
+template <typename T>
+void release(Node *node, int level) noexcept
+{
+    if (node->ref.deref())
+        return;
+    if (level == 0) {
+        delete static_cast<Leaf<T> *>(node);
+        return;
+    }
+    Branch *branch = static_cast<Branch *>(node);
+    for (Node *child : branch->children) {
+        if (child)
+            release<T>(child, level - Bits);
+    }
+    delete branch;
+}
+
+template <typename T>
+Node *copy(const Node *node, int level)
+{
+    if (level == 0) {
+        const Leaf<T> *from = static_cast<const Leaf<T> *>(node);
+        Leaf<T> *to = new Leaf<T>;
+        auto cleanup = qScopeGuard([to] { delete to; });
+        for (; to->count < from->count; ++to->count)
+            new (to->values() + to->count) T(from->values()[to->count]);
+        cleanup.dismiss();
+        return to;
+    }
+    const Branch *from = static_cast<const Branch *>(node);
+    Branch *to = new Branch;
+    for (int i = 0; i < Width; ++i) {
+        if ((to->children[i] = from->children[i]))
+            to->children[i]->ref.ref();
+    }
+    return to;
+}
+
+// Makes sure that the node in slot is not shared, replacing it with a
+// copy if it is.
+template <typename T>
+void detach(Node *&slot, int level)
+{
+    if (!slot->isShared())
+        return;
+    Node *c = copy<T>(slot, level);
+    release<T>(std::exchange(slot, c), level);
+}
+
+} // namespace QPersistentListPrivate
+
+template <typename T>
+class QPersistentList
+{
+    using Node = QPersistentListPrivate::Node;
+    using Branch = QPersistentListPrivate::Branch;
+    using Leaf = QPersistentListPrivate::Leaf<T>;
+    static constexpr int Bits = QPersistentListPrivate::Bits;
+    static constexpr int Width = QPersistentListPrivate::Width;
+    static constexpr int Mask = QPersistentListPrivate::Mask;
+    friend tst_QPersistentList;
+
+    // The trie holds the full leaves, the tail the last leaf, which has
+    // at least one element if the list is not empty.
+    Node *root = nullptr;
+    Leaf *tail = nullptr;
+    qsizetype s = 0;
+    int shift = Bits; // of the children of the root
+
+public:
+    using value_type = T;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using size_type = qsizetype;
+    using difference_type = qptrdiff;
+
+    class const_iterator
+    {
+        friend class QPersistentList<T>;
+        const QPersistentList *l = nullptr;
+        const T *leaf = nullptr;
+        qsizetype i = 0;
+
+        const_iterator(const QPersistentList *list, qsizetype index) noexcept
+            : l(list), i(index)
+        {
+            if (i < l->s)
+                leaf = l->leafFor(i)->values();
+        }
+
+    public:
+        using difference_type = qptrdiff;
+        using value_type = T;
+        using pointer = const T *;
+        using reference = const T &;
+        using iterator_category = std::random_access_iterator_tag;
+
+        constexpr const_iterator() noexcept = default;
+
+        const T &operator*() const noexcept { return leaf[i & Mask]; }
+        const T *operator->() const noexcept { return leaf + (i & Mask); }
+        const T &operator[](qsizetype j) const noexcept { return l->at(i + j); }
+
+        friend bool operator==(const const_iterator &lhs, const const_iterator &rhs) noexcept { return lhs.i == rhs.i; }
+        friend bool operator!=(const const_iterator &lhs, const const_iterator &rhs) noexcept { return lhs.i != rhs.i; }
+        friend bool operator<(const const_iterator &lhs, const const_iterator &rhs) noexcept { return lhs.i < rhs.i; }
+        friend bool operator<=(const const_iterator &lhs, const const_iterator &rhs) noexcept { return lhs.i <= rhs.i; }
+        friend bool operator>(const const_iterator &lhs, const const_iterator &rhs) noexcept { return lhs.i > rhs.i; }
+        friend bool operator>=(const const_iterator &lhs, const const_iterator &rhs) noexcept { return lhs.i >= rhs.i; }
+
+        const_iterator &operator++() noexcept
+        {
+            // the next leaf is only looked up when crossing into it
+            if ((++i & Mask) == 0 && i < l->s)
+                leaf = l->leafFor(i)->values();
+            return *this;
+        }
+        const_iterator operator++(int) noexcept { const_iterator r = *this; ++*this; return r; }
+        const_iterator &operator--() noexcept
+        {
+            if ((i-- & Mask) == 0 || !leaf)
+                leaf = l->leafFor(i)->values();
+            return *this;
+        }
+        const_iterator operator--(int) noexcept { const_iterator r = *this; --*this; return r; }
+        const_iterator &operator+=(qsizetype j) noexcept { *this = const_iterator(l, i + j); return *this; }
+        const_iterator &operator-=(qsizetype j) noexcept { return *this += -j; }
+        friend const_iterator operator+(const_iterator it, qsizetype j) noexcept { return it += j; }
+        friend const_iterator operator+(qsizetype j, const_iterator it) noexcept { return it += j; }
+        friend const_iterator operator-(const_iterator it, qsizetype j) noexcept { return it -= j; }
+        friend qsizetype operator-(const const_iterator &lhs, const const_iterator &rhs) noexcept { return lhs.i - rhs.i; }
+    };
+    using iterator = const_iterator;
+    using ConstIterator = const_iterator;
+    using Iterator = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reverse_iterator = const_reverse_iterator;
+
+    QPersistentList() noexcept = default;
+    QPersistentList(std::initializer_list<T> args)
+    {
+        for (const T &t : args)
+            append(t);
+    }
+    template <typename InputIterator, QtPrivate::IfIsInputIterator<InputIterator> = true>
+    QPersistentList(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first)
+            append(*first);
+    }
+    explicit QPersistentList(const QList<T> &list)
+        : QPersistentList(list.cbegin(), list.cend())
+    {}
+
+    QPersistentList(const QPersistentList &other) noexcept
+        : root(other.root), tail(other.tail), s(other.s), shift(other.shift)
+    {
+        if (root)
+            root->ref.ref();
+        if (tail)
+            tail->ref.ref();
+    }
+    QPersistentList(QPersistentList &&other) noexcept
+        : root(std::exchange(other.root, nullptr)), tail(std::exchange(other.tail, nullptr)),
+          s(std::exchange(other.s, 0)), shift(std::exchange(other.shift, Bits))
+    {}
+    ~QPersistentList()
+    {
+        static_assert(std::is_nothrow_destructible_v<T>, "Types with throwing destructors are not supported in Qt containers.");
+        clear();
+    }
+
+    QPersistentList &operator=(const QPersistentList &other) noexcept
+    {
+        QPersistentList copy(other);
+        swap(copy);
+        return *this;
+    }
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_MOVE_AND_SWAP(QPersistentList)
+
+    void swap(QPersistentList &other) noexcept
+    {
+        qt_ptr_swap(root, other.root);
+        qt_ptr_swap(tail, other.tail);
+        std::swap(s, other.s);
+        std::swap(shift, other.shift);
+    }
+
+    QList<T> toList() const
+    {
+        return QList<T>(begin(), end());
+    }
+
+#ifndef Q_CLANG_QDOC
+    template <typename U = T>
+    QTypeTraits::compare_eq_result_container<QPersistentList, U> operator==(const QPersistentList &other) const
+    {
+        if (s != other.s)
+            return false;
+        if (root == other.root && tail == other.tail)
+            return true;
+        return std::equal(begin(), end(), other.begin());
+    }
+    template <typename U = T>
+    QTypeTraits::compare_eq_result_container<QPersistentList, U> operator!=(const QPersistentList &other) const
+    {
+        return !(*this == other);
+    }
+#else
+    bool operator==(const QPersistentList &other) const;
+    bool operator!=(const QPersistentList &other) const;
+#endif
+
+    qsizetype size() const noexcept { return s; }
+    qsizetype count() const noexcept { return s; }
+    qsizetype length() const noexcept { return s; }
+    bool isEmpty() const noexcept { return s == 0; }
+
+    bool isSharedWith(const QPersistentList &other) const noexcept
+    {
+        return root == other.root && tail == other.tail;
+    }
+
+    void clear() noexcept
+    {
+        if (root)
+            QPersistentListPrivate::release<T>(root, shift);
+        if (tail)
+            QPersistentListPrivate::release<T>(tail, 0);
+        root = nullptr;
+        tail = nullptr;
+        s = 0;
+        shift = Bits;
+    }
+
+    const T &at(qsizetype i) const noexcept
+    {
+        Q_ASSERT_X(size_t(i) < size_t(s), "QPersistentList::at", "index out of range");
+        return leafFor(i)->values()[i & Mask];
+    }
+    const T &operator[](qsizetype i) const noexcept { return at(i); }
+    T &operator[](qsizetype i)
+    {
+        Q_ASSERT_X(size_t(i) < size_t(s), "QPersistentList::operator[]", "index out of range");
+        return *detachedSlot(i);
+    }
+    T value(qsizetype i) const { return value(i, T()); }
+    T value(qsizetype i, const T &defaultValue) const
+    {
+        return size_t(i) < size_t(s) ? at(i) : defaultValue;
+    }
+
+    const T &first() const noexcept { Q_ASSERT(!isEmpty()); return at(0); }
+    const T &constFirst() const noexcept { Q_ASSERT(!isEmpty()); return at(0); }
+    const T &last() const noexcept { Q_ASSERT(!isEmpty()); return tail->values()[tail->count - 1]; }
+    const T &constLast() const noexcept { Q_ASSERT(!isEmpty()); return tail->values()[tail->count - 1]; }
+
+    template <typename AT = T>
+    qsizetype indexOf(const AT &t, qsizetype from = 0) const noexcept
+    {
+        if (from < 0)
+            from = qMax(from + s, qsizetype(0));
+        for (auto it = begin() + from, e = end(); it < e; ++it) {
+            if (*it == t)
+                return it - begin();
+        }
+        return -1;
+    }
+    template <typename AT = T>
+    bool contains(const AT &t) const noexcept { return indexOf(t) != -1; }
+
+    void replace(qsizetype i, const T &t)
+    {
+        Q_ASSERT_X(size_t(i) < size_t(s), "QPersistentList::replace", "index out of range");
+        T copy(t); // t may refer to an element that is about to be detached
+        *detachedSlot(i) = std::move(copy);
+    }
+    void replace(qsizetype i, T &&t)
+    {
+        Q_ASSERT_X(size_t(i) < size_t(s), "QPersistentList::replace", "index out of range");
+        *detachedSlot(i) = std::move(t);
+    }
+
+    void append(const T &t) { emplaceBack(t); }
+    void append(T &&t) { emplaceBack(std::move(t)); }
+    void push_back(const T &t) { emplaceBack(t); }
+    void push_back(T &&t) { emplaceBack(std::move(t)); }
+
+    template <typename ...Args>
+    T &emplaceBack(Args &&... args)
+    {
+        using namespace QPersistentListPrivate;
+        if (tail && tail->count < Width) {
+            if (tail->isShared()) {
+                T t(std::forward<Args>(args)...); // args may refer to the tail
+                Node *slot = tail;
+                detach<T>(slot, 0);
+                tail = static_cast<Leaf *>(slot);
+                new (tail->values() + tail->count) T(std::move(t));
+            } else {
+                new (tail->values() + tail->count) T(std::forward<Args>(args)...);
+            }
+            ++tail->count;
+            ++s;
+            return tail->values()[tail->count - 1];
+        }
+
+        // the tail is full, or there is none: a new one takes the element,
+        // and the full one goes into the trie
+        Leaf *leaf = new Leaf;
+        auto cleanup = qScopeGuard([leaf] { delete leaf; });
+        new (leaf->values()) T(std::forward<Args>(args)...);
+        leaf->count = 1;
+        if (tail)
+            pushTail();
+        cleanup.dismiss();
+        tail = leaf;
+        ++s;
+        return tail->values()[0];
+    }
+
+    void removeLast()
+    {
+        Q_ASSERT(!isEmpty());
+        using namespace QPersistentListPrivate;
+        if (tail->count > 1 && !tail->isShared()) {
+            std::destroy_at(tail->values() + --tail->count);
+            --s;
+            return;
+        }
+        if (tail->count > 1) {
+            // keep all but the last element of the shared tail
+            Leaf *leaf = new Leaf;
+            auto cleanup = qScopeGuard([leaf] { delete leaf; });
+            for (; leaf->count < tail->count - 1; ++leaf->count)
+                new (leaf->values() + leaf->count) T(tail->values()[leaf->count]);
+            cleanup.dismiss();
+            release<T>(std::exchange(tail, leaf), 0);
+            --s;
+            return;
+        }
+        Leaf *old = std::exchange(tail, nullptr);
+        auto restore = qScopeGuard([&] { tail = old; ++s; });
+        if (--s > 0)
+            popTail();
+        restore.dismiss();
+        release<T>(old, 0);
+    }
+    T takeLast()
+    {
+        Q_ASSERT(!isEmpty());
+        T t = last();
+        removeLast();
+        return t;
+    }
+    void pop_back() { removeLast(); }
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, s); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_iterator constBegin() const noexcept { return begin(); }
+    const_iterator constEnd() const noexcept { return end(); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // STL compatibility
+    inline bool empty() const noexcept { return isEmpty(); }
+    const T &front() const noexcept { return first(); }
+    const T &back() const noexcept { return last(); }
+
+private:
+    qsizetype tailOffset() const noexcept { return s - (tail ? tail->count : 0); }
+
+    const Leaf *leafFor(qsizetype i) const noexcept
+    {
+        if (i >= tailOffset())
+            return tail;
+        const Node *node = root;
+        for (int level = shift; level > 0; level -= Bits)
+            node = static_cast<const Branch *>(node)->children[(i >> level) & Mask];
+        return static_cast<const Leaf *>(node);
+    }
+
+    // Returns the element at index i, after detaching the path to it.
+    T *detachedSlot(qsizetype i)
+    {
+        using namespace QPersistentListPrivate;
+        const qsizetype offset = tailOffset();
+        if (i >= offset) {
+            Node *slot = tail;
+            detach<T>(slot, 0);
+            tail = static_cast<Leaf *>(slot);
+            return tail->values() + (i - offset);
+        }
+        Node **slot = &root;
+        for (int level = shift; level > 0; level -= Bits) {
+            detach<T>(*slot, level);
+            slot = &static_cast<Branch *>(*slot)->children[(i >> level) & Mask];
+        }
+        detach<T>(*slot, 0);
+        return static_cast<Leaf *>(*slot)->values() + (i & Mask);
+    }
+
+    // Moves the full tail into the trie, as its last leaf.
+    void pushTail()
+    {
+        using namespace QPersistentListPrivate;
+        Q_ASSERT(tail->count == Width);
+        const qsizetype index = s - Width; // of the first element of the tail
+        if (!root) {
+            root = new Branch;
+            shift = Bits;
+        } else if ((s >> Bits) > (qsizetype(1) << shift)) {
+            // the trie is full: it grows by one level
+            Branch *newRoot = new Branch;
+            newRoot->children[0] = root;
+            root = newRoot;
+            shift += Bits;
+        }
+
+        Node **slot = &root;
+        for (int level = shift; level > Bits; level -= Bits) {
+            detach<T>(*slot, level);
+            Node *&child = static_cast<Branch *>(*slot)->children[(index >> level) & Mask];
+            if (!child)
+                child = new Branch;
+            slot = &child;
+        }
+        detach<T>(*slot, Bits);
+        static_cast<Branch *>(*slot)->children[(index >> Bits) & Mask] = std::exchange(tail, nullptr);
+    }
+
+    // Takes the last leaf out of the trie, as the new tail.
+    void popTail()
+    {
+        using namespace QPersistentListPrivate;
+        Q_ASSERT(!tail);
+        const qsizetype index = s - 1; // of the last element in the trie
+        if (s == Width) {
+            // the trie holds a single leaf
+            Branch *branch = static_cast<Branch *>(root);
+            Q_ASSERT(shift == Bits);
+            tail = static_cast<Leaf *>(branch->children[0]);
+            tail->ref.ref();
+            release<T>(std::exchange(root, nullptr), Bits);
+            return;
+        }
+
+        // The path to the leaf is detached, except for the leaf itself,
+        // which moves to the tail with the reference its branch had.
+        const int depth = shift / Bits;
+        Node **path[64 / Bits + 1];
+        Node **slot = &root;
+        for (int level = shift, n = 0; level > 0; level -= Bits, ++n) {
+            detach<T>(*slot, level);
+            path[n] = slot;
+            slot = &static_cast<Branch *>(*slot)->children[(index >> level) & Mask];
+        }
+        tail = static_cast<Leaf *>(std::exchange(*slot, nullptr));
+
+        // the branches left without children go, too
+        for (int n = depth - 1, level = Bits; n >= 0 && ((index >> level) & Mask) == 0; --n, level += Bits)
+            delete static_cast<Branch *>(std::exchange(*path[n], nullptr));
+
+        // as does a root with a single child
+        while (shift > Bits && !static_cast<Branch *>(root)->children[1]) {
+            Branch *old = static_cast<Branch *>(root);
+            root = std::exchange(old->children[0], nullptr);
+            delete old;
+            shift -= Bits;
+        }
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QPERSISTENTLIST_H
@@ -5328,6 +5328,53 @@ void tst_QSortFilterProxyModel::invalidateColumnsOrRowsFilter()
     QCOMPARE(proxy.rowFiltered, 20);
 }
 
+void tst_QSortFilterProxyModel::sortUsingCollationKeys_data()
+{
+    QTest::addColumn<QStringList>("strings");
+    QTest::addColumn<Qt::SortOrder>("order");
+
+    const QStringList strings = { "banana", "Apple", "apple", "\u00e9clair", "eclair",
+                                  "Zebra", "zebra", "", "cherry", "Cherry", "banana",
+                                  "\u00c5ngstr\u00f6m", "angstrom", "10", "9" };
+    QTest::newRow("ascending") << strings << Qt::AscendingOrder;
+    QTest::newRow("descending") << strings << Qt::DescendingOrder;
+}
+
+void tst_QSortFilterProxyModel::sortUsingCollationKeys()
+{
+    QFETCH(QStringList, strings);
+    QFETCH(Qt::SortOrder, order);
+
+    QStringListModel model(strings);
+    QSortFilterProxyModel reference;
+    reference.setSourceModel(&model);
+    reference.setSortLocaleAware(true);
+    reference.sort(0, order);
+
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setSortLocaleAware(true);
+    proxy.setSortUsingCollationKeys(true);
+    proxy.sort(0, order);
+
+    QCOMPARE(proxy.rowCount(), reference.rowCount());
+    for (int row = 0; row < proxy.rowCount(); ++row) {
+        QCOMPARE(proxy.mapToSource(proxy.index(row, 0)).row(),
+                 reference.mapToSource(reference.index(row, 0)).row());
+    }
+
+    // data that is not a string falls back to lessThan()
+    QStandardItemModel numbers;
+    for (int i : { 3, 10, 2, 1 })
+        numbers.appendRow(new QStandardItem(QString::number(i)));
+    for (int i = 0; i < numbers.rowCount(); ++i)
+        numbers.setData(numbers.index(i, 0), numbers.index(i, 0).data().toInt());
+    proxy.setSourceModel(&numbers);
+    proxy.sort(0, Qt::AscendingOrder);
+    QCOMPARE(proxy.index(0, 0).data().toInt(), 1);
+    QCOMPARE(proxy.index(3, 0).data().toInt(), 10);
+}
+
 void tst_QSortFilterProxyModel::filterKeyColumnBinding()
 {
     QSortFilterProxyModel proxyModel;
@@ -5360,6 +5407,14 @@ void tst_QSortFilterProxyModel::isSortLocaleAwareBinding()
                                                                            "isSortLocaleAware");
 }
 
+void tst_QSortFilterProxyModel::sortUsingCollationKeysBinding()
+{
+    QSortFilterProxyModel proxyModel;
+    QCOMPARE(proxyModel.sortUsingCollationKeys(), false);
+    QTestPrivate::testReadWritePropertyBasics<QSortFilterProxyModel, bool>(
+            proxyModel, true, false, "sortUsingCollationKeys");
+}
+
 void tst_QSortFilterProxyModel::sortRoleBinding()
 {
     QSortFilterProxyModel proxyModel;
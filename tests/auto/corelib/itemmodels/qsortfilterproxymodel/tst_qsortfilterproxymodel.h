@@ -166,11 +166,14 @@ private slots:
 
     void checkFilteredIndexes();
     void invalidateColumnsOrRowsFilter();
+    void sortUsingCollationKeys_data();
+    void sortUsingCollationKeys();
 
     void filterKeyColumnBinding();
     void dynamicSortFilterBinding();
     void sortCaseSensitivityBinding();
     void isSortLocaleAwareBinding();
+    void sortUsingCollationKeysBinding();
     void sortRoleBinding();
     void filterRoleBinding();
     void recursiveFilteringEnabledBinding();
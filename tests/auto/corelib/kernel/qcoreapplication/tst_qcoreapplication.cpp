@@ -586,6 +586,147 @@ void tst_QCoreApplication::globalPostedEventsCount()
     QCOMPARE(x.globalPostedEventsCount, expected);
 }
 
+class ValueEvent : public QEvent
+{
+public:
+    ValueEvent(Type type, int value) : QEvent(type), value(value) { }
+    int value;
+};
+
+class ValueEventSpy : public QObject
+{
+    Q_OBJECT
+
+public:
+    QList<std::pair<int, int>> recordedEvents;
+
+    bool event(QEvent *event) override
+    {
+        if (event->type() >= QEvent::User) {
+            recordedEvents.append({ event->type(), static_cast<ValueEvent *>(event)->value });
+            return true;
+        }
+        return QObject::event(event);
+    }
+};
+
+void tst_QCoreApplication::eventCompression()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    const auto compressed = QEvent::Type(QEvent::User + 100);
+    const auto uncompressed = QEvent::Type(QEvent::User + 101);
+    QVERIFY(!QCoreApplication::isEventCompressionEnabled(compressed));
+    QCoreApplication::setEventCompressionEnabled(compressed);
+    const auto reset = qScopeGuard([&] {
+        QCoreApplication::setEventCompressionEnabled(compressed, false);
+    });
+    QVERIFY(QCoreApplication::isEventCompressionEnabled(compressed));
+    QVERIFY(!QCoreApplication::isEventCompressionEnabled(uncompressed));
+
+    QTest::ignoreMessage(QtWarningMsg, "QCoreApplication::setEventCompressionEnabled: "
+                                       "Events of type 43 cannot be compressed");
+    QCoreApplication::setEventCompressionEnabled(QEvent::MetaCall);
+    QVERIFY(!QCoreApplication::isEventCompressionEnabled(QEvent::MetaCall));
+
+    using Events = QList<std::pair<int, int>>;
+    ValueEventSpy one, two;
+
+    // the latest event wins and keeps the place of the first one; the
+    // receivers are compressed independently
+    QCoreApplication::postEvent(&one, new ValueEvent(compressed, 1));
+    QCoreApplication::postEvent(&one, new ValueEvent(uncompressed, 2));
+    QCoreApplication::postEvent(&two, new ValueEvent(compressed, 3));
+    QCoreApplication::postEvent(&one, new ValueEvent(compressed, 4));
+    QCoreApplication::postEvent(&one, new ValueEvent(uncompressed, 5));
+    QCoreApplication::postEvent(&two, new ValueEvent(compressed, 6));
+    QCoreApplication::postEvent(&one, new ValueEvent(compressed, 7));
+    QCOMPARE(qGlobalPostedEventsCount(), 4u);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(one.recordedEvents, Events({ { compressed, 7 }, { uncompressed, 2 },
+                                          { uncompressed, 5 } }));
+    QCOMPARE(two.recordedEvents, Events({ { compressed, 6 } }));
+    one.recordedEvents.clear();
+    two.recordedEvents.clear();
+
+    // an event with another priority doesn't replace the pending one
+    QCoreApplication::postEvent(&one, new ValueEvent(compressed, 1));
+    QCoreApplication::postEvent(&one, new ValueEvent(compressed, 2), Qt::HighEventPriority);
+    QCoreApplication::postEvent(&one, new ValueEvent(compressed, 3), Qt::HighEventPriority);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(one.recordedEvents, Events({ { compressed, 3 }, { compressed, 1 } }));
+    one.recordedEvents.clear();
+
+    // removed events are not replaced
+    QCoreApplication::postEvent(&one, new ValueEvent(compressed, 1));
+    QCoreApplication::removePostedEvents(&one, compressed);
+    QCoreApplication::postEvent(&one, new ValueEvent(compressed, 2));
+    QCoreApplication::postEvent(&one, new ValueEvent(compressed, 3));
+    QCOMPARE(qGlobalPostedEventsCount(), 1u);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(one.recordedEvents, Events({ { compressed, 3 } }));
+    one.recordedEvents.clear();
+
+    // without compression, every event is delivered
+    QCoreApplication::setEventCompressionEnabled(compressed, false);
+    QVERIFY(!QCoreApplication::isEventCompressionEnabled(compressed));
+    QCoreApplication::postEvent(&one, new ValueEvent(compressed, 1));
+    QCoreApplication::postEvent(&one, new ValueEvent(compressed, 2));
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(one.recordedEvents, Events({ { compressed, 1 }, { compressed, 2 } }));
+}
+
+void tst_QCoreApplication::eventCompressionFlood()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    const auto compressed = QEvent::Type(QEvent::User + 100);
+    const auto uncompressed = QEvent::Type(QEvent::User + 101);
+    QCoreApplication::setEventCompressionEnabled(compressed);
+    const auto reset = qScopeGuard([&] {
+        QCoreApplication::setEventCompressionEnabled(compressed, false);
+    });
+
+    using Events = QList<std::pair<int, int>>;
+    ValueEventSpy consumer, other;
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(qGlobalPostedEventsCount(), 0u);
+
+    // the queue doesn't grow however many events are posted, and events
+    // inserted in front of the pending one by priority don't break the
+    // lookup
+    constexpr int Count = 100000;
+    for (int i = 0; i < Count; ++i) {
+        QCoreApplication::postEvent(&consumer, new ValueEvent(compressed, i));
+        if (i % 10000 == 0) {
+            QCoreApplication::postEvent(&other, new ValueEvent(uncompressed, i),
+                                        Qt::HighEventPriority);
+        }
+    }
+    QCOMPARE(qGlobalPostedEventsCount(), 1u + Count / 10000);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(consumer.recordedEvents, Events({ { compressed, Count - 1 } }));
+    QCOMPARE(other.recordedEvents.size(), Count / 10000);
+    consumer.recordedEvents.clear();
+
+#if QT_CONFIG(thread)
+    // a producer in another thread flooding the consumer
+    QScopedPointer<QThread> producer(QThread::create([&consumer, compressed] {
+        for (int i = 0; i < Count; ++i)
+            QCoreApplication::postEvent(&consumer, new ValueEvent(compressed, i));
+    }));
+    producer->start();
+    QVERIFY(producer->wait());
+    QCOMPARE(qGlobalPostedEventsCount(), 1u);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(consumer.recordedEvents, Events({ { compressed, Count - 1 } }));
+#endif
+}
+
 class ProcessEventsAlwaysSendsPostedEventsObject : public QObject
 {
 public:
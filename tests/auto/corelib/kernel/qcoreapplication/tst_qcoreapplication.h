@@ -48,6 +48,8 @@ private slots:
 #endif
     void applicationPid();
     void globalPostedEventsCount();
+    void eventCompression();
+    void eventCompressionFlood();
     void processEventsAlwaysSendsPostedEvents();
 #ifdef Q_OS_WIN
     void sendPostedEventsInNativeLoop();
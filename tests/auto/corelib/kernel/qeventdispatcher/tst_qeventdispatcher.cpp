@@ -37,6 +37,13 @@
 #include <QTimer>
 #include <QThreadPool>
 
+#ifdef USE_EPOLL_DISPATCHER
+static const bool epollDispatcherRequested = []() {
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    return true;
+}();
+#endif
+
 enum {
     PreciseTimerInterval    =   10,
     CoarseTimerInterval     =  200,
@@ -106,6 +113,11 @@ bool tst_QEventDispatcher::event(QEvent *e)
 // drain the system event queue after the test starts to avoid destabilizing the test functions
 void tst_QEventDispatcher::initTestCase()
 {
+#ifdef USE_EPOLL_DISPATCHER
+    if (!isGuiEventDispatcher)
+        QVERIFY(eventDispatcher->inherits("QEventDispatcherEpoll"));
+#endif
+
     QElapsedTimer elapsedTimer;
     elapsedTimer.start();
     while (!elapsedTimer.hasExpired(CoarseTimerInterval) && eventDispatcher->processEvents(QEventLoop::AllEvents)) {
@@ -172,6 +172,8 @@ private slots:
     void singleShotConnection();
     void objectNameBinding();
     void emitToDestroyedClass();
+    void queuedSignalsOrderWithPostedEvents();
+    void queuedSignalsWhileMovingReceiver();
 };
 
 struct QObjectCreatedOnShutdown
@@ -8245,6 +8247,83 @@ void tst_QObject::emitToDestroyedClass()
     QCOMPARE(wouldHaveAssertedCount, 1);
 }
 
+namespace QueuedSignalDelivery {
+class Sender : public QObject
+{
+    Q_OBJECT
+signals:
+    void valueChanged(int value);
+};
+
+class Receiver : public QObject
+{
+    Q_OBJECT
+public:
+    QList<int> values;
+
+public slots:
+    void receive(int value) { values.append(value); }
+
+protected:
+    void customEvent(QEvent *event) override { values.append(-int(event->type())); }
+};
+} // namespace QueuedSignalDelivery
+
+void tst_QObject::queuedSignalsOrderWithPostedEvents()
+{
+    using namespace QueuedSignalDelivery;
+    Sender sender;
+    Receiver receiver;
+    QObject::connect(&sender, &Sender::valueChanged, &receiver, &Receiver::receive,
+                     Qt::QueuedConnection);
+
+    QScopedPointer<QThread> thread(QThread::create([&sender, &receiver]() {
+        emit sender.valueChanged(1);
+        QCoreApplication::postEvent(&receiver, new QEvent(QEvent::User));
+        emit sender.valueChanged(2);
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+
+    QCoreApplication::sendPostedEvents(&receiver);
+    QCOMPARE(receiver.values, QList<int>({ 1, -int(QEvent::User), 2 }));
+}
+
+void tst_QObject::queuedSignalsWhileMovingReceiver()
+{
+    using namespace QueuedSignalDelivery;
+    const int emissions = 20000;
+    Sender sender;
+    Receiver receiver;
+    QObject::connect(&sender, &Sender::valueChanged, &receiver, &Receiver::receive,
+                     Qt::QueuedConnection);
+
+    QThread worker;
+    worker.start();
+    QThread *mainThread = QThread::currentThread();
+    QScopedPointer<QThread> producer(QThread::create([&sender]() {
+        for (int i = 0; i < emissions; ++i)
+            emit sender.valueChanged(i);
+    }));
+    producer->start();
+
+    // bounce the receiver between the threads while signals are queued to it
+    while (!producer->isFinished()) {
+        receiver.moveToThread(&worker);
+        QMetaObject::invokeMethod(&receiver, [&receiver, mainThread]() {
+            receiver.moveToThread(mainThread);
+        }, Qt::BlockingQueuedConnection);
+        QCoreApplication::processEvents();
+    }
+    QVERIFY(producer->wait());
+    worker.quit();
+    QVERIFY(worker.wait());
+
+    QTRY_COMPARE(receiver.values.size(), emissions);
+    for (int i = 0; i < emissions; ++i)
+        QCOMPARE(receiver.values.at(i), i);
+}
+
 // Test for QtPrivate::HasQ_OBJECT_Macro
 static_assert(QtPrivate::HasQ_OBJECT_Macro<tst_QObject>::Value);
 static_assert(!QtPrivate::HasQ_OBJECT_Macro<SiblingDeleter>::Value);
@@ -46,6 +46,14 @@
 #include <unistd.h>
 #endif
 
+#ifdef USE_EPOLL_DISPATCHER
+static const bool epollDispatcherRequested = []() {
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    qputenv("QT_EVENT_DISPATCHER_EPOLL_TIMERFD", "1");
+    return true;
+}();
+#endif
+
 class tst_QTimer : public QObject
 {
     Q_OBJECT
@@ -1556,6 +1556,14 @@ void tst_QByteArrayApiSymmetry::toDouble_data() const
     QTest::newRow("exponential")
         << QByteArray("9.31322574615478515625e-10") << 9.31322574615478515625e-10 << true;
 
+    // only the exact spellings "inf", "+inf", "-inf" and "nan" are special
+    QTest::newRow("-infinity") << QByteArray("-infinity") << 0.0 << false;
+    QTest::newRow("-INF") << QByteArray("-INF") << 0.0 << false;
+    QTest::newRow("-Inf") << QByteArray("-Inf") << 0.0 << false;
+    QTest::newRow("-nan") << QByteArray("-nan") << 0.0 << false;
+    QTest::newRow("-NaN") << QByteArray("-NaN") << 0.0 << false;
+    QTest::newRow("-nan(1)") << QByteArray("-nan(1)") << 0.0 << false;
+
     QTest::newRow("raw, null plus junk")
         << QByteArray::fromRawData("1.2\0 junk", 9) << 0.0 << false;
     QTest::newRow("raw, null-terminator excluded")
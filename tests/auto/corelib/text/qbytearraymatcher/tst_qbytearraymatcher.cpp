@@ -31,6 +31,7 @@
 
 #include <qbytearraymatcher.h>
 
+#include <algorithm>
 #include <numeric>
 #include <string>
 
@@ -51,6 +52,7 @@ private slots:
     void overloads();
     void interface();
     void indexIn();
+    void indexInEveryPosition();
     void staticByteArrayMatcher();
     void haystacksWithMoreThan4GiBWork();
 };
@@ -179,6 +181,32 @@ void tst_QByteArrayMatcher::indexIn()
     QCOMPARE(matcher.indexIn(haystack, 34), -1);
 }
 
+void tst_QByteArrayMatcher::indexInEveryPosition()
+{
+    // long enough for the SIMD code paths, made of few characters so that
+    // the needles have many near misses
+    QByteArray haystack(300, Qt::Uninitialized);
+    uint seed = 1;
+    for (char &c : haystack) {
+        seed = seed * 1103515245 + 12345;
+        c = "abcd"[(seed >> 16) % 4];
+    }
+
+    for (qsizetype length = 2; length <= 40; ++length) {
+        for (qsizetype pos = 0; pos + length <= haystack.size(); pos += 7) {
+            const QByteArray needle = haystack.mid(pos, length);
+            const QByteArrayMatcher matcher(needle);
+            for (qsizetype from : { qsizetype(0), pos / 2, pos, pos + 1 }) {
+                const auto it = std::search(haystack.cbegin() + from, haystack.cend(),
+                                            needle.cbegin(), needle.cend());
+                const qsizetype expected = it == haystack.cend() ? -1 : it - haystack.cbegin();
+                QCOMPARE(matcher.indexIn(haystack, from), expected);
+                QCOMPARE(haystack.indexOf(needle, from), expected);
+            }
+        }
+    }
+}
+
 void tst_QByteArrayMatcher::staticByteArrayMatcher()
 {
     {
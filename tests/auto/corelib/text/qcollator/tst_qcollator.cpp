@@ -47,6 +47,10 @@ private Q_SLOTS:
     void compare();
 
     void state();
+
+    void sortKeys_data();
+    void sortKeys();
+    void sortKeysLarge();
 };
 
 static bool dpointer_is_null(QCollator &c)
@@ -369,6 +373,87 @@ void tst_QCollator::state()
     QCOMPARE(c.locale(), QLocale(QLocale::NorwegianBokmal));
 }
 
+static int sign(int compared)
+{
+    return compared < 0 ? -1 : compared > 0 ? 1 : 0;
+}
+
+void tst_QCollator::sortKeys_data()
+{
+    QTest::addColumn<QString>("locale");
+    QTest::addColumn<bool>("numericMode");
+    QTest::addColumn<Qt::CaseSensitivity>("caseSensitivity");
+
+    QTest::newRow("C") << QString("C") << false << Qt::CaseSensitive;
+    QTest::newRow("en_US") << QString("en_US") << false << Qt::CaseSensitive;
+    QTest::newRow("en_US-numeric") << QString("en_US") << true << Qt::CaseSensitive;
+    QTest::newRow("de_DE-insensitive") << QString("de_DE") << false << Qt::CaseInsensitive;
+    QTest::newRow("sv_SE") << QString("sv_SE") << false << Qt::CaseSensitive;
+}
+
+void tst_QCollator::sortKeys()
+{
+    QFETCH(QString, locale);
+    QFETCH(bool, numericMode);
+    QFETCH(Qt::CaseSensitivity, caseSensitivity);
+
+    const QStringList strings = { "banana", "Apple", "apple", "\u00e9clair", "eclair", "Zebra",
+                                  "", "file10", "file9", "\u00c4rger", "Arger", "\u00f6l", "ol",
+                                  "banana", "zebra" };
+
+    QCollator collator((QLocale(locale)));
+    collator.setNumericMode(numericMode);
+    collator.setCaseSensitivity(caseSensitivity);
+
+    const QCollatorSortKeys keys = collator.sortKeys(strings);
+    QCOMPARE(keys.size(), strings.size());
+    QVERIFY(!keys.isEmpty());
+
+    for (qsizetype i = 0; i < strings.size(); ++i) {
+        for (qsizetype j = 0; j < strings.size(); ++j) {
+            QCOMPARE(sign(keys.compare(i, j)),
+                     sign(collator.compare(strings.at(i), strings.at(j))));
+        }
+    }
+
+    QStringList expected = strings;
+    std::stable_sort(expected.begin(), expected.end(), collator);
+    QStringList sorted;
+    for (qsizetype i : keys.sortedIndexes())
+        sorted.append(strings.at(i));
+    QCOMPARE(sorted, expected);
+
+    const QList<qsizetype> descending = keys.sortedIndexes(Qt::DescendingOrder);
+    QCOMPARE(descending.size(), strings.size());
+    for (qsizetype i = 1; i < descending.size(); ++i)
+        QVERIFY(keys.compare(descending.at(i - 1), descending.at(i)) >= 0);
+
+    // copies share the keys
+    QCollatorSortKeys copy = keys;
+    QCOMPARE(copy.size(), keys.size());
+    QCOMPARE(copy.sortedIndexes(), keys.sortedIndexes());
+
+    QVERIFY(QCollatorSortKeys().isEmpty());
+    QVERIFY(collator.sortKeys({}).isEmpty());
+}
+
+void tst_QCollator::sortKeysLarge()
+{
+    // enough strings for the keys to be generated in several chunks
+    QStringList strings;
+    for (int i = 0; i < 20000; ++i)
+        strings.append(QString::number((i * 7919) % 20000) + QChar(i % 2 ? u'\u00e9' : u'e'));
+
+    QCollator collator((QLocale(QLocale::French, QLocale::France)));
+    collator.setNumericMode(true);
+    const QCollatorSortKeys keys = collator.sortKeys(strings);
+    QCOMPARE(keys.size(), strings.size());
+
+    const QList<qsizetype> order = keys.sortedIndexes();
+    for (qsizetype i = 1; i < order.size(); ++i)
+        QVERIFY(collator.compare(strings.at(order.at(i - 1)), strings.at(order.at(i))) <= 0);
+}
+
 QTEST_APPLESS_MAIN(tst_QCollator)
 
 #include "tst_qcollator.moc"
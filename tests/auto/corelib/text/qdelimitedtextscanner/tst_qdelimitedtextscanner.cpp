@@ -0,0 +1,366 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QBuffer>
+#include <QFile>
+#include <qdelimitedtextscanner.h>
+
+#ifdef Q_OS_UNIX
+#  include <stdio.h>
+#  include <unistd.h>
+#endif
+
+using Records = QList<QStringList>;
+
+class tst_QDelimitedTextScanner : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void scan_data();
+    void scan();
+    void scanUtf8_data() { scan_data(); }
+    void scanUtf8();
+    void fields();
+    void separatorAndQuote();
+    void position();
+    void reader_data() { scan_data(); }
+    void reader();
+    void readerSequentialDevice_data();
+    void readerSequentialDevice();
+#ifdef Q_OS_UNIX
+    void readerPipe();
+#endif
+};
+
+template <typename Scanner>
+static Records scanAll(Scanner &scanner)
+{
+    Records records;
+    QList<typename Scanner::Field> fields;
+    while (scanner.readRecord(fields)) {
+        QStringList record;
+        for (const auto &field : fields) {
+            // view() must be the value unless the field needs unquoting
+            if (!field.needsUnquoting() && field.view().toString() != field.toString())
+                record.append(u"<view() differs from toString()>"_qs);
+            else
+                record.append(field.toString());
+        }
+        records.append(record);
+    }
+    return records;
+}
+
+void tst_QDelimitedTextScanner::scan_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<Records>("records");
+
+    QTest::newRow("empty") << QString() << Records();
+    QTest::newRow("one-field") << u"a"_qs << Records{ { u"a"_qs } };
+    QTest::newRow("one-record") << u"a,b,c"_qs << Records{ { u"a"_qs, u"b"_qs, u"c"_qs } };
+    QTest::newRow("lf") << u"a,b\nc,d\n"_qs
+                        << Records{ { u"a"_qs, u"b"_qs }, { u"c"_qs, u"d"_qs } };
+    QTest::newRow("crlf") << u"a,b\r\nc,d\r\n"_qs
+                          << Records{ { u"a"_qs, u"b"_qs }, { u"c"_qs, u"d"_qs } };
+    QTest::newRow("cr") << u"a,b\rc,d"_qs
+                        << Records{ { u"a"_qs, u"b"_qs }, { u"c"_qs, u"d"_qs } };
+    QTest::newRow("empty-fields") << u",,\n,"_qs
+                                  << Records{ { QString(), QString(), QString() },
+                                              { QString(), QString() } };
+    QTest::newRow("empty-lines") << u"a\n\n\nb"_qs
+                                 << Records{ { u"a"_qs }, { QString() }, { QString() }, { u"b"_qs } };
+    QTest::newRow("quoted") << u"\"a\",\"b,c\"\n\"d\ne\",\"\""_qs
+                            << Records{ { u"a"_qs, u"b,c"_qs }, { u"d\ne"_qs, QString() } };
+    QTest::newRow("quoted-crlf") << u"\"a\r\nb\"\r\nc"_qs
+                                 << Records{ { u"a\r\nb"_qs }, { u"c"_qs } };
+    QTest::newRow("escaped-quotes") << u"\"a\"\"b\",\"\"\"\"\"\",\"\"\"\""_qs
+                                    << Records{ { u"a\"b"_qs, u"\"\""_qs, u"\""_qs } };
+    QTest::newRow("quote-inside-unquoted") << u"a\"b,c\"\n"_qs
+                                           << Records{ { u"a\"b"_qs, u"c\""_qs } };
+    QTest::newRow("text-after-quote") << u"\"a\"b,\"c\"\"\"d\n"_qs
+                                      << Records{ { u"ab"_qs, u"c\"d"_qs } };
+    QTest::newRow("unterminated-quote") << u"a,\"b\nc,d"_qs
+                                        << Records{ { u"a"_qs, u"b\nc,d"_qs } };
+    QTest::newRow("unterminated-escaped-quote") << u"\"a\"\""_qs
+                                                << Records{ { u"a\""_qs } };
+    QTest::newRow("non-ascii") << u"été,\"€\"\"\U0001F600\"\n\U0001F600"_qs
+                               << Records{ { u"été"_qs, u"€\"\U0001F600"_qs },
+                                           { u"\U0001F600"_qs } };
+}
+
+void tst_QDelimitedTextScanner::scan()
+{
+    QFETCH(QString, text);
+    QFETCH(Records, records);
+
+    QDelimitedTextScanner scanner(text);
+    QCOMPARE(scanAll(scanner), records);
+    QVERIFY(scanner.atEnd());
+}
+
+void tst_QDelimitedTextScanner::scanUtf8()
+{
+    QFETCH(QString, text);
+    QFETCH(Records, records);
+
+    const QByteArray utf8 = text.toUtf8();
+    QUtf8DelimitedTextScanner scanner(utf8);
+    QCOMPARE(scanAll(scanner), records);
+    QVERIFY(scanner.atEnd());
+}
+
+void tst_QDelimitedTextScanner::fields()
+{
+    const QString text = u"plain,\"quoted\",\"esc\"\"aped\",\"\""_qs;
+    QDelimitedTextScanner scanner(text);
+    QList<QDelimitedTextScanner::Field> fields;
+    QVERIFY(scanner.readRecord(fields));
+    QCOMPARE(fields.size(), 4);
+
+    // all the fields are views into the text
+    for (const auto &field : fields) {
+        QVERIFY(field.rawView().data() >= text.constData());
+        QVERIFY(field.rawView().data() + field.rawView().size() <= text.constData() + text.size());
+    }
+
+    QVERIFY(!fields[0].isQuoted());
+    QVERIFY(!fields[0].needsUnquoting());
+    QCOMPARE(fields[0].view(), u"plain");
+    QCOMPARE(fields[0].rawView(), u"plain");
+
+    QVERIFY(fields[1].isQuoted());
+    QVERIFY(!fields[1].needsUnquoting());
+    QCOMPARE(fields[1].view(), u"quoted");
+    QCOMPARE(fields[1].rawView(), u"\"quoted\"");
+
+    QVERIFY(fields[2].isQuoted());
+    QVERIFY(fields[2].needsUnquoting());
+    QCOMPARE(fields[2].rawView(), u"\"esc\"\"aped\"");
+    QCOMPARE(fields[2].view(), fields[2].rawView());
+    QCOMPARE(fields[2].toString(), u"esc\"aped");
+
+    QVERIFY(fields[3].isQuoted());
+    QVERIFY(!fields[3].needsUnquoting());
+    QVERIFY(fields[3].view().isEmpty());
+
+    QVERIFY(!scanner.readRecord(fields));
+    QVERIFY(fields.isEmpty());
+
+    QDelimitedTextScanner::Field defaultField;
+    QVERIFY(defaultField.view().isNull());
+    QVERIFY(defaultField.toString().isNull());
+}
+
+void tst_QDelimitedTextScanner::separatorAndQuote()
+{
+    const QString tsv = u"a,b\t'c\td'\t''''\n"_qs;
+    QDelimitedTextScanner scanner(tsv, '\t', '\'');
+    QCOMPARE(scanner.separator(), '\t');
+    QCOMPARE(scanner.quote(), '\'');
+    QCOMPARE(scanAll(scanner), Records({ { u"a,b"_qs, u"c\td"_qs, u"'"_qs } }));
+
+    const QString semicolons = u"a;\"b;c\"\r\n"_qs;
+    QDelimitedTextScanner semicolonScanner(semicolons, ';');
+    QCOMPARE(scanAll(semicolonScanner), Records({ { u"a"_qs, u"b;c"_qs } }));
+}
+
+void tst_QDelimitedTextScanner::position()
+{
+    const QString text = u"a,b\r\n\"c\nd\"\ne"_qs;
+    QDelimitedTextScanner scanner(text);
+    QCOMPARE(scanner.text(), text);
+    QList<QDelimitedTextScanner::Field> fields;
+
+    QCOMPARE(scanner.position(), 0);
+    QVERIFY(!scanner.atEnd());
+    QVERIFY(scanner.readRecord(fields));
+    QCOMPARE(scanner.position(), 5);
+    QVERIFY(scanner.readRecord(fields));
+    QCOMPARE(scanner.position(), 11);
+    QVERIFY(scanner.readRecord(fields));
+    QCOMPARE(scanner.position(), text.size());
+    QVERIFY(scanner.atEnd());
+    QVERIFY(!scanner.readRecord(fields));
+
+    QDelimitedTextScanner empty(QStringView{});
+    QVERIFY(empty.atEnd());
+    QVERIFY(!empty.readRecord(fields));
+}
+
+static Records readAll(QDelimitedTextReader &reader)
+{
+    Records records;
+    QList<QDelimitedTextReader::Field> fields;
+    while (reader.readRecord(fields)) {
+        QStringList record;
+        for (const auto &field : fields)
+            record.append(field.toString());
+        records.append(record);
+    }
+    return records;
+}
+
+void tst_QDelimitedTextScanner::reader()
+{
+    QFETCH(QString, text);
+    QFETCH(Records, records);
+
+    // chunk boundaries at every position of the records
+    for (qsizetype chunkSize : { 1, 2, 3, 5, 8, 64 * 1024 }) {
+        QBuffer buffer;
+        buffer.setData(text.toUtf8());
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+        QDelimitedTextReader reader(&buffer);
+        QCOMPARE(reader.device(), &buffer);
+        QCOMPARE(reader.separator(), ',');
+        QCOMPARE(reader.quote(), '"');
+        QCOMPARE(reader.chunkSize(), 64 * 1024);
+        reader.setChunkSize(chunkSize);
+        QCOMPARE(reader.chunkSize(), chunkSize);
+
+        QCOMPARE(readAll(reader), records);
+        QVERIFY(reader.atEnd());
+    }
+}
+
+class PipeDevice : public QIODevice
+{
+public:
+    // how the device tells that there is no more data
+    enum EndOfData { ReadFails, ReadChannelFinished };
+
+    explicit PipeDevice(EndOfData endOfData) : endOfData(endOfData) { open(ReadOnly); }
+
+    bool isSequential() const override { return true; }
+    void write(const QByteArray &data) { pending += data; }
+    void closeWriteChannel()
+    {
+        writeChannelClosed = true;
+        if (endOfData == ReadChannelFinished)
+            emit readChannelFinished();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        if (pending.isEmpty())
+            return writeChannelClosed && endOfData == ReadFails ? -1 : 0;
+        const qint64 size = qMin(maxSize, qint64(pending.size()));
+        memcpy(data, pending.constData(), size);
+        pending.remove(0, size);
+        return size;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray pending;
+    EndOfData endOfData;
+    bool writeChannelClosed = false;
+};
+
+void tst_QDelimitedTextScanner::readerSequentialDevice_data()
+{
+    QTest::addColumn<PipeDevice::EndOfData>("endOfData");
+
+    QTest::newRow("read-fails") << PipeDevice::ReadFails;
+    QTest::newRow("read-channel-finished") << PipeDevice::ReadChannelFinished;
+}
+
+void tst_QDelimitedTextScanner::readerSequentialDevice()
+{
+    QFETCH(PipeDevice::EndOfData, endOfData);
+
+    PipeDevice device(endOfData);
+    QDelimitedTextReader reader(&device);
+    QList<QDelimitedTextReader::Field> fields;
+
+    QVERIFY(!reader.readRecord(fields));
+    QVERIFY(!reader.atEnd());
+
+    device.write("a,\"b");
+    QVERIFY(!reader.readRecord(fields));
+    QVERIFY(fields.isEmpty());
+
+    device.write("\nc\"\r");
+    // the record might continue with a line feed
+    QVERIFY(!reader.readRecord(fields));
+
+    device.write("\nd,");
+    QVERIFY(reader.readRecord(fields));
+    QCOMPARE(fields.size(), 2);
+    QCOMPARE(fields[0].view(), "a");
+    QCOMPARE(fields[1].view(), "b\nc");
+    QVERIFY(!reader.readRecord(fields));
+
+    device.write("e");
+    QVERIFY(!reader.readRecord(fields));
+    device.closeWriteChannel();
+    QVERIFY(reader.readRecord(fields));
+    QCOMPARE(fields.size(), 2);
+    QCOMPARE(fields[0].view(), "d");
+    QCOMPARE(fields[1].view(), "e");
+    QVERIFY(!reader.readRecord(fields));
+    QVERIFY(reader.atEnd());
+}
+
+#ifdef Q_OS_UNIX
+void tst_QDelimitedTextScanner::readerPipe()
+{
+    // reading a pipe returns no data at its end, rather than failing
+    const auto openPipe = [](QFile &file, bool buffered) {
+        int fds[2];
+        if (::pipe(fds) != 0)
+            return false;
+        const char data[] = "a,b\nc,d";
+        const bool written = ::write(fds[1], data, sizeof(data) - 1) == sizeof(data) - 1;
+        ::close(fds[1]);
+        if (buffered) {
+            FILE *fh = ::fdopen(fds[0], "r");
+            return written && fh && file.open(fh, QIODevice::ReadOnly, QFileDevice::AutoCloseHandle);
+        }
+        return written && file.open(fds[0], QIODevice::ReadOnly, QFileDevice::AutoCloseHandle);
+    };
+
+    for (bool buffered : { false, true }) {
+        QFile file;
+        QVERIFY(openPipe(file, buffered));
+        QVERIFY(file.isSequential());
+
+        QDelimitedTextReader reader(&file);
+        QCOMPARE(readAll(reader), Records({ { "a", "b" }, { "c", "d" } }));
+        QVERIFY(reader.atEnd());
+    }
+}
+#endif
+
+QTEST_APPLESS_MAIN(tst_QDelimitedTextScanner)
+#include "tst_qdelimitedtextscanner.moc"
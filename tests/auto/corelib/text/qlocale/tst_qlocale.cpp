@@ -87,6 +87,9 @@ private slots:
     void doubleToString();
     void strtod_data();
     void strtod();
+    void shortestRoundTrip_data();
+    void shortestRoundTrip();
+    void shortestRoundTripRandom();
     void long_long_conversion_data();
     void long_long_conversion();
     void long_long_conversion_extra();
@@ -880,12 +883,18 @@ void tst_QLocale::stringToDouble_data()
         QTest::newRow("C inf") << QString("C") << QString("inf") << true << huge;
         QTest::newRow("C +inf") << QString("C") << QString("+inf") << true << +huge;
         QTest::newRow("C -inf") << QString("C") << QString("-inf") << true << -huge;
+        // Letters are case-insensitive, but there are no other spellings:
+        QTest::newRow("C -INF") << QString("C") << QString("-INF") << true << -huge;
+        QTest::newRow("C -infinity") << QString("C") << QString("-infinity") << false << 0.0;
         // Overflow:
         QTest::newRow("C huge") << QString("C") << QString("2e308") << false << huge;
         QTest::newRow("C -huge") << QString("C") << QString("-2e308") << false << -huge;
     }
     if (std::numeric_limits<double>::has_quiet_NaN)
         QTest::newRow("C qnan") << QString("C") << QString("NaN") << true << std::numeric_limits<double>::quiet_NaN();
+    // NaN has no sign or payload:
+    QTest::newRow("C -NaN") << QString("C") << QString("-NaN") << false << 0.0;
+    QTest::newRow("C -nan(1)") << QString("C") << QString("-nan(1)") << false << 0.0;
 
     // In range (but outside float's range):
     QTest::newRow("C big") << QString("C") << QString("3.5e38") << true << 3.5e38;
@@ -1268,6 +1277,71 @@ void tst_QLocale::strtod_data()
     QTest::newRow("0x1.921fb5p+1")     << QString("0x1.921fb5p+1")     << 0.0 << 1 << true;
 }
 
+void tst_QLocale::shortestRoundTrip_data()
+{
+    QTest::addColumn<double>("num");
+    QTest::addColumn<QString>("numStr");
+
+    using D = std::numeric_limits<double>;
+    QTest::newRow("zero") << 0.0 << u"0"_qs;
+    QTest::newRow("one") << 1.0 << u"1"_qs;
+    QTest::newRow("0.1") << 0.1 << u"0.1"_qs;
+    QTest::newRow("1/3") << 1.0 / 3 << u"0.3333333333333333"_qs;
+    QTest::newRow("-2/3") << -2.0 / 3 << u"-0.6666666666666666"_qs;
+    QTest::newRow("0.3") << 0.1 + 0.2 << u"0.30000000000000004"_qs;
+    QTest::newRow("2^53") << 9007199254740992.0 << u"9007199254740992"_qs;
+    QTest::newRow("1e21") << 1e21 << u"1e+21"_qs;
+    QTest::newRow("1.5e-7") << 1.5e-7 << u"1.5e-07"_qs;
+    QTest::newRow("123456.789") << 123456.789 << u"123456.789"_qs;
+    QTest::newRow("max") << D::max() << u"1.7976931348623157e+308"_qs;
+    QTest::newRow("lowest") << D::lowest() << u"-1.7976931348623157e+308"_qs;
+    QTest::newRow("min") << D::min() << u"2.2250738585072014e-308"_qs;
+    QTest::newRow("denorm_min") << D::denorm_min() << u"5e-324"_qs;
+    QTest::newRow("epsilon") << D::epsilon() << u"2.220446049250313e-16"_qs;
+}
+
+void tst_QLocale::shortestRoundTrip()
+{
+    QFETCH(double, num);
+    QFETCH(QString, numStr);
+
+    QCOMPARE(QString::number(num, 'g', QLocale::FloatingPointShortest), numStr);
+    QCOMPARE(QByteArray::number(num, 'g', QLocale::FloatingPointShortest), numStr.toLatin1());
+    QCOMPARE(QLocale::c().toString(num, 'g', QLocale::FloatingPointShortest), numStr);
+
+    bool ok = false;
+    QCOMPARE(numStr.toDouble(&ok), num);
+    QVERIFY(ok);
+    QCOMPARE(numStr.toLatin1().toDouble(&ok), num);
+    QVERIFY(ok);
+    QCOMPARE(QLocale::c().toDouble(numStr, &ok), num);
+    QVERIFY(ok);
+}
+
+void tst_QLocale::shortestRoundTripRandom()
+{
+    // Any finite double must survive a round trip through its shortest
+    // representation, in every format.
+    quint64 bits = Q_UINT64_C(0x9E3779B97F4A7C15);
+    for (int i = 0; i < 20000; ++i) {
+        bits = bits * Q_UINT64_C(6364136223846793005) + Q_UINT64_C(1442695040888963407);
+        double num;
+        memcpy(&num, &bits, sizeof(num));
+        if (!qIsFinite(num))
+            continue;
+
+        for (char format : { 'g', 'e', 'f' }) {
+            const QString str = QString::number(num, format, QLocale::FloatingPointShortest);
+            bool ok = false;
+            const double back = str.toDouble(&ok);
+            if (!ok || back != num) {
+                QFAIL(qPrintable(u"%1 formatted as %2 does not round-trip"_qs
+                                 .arg(qulonglong(bits), 16, 16, QLatin1Char('0')).arg(str)));
+            }
+        }
+    }
+}
+
 void tst_QLocale::strtod()
 {
     QFETCH(QString, num_str);
@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <qmultibytearraymatcher.h>
+
+#include <algorithm>
+
+class tst_QMultiByteArrayMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultConstructed();
+    void matchesIn_data();
+    void matchesIn();
+    void matchIn();
+    void compareWithNaiveSearch();
+    void copyAndAssign();
+};
+
+static QByteArray toString(const QList<QMultiByteArrayMatcher::Match> &matches)
+{
+    QByteArrayList result;
+    for (const auto &match : matches)
+        result.append(QByteArray::number(match.index) + ':'
+                      + QByteArray::number(match.patternIndex));
+    return result.join(' ');
+}
+
+void tst_QMultiByteArrayMatcher::defaultConstructed()
+{
+    QMultiByteArrayMatcher matcher;
+    QVERIFY(matcher.patterns().isEmpty());
+    QCOMPARE(matcher.indexIn("foo"), -1);
+    QCOMPARE(matcher.matchIn("foo"), QMultiByteArrayMatcher::Match());
+    QVERIFY(matcher.matchesIn("foo").isEmpty());
+
+    QMultiByteArrayMatcher noPatterns{ QByteArrayList() };
+    QCOMPARE(noPatterns.indexIn("foo"), -1);
+    QVERIFY(noPatterns.matchesIn("foo").isEmpty());
+}
+
+void tst_QMultiByteArrayMatcher::matchesIn_data()
+{
+    QTest::addColumn<QByteArrayList>("patterns");
+    QTest::addColumn<QByteArray>("haystack");
+    QTest::addColumn<qsizetype>("from");
+    QTest::addColumn<QByteArray>("matches");
+
+    const QByteArrayList classic = { "he", "she", "his", "hers" };
+    QTest::newRow("classic") << classic << QByteArray("ushers") << qsizetype(0)
+                             << QByteArray("1:1 2:0 2:3");
+    QTest::newRow("classic-from") << classic << QByteArray("ushers") << qsizetype(2)
+                                  << QByteArray("2:0 2:3");
+    QTest::newRow("classic-from-beyond") << classic << QByteArray("ushers") << qsizetype(7)
+                                         << QByteArray();
+    QTest::newRow("no-match") << classic << QByteArray("nothing to see") << qsizetype(0)
+                              << QByteArray();
+    QTest::newRow("overlapping") << QByteArrayList{ "aa", "a" } << QByteArray("aaa")
+                                 << qsizetype(0) << QByteArray("0:1 0:0 1:1 1:0 2:1");
+    QTest::newRow("duplicates-and-empty")
+            << QByteArrayList{ "ab", QByteArray(), "ab", "b" } << QByteArray("abab")
+            << qsizetype(0) << QByteArray("0:0 0:2 1:3 2:0 2:2 3:3");
+    QTest::newRow("binary")
+            << QByteArrayList{ QByteArray("\0\xff", 2), "\x80" }
+            << QByteArray("\xff\0\xff\x80\0", 5) << qsizetype(0) << QByteArray("1:0 3:1");
+}
+
+void tst_QMultiByteArrayMatcher::matchesIn()
+{
+    QFETCH(QByteArrayList, patterns);
+    QFETCH(QByteArray, haystack);
+    QFETCH(qsizetype, from);
+    QFETCH(QByteArray, matches);
+
+    const QMultiByteArrayMatcher matcher(patterns);
+    QCOMPARE(matcher.patterns(), patterns);
+    QCOMPARE(toString(matcher.matchesIn(haystack, from)), matches);
+}
+
+void tst_QMultiByteArrayMatcher::matchIn()
+{
+    // "bc" ends first, but "abcd" starts first
+    const QMultiByteArrayMatcher matcher({ "bc", "abcd", "a" });
+    QCOMPARE(matcher.matchIn("xabcdx"), QMultiByteArrayMatcher::Match({ 1, 1 }));
+    QCOMPARE(matcher.indexIn("xabcdx"), 1);
+    QCOMPARE(matcher.matchIn("xabcdx", 2), QMultiByteArrayMatcher::Match({ 2, 0 }));
+    QCOMPARE(matcher.matchIn("xabcx"), QMultiByteArrayMatcher::Match({ 1, 2 }));
+    QCOMPARE(matcher.indexIn("xyz"), -1);
+}
+
+void tst_QMultiByteArrayMatcher::compareWithNaiveSearch()
+{
+    // a fixed LCG, so that failures are reproducible
+    quint32 seed = 42;
+    const auto random = [&seed](int bound) {
+        seed = seed * 1103515245 + 12345;
+        return int((seed >> 16) % bound);
+    };
+    const QByteArray alphabet("ab\0\xff", 4);
+    const auto randomBytes = [&](int length) {
+        QByteArray result;
+        for (int i = 0; i < length; ++i)
+            result.append(alphabet.at(random(alphabet.size())));
+        return result;
+    };
+
+    const QByteArray haystack = randomBytes(2000);
+    QByteArrayList patterns;
+    for (int i = 0; i < 50; ++i)
+        patterns.append(randomBytes(1 + random(6)));
+
+    QList<QMultiByteArrayMatcher::Match> expected;
+    for (qsizetype i = 0; i < haystack.size(); ++i) {
+        for (qsizetype p = 0; p < patterns.size(); ++p) {
+            if (QByteArrayView(haystack).sliced(i).startsWith(patterns.at(p)))
+                expected.append({ i, p });
+        }
+    }
+    QVERIFY(!expected.isEmpty());
+
+    const QMultiByteArrayMatcher matcher(patterns);
+    for (qsizetype from : { 0, 1, 999 }) {
+        QList<QMultiByteArrayMatcher::Match> actual = matcher.matchesIn(haystack, from);
+        std::sort(actual.begin(), actual.end(), [](auto lhs, auto rhs) {
+            return std::pair(lhs.index, lhs.patternIndex) < std::pair(rhs.index, rhs.patternIndex);
+        });
+        const auto firstExpected = std::find_if(expected.cbegin(), expected.cend(),
+                                                [from](auto match) { return match.index >= from; });
+        QCOMPARE(toString(actual),
+                 toString(QList<QMultiByteArrayMatcher::Match>(firstExpected, expected.cend())));
+        QCOMPARE(matcher.matchIn(haystack, from), *firstExpected);
+    }
+}
+
+void tst_QMultiByteArrayMatcher::copyAndAssign()
+{
+    const QByteArrayList patterns = { "one", "two" };
+    QMultiByteArrayMatcher matcher(patterns);
+    QMultiByteArrayMatcher copy(matcher);
+    QCOMPARE(copy.patterns(), patterns);
+    QCOMPARE(copy.indexIn("zero, one, two"), 6);
+
+    QMultiByteArrayMatcher assigned;
+    assigned = copy;
+    QCOMPARE(assigned.indexIn("zero, one, two"), 6);
+
+    matcher = QMultiByteArrayMatcher({ "three" });
+    QCOMPARE(matcher.indexIn("zero, one, two"), -1);
+    QCOMPARE(copy.indexIn("zero, one, two"), 6);
+}
+
+QTEST_APPLESS_MAIN(tst_QMultiByteArrayMatcher)
+#include "tst_qmultibytearraymatcher.moc"
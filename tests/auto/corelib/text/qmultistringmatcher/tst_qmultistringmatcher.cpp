@@ -0,0 +1,309 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <qmultistringmatcher.h>
+
+#include <algorithm>
+
+class tst_QMultiStringMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultConstructed();
+    void matchesIn_data();
+    void matchesIn();
+    void matchIn_data();
+    void matchIn();
+    void caseInsensitive_data();
+    void caseInsensitive();
+    void compareWithNaiveSearch_data();
+    void compareWithNaiveSearch();
+    void copyAndAssign();
+};
+
+static QString toString(const QList<QMultiStringMatcher::Match> &matches)
+{
+    QStringList result;
+    for (const auto &match : matches)
+        result.append(QString::number(match.index) + u':' + QString::number(match.patternIndex));
+    return result.join(u' ');
+}
+
+void tst_QMultiStringMatcher::defaultConstructed()
+{
+    QMultiStringMatcher matcher;
+    QVERIFY(matcher.patterns().isEmpty());
+    QCOMPARE(matcher.caseSensitivity(), Qt::CaseSensitive);
+    QCOMPARE(matcher.indexIn(u"foo"), -1);
+    QCOMPARE(matcher.matchIn(u"foo"), QMultiStringMatcher::Match());
+    QVERIFY(matcher.matchesIn(u"foo").isEmpty());
+
+    QMultiStringMatcher noPatterns{ QStringList() };
+    QCOMPARE(noPatterns.indexIn(u"foo"), -1);
+    QVERIFY(noPatterns.matchesIn(u"foo").isEmpty());
+}
+
+void tst_QMultiStringMatcher::matchesIn_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<qsizetype>("from");
+    QTest::addColumn<QString>("matches");
+
+    const QStringList classic = { u"he"_qs, u"she"_qs, u"his"_qs, u"hers"_qs };
+    QTest::newRow("classic") << classic << u"ushers"_qs << qsizetype(0) << u"1:1 2:0 2:3"_qs;
+    QTest::newRow("classic-from") << classic << u"ushers"_qs << qsizetype(2) << u"2:0 2:3"_qs;
+    QTest::newRow("classic-from-end") << classic << u"ushers"_qs << qsizetype(6) << QString();
+    QTest::newRow("classic-from-beyond") << classic << u"ushers"_qs << qsizetype(7) << QString();
+    QTest::newRow("classic-from-negative") << classic << u"his"_qs << qsizetype(-5) << u"0:2"_qs;
+    QTest::newRow("no-match") << classic << u"nothing to see"_qs << qsizetype(0) << QString();
+    QTest::newRow("empty-haystack") << classic << QString() << qsizetype(0) << QString();
+    QTest::newRow("overlapping")
+            << QStringList{ u"aa"_qs, u"a"_qs } << u"aaa"_qs << qsizetype(0)
+            << u"0:1 0:0 1:1 1:0 2:1"_qs;
+    QTest::newRow("nested")
+            << QStringList{ u"b"_qs, u"abcd"_qs, u"bc"_qs, u"c"_qs } << u"xabcdx"_qs
+            << qsizetype(0) << u"2:0 2:2 3:3 1:1"_qs;
+    QTest::newRow("duplicates-and-empty")
+            << QStringList{ u"ab"_qs, QString(), u"ab"_qs, u"b"_qs } << u"abab"_qs
+            << qsizetype(0) << u"0:0 0:2 1:3 2:0 2:2 3:3"_qs;
+    QTest::newRow("non-latin1")
+            << QStringList{ u"été"_qs, u"€"_qs, u"\U0001F600"_qs }
+            << u"l'été coûte 5€ \U0001F600"_qs << qsizetype(0)
+            << u"2:0 13:1 15:2"_qs;
+    // only whole surrogate pairs match
+    QTest::newRow("surrogates")
+            << QStringList{ u"\U0001F600"_qs } << u"\U0001F601\U0001F600"_qs << qsizetype(0)
+            << u"2:0"_qs;
+}
+
+void tst_QMultiStringMatcher::matchesIn()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(QString, haystack);
+    QFETCH(qsizetype, from);
+    QFETCH(QString, matches);
+
+    const QMultiStringMatcher matcher(patterns);
+    QCOMPARE(matcher.patterns(), patterns);
+    QCOMPARE(toString(matcher.matchesIn(haystack, from)), matches);
+}
+
+void tst_QMultiStringMatcher::matchIn_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<qsizetype>("from");
+    QTest::addColumn<qsizetype>("index");
+    QTest::addColumn<qsizetype>("patternIndex");
+
+    // "bc" ends first, but "abcd" starts first
+    QTest::newRow("leftmost")
+            << QStringList{ u"bc"_qs, u"abcd"_qs } << u"xabcdx"_qs << qsizetype(0)
+            << qsizetype(1) << qsizetype(1);
+    QTest::newRow("leftmost-from")
+            << QStringList{ u"bc"_qs, u"abcd"_qs } << u"xabcdx"_qs << qsizetype(2)
+            << qsizetype(2) << qsizetype(0);
+    // of the patterns starting at the same position, the first one wins
+    QTest::newRow("first-pattern")
+            << QStringList{ u"ab"_qs, u"abc"_qs, u"a"_qs } << u"xabc"_qs << qsizetype(0)
+            << qsizetype(1) << qsizetype(0);
+    QTest::newRow("first-pattern-reversed")
+            << QStringList{ u"a"_qs, u"abc"_qs, u"ab"_qs } << u"xabc"_qs << qsizetype(0)
+            << qsizetype(1) << qsizetype(0);
+    QTest::newRow("later-longer")
+            << QStringList{ u"cd"_qs, u"abcde"_qs } << u"abcdabcde"_qs << qsizetype(0)
+            << qsizetype(2) << qsizetype(0);
+    QTest::newRow("no-match")
+            << QStringList{ u"cd"_qs, u"abcde"_qs } << u"abc"_qs << qsizetype(0)
+            << qsizetype(-1) << qsizetype(-1);
+}
+
+void tst_QMultiStringMatcher::matchIn()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(QString, haystack);
+    QFETCH(qsizetype, from);
+    QFETCH(qsizetype, index);
+    QFETCH(qsizetype, patternIndex);
+
+    const QMultiStringMatcher matcher(patterns);
+    const QMultiStringMatcher::Match match = matcher.matchIn(haystack, from);
+    QCOMPARE(match.index, index);
+    QCOMPARE(match.patternIndex, patternIndex);
+    QCOMPARE(matcher.indexIn(haystack, from), index);
+}
+
+void tst_QMultiStringMatcher::caseInsensitive_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<QString>("sensitive");
+    QTest::addColumn<QString>("insensitive");
+
+    QTest::newRow("ascii")
+            << QStringList{ u"Foo"_qs, u"bar"_qs } << u"foo BAR Foo bAr"_qs
+            << u"8:0"_qs << u"0:0 4:1 8:0 12:1"_qs;
+    // U+212A KELVIN SIGN folds to 'k'; the patterns are Latin-1 only
+    QTest::newRow("kelvin")
+            << QStringList{ u"ok"_qs } << u"OK o\u212A ok"_qs << u"6:0"_qs
+            << u"0:0 3:0 6:0"_qs;
+    QTest::newRow("kelvin-pattern")
+            << QStringList{ u"o\u212A"_qs } << u"OK o\u212A ok"_qs << u"3:0"_qs
+            << u"0:0 3:0 6:0"_qs;
+    QTest::newRow("latin1-folding-out")
+            << QStringList{ u"µs"_qs } << u"5µs 5ΜS"_qs << u"1:0"_qs
+            << u"1:0 5:0"_qs;
+    QTest::newRow("greek")
+            << QStringList{ u"σοφια"_qs }
+            << u"ΣΟΦΙΑ σοφια"_qs
+            << u"6:0"_qs << u"0:0 6:0"_qs;
+    // U+10400 DESERET CAPITAL LETTER LONG I folds to U+10428
+    QTest::newRow("surrogates")
+            << QStringList{ u"a\U00010428"_qs } << u"A\U00010400 a\U00010428"_qs
+            << u"4:0"_qs << u"0:0 4:0"_qs;
+}
+
+void tst_QMultiStringMatcher::caseInsensitive()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(QString, haystack);
+    QFETCH(QString, sensitive);
+    QFETCH(QString, insensitive);
+
+    const QMultiStringMatcher matcher(patterns);
+    QCOMPARE(toString(matcher.matchesIn(haystack)), sensitive);
+
+    const QMultiStringMatcher insensitiveMatcher(patterns, Qt::CaseInsensitive);
+    QCOMPARE(insensitiveMatcher.caseSensitivity(), Qt::CaseInsensitive);
+    QCOMPARE(toString(insensitiveMatcher.matchesIn(haystack)), insensitive);
+}
+
+void tst_QMultiStringMatcher::compareWithNaiveSearch_data()
+{
+    QTest::addColumn<QString>("alphabet");
+    QTest::addColumn<int>("patternCount");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+
+    const QString small = u"aAbB\u212Aé"_qs;
+    QTest::newRow("small-sensitive") << small << 50 << Qt::CaseSensitive;
+    QTest::newRow("small-insensitive") << small << 50 << Qt::CaseInsensitive;
+
+    // enough states and distinct characters that the automaton doesn't
+    // expand its transitions into a table
+    QString wide;
+    for (char16_t c = 0x4e00; c < 0x4e00 + 3000; ++c)
+        wide.append(QChar(c));
+    QTest::newRow("wide-sensitive") << wide << 3000 << Qt::CaseSensitive;
+    QTest::newRow("wide-insensitive") << wide << 3000 << Qt::CaseInsensitive;
+}
+
+void tst_QMultiStringMatcher::compareWithNaiveSearch()
+{
+    QFETCH(QString, alphabet);
+    QFETCH(int, patternCount);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    // a fixed LCG, so that failures are reproducible
+    quint32 seed = 42;
+    const auto random = [&seed](int bound) {
+        seed = seed * 1103515245 + 12345;
+        return int((seed >> 16) % bound);
+    };
+    const auto randomString = [&](int length) {
+        QString result;
+        for (int i = 0; i < length; ++i)
+            result.append(alphabet.at(random(alphabet.size())));
+        return result;
+    };
+
+    const QString haystack = randomString(2000);
+    QStringList patterns;
+    for (int i = 0; i < patternCount; ++i) {
+        // some of the patterns are taken from the haystack, to have matches
+        const int length = 1 + random(6);
+        if (i % 2)
+            patterns.append(haystack.mid(random(haystack.size() - length), length));
+        else
+            patterns.append(randomString(length));
+    }
+
+    QList<QMultiStringMatcher::Match> expected;
+    for (qsizetype i = 0; i < haystack.size(); ++i) {
+        for (qsizetype p = 0; p < patterns.size(); ++p) {
+            if (QStringView(haystack).mid(i).startsWith(patterns.at(p), cs))
+                expected.append({ i, p });
+        }
+    }
+    QVERIFY(!expected.isEmpty());
+
+    const QMultiStringMatcher matcher(patterns, cs);
+    for (qsizetype from : { 0, 1, 999 }) {
+        QList<QMultiStringMatcher::Match> actual = matcher.matchesIn(haystack, from);
+        QVERIFY(std::is_sorted(actual.cbegin(), actual.cend(), [&](auto lhs, auto rhs) {
+            return lhs.index + patterns.at(lhs.patternIndex).size()
+                    < rhs.index + patterns.at(rhs.patternIndex).size();
+        }));
+        std::sort(actual.begin(), actual.end(), [](auto lhs, auto rhs) {
+            return std::pair(lhs.index, lhs.patternIndex) < std::pair(rhs.index, rhs.patternIndex);
+        });
+        const auto firstExpected = std::find_if(expected.cbegin(), expected.cend(),
+                                                [from](auto match) { return match.index >= from; });
+        QCOMPARE(toString(actual),
+                 toString(QList<QMultiStringMatcher::Match>(firstExpected, expected.cend())));
+        QCOMPARE(matcher.matchIn(haystack, from), *firstExpected);
+    }
+}
+
+void tst_QMultiStringMatcher::copyAndAssign()
+{
+    const QStringList patterns = { u"one"_qs, u"two"_qs };
+    QMultiStringMatcher matcher(patterns, Qt::CaseInsensitive);
+    QMultiStringMatcher copy(matcher);
+    QCOMPARE(copy.patterns(), patterns);
+    QCOMPARE(copy.caseSensitivity(), Qt::CaseInsensitive);
+    QCOMPARE(copy.indexIn(u"zero, One, two"), 6);
+
+    QMultiStringMatcher assigned;
+    assigned = copy;
+    QCOMPARE(assigned.indexIn(u"zero, One, two"), 6);
+
+    QMultiStringMatcher moved(std::move(assigned));
+    QCOMPARE(moved.indexIn(u"zero, One, two"), 6);
+    assigned = std::move(moved);
+    QCOMPARE(assigned.indexIn(u"TWO"), 0);
+
+    matcher = QMultiStringMatcher({ u"three"_qs });
+    QCOMPARE(matcher.indexIn(u"zero, One, two"), -1);
+    QCOMPARE(copy.indexIn(u"zero, One, two"), 6);
+}
+
+QTEST_APPLESS_MAIN(tst_QMultiStringMatcher)
+#include "tst_qmultistringmatcher.moc"
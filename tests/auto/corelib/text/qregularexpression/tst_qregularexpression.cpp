@@ -70,6 +70,8 @@ private slots:
     void partialMatch();
     void globalMatch_data();
     void globalMatch();
+    void globalMatchOffsets_data();
+    void globalMatchOffsets();
     void serialize_data();
     void serialize();
     void operatoreq_data();
@@ -1678,6 +1680,39 @@ void tst_QRegularExpression::globalMatch()
                                                matchList);
 }
 
+void tst_QRegularExpression::globalMatchOffsets_data()
+{
+    globalMatch_data();
+}
+
+void tst_QRegularExpression::globalMatchOffsets()
+{
+    QFETCH(QRegularExpression, regexp);
+    QFETCH(QString, subject);
+    QFETCH(qsizetype, offset);
+    QFETCH(QRegularExpression::MatchType, matchType);
+    QFETCH(QRegularExpression::MatchOptions, matchOptions);
+
+    if (matchType != QRegularExpression::NormalMatch)
+        QSKIP("globalMatchOffsets() only supports normal matching");
+
+    QList<qsizetype> expected;
+    QRegularExpressionMatchIterator iterator = regexp.globalMatch(subject, offset, matchType, matchOptions);
+    while (iterator.hasNext()) {
+        const QRegularExpressionMatch match = iterator.next();
+        for (int i = 0; i <= regexp.captureCount(); ++i)
+            expected << match.capturedStart(i) << match.capturedEnd(i);
+    }
+
+    const QList<qsizetype> offsets = regexp.globalMatchOffsets(subject, offset, matchOptions);
+    QCOMPARE(offsets, expected);
+    QCOMPARE(offsets.size() % (2 * (qMax(regexp.captureCount(), 0) + 1)), 0);
+
+    // an equal, separately constructed expression reuses the cached compiled pattern
+    const QRegularExpression copy(regexp.pattern(), regexp.patternOptions());
+    QCOMPARE(copy.globalMatchOffsets(QStringView(subject), offset, matchOptions), expected);
+}
+
 void tst_QRegularExpression::serialize_data()
 {
     provideRegularExpressions();
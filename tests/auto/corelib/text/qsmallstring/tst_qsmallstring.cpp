@@ -0,0 +1,219 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QHash>
+#include <qsmallstring.h>
+
+class tst_QSmallString : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultConstructed();
+    void construct_data();
+    void construct();
+    void fromQString();
+    void copyAndMove();
+    void assign();
+    void swap();
+    void compare();
+    void hash();
+    void views();
+};
+
+void tst_QSmallString::defaultConstructed()
+{
+    QSmallString s;
+    QVERIFY(s.isEmpty());
+    QCOMPARE(s.size(), 0);
+    QCOMPARE(s.begin(), s.end());
+    QCOMPARE(s.toString(), QString());
+    QCOMPARE(s, QSmallString(QString()));
+    QCOMPARE(s, QSmallString(u""));
+}
+
+void tst_QSmallString::construct_data()
+{
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("empty") << QString();
+    QTest::newRow("one") << QStringLiteral("a");
+    QTest::newRow("latin1") << QStringLiteral("grüße");
+    QTest::newRow("non-latin1") << QStringLiteral("буквы");
+    QTest::newRow("surrogates") << QStringLiteral("\U0001F600\U0001F601");
+    QTest::newRow("capacity-1") << QString(QSmallString::InlineCapacity - 1, u'x');
+    QTest::newRow("capacity") << QString(QSmallString::InlineCapacity, u'y');
+    QTest::newRow("capacity+1") << QString(QSmallString::InlineCapacity + 1, u'z');
+    QTest::newRow("long") << QStringLiteral("a string much too long to be stored inline");
+    QTest::newRow("long-non-latin1") << QString(QSmallString::InlineCapacity + 3, u'€');
+}
+
+void tst_QSmallString::construct()
+{
+    QFETCH(QString, text);
+
+    const QSmallString fromUtf16{QStringView(text)};
+    QCOMPARE(fromUtf16.size(), text.size());
+    QCOMPARE(fromUtf16.toString(), text);
+    QCOMPARE(fromUtf16.view(), text);
+    for (qsizetype i = 0; i < text.size(); ++i)
+        QCOMPARE(fromUtf16.at(i), text.at(i));
+
+    const QByteArray utf8 = text.toUtf8();
+    const QSmallString fromUtf8{QUtf8StringView(utf8)};
+    QCOMPARE(fromUtf8.toString(), text);
+
+    const QString latin1Text = QString::fromLatin1(text.toLatin1());
+    const QSmallString fromLatin1{QLatin1StringView(text.toLatin1())};
+    QCOMPARE(fromLatin1.toString(), latin1Text);
+}
+
+void tst_QSmallString::fromQString()
+{
+    const QString longText(QSmallString::InlineCapacity + 1, u'x');
+    const QSmallString shared(longText);
+    QCOMPARE(shared.data(), longText.constData());
+    QVERIFY(shared.toString().isSharedWith(longText));
+
+    QString moved = longText;
+    const QSmallString fromMoved(std::move(moved));
+    QCOMPARE(fromMoved.data(), longText.constData());
+
+    const QString shortText = QStringLiteral("short");
+    const QSmallString copied(shortText);
+    QVERIFY(copied.data() != shortText.constData());
+    QCOMPARE(copied.toString(), shortText);
+}
+
+void tst_QSmallString::copyAndMove()
+{
+    const QString texts[] = { QStringLiteral("short"), QString(QSmallString::InlineCapacity * 2, u'x') };
+    for (const QString &text : texts) {
+        QSmallString s(text);
+        QSmallString copy(s);
+        QCOMPARE(copy, s);
+        QCOMPARE(copy.toString(), text);
+
+        QSmallString moved(std::move(s));
+        QCOMPARE(moved.toString(), text);
+        QVERIFY(s.isEmpty()); // NOLINT(bugprone-use-after-move)
+
+        QString out = std::move(moved).toString();
+        QCOMPARE(out, text);
+    }
+}
+
+void tst_QSmallString::assign()
+{
+    const QSmallString shortString(u"abc");
+    const QSmallString longString(QString(QSmallString::InlineCapacity + 5, u'l'));
+
+    QSmallString s;
+    s = longString;
+    QCOMPARE(s, longString);
+    s = shortString;
+    QCOMPARE(s, shortString);
+    s = QSmallString(longString);
+    QCOMPARE(s, longString);
+    s = s;
+    QCOMPARE(s, longString);
+    s.clear();
+    QVERIFY(s.isEmpty());
+
+    QSmallString t(shortString);
+    t = std::move(s);
+    QVERIFY(t.isEmpty());
+}
+
+void tst_QSmallString::swap()
+{
+    QSmallString a(u"abc");
+    QSmallString b(QString(QSmallString::InlineCapacity + 5, u'l'));
+    const QSmallString aCopy = a;
+    const QSmallString bCopy = b;
+
+    a.swap(b);
+    QCOMPARE(a, bCopy);
+    QCOMPARE(b, aCopy);
+    qSwap(a, b);
+    QCOMPARE(a, aCopy);
+    QCOMPARE(b, bCopy);
+}
+
+void tst_QSmallString::compare()
+{
+    const QSmallString a(u"apple");
+    const QSmallString b(u"banana");
+    const QSmallString longB(QStringLiteral("banana split with extra cream"));
+
+    QVERIFY(a == QSmallString(u"apple"));
+    QVERIFY(a != b);
+    QVERIFY(a < b);
+    QVERIFY(a <= b);
+    QVERIFY(b > a);
+    QVERIFY(b >= a);
+    QVERIFY(b < longB);
+
+    QVERIFY(a == u"apple");
+    QVERIFY(u"apple" == a);
+    QVERIFY(a != u"apples");
+    QVERIFY(a == QStringLiteral("apple"));
+    QVERIFY(QStringView(u"banana") != a);
+}
+
+void tst_QSmallString::hash()
+{
+    const QString texts[] = { QStringLiteral("key"), QString(QSmallString::InlineCapacity * 3, u'k') };
+    for (const QString &text : texts) {
+        QCOMPARE(qHash(QSmallString(text)), qHash(text));
+        QCOMPARE(qHash(QSmallString(text), 42), qHash(QStringView(text), 42));
+    }
+
+    QHash<QSmallString, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(QSmallString(QString::number(i)), i);
+    QCOMPARE(hash.size(), 100);
+    QCOMPARE(hash.value(QSmallString(u"42")), 42);
+    QCOMPARE(hash.value(QSmallString(u"100"), -1), -1);
+}
+
+void tst_QSmallString::views()
+{
+    const QSmallString s(u"hello world");
+    QStringView view = s;
+    QCOMPARE(view, u"hello world");
+    QAnyStringView any = s;
+    QCOMPARE(any, u"hello world");
+    QVERIFY(QStringLiteral("hello world") == s.view());
+    QVERIFY(s.view().startsWith(u"hello"));
+    QCOMPARE(QString(s.begin(), s.size()), s.toString());
+}
+
+QTEST_APPLESS_MAIN(tst_QSmallString)
+#include "tst_qsmallstring.moc"
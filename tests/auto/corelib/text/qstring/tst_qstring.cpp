@@ -481,6 +481,7 @@ private slots:
     void isLower_isUpper_data();
     void isLower_isUpper();
     void toCaseFolded();
+    void caseConversionAsciiBlocks();
     void rightJustified();
     void leftJustified();
     void mid();
@@ -572,6 +573,7 @@ private slots:
     void nanAndInf();
     void compare_data();
     void compare();
+    void compareCaseInsensitiveAsciiBlocks();
     void resize();
     void resizeAfterFromRawData();
     void resizeAfterReserve();
@@ -2208,6 +2210,42 @@ void tst_QString::leftJustified()
     QCOMPARE(a.leftJustified(0,' ',true), QLatin1String(""));
 }
 
+// The case conversions handle ASCII text in blocks; put a string that needs
+// the Unicode tables at every position of an ASCII one.
+void tst_QString::caseConversionAsciiBlocks()
+{
+    const QByteArray ascii = "The Quick Brown Fox Jumps Over The Lazy Dog, 0123456789";
+    const QString specials[] = {
+        u"Stra\u00dfe"_qs, u"\u00c4\u00d6\u00fc"_qs, u"\u212a"_qs,
+        QString::fromUcs4(U"\U00010400\U00010428"),
+    };
+    for (const QString &special : specials) {
+        for (qsizetype i = 0; i <= ascii.size(); ++i) {
+            const QByteArray left = ascii.left(i);
+            const QByteArray right = ascii.mid(i);
+            const QString text = QLatin1StringView(left) + special + QLatin1StringView(right);
+            auto expected = [&](QString (QString::*convert)() const &, bool upper) {
+                return QLatin1StringView(upper ? left.toUpper() : left.toLower())
+                        + (special.*convert)()
+                        + QLatin1StringView(upper ? right.toUpper() : right.toLower());
+            };
+
+            QCOMPARE(text.toLower(), expected(&QString::toLower, false));
+            QCOMPARE(text.toUpper(), expected(&QString::toUpper, true));
+            QCOMPARE(text.toCaseFolded(), expected(&QString::toCaseFolded, false));
+            // in-place conversion
+            QCOMPARE(QString(text.constData(), text.size()).toLower(), text.toLower());
+            QCOMPARE(QString(text.constData(), text.size()).toUpper(), text.toUpper());
+        }
+    }
+
+    // nothing to convert in the ASCII blocks, then something after them
+    const QString lowerText = QString::fromLatin1(ascii.toLower());
+    QVERIFY(lowerText.toLower().isSharedWith(lowerText));
+    QCOMPARE((lowerText + u'\u00c4').toLower(), lowerText + u'\u00e4');
+    QCOMPARE((lowerText + u'A').toLower(), lowerText + u'a');
+}
+
 void tst_QString::rightJustified()
 {
     QString a;
@@ -6717,6 +6755,59 @@ void tst_QString::compare()
     }
 }
 
+// Case-insensitive comparison and search handle ASCII text in blocks; put
+// differences and characters that need the Unicode tables at every position.
+void tst_QString::compareCaseInsensitiveAsciiBlocks()
+{
+    const QByteArray ascii = "The Quick Brown Fox Jumps Over The Lazy Dog, 0123456789";
+    const QByteArray lowerAscii = ascii.toLower();
+    const QString text = QString::fromLatin1(ascii);
+    const QString lowerText = QString::fromLatin1(lowerAscii);
+
+    QCOMPARE(QString::compare(text, lowerText, Qt::CaseInsensitive), 0);
+    QCOMPARE(QString::compare(text, QLatin1StringView(lowerAscii), Qt::CaseInsensitive), 0);
+    QCOMPARE(QLatin1StringView(ascii).compare(QLatin1StringView(lowerAscii), Qt::CaseInsensitive), 0);
+
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        // a difference at position i; '~' sorts after all characters of the text
+        QString different = lowerText;
+        different[i] = u'~';
+        QByteArray differentAscii = lowerAscii;
+        differentAscii[i] = '~';
+        QVERIFY(QString::compare(text, different, Qt::CaseInsensitive) < 0);
+        QVERIFY(QString::compare(different, text, Qt::CaseInsensitive) > 0);
+        QVERIFY(QString::compare(text, QLatin1StringView(differentAscii), Qt::CaseInsensitive) < 0);
+        QVERIFY(QLatin1StringView(ascii).compare(QLatin1StringView(differentAscii), Qt::CaseInsensitive) < 0);
+        QVERIFY(!text.startsWith(different, Qt::CaseInsensitive));
+        QVERIFY(!text.endsWith(different.mid(1), Qt::CaseInsensitive) || i == 0);
+
+        // non-ASCII characters that are equal under case folding
+        QString withUpper = text;
+        withUpper.insert(i, u"\u00c4"_qs + QString::fromUcs4(U"\U00010400"));
+        QString withLower = lowerText;
+        withLower.insert(i, u"\u00e4"_qs + QString::fromUcs4(U"\U00010428"));
+        QCOMPARE(QString::compare(withUpper, withLower, Qt::CaseInsensitive), 0);
+        QVERIFY(withUpper.startsWith(withLower.left(i + 3), Qt::CaseInsensitive));
+        QVERIFY(withUpper.endsWith(withLower.mid(i), Qt::CaseInsensitive));
+        QVERIFY(QString::compare(withUpper, withLower, Qt::CaseSensitive) != 0);
+
+        QByteArray latin1Upper = ascii;
+        latin1Upper.insert(i, "\xc4");
+        QByteArray latin1Lower = lowerAscii;
+        latin1Lower.insert(i, "\xe4");
+        QCOMPARE(QLatin1StringView(latin1Upper).compare(QLatin1StringView(latin1Lower), Qt::CaseInsensitive), 0);
+        QCOMPARE(QString::compare(QString::fromLatin1(latin1Upper), QLatin1StringView(latin1Lower), Qt::CaseInsensitive), 0);
+
+        // single-character search finds both ASCII variants and the non-ASCII
+        // characters that fold to them
+        const QChar c = text.at(i);
+        QCOMPARE(lowerText.indexOf(c.toUpper(), i, Qt::CaseInsensitive), lowerText.indexOf(c.toLower(), i));
+        QString withKelvin = lowerText;
+        withKelvin[i] = QChar(0x212a);
+        QCOMPARE(withKelvin.indexOf(u'K', 0, Qt::CaseInsensitive), qMin(i, lowerText.indexOf(u'k')));
+    }
+}
+
 void tst_QString::resize()
 {
     QString s;
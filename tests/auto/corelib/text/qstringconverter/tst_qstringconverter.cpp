@@ -59,6 +59,9 @@ private slots:
     void utf8stateful_data();
     void utf8stateful();
 
+    void utf8LongText_data();
+    void utf8LongText();
+
     void utfHeaders_data();
     void utfHeaders();
 
@@ -1475,6 +1478,105 @@ void tst_QStringConverter::utf8stateful()
     }
 }
 
+// Long enough for the SIMD code paths, and mixing characters of every
+// UTF-8 length in different patterns
+void tst_QStringConverter::utf8LongText_data()
+{
+    QTest::addColumn<QString>("text");
+
+    const auto repeat = [](QStringView s) {
+        QString result;
+        while (result.size() < 100)
+            result += s;
+        return result;
+    };
+    QTest::newRow("cyrillic") << repeat(u"Съешь же ещё этих мягких булок, да выпей чаю. ");
+    QTest::newRow("cjk") << repeat(u"天地玄黄宇宙洪荒日月盈昃辰宿列张寒来暑往秋收冬藏");
+    QTest::newRow("cjk-ascii") << repeat(u"Qt是一个跨平台的C++应用程序开发框架。");
+    QTest::newRow("mixed") << repeat(u"Привет, мир! 你好，世界！ Γειά σου Κόσμε! ");
+    QTest::newRow("emoji") << repeat(u"smile \U0001F600 wink \U0001F609 мир \U0001F680 世界");
+    QTest::newRow("bmp-edges") << repeat(u"\u0080\u07ff\u0800\ud7ff\ue000\uffef\u007f");
+}
+
+void tst_QStringConverter::utf8LongText()
+{
+    QFETCH(QString, text);
+
+    // Converting each character on its own is too short for the SIMD code,
+    // so it serves as a reference. Decoding restarts at every character
+    // boundary, so corrupting one byte can only change that character.
+    QByteArray reference;
+    QList<qsizetype> boundaries;
+    for (qsizetype i = 0; i < text.size(); ) {
+        const qsizetype n = text.at(i).isHighSurrogate() ? 2 : 1;
+        boundaries.append(reference.size());
+        reference += QStringView(text).sliced(i, n).toUtf8();
+        i += n;
+    }
+    boundaries.append(reference.size());
+
+    const QByteArray utf8 = text.toUtf8();
+    QCOMPARE(utf8, reference);
+    QCOMPARE(QString::fromUtf8(utf8), text);
+    QVERIFY(utf8.isValidUtf8());
+
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    QCOMPARE(QByteArray(encoder(text)), reference);
+    QVERIFY(!encoder.hasError());
+
+    // stateful decoding, with the data split at every possible point
+    for (qsizetype split = 0; split <= utf8.size(); ++split) {
+        QStringDecoder decoder(QStringDecoder::Utf8);
+        QString decoded = decoder(QByteArrayView(utf8).first(split));
+        decoded += decoder(QByteArrayView(utf8).sliced(split));
+        QCOMPARE(decoded, text);
+        QVERIFY(!decoder.hasError());
+    }
+
+    const char corruptions[] = { '\xff', '\x80', '\xc1', '\xe0', '\xed', '\xf0', 'a' };
+    for (qsizetype i = 0; i < utf8.size(); ++i) {
+        for (char c : corruptions) {
+            QByteArray corrupted = utf8;
+            if (corrupted.at(i) == c)
+                continue;
+            corrupted[i] = c;
+
+            QString expected;
+            QString expectedStateless;
+            bool expectedValid = true;
+            for (qsizetype k = 0; k + 1 < boundaries.size(); ++k) {
+                const QByteArrayView piece = QByteArrayView(corrupted).sliced(
+                        boundaries.at(k), boundaries.at(k + 1) - boundaries.at(k));
+                expected += QString::fromUtf8(piece);
+                QStringDecoder decoder(QStringDecoder::Utf8, QStringDecoder::Flag::Stateless);
+                expectedStateless += decoder(piece);
+                expectedValid = expectedValid && piece.isValidUtf8();
+            }
+
+            QCOMPARE(QString::fromUtf8(corrupted), expected);
+            QStringDecoder decoder(QStringDecoder::Utf8, QStringDecoder::Flag::Stateless);
+            QCOMPARE(QString(decoder(corrupted)), expectedStateless);
+            QCOMPARE(corrupted.isValidUtf8(), expectedValid);
+        }
+    }
+
+    // lone surrogates
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        for (char16_t c : { u'\xd800', u'\xdc00' }) {
+            QString corrupted = text;
+            corrupted[i] = c;
+
+            QByteArray expected;
+            for (qsizetype k = 0; k < corrupted.size(); ) {
+                const qsizetype n = text.at(k).isHighSurrogate() ? 2 : 1;
+                expected += QStringView(corrupted).sliced(k, n).toUtf8();
+                k += n;
+            }
+            QCOMPARE(corrupted.toUtf8(), expected);
+        }
+    }
+}
+
 void tst_QStringConverter::utfHeaders_data()
 {
     QTest::addColumn<QStringConverter::Encoding>("encoding");
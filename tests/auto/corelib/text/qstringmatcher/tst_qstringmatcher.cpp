@@ -40,6 +40,8 @@ private slots:
     void indexIn();
     void setCaseSensitivity_data();
     void setCaseSensitivity();
+    void indexInEveryPosition_data();
+    void indexInEveryPosition();
     void assignOperator();
 };
 
@@ -136,6 +138,47 @@ void tst_QStringMatcher::setCaseSensitivity()
     QCOMPARE(matcher.indexIn(QStringView(haystack), from), indexIn);
 }
 
+void tst_QStringMatcher::indexInEveryPosition_data()
+{
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+
+    QTest::newRow("sensitive") << Qt::CaseSensitive;
+    QTest::newRow("insensitive") << Qt::CaseInsensitive;
+}
+
+void tst_QStringMatcher::indexInEveryPosition()
+{
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    // long enough for the SIMD code paths, made of few characters so that
+    // the needles have many near misses; U+212A KELVIN SIGN folds to 'k'
+    const char16_t alphabet[] = u"kKab\u212a\u00e9";
+    QString haystack(300, Qt::Uninitialized);
+    uint seed = 1;
+    for (QChar &c : haystack) {
+        seed = seed * 1103515245 + 12345;
+        c = alphabet[(seed >> 16) % 6];
+    }
+
+    for (qsizetype length = 2; length <= 40; ++length) {
+        for (qsizetype pos = 0; pos + length <= haystack.size(); pos += 7) {
+            const QString needle = haystack.mid(pos, length);
+            const QStringMatcher matcher(needle, cs);
+            for (qsizetype from : { qsizetype(0), pos / 2, pos, pos + 1 }) {
+                qsizetype expected = -1;
+                for (qsizetype i = from; i + length <= haystack.size(); ++i) {
+                    if (QStringView(haystack).sliced(i, length).compare(needle, cs) == 0) {
+                        expected = i;
+                        break;
+                    }
+                }
+                QCOMPARE(matcher.indexIn(haystack, from), expected);
+                QCOMPARE(haystack.indexOf(needle, from, cs), expected);
+            }
+        }
+    }
+}
+
 void tst_QStringMatcher::assignOperator()
 {
     QString needle("d");
@@ -0,0 +1,193 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QList>
+#include <QThread>
+#include <qstringpool.h>
+
+class tst_QStringPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void intern();
+    void internQString();
+    void internRawData();
+    void empty();
+    void statistics();
+    void evictUnused();
+    void clear();
+    void globalInstance();
+    void threads();
+};
+
+void tst_QStringPool::intern()
+{
+    QStringPool pool;
+    const QString a = pool.intern(u"active");
+    const QString b = pool.intern(QString::fromLatin1("active"));
+    const QString c = pool.intern(u"closed");
+
+    QCOMPARE(a, u"active");
+    QCOMPARE(c, u"closed");
+    QVERIFY(a.isSharedWith(b));
+    QVERIFY(!a.isSharedWith(c));
+    QCOMPARE(pool.size(), 2);
+    QVERIFY(pool.contains(u"active"));
+    QVERIFY(!pool.contains(u"act"));
+}
+
+void tst_QStringPool::internQString()
+{
+    QStringPool pool;
+    const QString first = QString::fromLatin1("property");
+    const QString interned = pool.intern(first);
+    QVERIFY(interned.isSharedWith(first));
+
+    const QString second = QString::fromLatin1("property");
+    QVERIFY(pool.intern(second).isSharedWith(first));
+
+    // detaching a returned string does not change the pool
+    QString modified = pool.intern(u"property");
+    modified.append(u'!');
+    QCOMPARE(pool.intern(u"property"), u"property");
+}
+
+void tst_QStringPool::internRawData()
+{
+    QStringPool pool;
+    QString interned;
+    {
+        const QChar text[] = { u'r', u'a', u'w' };
+        const QString raw = QString::fromRawData(text, 3);
+        interned = pool.intern(raw);
+        QVERIFY(interned.constData() != text);
+    }
+    QCOMPARE(pool.intern(u"raw"), u"raw");
+    QVERIFY(pool.intern(u"raw").isSharedWith(interned));
+}
+
+void tst_QStringPool::empty()
+{
+    QStringPool pool;
+    QVERIFY(pool.intern(QStringView()).isNull());
+    QVERIFY(pool.intern(u"").isEmpty());
+    QVERIFY(pool.intern(QString()).isNull());
+    QCOMPARE(pool.size(), 0);
+    QCOMPARE(pool.statistics().lookups, 0u);
+}
+
+void tst_QStringPool::statistics()
+{
+    QStringPool pool;
+    const QString countries[] = { u"NO"_qs, u"DE"_qs, u"NO"_qs, u"FR"_qs, u"NO"_qs, u"DE"_qs };
+    QStringList interned;
+    for (const QString &country : countries)
+        interned.append(pool.intern(QStringView(country)));
+
+    const QStringPool::Statistics stats = pool.statistics();
+    QCOMPARE(stats.count, 3);
+    QCOMPARE(stats.characters, 6);
+    QCOMPARE(stats.lookups, 6u);
+    QCOMPARE(stats.hits, 3u);
+    QCOMPARE(stats.evictions, 0u);
+}
+
+void tst_QStringPool::evictUnused()
+{
+    QStringPool pool;
+    QString kept = pool.intern(u"kept");
+    (void)pool.intern(u"dropped");
+    QCOMPARE(pool.size(), 2);
+
+    QCOMPARE(pool.evictUnused(), 1);
+    QCOMPARE(pool.size(), 1);
+    QVERIFY(pool.contains(u"kept"));
+    QVERIFY(!pool.contains(u"dropped"));
+    QCOMPARE(pool.statistics().evictions, 1u);
+    QCOMPARE(pool.statistics().characters, 4);
+
+    kept.clear();
+    QCOMPARE(pool.evictUnused(), 1);
+    QCOMPARE(pool.size(), 0);
+}
+
+void tst_QStringPool::clear()
+{
+    QStringPool pool;
+    const QString before = pool.intern(u"value");
+    pool.clear();
+    QCOMPARE(pool.size(), 0);
+    QCOMPARE(before, u"value");
+
+    const QString after = pool.intern(u"value");
+    QVERIFY(!after.isSharedWith(before));
+}
+
+void tst_QStringPool::globalInstance()
+{
+    QStringPool *pool = QStringPool::globalInstance();
+    QVERIFY(pool);
+    QCOMPARE(QStringPool::globalInstance(), pool);
+    QVERIFY(pool->intern(u"global").isSharedWith(pool->intern(u"global")));
+}
+
+void tst_QStringPool::threads()
+{
+    QStringPool pool;
+    constexpr int ThreadCount = 4;
+    constexpr int Iterations = 2000;
+    QList<QStringList> results(ThreadCount);
+
+    QList<QThread *> threads;
+    for (int t = 0; t < ThreadCount; ++t) {
+        threads.append(QThread::create([&pool, &results, t] {
+            for (int i = 0; i < Iterations; ++i) {
+                results[t].append(pool.intern(QString::number(i % 100)));
+                if (i % 500 == 0)
+                    pool.evictUnused();
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread *thread : std::as_const(threads)) {
+        QVERIFY(thread->wait());
+        delete thread;
+    }
+
+    QCOMPARE(pool.size(), 100);
+    for (int i = 0; i < Iterations; ++i) {
+        for (int t = 1; t < ThreadCount; ++t)
+            QVERIFY(results[t].at(i).isSharedWith(results[0].at(i)));
+    }
+    QCOMPARE(pool.statistics().lookups, quint64(ThreadCount * Iterations));
+}
+
+QTEST_APPLESS_MAIN(tst_QStringPool)
+#include "tst_qstringpool.moc"
@@ -206,6 +206,7 @@ private slots:
     void onCanceled();
     void cancelContinuations();
     void continuationsWithContext();
+    void continuationsWithExecutor();
     void continuationsWithMoveOnlyLambda();
 #if 0
     // TODO: enable when QFuture::takeResults() is enabled
@@ -3229,6 +3230,141 @@ void tst_QFuture::continuationsWithContext()
     thread.wait();
 }
 
+class QueueExecutor : public QtFuture::Executor
+{
+public:
+    ~QueueExecutor() override { runAll(); }
+
+    void execute(QRunnable *runnable) override
+    {
+        QMutexLocker locker(&mutex);
+        queue.append(runnable);
+    }
+
+    int runAll()
+    {
+        int count = 0;
+        forever {
+            QRunnable *runnable;
+            {
+                QMutexLocker locker(&mutex);
+                if (queue.isEmpty())
+                    return count;
+                runnable = queue.takeFirst();
+            }
+            const bool autoDelete = runnable->autoDelete();
+            runnable->run();
+            if (autoDelete)
+                delete runnable;
+            ++count;
+        }
+    }
+
+private:
+    QMutex mutex;
+    QList<QRunnable *> queue;
+};
+
+void tst_QFuture::continuationsWithExecutor()
+{
+    // the executor decides when the continuation runs; continuations after
+    // it run synchronously
+    {
+        QueueExecutor executor;
+        QPromise<int> promise;
+        auto future = promise.future()
+                              .then(&executor, [](int val) { return val + 1; })
+                              .then([](int val) { return val + 1; });
+        promise.start();
+        promise.addResult(0);
+        promise.finish();
+        QVERIFY(!future.isFinished());
+        QCOMPARE(executor.runAll(), 1);
+        QVERIFY(future.isFinished());
+        QCOMPARE(future.result(), 2);
+    }
+
+    // a ready future hands the continuation to the executor right away
+    {
+        QueueExecutor executor;
+        auto future = QtFuture::makeReadyFuture(41).then(&executor, [](int val) {
+            return val + 1;
+        });
+        QCOMPARE(executor.runAll(), 1);
+        QCOMPARE(future.result(), 42);
+    }
+
+    // canceled parents don't reach the executor
+    {
+        QueueExecutor executor;
+        QPromise<int> promise;
+        bool called = false;
+        auto future = promise.future().then(&executor, [&](int) { called = true; });
+        promise.start();
+        promise.future().cancel();
+        promise.finish();
+        QCOMPARE(executor.runAll(), 0);
+        QVERIFY(future.isCanceled());
+        QVERIFY(!called);
+    }
+
+#ifndef QT_NO_EXCEPTIONS
+    // neither do failed ones
+    {
+        QueueExecutor executor;
+        QPromise<int> promise;
+        auto future = promise.future().then(&executor, [](int val) { return val; });
+        promise.start();
+        promise.setException(std::make_exception_ptr(std::runtime_error("failed")));
+        promise.finish();
+        QCOMPARE(executor.runAll(), 0);
+        QVERIFY_THROWS_EXCEPTION(std::runtime_error, future.result());
+    }
+#endif
+
+    // the inline executor runs the whole chain in the thread that finishes
+    // the first future
+    {
+        QPromise<int> promise;
+        QThread *finishingThread = nullptr;
+        auto chain = promise.future();
+        for (int i = 0; i < 10; ++i) {
+            chain = chain.then(QtFuture::inlineExecutor(), [&, i](int val) {
+                if (i == 0)
+                    finishingThread = QThread::currentThread();
+                else if (QThread::currentThread() != finishingThread)
+                    return -1;
+                return val + 1;
+            });
+        }
+        QScopedPointer<QThread> thread(QThread::create([&] {
+            promise.start();
+            promise.addResult(0);
+            promise.finish();
+        }));
+        thread->start();
+        QCOMPARE(chain.result(), 10);
+        QVERIFY(thread->wait());
+        QCOMPARE(finishingThread, thread.data());
+    }
+
+    // an executor forwarding to a thread pool
+    {
+        struct PoolExecutor : QtFuture::Executor
+        {
+            QThreadPool pool;
+            void execute(QRunnable *runnable) override { pool.start(runnable); }
+        } executor;
+        QThread *continuationThread = nullptr;
+        auto future = QtFuture::makeReadyFuture().then(&executor, [&] {
+            continuationThread = QThread::currentThread();
+        });
+        future.waitForFinished();
+        QVERIFY(continuationThread);
+        QVERIFY(continuationThread != QThread::currentThread());
+    }
+}
+
 void tst_QFuture::continuationsWithMoveOnlyLambda()
 {
     // .then()
@@ -0,0 +1,359 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QCoreApplication>
+#include <QPromise>
+#include <QTest>
+#include <QThread>
+#include <qfuture.h>
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+class Sender : public QObject
+{
+    Q_OBJECT
+signals:
+    void noArgs();
+    void oneArg(int value);
+    void twoArgs(int value, const QString &text);
+};
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+// Eagerly started coroutine that nobody waits for; the tests poll the state
+// it writes to.
+struct Task
+{
+    struct promise_type
+    {
+        Task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() { }
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+struct AwaitState
+{
+    int result = -1;
+    bool done = false;
+    QThread *resumedIn = nullptr;
+};
+
+static Task awaitFuture(QFuture<int> future, AwaitState *state)
+{
+    state->result = co_await future;
+    state->resumedIn = QThread::currentThread();
+    state->done = true;
+}
+
+static Task awaitChain(QList<QFuture<int>> futures, AwaitState *state)
+{
+    int sum = 0;
+    for (const auto &future : futures)
+        sum += co_await future;
+    state->result = sum;
+    state->done = true;
+}
+
+static Task awaitVoid(QFuture<void> future, AwaitState *state, bool *threw)
+{
+    try {
+        co_await future;
+    } catch (const std::runtime_error &) {
+        *threw = true;
+    }
+    state->done = true;
+}
+
+static Task awaitMoveOnly(QFuture<std::unique_ptr<int>> future, AwaitState *state)
+{
+    std::unique_ptr<int> value = co_await future;
+    state->result = value ? *value : -1;
+    state->done = true;
+}
+
+template<class Awaiter, class Result>
+static Task awaitSignal(Awaiter awaiter, Result *result, AwaitState *state)
+{
+    *result = co_await awaiter;
+    state->resumedIn = QThread::currentThread();
+    state->done = true;
+}
+
+#endif // __cpp_impl_coroutine
+
+class tst_QFutureCoroutines : public QObject
+{
+    Q_OBJECT
+private slots:
+    void awaitReadyFuture();
+    void awaitFromOtherThread();
+    void awaitChain();
+    void awaitException();
+    void awaitCanceled();
+    void awaitMoveOnly();
+    void nextSignal();
+    void nextSignalBeforeAwait();
+    void nextSignalSenderDestroyed();
+    void nextSignalContextDestroyed();
+    void nextSignalFromOtherThread();
+    void nextSignalNotAwaited();
+};
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+void tst_QFutureCoroutines::awaitReadyFuture()
+{
+    AwaitState state;
+    awaitFuture(QtFuture::makeReadyFuture(42), &state);
+    // no suspension at all
+    QVERIFY(state.done);
+    QCOMPARE(state.result, 42);
+    QCOMPARE(state.resumedIn, QThread::currentThread());
+}
+
+void tst_QFutureCoroutines::awaitFromOtherThread()
+{
+    QPromise<int> promise;
+    AwaitState state;
+    awaitFuture(promise.future(), &state);
+    QVERIFY(!state.done);
+
+    QScopedPointer<QThread> thread(QThread::create([&promise] {
+        promise.start();
+        promise.addResult(42);
+        promise.finish();
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+
+    // the coroutine resumes in the thread that awaited, not the one that
+    // finished the future
+    QVERIFY(!state.done);
+    QTRY_VERIFY(state.done);
+    QCOMPARE(state.result, 42);
+    QCOMPARE(state.resumedIn, QThread::currentThread());
+}
+
+void tst_QFutureCoroutines::awaitChain()
+{
+    std::vector<QPromise<int>> promises(10);
+    QList<QFuture<int>> futures;
+    for (auto &promise : promises)
+        futures.append(promise.future());
+
+    AwaitState state;
+    ::awaitChain(futures, &state);
+    for (int i = 0; i < int(promises.size()); ++i) {
+        QVERIFY(!state.done);
+        // finishing in the awaiting thread resumes directly
+        promises[i].start();
+        promises[i].addResult(i);
+        promises[i].finish();
+    }
+    QVERIFY(state.done);
+    QCOMPARE(state.result, 45);
+}
+
+void tst_QFutureCoroutines::awaitException()
+{
+    QPromise<void> promise;
+    AwaitState state;
+    bool threw = false;
+    awaitVoid(promise.future(), &state, &threw);
+    promise.start();
+    promise.setException(std::make_exception_ptr(std::runtime_error("failed")));
+    promise.finish();
+    QVERIFY(state.done);
+    QVERIFY(threw);
+}
+
+void tst_QFutureCoroutines::awaitCanceled()
+{
+    AwaitState state;
+    {
+        QPromise<int> promise;
+        awaitFuture(promise.future(), &state);
+        promise.start();
+        // destroying an unfinished promise cancels and finishes it
+    }
+    QVERIFY(state.done);
+    QCOMPARE(state.result, 0);
+}
+
+void tst_QFutureCoroutines::awaitMoveOnly()
+{
+    QPromise<std::unique_ptr<int>> promise;
+    AwaitState state;
+    ::awaitMoveOnly(promise.future(), &state);
+    promise.start();
+    promise.addResult(std::make_unique<int>(42));
+    promise.finish();
+    QVERIFY(state.done);
+    QCOMPARE(state.result, 42);
+}
+
+void tst_QFutureCoroutines::nextSignal()
+{
+    Sender sender;
+
+    {
+        AwaitState state;
+        bool emitted = false;
+        awaitSignal(QtFuture::nextSignal(&sender, &Sender::noArgs), &emitted, &state);
+        QVERIFY(!state.done);
+        emit sender.noArgs();
+        QVERIFY(state.done);
+        QVERIFY(emitted);
+    }
+
+    {
+        AwaitState state;
+        std::optional<int> value;
+        awaitSignal(QtFuture::nextSignal(&sender, &Sender::oneArg), &value, &state);
+        emit sender.oneArg(42);
+        QVERIFY(state.done);
+        QCOMPARE(value, 42);
+
+        // only the next emission counts
+        emit sender.oneArg(1);
+        QCOMPARE(value, 42);
+    }
+
+    {
+        AwaitState state;
+        std::optional<std::tuple<int, QString>> value;
+        awaitSignal(QtFuture::nextSignal(&sender, &Sender::twoArgs), &value, &state);
+        emit sender.twoArgs(42, QStringLiteral("text"));
+        QVERIFY(state.done);
+        QVERIFY(value);
+        QCOMPARE(std::get<0>(*value), 42);
+        QCOMPARE(std::get<1>(*value), QStringLiteral("text"));
+    }
+}
+
+void tst_QFutureCoroutines::nextSignalBeforeAwait()
+{
+    Sender sender;
+    AwaitState state;
+    std::optional<int> value;
+
+    // the connection is made when the awaitable is created, not when it is
+    // awaited
+    auto awaiter = QtFuture::nextSignal(&sender, &Sender::oneArg);
+    emit sender.oneArg(42);
+    awaitSignal(std::move(awaiter), &value, &state);
+    QVERIFY(state.done);
+    QCOMPARE(value, 42);
+}
+
+void tst_QFutureCoroutines::nextSignalSenderDestroyed()
+{
+    AwaitState state;
+    std::optional<int> value = 0;
+    auto sender = std::make_unique<Sender>();
+    awaitSignal(QtFuture::nextSignal(sender.get(), &Sender::oneArg), &value, &state);
+    QVERIFY(!state.done);
+    sender.reset();
+    QVERIFY(state.done);
+    QVERIFY(!value);
+}
+
+void tst_QFutureCoroutines::nextSignalContextDestroyed()
+{
+    Sender sender;
+    AwaitState state;
+    bool emitted = true;
+    auto context = std::make_unique<QObject>();
+    awaitSignal(QtFuture::nextSignal(&sender, &Sender::noArgs, context.get()), &emitted,
+                &state);
+    context.reset();
+    QVERIFY(state.done);
+    QVERIFY(!emitted);
+
+    // no longer connected
+    emit sender.noArgs();
+}
+
+void tst_QFutureCoroutines::nextSignalFromOtherThread()
+{
+    Sender sender;
+    QObject context;
+    AwaitState state;
+    std::optional<int> value;
+    awaitSignal(QtFuture::nextSignal(&sender, &Sender::oneArg, &context), &value, &state);
+
+    QScopedPointer<QThread> thread(QThread::create([&sender] { emit sender.oneArg(42); }));
+    thread->start();
+    QVERIFY(thread->wait());
+
+    // resumes in the context's thread
+    QVERIFY(!state.done);
+    QTRY_VERIFY(state.done);
+    QCOMPARE(value, 42);
+    QCOMPARE(state.resumedIn, QThread::currentThread());
+}
+
+void tst_QFutureCoroutines::nextSignalNotAwaited()
+{
+    Sender sender;
+    QObject context;
+    {
+        auto awaiter = QtFuture::nextSignal(&sender, &Sender::oneArg, &context);
+        QScopedPointer<QThread> thread(QThread::create([&sender] { emit sender.oneArg(42); }));
+        thread->start();
+        QVERIFY(thread->wait());
+    }
+    // the queued call outlives the awaiter
+    QCoreApplication::processEvents();
+    emit sender.oneArg(1);
+}
+
+#else
+
+void tst_QFutureCoroutines::awaitReadyFuture() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::awaitFromOtherThread() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::awaitChain() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::awaitException() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::awaitCanceled() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::awaitMoveOnly() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::nextSignal() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::nextSignalBeforeAwait() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::nextSignalSenderDestroyed() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::nextSignalContextDestroyed() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::nextSignalFromOtherThread() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::nextSignalNotAwaited() { QSKIP("No coroutine support"); }
+
+#endif // __cpp_impl_coroutine
+
+QTEST_MAIN(tst_QFutureCoroutines)
+#include "tst_qfuturecoroutines.moc"
@@ -0,0 +1,312 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QElapsedTimer>
+#include <QMpmcQueue>
+#include <QString>
+#include <QThread>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "../../../../shared/containertesthelpers.h"
+
+using QTestContainerHelpers::Counted;
+using QTestContainerHelpers::startThread;
+
+class tst_QMpmcQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void capacity();
+    void fifoOrder();
+    void wrapAround();
+    void emplace();
+    void moveOnly();
+    void failedEnqueueKeepsValue();
+    void destroysRemainingElements();
+    void timedDequeueTimesOut();
+    void timedEnqueueTimesOut();
+    void blockingDequeue();
+    void blockingEnqueue();
+    void manyProducersAndConsumers_data();
+    void manyProducersAndConsumers();
+    void concurrentTryEnqueue();
+};
+
+void tst_QMpmcQueue::capacity()
+{
+    QMpmcQueue<int> queue(3);
+    QCOMPARE(queue.capacity(), 3);
+    QCOMPARE(queue.size(), 0);
+    QVERIFY(queue.isEmpty());
+
+    QVERIFY(queue.tryEnqueue(1));
+    QCOMPARE(queue.size(), 1);
+    QVERIFY(!queue.isEmpty());
+    QVERIFY(queue.tryEnqueue(2));
+    QVERIFY(queue.tryEnqueue(3));
+    QCOMPARE(queue.size(), 3);
+    QVERIFY(!queue.tryEnqueue(4));
+    QCOMPARE(queue.size(), 3);
+
+    QMpmcQueue<int> single(1);
+    QCOMPARE(single.capacity(), 1);
+    QVERIFY(single.tryEnqueue(1));
+    QVERIFY(!single.tryEnqueue(2));
+    QCOMPARE(single.tryDequeue(), std::optional<int>(1));
+    QVERIFY(single.tryEnqueue(3));
+}
+
+void tst_QMpmcQueue::fifoOrder()
+{
+    QMpmcQueue<int> queue(8);
+    QCOMPARE(queue.tryDequeue(), std::nullopt);
+    for (int i = 0; i < 8; ++i)
+        QVERIFY(queue.tryEnqueue(i));
+    for (int i = 0; i < 8; ++i)
+        QCOMPARE(queue.tryDequeue(), std::optional<int>(i));
+    QCOMPARE(queue.tryDequeue(), std::nullopt);
+    QVERIFY(queue.isEmpty());
+}
+
+void tst_QMpmcQueue::wrapAround()
+{
+    QMpmcQueue<int> queue(5);
+    int next = 0;
+    int expected = 0;
+    for (int round = 0; round < 100; ++round) {
+        // a different number of elements every round, to move the indexes
+        // around the slots
+        const int count = round % 5 + 1;
+        for (int i = 0; i < count; ++i)
+            QVERIFY(queue.tryEnqueue(next++));
+        QCOMPARE(queue.size(), count);
+        for (int i = 0; i < count; ++i)
+            QCOMPARE(queue.dequeue(), expected++);
+        QVERIFY(queue.isEmpty());
+    }
+}
+
+void tst_QMpmcQueue::emplace()
+{
+    QMpmcQueue<QString> queue(2);
+    QVERIFY(queue.tryEmplace(3, u'x'));
+    QVERIFY(queue.tryEmplace(QLatin1String("text")));
+    QVERIFY(!queue.tryEmplace(QLatin1String("more")));
+    QCOMPARE(queue.dequeue(), QStringLiteral("xxx"));
+    QCOMPARE(queue.dequeue(), QStringLiteral("text"));
+}
+
+void tst_QMpmcQueue::moveOnly()
+{
+    QMpmcQueue<std::unique_ptr<int>> queue(2);
+    queue.enqueue(std::make_unique<int>(1));
+    QVERIFY(queue.tryEnqueue(std::make_unique<int>(2)));
+    QCOMPARE(*queue.dequeue(), 1);
+    std::optional<std::unique_ptr<int>> p = queue.tryDequeue();
+    QVERIFY(p);
+    QCOMPARE(**p, 2);
+}
+
+void tst_QMpmcQueue::failedEnqueueKeepsValue()
+{
+    QMpmcQueue<std::unique_ptr<int>> queue(1);
+    QVERIFY(queue.tryEnqueue(std::make_unique<int>(1)));
+    auto value = std::make_unique<int>(2);
+    QVERIFY(!queue.tryEnqueue(std::move(value)));
+    QVERIFY(value);
+    QVERIFY(!queue.tryEnqueue(std::move(value), QDeadlineTimer(10)));
+    QVERIFY(value);
+    QCOMPARE(*value, 2);
+}
+
+void tst_QMpmcQueue::destroysRemainingElements()
+{
+    {
+        QMpmcQueue<Counted> queue(4);
+        // leave the elements across the end of the slots
+        for (int i = 0; i < 3; ++i)
+            queue.enqueue(Counted(i));
+        for (int i = 0; i < 3; ++i)
+            QCOMPARE(queue.dequeue().value, i);
+        for (int i = 0; i < 4; ++i)
+            queue.enqueue(Counted(i));
+        QCOMPARE(queue.dequeue().value, 0);
+        QCOMPARE(Counted::alive(), 3);
+    }
+    QCOMPARE(Counted::alive(), 0);
+}
+
+void tst_QMpmcQueue::timedDequeueTimesOut()
+{
+    QMpmcQueue<int> queue(1);
+    QElapsedTimer timer;
+    timer.start();
+    QCOMPARE(queue.tryDequeue(QDeadlineTimer(50)), std::nullopt);
+    QVERIFY2(timer.elapsed() >= 45, QByteArray::number(timer.elapsed()));
+
+    QCOMPARE(queue.tryDequeue(QDeadlineTimer(0)), std::nullopt);
+    queue.enqueue(1);
+    QCOMPARE(queue.tryDequeue(QDeadlineTimer(0)), std::optional<int>(1));
+}
+
+void tst_QMpmcQueue::timedEnqueueTimesOut()
+{
+    QMpmcQueue<int> queue(1);
+    QVERIFY(queue.tryEnqueue(1, QDeadlineTimer(0)));
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!queue.tryEnqueue(2, QDeadlineTimer(50)));
+    QVERIFY2(timer.elapsed() >= 45, QByteArray::number(timer.elapsed()));
+    QCOMPARE(queue.dequeue(), 1);
+    QVERIFY(queue.isEmpty());
+}
+
+void tst_QMpmcQueue::blockingDequeue()
+{
+    QMpmcQueue<int> queue(1);
+    std::optional<int> received;
+    auto consumer = startThread([&] { received = queue.tryDequeue(QDeadlineTimer(10000)); });
+    // give the consumer time to block
+    QThread::msleep(50);
+    QVERIFY(!consumer->isFinished());
+    queue.enqueue(42);
+    QVERIFY(consumer->wait(10000));
+    QCOMPARE(received, std::optional<int>(42));
+}
+
+void tst_QMpmcQueue::blockingEnqueue()
+{
+    QMpmcQueue<int> queue(1);
+    queue.enqueue(1);
+    auto producer = startThread([&] { queue.enqueue(2); });
+    QThread::msleep(50);
+    QVERIFY(!producer->isFinished());
+    QCOMPARE(queue.dequeue(), 1);
+    QVERIFY(producer->wait(10000));
+    QCOMPARE(queue.dequeue(), 2);
+}
+
+void tst_QMpmcQueue::manyProducersAndConsumers_data()
+{
+    QTest::addColumn<int>("capacity");
+    QTest::addColumn<int>("countPerProducer");
+
+    // every element passes through the one slot, so that producers and
+    // consumers contend for it all the time
+    QTest::newRow("one slot") << 1 << 5000;
+    // the slot of an element is not a bit mask of its position, and all
+    // threads block often
+    QTest::newRow("not a power of two") << 13 << 50000;
+    QTest::newRow("power of two") << 64 << 50000;
+}
+
+void tst_QMpmcQueue::manyProducersAndConsumers()
+{
+    QFETCH(int, capacity);
+    QFETCH(int, countPerProducer);
+    constexpr int Producers = 4;
+    constexpr int Consumers = 4;
+    const int total = Producers * countPerProducer;
+
+    // every consumer must see the elements of each producer in order, and
+    // every element must be seen by exactly one consumer
+    std::vector<std::vector<int>> received(Consumers);
+    {
+        QMpmcQueue<Counted> queue(capacity);
+        QCOMPARE(queue.capacity(), capacity);
+
+        std::vector<std::unique_ptr<QThread>> producers;
+        for (int p = 0; p < Producers; ++p) {
+            producers.push_back(startThread([&queue, p, countPerProducer] {
+                for (int i = 0; i < countPerProducer; ++i) {
+                    const int value = p * countPerProducer + i;
+                    if (!queue.tryEnqueue(Counted(value)))
+                        queue.enqueue(Counted(value));
+                }
+            }));
+        }
+
+        QAtomicInt remaining(total);
+        std::vector<std::unique_ptr<QThread>> consumers;
+        for (int c = 0; c < Consumers; ++c) {
+            consumers.push_back(startThread([&, c] {
+                while (remaining.fetchAndSubRelaxed(1) > 0)
+                    received[c].push_back(queue.dequeue().value);
+            }));
+        }
+
+        for (const auto &thread : producers)
+            QVERIFY(thread->wait(60000));
+        for (const auto &thread : consumers)
+            QVERIFY(thread->wait(60000));
+        QVERIFY(queue.isEmpty());
+        QCOMPARE(queue.tryDequeue(), std::nullopt);
+    }
+    QCOMPARE(Counted::alive(), 0);
+
+    std::vector<int> seen(total);
+    for (const std::vector<int> &values : received) {
+        std::vector<int> last(Producers, -1);
+        for (int value : values) {
+            QVERIFY(value >= 0 && value < total);
+            const int producer = value / countPerProducer;
+            QVERIFY(value > last[producer]);
+            last[producer] = value;
+            ++seen[value];
+        }
+    }
+    QCOMPARE(std::count(seen.begin(), seen.end(), 1), qsizetype(seen.size()));
+}
+
+void tst_QMpmcQueue::concurrentTryEnqueue()
+{
+    constexpr int Threads = 8;
+    // exactly capacity() of the attempts succeed
+    QMpmcQueue<int> queue(100);
+    QAtomicInt succeeded;
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.push_back(startThread([&queue, &succeeded] {
+            for (int i = 0; i < 1000; ++i)
+                succeeded.fetchAndAddRelaxed(queue.tryEnqueue(i));
+        }));
+    }
+    for (const auto &thread : threads)
+        QVERIFY(thread->wait(60000));
+    QCOMPARE(succeeded.loadRelaxed(), 100);
+    QCOMPARE(queue.size(), 100);
+}
+
+QTEST_MAIN(tst_QMpmcQueue)
+
+#include "tst_qmpmcqueue.moc"
@@ -0,0 +1,233 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QAtomicInt>
+#include <QShardedReadWriteLock>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+Q_DECLARE_METATYPE(QShardedReadWriteLock::Policy)
+
+class tst_QShardedReadWriteLock : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase_data();
+    void slotCount();
+    void readersShareTheLock();
+    void writerExcludesEveryone();
+    void readersBlockWriter();
+    void pendingWriter();
+    void timedOutWriterLetsReadersIn();
+    void readerUnlocksInAnotherThread();
+    void stress();
+};
+
+void tst_QShardedReadWriteLock::initTestCase_data()
+{
+    QTest::addColumn<QShardedReadWriteLock::Policy>("policy");
+    QTest::newRow("WriterPreferring") << QShardedReadWriteLock::WriterPreferring;
+    QTest::newRow("ReaderBiased") << QShardedReadWriteLock::ReaderBiased;
+}
+
+template <typename Functor>
+static bool inOtherThread(Functor &&f)
+{
+    bool result = false;
+    std::unique_ptr<QThread> thread(QThread::create([&] { result = f(); }));
+    thread->start();
+    thread->wait();
+    return result;
+}
+
+void tst_QShardedReadWriteLock::slotCount()
+{
+    QFETCH_GLOBAL(QShardedReadWriteLock::Policy, policy);
+    QCOMPARE(QShardedReadWriteLock(policy, 1).slotCount(), 1);
+    QCOMPARE(QShardedReadWriteLock(policy, 5).slotCount(), 8);
+    QCOMPARE(QShardedReadWriteLock(policy, 16).slotCount(), 16);
+    QCOMPARE(QShardedReadWriteLock(policy, 1000).slotCount(), 64);
+    QVERIFY(QShardedReadWriteLock(policy).slotCount() >= 1);
+    QCOMPARE(QShardedReadWriteLock(policy).policy(), policy);
+}
+
+void tst_QShardedReadWriteLock::readersShareTheLock()
+{
+    QFETCH_GLOBAL(QShardedReadWriteLock::Policy, policy);
+    QShardedReadWriteLock lock(policy);
+    lock.lockForRead();
+    QVERIFY(inOtherThread([&] {
+        if (!lock.tryLockForRead())
+            return false;
+        lock.unlock();
+        return true;
+    }));
+    lock.unlock();
+}
+
+void tst_QShardedReadWriteLock::writerExcludesEveryone()
+{
+    QFETCH_GLOBAL(QShardedReadWriteLock::Policy, policy);
+    QShardedReadWriteLock lock(policy);
+    lock.lockForWrite();
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForRead() && !lock.tryLockForWrite(); }));
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForRead(20) && !lock.tryLockForWrite(20); }));
+    lock.unlock();
+
+    QVERIFY(inOtherThread([&] {
+        if (!lock.tryLockForWrite())
+            return false;
+        lock.unlock();
+        return true;
+    }));
+}
+
+void tst_QShardedReadWriteLock::readersBlockWriter()
+{
+    QFETCH_GLOBAL(QShardedReadWriteLock::Policy, policy);
+    QShardedReadWriteLock lock(policy);
+    lock.lockForRead();
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForWrite(); }));
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForWrite(20); }));
+    lock.unlock();
+    QVERIFY(lock.tryLockForWrite());
+    lock.unlock();
+}
+
+void tst_QShardedReadWriteLock::pendingWriter()
+{
+    QFETCH_GLOBAL(QShardedReadWriteLock::Policy, policy);
+    QShardedReadWriteLock lock(policy);
+    QAtomicInt writerDone = 0;
+
+    lock.lockForRead();
+    std::unique_ptr<QThread> writer(QThread::create([&] {
+        lock.lockForWrite();
+        writerDone.storeRelaxed(1);
+        lock.unlock();
+    }));
+    writer->start();
+
+    // a new reader gets in while the writer waits only if readers are
+    // favored; in either case, the writer has to wait for us
+    if (policy == QShardedReadWriteLock::WriterPreferring) {
+        QTRY_VERIFY(inOtherThread([&] {
+            const bool locked = lock.tryLockForRead();
+            if (locked)
+                lock.unlock();
+            return !locked;
+        }));
+    } else {
+        QTest::qWait(50);
+        QVERIFY(inOtherThread([&] {
+            if (!lock.tryLockForRead())
+                return false;
+            lock.unlock();
+            return true;
+        }));
+    }
+    QCOMPARE(writerDone.loadRelaxed(), 0);
+
+    lock.unlock();
+    QVERIFY(writer->wait());
+    QCOMPARE(writerDone.loadRelaxed(), 1);
+}
+
+void tst_QShardedReadWriteLock::timedOutWriterLetsReadersIn()
+{
+    QFETCH_GLOBAL(QShardedReadWriteLock::Policy, policy);
+    QShardedReadWriteLock lock(policy);
+    lock.lockForRead();
+    QVERIFY(inOtherThread([&] { return !lock.tryLockForWrite(50); }));
+    QVERIFY(inOtherThread([&] {
+        if (!lock.tryLockForRead())
+            return false;
+        lock.unlock();
+        return true;
+    }));
+    lock.unlock();
+}
+
+void tst_QShardedReadWriteLock::readerUnlocksInAnotherThread()
+{
+    QFETCH_GLOBAL(QShardedReadWriteLock::Policy, policy);
+    QShardedReadWriteLock lock(policy, 64);
+    lock.lockForRead();
+    inOtherThread([&] { lock.unlock(); return true; });
+    QVERIFY(lock.tryLockForWrite());
+    lock.unlock();
+}
+
+void tst_QShardedReadWriteLock::stress()
+{
+    QFETCH_GLOBAL(QShardedReadWriteLock::Policy, policy);
+    QShardedReadWriteLock lock(policy);
+
+    // the writers keep both values equal; readers must never see them differ
+    int first = 0;
+    int second = 0;
+    QAtomicInt mismatches = 0;
+    QAtomicInt writes = 0;
+    enum { Threads = 8, Iterations = 20000 };
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.emplace_back(QThread::create([&, t] {
+            for (int i = 0; i < Iterations; ++i) {
+                if ((i + t) % 64 == 0) {
+                    lock.lockForWrite();
+                    ++first;
+                    QThread::yieldCurrentThread();
+                    ++second;
+                    writes.ref();
+                    lock.unlock();
+                } else {
+                    lock.lockForRead();
+                    if (first != second)
+                        mismatches.ref();
+                    lock.unlock();
+                }
+            }
+        }));
+    }
+    for (auto &thread : threads)
+        thread->start();
+    for (auto &thread : threads)
+        QVERIFY(thread->wait());
+
+    QCOMPARE(mismatches.loadRelaxed(), 0);
+    QCOMPARE(first, writes.loadRelaxed());
+    QCOMPARE(second, writes.loadRelaxed());
+}
+
+QTEST_MAIN(tst_QShardedReadWriteLock)
+#include "tst_qshardedreadwritelock.moc"
@@ -108,6 +108,10 @@ private slots:
     void takeAllAndIncreaseMaxThreadCount();
     void waitForDoneAfterTake();
     void threadReuse();
+    void workStealing_data();
+    void workStealing();
+    void workStealingPriority();
+    void workStealingTryTakeAndClear();
 
 private:
     QMutex m_functionTestMutex;
@@ -1460,5 +1464,101 @@ void tst_QThreadPool::threadReuse()
     }
 }
 
+void tst_QThreadPool::workStealing_data()
+{
+    QTest::addColumn<int>("maxThreadCount");
+    for (int threads : {1, 2, 4, 16})
+        QTest::addRow("threads: %d", threads) << threads;
+}
+
+void tst_QThreadPool::workStealing()
+{
+    QFETCH(int, maxThreadCount);
+
+    // runnables started from the pool's threads go to their own queues
+    const int outer = 100;
+    const int inner = 100;
+    count.storeRelaxed(0);
+    {
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(maxThreadCount);
+        threadPool.setWorkStealingEnabled(true);
+        QVERIFY(threadPool.isWorkStealingEnabled());
+        for (int i = 0; i < outer; ++i) {
+            threadPool.start([&threadPool]() {
+                for (int j = 0; j < inner; ++j)
+                    threadPool.start(new CountingRunnable());
+                count.ref();
+            });
+        }
+        QVERIFY(threadPool.waitForDone());
+        QCOMPARE(count.loadRelaxed(), outer * (inner + 1));
+        QVERIFY(threadPool.activeThreadCount() <= maxThreadCount);
+
+        // switching back leaves the pool usable
+        threadPool.setWorkStealingEnabled(false);
+        for (int i = 0; i < outer; ++i)
+            threadPool.start(new CountingRunnable());
+    }
+    QCOMPARE(count.loadRelaxed(), outer * (inner + 2));
+}
+
+void tst_QThreadPool::workStealingPriority()
+{
+    class Runner : public QRunnable
+    {
+    public:
+        QAtomicPointer<QRunnable> &ptr;
+        Runner(QAtomicPointer<QRunnable> &ptr) : ptr(ptr) {}
+        void run() override
+        {
+            ptr.testAndSetRelaxed(nullptr, this);
+        }
+    };
+
+    QSemaphore sem;
+    QAtomicPointer<QRunnable> firstStarted;
+    QRunnable *expected;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.setWorkStealingEnabled(true);
+
+    threadPool.start([&sem]() { sem.acquire(); });
+    // more than fits in one queue page
+    for (int i = 0; i < 300; ++i)
+        threadPool.start(new Runner(firstStarted), 0);
+    threadPool.start(expected = new Runner(firstStarted), 1);
+
+    sem.release();
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(firstStarted.loadRelaxed(), expected);
+}
+
+void tst_QThreadPool::workStealingTryTakeAndClear()
+{
+    QSemaphore sem;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.setWorkStealingEnabled(true);
+    threadPool.start([&sem]() { sem.acquire(); });
+
+    count.storeRelaxed(0);
+    QList<QRunnable *> runnables;
+    for (int i = 0; i < 10; ++i) {
+        runnables.append(new CountingRunnable);
+        threadPool.start(runnables.last());
+    }
+
+    QRunnable *taken = runnables.takeAt(5);
+    QVERIFY(threadPool.tryTake(taken));
+    QVERIFY(!threadPool.tryTake(taken));
+    delete taken;
+
+    threadPool.clear();
+    sem.release();
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(count.loadRelaxed(), 0);
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
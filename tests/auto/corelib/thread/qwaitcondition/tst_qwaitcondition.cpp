@@ -35,6 +35,9 @@
 #include <qthread.h>
 #include <qwaitcondition.h>
 
+#include <memory>
+#include <vector>
+
 #define COND_WAIT_TIME 1
 
 class tst_QWaitCondition : public QObject
@@ -46,6 +49,9 @@ private slots:
     void wakeOne();
     void wakeAll();
     void wait_RaceCondition();
+    void wakeAll_manyWaiters();
+    void wakeAll_mixedLocks();
+    void wakeAll_withoutLockWhileWaitersEnter();
 };
 
 static const int iterations = 4;
@@ -874,5 +880,163 @@ void tst_QWaitCondition::wait_RaceCondition()
     }
 }
 
+void tst_QWaitCondition::wakeAll_manyWaiters()
+{
+    // all threads wait with the same mutex, so wakeAll() may hand them over
+    // to the mutex one after the other; each must still wake up, also when
+    // they keep the mutex a while and when some wait with a timeout
+    enum { Waiters = 32, Rounds = 20 };
+    QMutex mutex;
+    QWaitCondition cond;
+    int generation = 0;
+    int woken = 0;
+    int waiting = 0;
+    QWaitCondition allWaiting;
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < Waiters; ++t) {
+        threads.emplace_back(QThread::create([&, t] {
+            for (int round = 0; round < Rounds; ++round) {
+                QMutexLocker locker(&mutex);
+                const int seen = generation;
+                if (++waiting == Waiters)
+                    allWaiting.wakeOne();
+                while (generation == seen) {
+                    if (t % 4)
+                        cond.wait(&mutex);
+                    else
+                        cond.wait(&mutex, 10);
+                }
+                ++woken;
+                if (t % 8 == 0)
+                    QThread::yieldCurrentThread();
+            }
+        }));
+        threads.back()->start();
+    }
+
+    for (int round = 0; round < Rounds; ++round) {
+        QMutexLocker locker(&mutex);
+        while (waiting < Waiters)
+            QVERIFY(allWaiting.wait(&mutex, 10000));
+        waiting = 0;
+        ++generation;
+        cond.wakeAll();
+    }
+    for (auto &thread : threads)
+        QVERIFY(thread->wait(10000));
+    QCOMPARE(woken, Waiters * Rounds);
+}
+
+void tst_QWaitCondition::wakeAll_mixedLocks()
+{
+    // waiters that use different locks on the same condition
+    QMutex mutex1, mutex2;
+    QReadWriteLock readWriteLock;
+    QWaitCondition cond;
+    QAtomicInt ready = 0;
+    QAtomicInt woken = 0;
+    bool go = false;
+    enum { ThreadsPerLock = 4 };
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    auto waitOn = [&](auto *lock, auto &&unlocker) {
+        threads.emplace_back(QThread::create([&, lock, unlocker] {
+            unlocker(lock, [&] {
+                ready.ref();
+                while (!go)
+                    cond.wait(lock, 10000);
+                woken.ref();
+            });
+        }));
+        threads.back()->start();
+    };
+    const auto withMutex = [](QMutex *m, auto &&f) { QMutexLocker locker(m); f(); };
+    const auto withWriteLock = [](QReadWriteLock *l, auto &&f) { QWriteLocker locker(l); f(); };
+    for (int i = 0; i < ThreadsPerLock; ++i) {
+        waitOn(&mutex1, withMutex);
+        waitOn(&mutex2, withMutex);
+        waitOn(&readWriteLock, withWriteLock);
+    }
+    QTRY_COMPARE(ready.loadRelaxed(), 3 * ThreadsPerLock);
+
+    {
+        // everyone holds their lock until it's inside wait()
+        QMutexLocker locker1(&mutex1);
+        QMutexLocker locker2(&mutex2);
+        QWriteLocker locker3(&readWriteLock);
+        go = true;
+        cond.wakeAll();
+    }
+    for (auto &thread : threads)
+        QVERIFY(thread->wait(10000));
+    QCOMPARE(woken.loadRelaxed(), 3 * ThreadsPerLock);
+}
+
+void tst_QWaitCondition::wakeAll_withoutLockWhileWaitersEnter()
+{
+    // wakeAll() without the mutex held, while other threads keep starting
+    // to wait on the same mutex and condition: those must not take the
+    // wakeups of the waiters that wakeAll() requeues onto the mutex, or one
+    // of the latter never wakes up and the next round doesn't start
+    enum { Waiters = 8, Latecomers = 8, Rounds = 200 };
+    QMutex mutex;
+    QWaitCondition cond;
+    QWaitCondition allWaiting;
+    int generation = 0;
+    int waiting = 0;
+    QAtomicInt done = false;
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < Waiters; ++t) {
+        threads.emplace_back(QThread::create([&] {
+            for (int round = 0; round < Rounds; ++round) {
+                QMutexLocker locker(&mutex);
+                const int seen = generation;
+                if (++waiting == Waiters)
+                    allWaiting.wakeOne();
+                while (generation == seen && !done.loadRelaxed())
+                    cond.wait(&mutex);
+                if (done.loadRelaxed())
+                    return;
+            }
+        }));
+        threads.back()->start();
+    }
+    for (int t = 0; t < Latecomers; ++t) {
+        threads.emplace_back(QThread::create([&] {
+            while (!done.loadRelaxed()) {
+                QMutexLocker locker(&mutex);
+                cond.wait(&mutex, 1);
+            }
+        }));
+        threads.back()->start();
+    }
+
+    int rounds = 0;
+    for (; rounds < Rounds; ++rounds) {
+        {
+            QMutexLocker locker(&mutex);
+            while (waiting < Waiters && allWaiting.wait(&mutex, 10000))
+                ;
+            if (waiting < Waiters)
+                break;
+            waiting = 0;
+            ++generation;
+        }
+        cond.wakeAll();
+    }
+
+    {
+        // let a waiter that lost its wakeup go, so that we can clean up
+        QMutexLocker locker(&mutex);
+        done.storeRelaxed(true);
+        cond.wakeAll();
+    }
+    for (auto &thread : threads)
+        QVERIFY(thread->wait(10000));
+    QCOMPARE(rounds, int(Rounds));
+}
+
 QTEST_MAIN(tst_QWaitCondition)
 #include "tst_qwaitcondition.moc"
@@ -0,0 +1,838 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+
+#include <qbtreemap.h>
+#include <qmap.h>
+#include <qrandom.h>
+#include <qstring.h>
+
+#include <map>
+
+#include "../../../../shared/containertesthelpers.h"
+
+using QTestContainerHelpers::Counted;
+
+class tst_QBTreeMap : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insertAndFind();
+    void operatorBracket();
+    void emplace();
+    void orderedIteration();
+    void appendInOrder();
+    void lowerAndUpperBound();
+    void boundsAtLeafEdges();
+    void remove();
+    void splitAndMergeLeaves();
+    void splitAndMergeInnerNodes();
+    void take();
+    void randomOperations_data();
+    void randomOperations();
+    void erase();
+    void eraseRange();
+    void eraseAtLeafEdges();
+    void removeIf();
+    void implicitSharing();
+    void equality();
+    void nonTrivialTypes();
+    void largeValues();
+    void keysAndValues();
+    void firstAndLast();
+    void fromAndToMap();
+
+private:
+    template <typename Key, typename T>
+    static bool checkInvariants(const QBTreeMap<Key, T> &map);
+    template <typename Key, typename T>
+    static bool checkNode(const void *node, int level, const Key *lowerBound, const Key *upperBound,
+                          std::vector<const QBTreeMapPrivate::Leaf<Key, T> *> &leaves);
+    template <typename Key, typename T>
+    static bool sameAsStdMap(const QBTreeMap<Key, T> &map, const std::map<Key, T> &reference);
+};
+
+// Walks the tree, checking the order of the keys against the separators,
+// the fill of the nodes and the list of leaves.
+template <typename Key, typename T>
+bool tst_QBTreeMap::checkNode(const void *node, int level, const Key *lowerBound, const Key *upperBound,
+                              std::vector<const QBTreeMapPrivate::Leaf<Key, T> *> &leaves)
+{
+    using Leaf = QBTreeMapPrivate::Leaf<Key, T>;
+    using Inner = QBTreeMapPrivate::Inner<Key>;
+    const auto inRange = [&](const Key &key) {
+        return (!lowerBound || !(key < *lowerBound)) && (!upperBound || key < *upperBound);
+    };
+
+    if (level == 0) {
+        const Leaf *leaf = static_cast<const Leaf *>(node);
+        if (leaf->count < 1 || leaf->count > Leaf::Capacity)
+            return false;
+        for (int i = 0; i < leaf->count; ++i) {
+            if (!inRange(leaf->keys()[i]))
+                return false;
+            if (i > 0 && !(leaf->keys()[i - 1] < leaf->keys()[i]))
+                return false;
+        }
+        leaves.push_back(leaf);
+        return true;
+    }
+
+    const Inner *inner = static_cast<const Inner *>(node);
+    if (inner->count < 1 || inner->count > Inner::Capacity)
+        return false;
+    for (int i = 0; i < inner->count; ++i) {
+        if (!inRange(inner->keys()[i]))
+            return false;
+        if (i > 0 && !(inner->keys()[i - 1] < inner->keys()[i]))
+            return false;
+    }
+    for (int i = 0; i <= inner->count; ++i) {
+        const Key *lower = i > 0 ? &inner->keys()[i - 1] : lowerBound;
+        const Key *upper = i < inner->count ? &inner->keys()[i] : upperBound;
+        if (!checkNode<Key, T>(inner->children[i], level - 1, lower, upper, leaves))
+            return false;
+    }
+    return true;
+}
+
+template <typename Key, typename T>
+bool tst_QBTreeMap::checkInvariants(const QBTreeMap<Key, T> &map)
+{
+    const auto *d = map.d;
+    if (!d)
+        return true;
+    if (!d->root)
+        return d->size == 0 && d->depth == 0 && !d->first && !d->last;
+
+    std::vector<const QBTreeMapPrivate::Leaf<Key, T> *> leaves;
+    if (!checkNode<Key, T>(d->root, d->depth, nullptr, nullptr, leaves))
+        return false;
+
+    // the leaves, in key order, form a doubly-linked list
+    if (d->first != leaves.front() || d->last != leaves.back())
+        return false;
+    size_t size = 0;
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        if (leaves[i]->prev != (i > 0 ? leaves[i - 1] : nullptr))
+            return false;
+        if (leaves[i]->next != (i + 1 < leaves.size() ? leaves[i + 1] : nullptr))
+            return false;
+        size += leaves[i]->count;
+    }
+    return size == d->size;
+}
+
+template <typename Key, typename T>
+bool tst_QBTreeMap::sameAsStdMap(const QBTreeMap<Key, T> &map, const std::map<Key, T> &reference)
+{
+    if (size_t(map.size()) != reference.size())
+        return false;
+    auto it = map.begin();
+    for (const auto &[key, value] : reference) {
+        if (it == map.end() || !(it.key() == key) || !(it.value() == value))
+            return false;
+        ++it;
+    }
+    if (it != map.end())
+        return false;
+
+    // and backwards
+    auto rit = reference.rbegin();
+    for (auto bit = map.end(); bit != map.begin(); ++rit) {
+        --bit;
+        if (!(bit.key() == rit->first))
+            return false;
+    }
+    return rit == reference.rend();
+}
+
+void tst_QBTreeMap::insertAndFind()
+{
+    QBTreeMap<int, int> map;
+    QVERIFY(map.isEmpty());
+    QCOMPARE(map.size(), 0);
+    QVERIFY(!map.contains(1));
+    QCOMPARE(map.find(1), map.end());
+    QCOMPARE(std::as_const(map).find(1), map.constEnd());
+    QCOMPARE(map.value(1), 0);
+    QCOMPARE(map.value(1, -1), -1);
+    QCOMPARE(map.begin(), map.end());
+
+    map.insert(2, 20);
+    map.insert(1, 10);
+    map.insert(2, 21);
+    QCOMPARE(map.size(), 2);
+    QVERIFY(map.contains(1));
+    QVERIFY(map.contains(2));
+    QVERIFY(!map.contains(3));
+    QCOMPARE(map.value(1), 10);
+    QCOMPARE(map.value(2), 21);
+    QCOMPARE(map.count(1), 1);
+    QCOMPARE(map.count(3), 0);
+
+    auto it = map.find(2);
+    QVERIFY(it != map.end());
+    QCOMPARE(it.key(), 2);
+    QCOMPARE(it.value(), 21);
+    *it = 22;
+    QCOMPARE(map.value(2), 22);
+    QCOMPARE(std::as_const(map).constFind(2).value(), 22);
+
+    // enough entries for several levels
+    for (int i = 0; i < 10000; ++i)
+        map.insert(i * 7 % 10000, i);
+    QCOMPARE(map.size(), 10000);
+    QVERIFY(checkInvariants(map));
+    for (int i = 0; i < 10000; ++i)
+        QCOMPARE(map.value(i * 7 % 10000, -1), i);
+    QVERIFY(!map.contains(10000));
+    QVERIFY(!map.contains(-1));
+}
+
+void tst_QBTreeMap::operatorBracket()
+{
+    QBTreeMap<QString, int> map;
+    map[QStringLiteral("one")] = 1;
+    map[QStringLiteral("two")] = 2;
+    ++map[QStringLiteral("one")];
+    QCOMPARE(map.size(), 2);
+    QCOMPARE(map.value(QStringLiteral("one")), 2);
+    QCOMPARE(map[QStringLiteral("three")], 0);
+    QCOMPARE(map.size(), 3);
+
+    const auto &cmap = map;
+    QCOMPARE(cmap[QStringLiteral("two")], 2);
+    QCOMPARE(cmap[QStringLiteral("four")], 0);
+    QCOMPARE(map.size(), 3);
+
+    // a key referring into the map itself, while it detaches
+    QBTreeMap<QString, int> copy = map;
+    copy[copy.firstKey()] = 42;
+    QCOMPARE(copy.value(QStringLiteral("one")), 42);
+    QCOMPARE(map.value(QStringLiteral("one")), 2);
+}
+
+void tst_QBTreeMap::emplace()
+{
+    QBTreeMap<int, QString> map;
+    auto it = map.emplace(1, 3, QLatin1Char('a'));
+    QCOMPARE(it.key(), 1);
+    QCOMPARE(it.value(), QStringLiteral("aaa"));
+    it = map.emplace(1, QStringLiteral("b"));
+    QCOMPARE(it.value(), QStringLiteral("b"));
+    QCOMPARE(map.size(), 1);
+
+    // an argument referring into the map, across a split of the leaf
+    for (int i = 2; i < 200; ++i)
+        map.emplace(i, map.first());
+    QCOMPARE(map.size(), 199);
+    for (auto v : std::as_const(map))
+        QCOMPARE(v, QStringLiteral("b"));
+    QVERIFY(checkInvariants(map));
+}
+
+void tst_QBTreeMap::orderedIteration()
+{
+    QBTreeMap<quint32, int> map;
+    std::map<quint32, int> reference;
+    QRandomGenerator rng(42);
+    for (int i = 0; i < 20000; ++i) {
+        const quint32 key = rng.bounded(100000);
+        map.insert(key, i);
+        reference[key] = i;
+    }
+    QVERIFY(checkInvariants(map));
+    QVERIFY(sameAsStdMap(map, reference));
+
+    // post-increment and -decrement
+    auto it = map.constBegin();
+    auto prev = it++;
+    QCOMPARE(prev, map.constBegin());
+    QCOMPARE(it.key(), std::next(reference.begin())->first);
+    QCOMPARE((it--).key(), std::next(reference.begin())->first);
+    QCOMPARE(it, map.constBegin());
+
+    int n = 0;
+    for (auto [key, value] : map.asKeyValueRange()) {
+        QCOMPARE(reference.at(key), value);
+        ++n;
+    }
+    QCOMPARE(n, map.size());
+
+    QList<quint32> keys(map.keyBegin(), map.keyEnd());
+    QVERIFY(std::is_sorted(keys.cbegin(), keys.cend()));
+}
+
+void tst_QBTreeMap::appendInOrder()
+{
+    using Leaf = QBTreeMapPrivate::Leaf<int, int>;
+    QBTreeMap<int, int> map;
+    const int n = 100 * Leaf::Capacity + 1;
+    for (int i = 0; i < n; ++i)
+        map.insert(i, i);
+    QVERIFY(checkInvariants(map));
+    QCOMPARE(map.firstKey(), 0);
+    QCOMPARE(map.lastKey(), n - 1);
+
+    // appending in key order fills the leaves instead of splitting them in half
+    int leaves = 0;
+    for (auto leaf = map.d->first; leaf; leaf = leaf->next)
+        ++leaves;
+    QCOMPARE(leaves, 101);
+
+    // inserting in reverse order gives the same map
+    QBTreeMap<int, int> reversed;
+    for (int i = n - 1; i >= 0; --i)
+        reversed.insert(i, i);
+    QVERIFY(checkInvariants(reversed));
+    QCOMPARE(reversed, map);
+}
+
+void tst_QBTreeMap::lowerAndUpperBound()
+{
+    QBTreeMap<int, int> map;
+    QMap<int, int> reference;
+    QCOMPARE(map.lowerBound(1), map.end());
+    QCOMPARE(std::as_const(map).upperBound(1), map.constEnd());
+
+    for (int i = 0; i < 5000; ++i) {
+        map.insert(i * 2, i);
+        reference.insert(i * 2, i);
+    }
+    for (int key = -2; key < 10002; ++key) {
+        const auto lower = std::as_const(map).lowerBound(key);
+        const auto upper = std::as_const(map).upperBound(key);
+        const auto expectedLower = reference.lowerBound(key);
+        const auto expectedUpper = reference.upperBound(key);
+        if (expectedLower == reference.end())
+            QCOMPARE(lower, map.constEnd());
+        else
+            QCOMPARE(lower.key(), expectedLower.key());
+        if (expectedUpper == reference.end())
+            QCOMPARE(upper, map.constEnd());
+        else
+            QCOMPARE(upper.key(), expectedUpper.key());
+    }
+
+    // a range scan
+    int sum = 0;
+    for (auto it = map.lowerBound(1000), end = map.upperBound(2000); it != end; ++it)
+        sum += it.key();
+    QCOMPARE(sum, (1000 + 2000) * 501 / 2);
+
+    const auto range = map.equal_range(10);
+    QCOMPARE(range.first.key(), 10);
+    QCOMPARE(range.second.key(), 12);
+    const auto none = std::as_const(map).equal_range(11);
+    QCOMPARE(none.first, none.second);
+}
+
+void tst_QBTreeMap::boundsAtLeafEdges()
+{
+    // leaves of different fill, with gaps between the keys
+    QBTreeMap<int, int> map;
+    std::map<int, int> reference;
+    for (int i = 0; i < 5000; ++i) {
+        map.insert(i * 2, i);
+        reference[i * 2] = i;
+    }
+    for (int i = 0; i < 10000; i += 6) {
+        map.remove(i);
+        reference.erase(i);
+    }
+    QVERIFY(checkInvariants(map));
+
+    const auto keyOrEnd = [&](QBTreeMap<int, int>::const_iterator it) {
+        return it == map.cend() ? -1 : it.key();
+    };
+    const auto expected = [&](std::map<int, int>::const_iterator it) {
+        return it == reference.cend() ? -1 : it->first;
+    };
+    int leaves = 0;
+    for (auto leaf = map.d->first; leaf; leaf = leaf->next, ++leaves) {
+        const int first = leaf->keys()[0];
+        const int last = leaf->keys()[leaf->count - 1];
+        for (int key : { first - 1, first, last, last + 1 }) {
+            QCOMPARE(keyOrEnd(std::as_const(map).lowerBound(key)), expected(reference.lower_bound(key)));
+            QCOMPARE(keyOrEnd(std::as_const(map).upperBound(key)), expected(reference.upper_bound(key)));
+        }
+        // stepping over the edge in both directions
+        auto it = std::as_const(map).upperBound(last);
+        QCOMPARE(keyOrEnd(it), leaf->next ? leaf->next->keys()[0] : -1);
+        QCOMPARE((--it).key(), last);
+        if (leaf->prev)
+            QCOMPARE(std::prev(std::as_const(map).lowerBound(first)).key(), leaf->prev->keys()[leaf->prev->count - 1]);
+    }
+    QVERIFY(leaves > 10);
+}
+
+void tst_QBTreeMap::remove()
+{
+    QBTreeMap<int, int> map;
+    QCOMPARE(map.remove(1), 0);
+    QVERIFY(!map.d); // does not allocate
+
+    std::map<int, int> reference;
+    for (int i = 0; i < 10000; ++i) {
+        map.insert(i, i);
+        reference[i] = i;
+    }
+    QCOMPARE(map.remove(-1), 0);
+
+    // remove every other key, then the rest from the back, so that leaves
+    // both borrow from their siblings and get merged with them
+    for (int i = 0; i < 10000; i += 2) {
+        QCOMPARE(map.remove(i), 1);
+        reference.erase(i);
+        if (i % 512 == 0)
+            QVERIFY(checkInvariants(map));
+    }
+    QCOMPARE(map.remove(0), 0);
+    QVERIFY(sameAsStdMap(map, reference));
+    for (int i = 9999; i > 0; i -= 2) {
+        QCOMPARE(map.remove(i), 1);
+        if (i % 511 == 0)
+            QVERIFY(checkInvariants(map));
+    }
+    QVERIFY(map.isEmpty());
+    QVERIFY(checkInvariants(map));
+    QCOMPARE(map.begin(), map.end());
+
+    map.insert(1, 1);
+    QCOMPARE(map.size(), 1);
+    QCOMPARE(map.value(1), 1);
+}
+
+void tst_QBTreeMap::splitAndMergeLeaves()
+{
+    using Leaf = QBTreeMapPrivate::Leaf<int, int>;
+    static_assert(Leaf::Capacity == 2 * Leaf::MinCount);
+
+    // a full leaf stays the root until one more entry arrives
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < Leaf::Capacity; ++i)
+        map.insert(i * 2, i);
+    QCOMPARE(map.d->depth, 0);
+    QCOMPARE(map.d->first, map.d->last);
+
+    // which is then split in half, not appended to a new leaf
+    map.insert(1, -1);
+    QVERIFY(checkInvariants(map));
+    QCOMPARE(map.d->depth, 1);
+    QCOMPARE(map.d->first->next, map.d->last);
+    QCOMPARE(map.d->first->count, Leaf::MinCount + 1);
+    QCOMPARE(map.d->last->count, Leaf::MinCount);
+
+    // one below the minimum, the right leaf borrows from the left one
+    map.remove(map.lastKey());
+    QVERIFY(checkInvariants(map));
+    QCOMPARE(map.d->depth, 1);
+    QCOMPARE(map.d->first->count, Leaf::MinCount);
+    QCOMPARE(map.d->last->count, Leaf::MinCount);
+
+    // and now, as neither can spare one, they are merged into the root
+    map.remove(map.lastKey());
+    QVERIFY(checkInvariants(map));
+    QCOMPARE(map.d->depth, 0);
+    QCOMPARE(map.d->first, map.d->last);
+    QCOMPARE(map.size(), 2 * Leaf::MinCount - 1);
+    QCOMPARE(map.firstKey(), 0);
+    QCOMPARE(map.value(1), -1);
+}
+
+void tst_QBTreeMap::splitAndMergeInnerNodes()
+{
+    using Leaf = QBTreeMapPrivate::Leaf<int, int>;
+    using Inner = QBTreeMapPrivate::Inner<int>;
+
+    // appending fills the leaves, so this fills the root exactly
+    const int n = (Inner::Capacity + 1) * Leaf::Capacity;
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < n; ++i)
+        map.insert(i, i);
+    QVERIFY(checkInvariants(map));
+    QCOMPARE(map.d->depth, 1);
+    QCOMPARE(static_cast<const Inner *>(map.d->root)->count, Inner::Capacity);
+
+    map.insert(n, n);
+    QVERIFY(checkInvariants(map));
+    QCOMPARE(map.d->depth, 2);
+
+    // shrinking from the back merges the nodes again, level by level
+    int depth = map.d->depth;
+    for (int i = n; i >= 0; --i) {
+        QCOMPARE(map.remove(i), 1);
+        QVERIFY(map.d->depth <= depth);
+        depth = map.d->depth;
+        if (i % 7 == 0 || depth != 2)
+            QVERIFY2(checkInvariants(map), QByteArray::number(i));
+        if (i == Leaf::Capacity)
+            QCOMPARE(depth, 1);
+    }
+    QVERIFY(map.isEmpty());
+    QCOMPARE(map.d->depth, 0);
+}
+
+void tst_QBTreeMap::take()
+{
+    QBTreeMap<int, QString> map;
+    QCOMPARE(map.take(1), QString());
+    for (int i = 0; i < 1000; ++i)
+        map.insert(i, QString::number(i));
+    QBTreeMap<int, QString> copy = map;
+    QCOMPARE(map.take(500), QStringLiteral("500"));
+    QCOMPARE(map.size(), 999);
+    QVERIFY(!map.contains(500));
+    QCOMPARE(map.take(500), QString());
+    QCOMPARE(copy.size(), 1000);
+    QCOMPARE(copy.value(500), QStringLiteral("500"));
+    QVERIFY(checkInvariants(map));
+}
+
+void tst_QBTreeMap::randomOperations_data()
+{
+    QTest::addColumn<int>("keyRange");
+    QTest::addColumn<int>("operations");
+
+    QTest::newRow("dense") << 300 << 50000;
+    QTest::newRow("sparse") << 100000 << 50000;
+}
+
+void tst_QBTreeMap::randomOperations()
+{
+    QFETCH(int, keyRange);
+    QFETCH(int, operations);
+
+    QBTreeMap<int, int> map;
+    std::map<int, int> reference;
+    QRandomGenerator rng(1234);
+    for (int i = 0; i < operations; ++i) {
+        const int key = rng.bounded(keyRange);
+        switch (rng.bounded(4)) {
+        case 0:
+        case 1:
+            map.insert(key, i);
+            reference[key] = i;
+            break;
+        case 2:
+            QCOMPARE(map.remove(key), qsizetype(reference.erase(key)));
+            break;
+        case 3: {
+            const auto it = map.lowerBound(key);
+            const auto expected = reference.lower_bound(key);
+            if (expected == reference.end()) {
+                QCOMPARE(it, map.end());
+                break;
+            }
+            QCOMPARE(it.key(), expected->first);
+            const auto next = map.erase(it);
+            const auto expectedNext = reference.erase(expected);
+            if (expectedNext == reference.end())
+                QCOMPARE(next, map.end());
+            else
+                QCOMPARE(next.key(), expectedNext->first);
+            break;
+        }
+        }
+        if (i % 1000 == 0)
+            QVERIFY(checkInvariants(map));
+    }
+    QVERIFY(checkInvariants(map));
+    QVERIFY(sameAsStdMap(map, reference));
+}
+
+void tst_QBTreeMap::erase()
+{
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < 5000; ++i)
+        map.insert(i, i);
+
+    // erasing everything through the returned iterators visits every key
+    int expected = 0;
+    for (auto it = map.begin(); it != map.end();) {
+        QCOMPARE(it.key(), expected);
+        if (expected % 3 == 0) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+        ++expected;
+    }
+    QCOMPARE(expected, 5000);
+    QCOMPARE(map.size(), 5000 - 1667);
+    QVERIFY(checkInvariants(map));
+
+    // erasing from a shared map detaches it
+    QBTreeMap<int, int> copy = map;
+    auto it = copy.erase(copy.constFind(1));
+    QCOMPARE(it.key(), 2);
+    QCOMPARE(copy.size(), map.size() - 1);
+    QVERIFY(map.contains(1));
+
+    // erasing the last entry returns end()
+    while (!map.isEmpty())
+        it = map.erase(std::prev(map.cend()));
+    QCOMPARE(it, map.end());
+    QVERIFY(checkInvariants(map));
+}
+
+void tst_QBTreeMap::eraseRange()
+{
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < 3000; ++i)
+        map.insert(i, i);
+
+    auto it = map.erase(map.constFind(100), map.constFind(2000));
+    QCOMPARE(it.key(), 2000);
+    QCOMPARE(map.size(), 1100);
+    QVERIFY(map.contains(99));
+    QVERIFY(!map.contains(100));
+    QVERIFY(!map.contains(1999));
+    QVERIFY(checkInvariants(map));
+
+    it = map.erase(map.constFind(2000), map.constFind(2000));
+    QCOMPARE(it.key(), 2000);
+    QCOMPARE(map.size(), 1100);
+
+    it = map.erase(map.cbegin(), map.cend());
+    QCOMPARE(it, map.end());
+    QVERIFY(map.isEmpty());
+}
+
+void tst_QBTreeMap::eraseAtLeafEdges()
+{
+    QBTreeMap<int, int> map;
+    std::map<int, int> reference;
+    QRandomGenerator rng(5);
+    for (int i = 0; i < 5000; ++i) {
+        const int key = rng.bounded(20000);
+        map.insert(key, i);
+        reference[key] = i;
+    }
+
+    // Erase the first and last entries of every leaf through iterators,
+    // which makes the leaves borrow and merge, and check that the returned
+    // iterator and the leaf chain lead to the right neighbours.
+    for (int round = 0; round < 4 && !map.isEmpty(); ++round) {
+        QList<int> edges;
+        for (auto leaf = map.d->first; leaf; leaf = leaf->next) {
+            edges.append(leaf->keys()[0]);
+            if (leaf->count > 1)
+                edges.append(leaf->keys()[leaf->count - 1]);
+        }
+        for (int key : std::as_const(edges)) {
+            auto next = reference.erase(reference.find(key));
+            auto it = map.erase(map.constFind(key));
+            if (next == reference.end()) {
+                QCOMPARE(it, map.end());
+            } else {
+                QCOMPARE(it.key(), next->first);
+            }
+            if (next != reference.begin())
+                QCOMPARE(std::prev(it).key(), std::prev(next)->first);
+        }
+        QVERIFY(checkInvariants(map));
+        QVERIFY(sameAsStdMap(map, reference));
+    }
+}
+
+void tst_QBTreeMap::removeIf()
+{
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < 2000; ++i)
+        map.insert(i, i);
+
+    QCOMPARE(map.removeIf([](QBTreeMap<int, int>::iterator it) { return it.key() % 2; }), 1000);
+    QCOMPARE(map.size(), 1000);
+    QCOMPARE(erase_if(map, [](std::pair<const int &, int &> p) { return p.second >= 1000; }), 500);
+    QCOMPARE(map.size(), 500);
+    for (auto it = map.cbegin(); it != map.cend(); ++it)
+        QVERIFY(it.key() % 2 == 0 && it.key() < 1000);
+    QVERIFY(checkInvariants(map));
+}
+
+void tst_QBTreeMap::implicitSharing()
+{
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < 1000; ++i)
+        map.insert(i, i);
+
+    QBTreeMap<int, int> copy = map;
+    QVERIFY(copy.isSharedWith(map));
+    QVERIFY(!map.isDetached());
+
+    copy.insert(1000, 1000);
+    QVERIFY(!copy.isSharedWith(map));
+    QVERIFY(copy.isDetached());
+    QCOMPARE(map.size(), 1000);
+    QCOMPARE(copy.size(), 1001);
+    QVERIFY(checkInvariants(copy));
+
+    // reading does not detach
+    QBTreeMap<int, int> reader = map;
+    QCOMPARE(std::as_const(reader).value(5), 5);
+    QVERIFY(std::as_const(reader).constFind(5) != reader.constEnd());
+    QVERIFY(reader.isSharedWith(map));
+    QCOMPARE(reader.remove(5000), 0);
+    QVERIFY(reader.isSharedWith(map));
+
+    // neither does a move
+    QBTreeMap<int, int> moved = std::move(reader);
+    QVERIFY(moved.isSharedWith(map));
+
+    // nor a clear of the copy
+    moved.clear();
+    QVERIFY(moved.isEmpty());
+    QCOMPARE(map.size(), 1000);
+
+    QBTreeMap<int, int> other;
+    other.swap(copy);
+    QCOMPARE(other.size(), 1001);
+    QVERIFY(copy.isEmpty());
+}
+
+void tst_QBTreeMap::equality()
+{
+    QBTreeMap<int, QString> a { { 1, QStringLiteral("one") }, { 2, QStringLiteral("two") } };
+    QBTreeMap<int, QString> b { { 2, QStringLiteral("two") }, { 1, QStringLiteral("one") } };
+    QVERIFY(a == b);
+    QVERIFY(!(a != b));
+    b[2] = QStringLiteral("deux");
+    QVERIFY(a != b);
+    b.remove(2);
+    QVERIFY(a != b);
+    QVERIFY((QBTreeMap<int, QString>() == QBTreeMap<int, QString>()));
+}
+
+void tst_QBTreeMap::nonTrivialTypes()
+{
+    {
+        QBTreeMap<Counted, Counted> map;
+        for (int i = 0; i < 3000; ++i)
+            map.insert(Counted((i * 37) % 3000), Counted(i));
+        QCOMPARE(map.size(), 3000);
+        QVERIFY(checkInvariants(map));
+
+        QBTreeMap<Counted, Counted> copy = map;
+        for (int i = 0; i < 3000; i += 3)
+            QCOMPARE(copy.remove(Counted(i)), 1);
+        QVERIFY(checkInvariants(copy));
+        QCOMPARE(copy.size(), 2000);
+        QCOMPARE(map.size(), 3000);
+        QCOMPARE(map.value(Counted(37)).value, 1);
+    }
+    QCOMPARE(Counted::alive(), 0);
+
+    QBTreeMap<QString, QString> strings;
+    for (int i = 0; i < 2000; ++i)
+        strings.insert(QString::number(i), QString::number(i * 2));
+    for (int i = 0; i < 2000; i += 2)
+        strings.remove(QString::number(i));
+    QVERIFY(checkInvariants(strings));
+    QCOMPARE(strings.size(), 1000);
+    QCOMPARE(strings.value(QStringLiteral("999")), QStringLiteral("1998"));
+    QVERIFY(!strings.contains(QStringLiteral("998")));
+}
+
+void tst_QBTreeMap::largeValues()
+{
+    // few entries fit into a node
+    struct Large
+    {
+        int value = 0;
+        char padding[1020] = {};
+        bool operator==(const Large &other) const { return value == other.value; }
+    };
+    static_assert(QBTreeMapPrivate::Leaf<int, Large>::Capacity == 4);
+
+    QBTreeMap<int, Large> map;
+    std::map<int, int> reference;
+    QRandomGenerator rng(7);
+    for (int i = 0; i < 3000; ++i) {
+        const int key = rng.bounded(1000);
+        if (rng.bounded(3)) {
+            map.insert(key, Large{ i, {} });
+            reference[key] = i;
+        } else {
+            QCOMPARE(map.remove(key), qsizetype(reference.erase(key)));
+        }
+    }
+    QVERIFY(checkInvariants(map));
+    QCOMPARE(size_t(map.size()), reference.size());
+    for (const auto &[key, value] : reference)
+        QCOMPARE(map.value(key).value, value);
+}
+
+void tst_QBTreeMap::keysAndValues()
+{
+    QBTreeMap<int, QString> map;
+    map.insert(3, QStringLiteral("c"));
+    map.insert(1, QStringLiteral("a"));
+    map.insert(2, QStringLiteral("b"));
+    map.insert(4, QStringLiteral("a"));
+
+    QCOMPARE(map.keys(), QList<int>({ 1, 2, 3, 4 }));
+    QCOMPARE(map.values(), QList<QString>({ QStringLiteral("a"), QStringLiteral("b"),
+                                            QStringLiteral("c"), QStringLiteral("a") }));
+    QCOMPARE(map.keys(QStringLiteral("a")), QList<int>({ 1, 4 }));
+    QCOMPARE(map.key(QStringLiteral("b")), 2);
+    QCOMPARE(map.key(QStringLiteral("z"), -1), -1);
+    QCOMPARE(map.count(), 4);
+}
+
+void tst_QBTreeMap::firstAndLast()
+{
+    QBTreeMap<int, int> map;
+    for (int i = 0; i < 1000; ++i)
+        map.insert(1000 - i, i);
+    QCOMPARE(map.firstKey(), 1);
+    QCOMPARE(map.lastKey(), 1000);
+    QCOMPARE(map.first(), 999);
+    QCOMPARE(map.last(), 0);
+    map.first() = -1;
+    QCOMPARE(std::as_const(map).first(), -1);
+    QCOMPARE((--map.end()).key(), 1000);
+}
+
+void tst_QBTreeMap::fromAndToMap()
+{
+    QMap<QString, int> qmap;
+    for (int i = 0; i < 500; ++i)
+        qmap.insert(QString::number(i), i);
+
+    const QBTreeMap<QString, int> map(qmap);
+    QCOMPARE(map.size(), 500);
+    QVERIFY(checkInvariants(map));
+    QCOMPARE(map.keys(), qmap.keys());
+    QCOMPARE(map.toMap(), qmap);
+}
+
+QTEST_APPLESS_MAIN(tst_QBTreeMap)
+#include "tst_qbtreemap.moc"
@@ -0,0 +1,452 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+
+#include <qconcurrenthash.h>
+#include <qlist.h>
+#include <qrandom.h>
+#include <qstring.h>
+#include <qthread.h>
+
+#include <functional>
+
+#include "../../../../shared/containertesthelpers.h"
+
+using QTestContainerHelpers::Counted;
+
+class tst_QConcurrentHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insertAndValue();
+    void tryInsert();
+    void emplace();
+    void remove();
+    void take();
+    void clear();
+    void growth();
+    void reserve();
+    void keysAndValues();
+    void fromAndToHash();
+    void reclamation();
+    void concurrentReadersAndWriters();
+    void concurrentTryInsert();
+    void concurrentReplace();
+    void readersDuringRehashAndClear();
+    void threadExitWithRetiredNodes();
+
+private:
+    template <typename Key, typename T>
+    static size_t bucketCount(const QConcurrentHash<Key, T> &hash)
+    { return hash.d.loadRelaxed()->bucketCount(); }
+
+    static void runThreads(int count, const std::function<void(int)> &f);
+    static bool allReclaimed();
+};
+
+void tst_QConcurrentHash::runThreads(int count, const std::function<void(int)> &f)
+{
+    QList<QThread *> threads;
+    for (int i = 0; i < count; ++i) {
+        threads.append(QThread::create(f, i));
+        threads.last()->start();
+    }
+    for (QThread *thread : std::as_const(threads)) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+bool tst_QConcurrentHash::allReclaimed()
+{
+    // Nothing reads anymore, so all retired nodes can go. But threads hand
+    // theirs over from a thread_local destructor, which may run after
+    // QThread::wait() returned, so use with QTRY_VERIFY.
+    QConcurrentHashPrivate::reclaimRetired();
+    return Counted::alive() == 0;
+}
+
+void tst_QConcurrentHash::insertAndValue()
+{
+    QConcurrentHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.value(1), 0);
+    QCOMPARE(hash.value(1, -1), -1);
+    QVERIFY(!hash.contains(1));
+
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i * 2);
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.value(i), i * 2);
+        QCOMPARE(hash[i], i * 2);
+    }
+    QCOMPARE(hash.count(5), 1);
+    QCOMPARE(hash.count(1000), 0);
+
+    // replacing does not add
+    hash.insert(5, 50);
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(hash.value(5), 50);
+
+    QConcurrentHash<QString, QString> strings;
+    strings.insert(QLatin1String("one"), QLatin1String("1"));
+    QCOMPARE(strings.value(QLatin1String("one")), QLatin1String("1"));
+    QCOMPARE(strings.value(QLatin1String("two")), QString());
+}
+
+void tst_QConcurrentHash::tryInsert()
+{
+    QConcurrentHash<int, QString> hash;
+    QVERIFY(hash.tryInsert(1, QLatin1String("a")));
+    QVERIFY(!hash.tryInsert(1, QLatin1String("b")));
+    QCOMPARE(hash.value(1), QLatin1String("a"));
+    QVERIFY(hash.tryEmplace(2, 3, QLatin1Char('x')));
+    QVERIFY(!hash.tryEmplace(2, 1, QLatin1Char('y')));
+    QCOMPARE(hash.value(2), QLatin1String("xxx"));
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QConcurrentHash::emplace()
+{
+    {
+        QConcurrentHash<Counted, Counted> hash;
+        for (int i = 0; i < 200; ++i)
+            hash.emplace(Counted(i), i + 1);
+        QCOMPARE(hash.size(), 200);
+        hash.emplace(Counted(7), 70);
+        QCOMPARE(hash.size(), 200);
+        QCOMPARE(hash.value(Counted(7)).value, 70);
+        QCOMPARE(hash.value(Counted(8)).value, 9);
+    }
+    QVERIFY(allReclaimed());
+}
+
+void tst_QConcurrentHash::remove()
+{
+    {
+        QConcurrentHash<Counted, Counted> hash;
+        for (int i = 0; i < 3000; ++i)
+            hash.insert(i, i);
+        QVERIFY(!hash.remove(3000));
+        for (int i = 0; i < 3000; i += 2)
+            QVERIFY(hash.remove(i));
+        QCOMPARE(hash.size(), 1500);
+        for (int i = 0; i < 3000; ++i)
+            QCOMPARE(hash.contains(i), i % 2 == 1);
+        QVERIFY(!hash.remove(0));
+    }
+    QVERIFY(allReclaimed());
+}
+
+void tst_QConcurrentHash::take()
+{
+    QConcurrentHash<int, QString> hash;
+    hash.insert(1, QLatin1String("one"));
+    QCOMPARE(hash.take(1), QLatin1String("one"));
+    QCOMPARE(hash.take(1), QString());
+    QVERIFY(hash.isEmpty());
+}
+
+void tst_QConcurrentHash::clear()
+{
+    {
+        QConcurrentHash<Counted, Counted> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(i, i);
+        hash.clear();
+        QVERIFY(hash.isEmpty());
+        QVERIFY(!hash.contains(5));
+        QCOMPARE(bucketCount(hash), size_t(64));
+        hash.insert(5, 5);
+        QCOMPARE(hash.value(5).value, 5);
+    }
+    QVERIFY(allReclaimed());
+}
+
+void tst_QConcurrentHash::growth()
+{
+    QConcurrentHash<int, int> hash;
+    const size_t initial = bucketCount(hash);
+    for (int i = 0; i < 100000; ++i)
+        hash.insert(i, -i);
+    QCOMPARE(hash.size(), 100000);
+    QVERIFY(bucketCount(hash) > initial);
+    for (int i = 0; i < 100000; ++i)
+        QCOMPARE(hash.value(i, 1), -i);
+}
+
+void tst_QConcurrentHash::reserve()
+{
+    QConcurrentHash<int, int> hash;
+    hash.reserve(5000);
+    const size_t buckets = bucketCount(hash);
+    QVERIFY(buckets >= 5000);
+    for (int i = 0; i < 5000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.size(), 5000);
+
+    // reserving less does not shrink
+    hash.reserve(10);
+    QCOMPARE(bucketCount(hash), buckets);
+}
+
+void tst_QConcurrentHash::keysAndValues()
+{
+    QConcurrentHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i + 1000);
+    QList<int> keys = hash.keys();
+    QList<int> values = hash.values();
+    std::sort(keys.begin(), keys.end());
+    std::sort(values.begin(), values.end());
+    QCOMPARE(keys.size(), 100);
+    QCOMPARE(values.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(keys.at(i), i);
+        QCOMPARE(values.at(i), i + 1000);
+    }
+}
+
+void tst_QConcurrentHash::fromAndToHash()
+{
+    QHash<QString, int> source;
+    for (int i = 0; i < 300; ++i)
+        source.insert(QString::number(i), i);
+    const QConcurrentHash<QString, int> hash(source);
+    QCOMPARE(hash.size(), 300);
+    QCOMPARE(hash.toHash(), source);
+
+    const QConcurrentHash<int, int> list = { { 1, 2 }, { 3, 4 } };
+    QCOMPARE(list.value(3), 4);
+}
+
+void tst_QConcurrentHash::reclamation()
+{
+    {
+        QConcurrentHash<Counted, Counted> hash;
+        for (int round = 0; round < 10; ++round) {
+            for (int i = 0; i < 500; ++i)
+                hash.insert(i, round);
+        }
+        for (int i = 0; i < 500; i += 3)
+            hash.remove(i);
+    }
+    // the replaced and removed nodes, and the tables that were grown out
+    // of, are freed once no thread can be reading them
+    QVERIFY(allReclaimed());
+
+    // a reader holds on to what it may still see
+    QConcurrentHash<int, Counted> hash;
+    hash.insert(1, 1);
+    const int destroyedBefore = Counted::destructions.loadRelaxed();
+    {
+        QConcurrentHashPrivate::EpochGuard guard;
+        hash.remove(1);
+        QConcurrentHashPrivate::reclaimRetired();
+        QCOMPARE(Counted::destructions.loadRelaxed(), destroyedBefore);
+    }
+    QConcurrentHashPrivate::reclaimRetired();
+    QCOMPARE(Counted::destructions.loadRelaxed(), destroyedBefore + 1);
+}
+
+void tst_QConcurrentHash::concurrentReadersAndWriters()
+{
+    // Writers own disjoint ranges of keys, and only ever store 2 * key or
+    // remove it; readers check that they never see anything else.
+    QConcurrentHash<int, QString> hash;
+    const int writers = 4;
+    const int keysPerWriter = 2000;
+    QAtomicInt writersDone = 0;
+    QAtomicInt failures = 0;
+
+    runThreads(writers + 4, [&](int id) {
+        if (id < writers) {
+            QRandomGenerator rng(id);
+            for (int round = 0; round < 30000; ++round) {
+                const int key = id * keysPerWriter + int(rng.bounded(keysPerWriter));
+                if (rng.bounded(3))
+                    hash.insert(key, QString::number(2 * key));
+                else
+                    hash.remove(key);
+            }
+            // leave every key of the range in
+            for (int key = id * keysPerWriter; key < (id + 1) * keysPerWriter; ++key)
+                hash.insert(key, QString::number(2 * key));
+            writersDone.ref();
+            return;
+        }
+        QRandomGenerator rng(100 + id);
+        while (writersDone.loadAcquire() < writers) {
+            const int key = int(rng.bounded(writers * keysPerWriter));
+            const QString v = hash.value(key);
+            if (!v.isNull() && v != QString::number(2 * key))
+                failures.ref();
+        }
+    });
+
+    QCOMPARE(failures.loadRelaxed(), 0);
+    QCOMPARE(hash.size(), writers * keysPerWriter);
+    for (int key = 0; key < writers * keysPerWriter; ++key)
+        QCOMPARE(hash.value(key), QString::number(2 * key));
+}
+
+void tst_QConcurrentHash::concurrentTryInsert()
+{
+    // every key is inserted by exactly one of the threads
+    QConcurrentHash<int, int> hash;
+    QAtomicInt inserted = 0;
+    const int keys = 20000;
+    runThreads(8, [&](int id) {
+        for (int key = 0; key < keys; ++key) {
+            if (hash.tryInsert(key, id))
+                inserted.ref();
+        }
+    });
+    QCOMPARE(inserted.loadRelaxed(), keys);
+    QCOMPARE(hash.size(), keys);
+}
+
+void tst_QConcurrentHash::concurrentReplace()
+{
+    // replacing values while the table grows from under the readers
+    {
+        QConcurrentHash<int, Counted> hash;
+        QAtomicInt failures = 0;
+        runThreads(6, [&](int id) {
+            if (id < 2) {
+                for (int i = 0; i < 50000; ++i)
+                    hash.insert(i % 10000 + id * 10000, i % 10000 + id * 10000);
+            } else {
+                for (int i = 0; i < 50000; ++i) {
+                    const int key = i % 20000;
+                    const Counted v = hash.value(key, Counted(key));
+                    if (v.value != key)
+                        failures.ref();
+                }
+            }
+        });
+        QCOMPARE(failures.loadRelaxed(), 0);
+        QCOMPARE(hash.size(), 20000);
+    }
+    QTRY_VERIFY(allReclaimed());
+}
+
+void tst_QConcurrentHash::readersDuringRehashAndClear()
+{
+    // Writers keep growing the table from its minimum size, which another
+    // thread keeps resetting with clear(), while one thread removes keys.
+    // Every value stored is 2 * key; the readers check that they never see
+    // anything else, neither by lookup nor in a snapshot of the whole hash.
+    constexpr int Writers = 2;
+    constexpr int Readers = 4;
+    constexpr int Keys = 4000;
+    constexpr int MinClears = 20;
+    {
+        QConcurrentHash<int, Counted> hash;
+        QAtomicInt writersDone = 0;
+        QAtomicInt failures = 0;
+        QAtomicInt clears = 0;
+
+        runThreads(Writers + 2 + Readers, [&](int id) {
+            if (id < Writers) {
+                // go on until the table was reset enough times, however
+                // the threads get scheduled
+                for (int round = 0; round < 10 || clears.loadAcquire() < MinClears; ++round) {
+                    for (int key = id; key < Keys; key += Writers)
+                        hash.insert(key, Counted(2 * key));
+                }
+                writersDone.ref();
+            } else if (id == Writers) {
+                while (writersDone.loadAcquire() < Writers) {
+                    if (hash.size() > Keys / 4) {
+                        hash.clear();
+                        clears.ref();
+                    }
+                    QThread::yieldCurrentThread();
+                }
+            } else if (id == Writers + 1) {
+                QRandomGenerator rng(id);
+                while (writersDone.loadAcquire() < Writers)
+                    hash.remove(int(rng.bounded(Keys)));
+            } else {
+                QRandomGenerator rng(id);
+                for (int i = 0; writersDone.loadAcquire() < Writers; ++i) {
+                    const int key = int(rng.bounded(Keys));
+                    const int v = hash.value(key, Counted(-1)).value;
+                    if (v != -1 && v != 2 * key)
+                        failures.ref();
+                    if (i % 1000 == 0) {
+                        const QHash<int, Counted> snapshot = hash.toHash();
+                        for (auto it = snapshot.cbegin(); it != snapshot.cend(); ++it) {
+                            if (it.value().value != 2 * it.key())
+                                failures.ref();
+                        }
+                    }
+                }
+            }
+        });
+        QCOMPARE(failures.loadRelaxed(), 0);
+        QVERIFY(clears.loadRelaxed() >= MinClears);
+        QVERIFY(hash.size() <= Keys);
+
+        // the table still works after all that
+        for (int key = 0; key < Keys; ++key)
+            hash.insert(key, Counted(2 * key));
+        QCOMPARE(hash.size(), Keys);
+        for (int key = 0; key < Keys; ++key)
+            QCOMPARE(hash.value(key).value, 2 * key);
+    }
+    QTRY_VERIFY(allReclaimed());
+}
+
+void tst_QConcurrentHash::threadExitWithRetiredNodes()
+{
+    QConcurrentHash<int, Counted> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+
+    // this thread reads while the other one retires nodes and exits, so
+    // they cannot be freed before the thread is gone
+    {
+        QConcurrentHashPrivate::EpochGuard guard;
+        runThreads(1, [&](int) {
+            for (int i = 0; i < 100; ++i)
+                hash.remove(i);
+        });
+    }
+    QVERIFY(hash.isEmpty());
+
+    hash.clear();
+    QTRY_VERIFY(allReclaimed());
+}
+
+QTEST_APPLESS_MAIN(tst_QConcurrentHash)
+#include "tst_qconcurrenthash.moc"
@@ -0,0 +1,542 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+
+#include <qflathash.h>
+#include <qhash.h>
+#include <qrandom.h>
+#include <qstring.h>
+
+#include <unordered_map>
+
+#include "../../../../shared/containertesthelpers.h"
+
+using QTestContainerHelpers::Colliding;
+using QTestContainerHelpers::Counted;
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void insertAndFind();
+    void operatorBracket();
+    void emplace();
+    void growth();
+    void remove();
+    void take();
+    void randomOperations();
+    void collidingHashes();
+    void probingWrapsAround();
+    void tombstones();
+    void maxLoadFactor();
+    void erase();
+    void removeIf();
+    void iterators();
+    void implicitSharing();
+    void reserveAndSqueeze();
+    void equality();
+    void nonTrivialTypes();
+    void keysAndValues();
+    void set();
+};
+
+void tst_QFlatHash::initTestCase()
+{
+    // the expectations don't depend on the seed, but make failures reproducible
+    QHashSeed::setDeterministicGlobalSeed();
+}
+
+void tst_QFlatHash::insertAndFind()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.size(), 0);
+    QVERIFY(!hash.contains(1));
+    QCOMPARE(hash.find(1), hash.end());
+    QCOMPARE(hash.value(1), 0);
+    QCOMPARE(hash.value(1, -1), -1);
+
+    hash.insert(1, 10);
+    hash.insert(2, 20);
+    hash.insert(1, 11);
+    QCOMPARE(hash.size(), 2);
+    QVERIFY(hash.contains(1));
+    QVERIFY(hash.contains(2));
+    QVERIFY(!hash.contains(3));
+    QCOMPARE(hash.value(1), 11);
+    QCOMPARE(hash.value(2), 20);
+    QCOMPARE(hash.count(1), 1);
+    QCOMPARE(hash.count(3), 0);
+
+    auto it = hash.find(2);
+    QVERIFY(it != hash.end());
+    QCOMPARE(it.key(), 2);
+    QCOMPARE(it.value(), 20);
+    *it = 21;
+    QCOMPARE(hash.value(2), 21);
+    QCOMPARE(std::as_const(hash).constFind(2).value(), 21);
+}
+
+void tst_QFlatHash::operatorBracket()
+{
+    QFlatHash<QString, int> hash;
+    hash[QStringLiteral("one")] = 1;
+    ++hash[QStringLiteral("one")];
+    ++hash[QStringLiteral("two")];
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(QStringLiteral("one")), 2);
+    QCOMPARE(hash.value(QStringLiteral("two")), 1);
+
+    const QFlatHash<QString, int> &constHash = hash;
+    QCOMPARE(constHash[QStringLiteral("three")], 0);
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QFlatHash::emplace()
+{
+    QFlatHash<int, QString> hash;
+    auto it = hash.emplace(1, 3, u'x');
+    QCOMPARE(it.value(), QStringLiteral("xxx"));
+    hash.emplace(1, QStringLiteral("y"));
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(hash.value(1), QStringLiteral("y"));
+
+    // emplacing a value that refers to an element must survive the growth
+    for (int i = 2; i < 1000; ++i)
+        hash.emplace(i, hash[i - 1]);
+    QCOMPARE(hash.size(), 999);
+    for (int i = 1; i < 1000; ++i)
+        QCOMPARE(hash.value(i), QStringLiteral("y"));
+}
+
+void tst_QFlatHash::growth()
+{
+    QFlatHash<int, int> hash;
+    QHash<int, int> reference;
+    for (int i = 0; i < 100000; ++i) {
+        hash.insert(i * 7, i);
+        reference.insert(i * 7, i);
+        QVERIFY(hash.capacity() >= hash.size());
+    }
+    QCOMPARE(hash.size(), reference.size());
+    QVERIFY(hash.load_factor() <= hash.max_load_factor());
+    for (auto it = reference.cbegin(); it != reference.cend(); ++it)
+        QCOMPARE(hash.value(it.key(), -1), it.value());
+    for (int i = 0; i < 1000; ++i)
+        QVERIFY(!hash.contains(i * 7 + 1));
+}
+
+void tst_QFlatHash::remove()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QVERIFY(!hash.remove(1000));
+    for (int i = 0; i < 1000; i += 2)
+        QVERIFY(hash.remove(i));
+    QCOMPARE(hash.size(), 500);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(i), i % 2 == 1);
+
+    // removed buckets are reused
+    const size_t buckets = hash.bucket_count();
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 1000; i += 2)
+            hash.insert(i, i);
+        for (int i = 0; i < 1000; i += 2)
+            QVERIFY(hash.remove(i));
+    }
+    QCOMPARE(hash.size(), 500);
+    QCOMPARE(hash.bucket_count(), buckets);
+
+    QFlatHash<int, int> empty;
+    QVERIFY(!empty.remove(1));
+    QVERIFY(!empty.isDetached());
+}
+
+void tst_QFlatHash::take()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, QStringLiteral("one"));
+    hash.insert(2, QStringLiteral("two"));
+    QCOMPARE(hash.take(1), QStringLiteral("one"));
+    QCOMPARE(hash.take(1), QString());
+    QCOMPARE(hash.size(), 1);
+    QVERIFY(!hash.contains(1));
+    QVERIFY(hash.contains(2));
+}
+
+void tst_QFlatHash::randomOperations()
+{
+    QRandomGenerator generator(42);
+    QFlatHash<quint32, quint32> hash;
+    std::unordered_map<quint32, quint32> reference;
+    for (int i = 0; i < 200000; ++i) {
+        const quint32 key = generator.bounded(5000u);
+        switch (generator.bounded(4)) {
+        case 0:
+        case 1:
+            hash.insert(key, quint32(i));
+            reference[key] = quint32(i);
+            break;
+        case 2:
+            QCOMPARE(hash.remove(key), reference.erase(key) == 1);
+            break;
+        case 3: {
+            auto found = reference.find(key);
+            if (found == reference.end())
+                QVERIFY(!hash.contains(key));
+            else
+                QCOMPARE(hash.value(key), found->second);
+            break;
+        }
+        }
+    }
+    QCOMPARE(size_t(hash.size()), reference.size());
+    qsizetype count = 0;
+    for (auto it = hash.cbegin(); it != hash.cend(); ++it, ++count)
+        QCOMPARE(reference.at(it.key()), it.value());
+    QCOMPARE(count, hash.size());
+}
+
+void tst_QFlatHash::collidingHashes()
+{
+    // all keys share the same hash, so every lookup probes the whole run
+    QFlatHash<Colliding, int> hash;
+    for (int i = 0; i < 300; ++i)
+        hash.insert({ i }, i);
+    QCOMPARE(hash.size(), 300);
+    for (int i = 0; i < 300; i += 3)
+        QVERIFY(hash.remove({ i }));
+    for (int i = 0; i < 300; ++i)
+        QCOMPARE(hash.value({ i }, -1), i % 3 ? i : -1);
+    for (int i = 0; i < 300; i += 3)
+        hash.insert({ i }, -i);
+    QCOMPARE(hash.size(), 300);
+    QCOMPARE(hash.value({ 3 }), -3);
+}
+
+void tst_QFlatHash::probingWrapsAround()
+{
+    // every key starts probing at the last bucket, so the groups wrap around
+    // the end of the table, relying on its mirrored control bytes
+    const size_t lastBucket = ~size_t(0);
+    QFlatHash<Colliding, int> hash;
+    hash.reserve(50);
+    const size_t buckets = hash.bucket_count();
+    const int count = int(hash.capacity());
+    for (int i = 0; i < count; ++i)
+        hash.insert({ i, lastBucket }, i);
+    QCOMPARE(hash.bucket_count(), buckets);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(hash.value({ i, lastBucket }, -1), i);
+    QVERIFY(!hash.contains({ count, lastBucket }));
+
+    // erasing on either side of the end must not cut the run short
+    for (int i = 0; i < count; i += 2)
+        QVERIFY(hash.remove({ i, lastBucket }));
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(hash.value({ i, lastBucket }, -1), i % 2 ? i : -1);
+
+    // the mirrored control bytes aren't visited twice
+    int visited = 0;
+    for (auto it = hash.cbegin(); it != hash.cend(); ++it, ++visited)
+        QCOMPARE(it.key().value % 2, 1);
+    QCOMPARE(visited, hash.size());
+}
+
+void tst_QFlatHash::tombstones()
+{
+    // Batches of 32 keys share the bucket their probes start at, so erasing
+    // from a batch leaves tombstones, while new batches use up the empty
+    // buckets further on. With the table less than half full, running out of
+    // empty buckets must drop the tombstones instead of growing the table.
+    const auto key = [](int i) { return Colliding{ i, size_t(i / 32 * 16) << 7 }; };
+    QFlatHash<Colliding, int> hash;
+    hash.reserve(100);
+    const size_t buckets = hash.bucket_count();
+    int next = 0;
+    for (; next < 40; ++next)
+        hash.insert(key(next), next);
+    for (int round = 0; round < 5000; ++round, ++next) {
+        QVERIFY(hash.remove(key(next - 40)));
+        hash.insert(key(next), next);
+    }
+    QCOMPARE(hash.size(), 40);
+    QCOMPARE(hash.bucket_count(), buckets);
+    for (int i = next - 40; i < next; ++i)
+        QCOMPARE(hash.value(key(i), -1), i);
+    QVERIFY(!hash.contains(key(next - 41)));
+    QVERIFY(!hash.contains(key(next)));
+}
+
+void tst_QFlatHash::maxLoadFactor()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const size_t buckets = hash.bucket_count();
+    const int capacity = int(hash.capacity());
+    QCOMPARE(size_t(capacity), buckets - buckets / 8);
+
+    // the table may become exactly 7/8 full, and grows on the next insertion
+    for (int i = 0; i < capacity; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.bucket_count(), buckets);
+    QCOMPARE(hash.load_factor(), hash.max_load_factor());
+    hash.insert(capacity, capacity);
+    QCOMPARE(hash.bucket_count(), 2 * buckets);
+    for (int i = 0; i <= capacity; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+}
+
+void tst_QFlatHash::erase()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+
+    int visited = 0;
+    for (auto it = hash.begin(); it != hash.end(); ++visited) {
+        if (it.key() % 2)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(visited, 100);
+    QCOMPARE(hash.size(), 50);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), i % 2 == 0);
+
+    // erasing through an iterator of a shared copy detaches first
+    QFlatHash<int, int> copy = hash;
+    copy.erase(copy.constFind(0));
+    QVERIFY(!copy.contains(0));
+    QVERIFY(hash.contains(0));
+}
+
+void tst_QFlatHash::removeIf()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i * 10);
+    QCOMPARE(hash.removeIf([](auto it) { return it.value() >= 500; }), 50);
+    QCOMPARE(hash.size(), 50);
+    QCOMPARE(erase_if(hash, [](const std::pair<const int &, int &> &p) { return p.first < 10; }), 10);
+    QCOMPARE(hash.size(), 40);
+    QVERIFY(!hash.contains(5));
+    QVERIFY(hash.contains(10));
+}
+
+void tst_QFlatHash::iterators()
+{
+    QFlatHash<int, int> hash;
+    QCOMPARE(hash.constBegin(), hash.constEnd());
+
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i + 1);
+
+    QList<bool> seen(1000);
+    for (auto it = hash.cbegin(); it != hash.cend(); ++it) {
+        QCOMPARE(it.value(), it.key() + 1);
+        QVERIFY(!seen.at(it.key()));
+        seen[it.key()] = true;
+    }
+    QVERIFY(!seen.contains(false));
+
+    for (auto it = hash.begin(); it != hash.end(); ++it)
+        it.value() = -it.key();
+    int sum = 0;
+    for (auto [key, value] : std::as_const(hash).asKeyValueRange()) {
+        QCOMPARE(value, -key);
+        sum += key;
+    }
+    QCOMPARE(sum, 999 * 1000 / 2);
+
+    QCOMPARE(std::distance(hash.keyBegin(), hash.keyEnd()), hash.size());
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, QStringLiteral("one"));
+
+    QFlatHash<int, QString> copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+    QVERIFY(!hash.isDetached());
+
+    copy.insert(2, QStringLiteral("two"));
+    QVERIFY(!copy.isSharedWith(hash));
+    QVERIFY(hash.isDetached());
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(copy.size(), 2);
+
+    copy = hash;
+    copy[1] = QStringLiteral("uno");
+    QCOMPARE(hash.value(1), QStringLiteral("one"));
+    QCOMPARE(copy.value(1), QStringLiteral("uno"));
+
+    // const access doesn't detach
+    copy = hash;
+    QCOMPARE(std::as_const(copy).find(1).value(), QStringLiteral("one"));
+    QVERIFY(copy.contains(1));
+    QVERIFY(copy.isSharedWith(hash));
+
+    QFlatHash<int, QString> moved = std::move(copy);
+    QVERIFY(moved.isSharedWith(hash));
+    QVERIFY(copy.isEmpty());
+
+    moved.clear();
+    QVERIFY(moved.isEmpty());
+    QCOMPARE(hash.size(), 1);
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    QCOMPARE(hash.capacity(), 0);
+    hash.reserve(1000);
+    QVERIFY(hash.capacity() >= 1000);
+    const size_t buckets = hash.bucket_count();
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.bucket_count(), buckets);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.bucket_count() < buckets);
+    QVERIFY(hash.capacity() >= 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+
+    // reserve on a shared hash detaches
+    QFlatHash<int, int> copy = hash;
+    copy.reserve(5000);
+    QVERIFY(copy.capacity() >= 5000);
+    QVERIFY(!copy.isSharedWith(hash));
+    QCOMPARE(copy, hash);
+}
+
+void tst_QFlatHash::equality()
+{
+    QFlatHash<int, int> a { { 1, 10 }, { 2, 20 }, { 3, 30 } };
+    QFlatHash<int, int> b;
+    b.insert(3, 30);
+    b.insert(2, 20);
+    b.insert(1, 10);
+    QCOMPARE(a, b);
+    b[2] = 21;
+    QVERIFY(a != b);
+    b.remove(2);
+    QVERIFY(a != b);
+    QVERIFY((QFlatHash<int, int>() == QFlatHash<int, int>()));
+}
+
+void tst_QFlatHash::nonTrivialTypes()
+{
+    {
+        QFlatHash<Counted, Counted> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(i, i * 2);
+        for (int i = 0; i < 1000; i += 3)
+            hash.remove(i);
+        QFlatHash<Counted, Counted> copy = hash;
+        copy.insert(5000, 0);
+        QCOMPARE(copy.size(), hash.size() + 1);
+        QCOMPARE(hash.value(4).value, 8);
+        hash.take(4);
+        copy.squeeze();
+    }
+    QCOMPARE(Counted::alive(), 0);
+}
+
+void tst_QFlatHash::keysAndValues()
+{
+    QFlatHash<int, QString> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, QString::number(i));
+
+    QList<int> keys = hash.keys();
+    std::sort(keys.begin(), keys.end());
+    QCOMPARE(keys.size(), 100);
+    QCOMPARE(keys.first(), 0);
+    QCOMPARE(keys.last(), 99);
+
+    QList<QString> values = hash.values();
+    QCOMPARE(values.size(), 100);
+    QVERIFY(values.contains(QStringLiteral("42")));
+
+    QFlatHash<int, QString> fromRange(hash.cbegin(), hash.cend());
+    QCOMPARE(fromRange, hash);
+
+    QFlatHash<int, QString> other { { 1000, QStringLiteral("thousand") } };
+    other.insert(hash);
+    QCOMPARE(other.size(), 101);
+}
+
+void tst_QFlatHash::set()
+{
+    QFlatHashSet<QString> set { QStringLiteral("a"), QStringLiteral("b") };
+    QCOMPARE(set.size(), 2);
+    set.insert(QStringLiteral("a"));
+    set.insert(QStringLiteral("c"));
+    QCOMPARE(set.size(), 3);
+    QVERIFY(set.contains(QStringLiteral("c")));
+    QVERIFY(!set.contains(QStringLiteral("d")));
+    QCOMPARE(*set.find(QStringLiteral("b")), QStringLiteral("b"));
+
+    QFlatHashSet<QString> copy = set;
+    QVERIFY(copy.remove(QStringLiteral("a")));
+    QVERIFY(!copy.remove(QStringLiteral("a")));
+    QVERIFY(set.contains(QStringLiteral("a")));
+    QVERIFY(copy != set);
+
+    QFlatHashSet<int> numbers;
+    for (int i = 0; i < 10000; ++i)
+        numbers.insert(i);
+    QCOMPARE(numbers.removeIf([](int i) { return i % 10; }), 9000);
+    QCOMPARE(numbers.size(), 1000);
+    int count = 0;
+    for (int i : std::as_const(numbers)) {
+        QCOMPARE(i % 10, 0);
+        ++count;
+    }
+    QCOMPARE(count, 1000);
+
+    QList<int> values = numbers.values();
+    std::sort(values.begin(), values.end());
+    QCOMPARE(values.size(), 1000);
+    QCOMPARE(values.last(), 9990);
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+
+#include "tst_qflathash.moc"
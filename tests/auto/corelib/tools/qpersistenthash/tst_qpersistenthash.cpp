@@ -0,0 +1,454 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+
+#include <qhash.h>
+#include <qpersistenthash.h>
+#include <qrandom.h>
+#include <qset.h>
+#include <qstring.h>
+#include <qthread.h>
+
+#include "../../../../shared/containertesthelpers.h"
+
+using QTestContainerHelpers::Colliding;
+using QTestContainerHelpers::Counted;
+
+class tst_QPersistentHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insertAndFind();
+    void emplace();
+    void iterators();
+    void remove();
+    void take();
+    void collisions();
+    void randomOperations();
+    void snapshots();
+    void snapshotsInThreads();
+    void versionHistory();
+    void structuralSharing();
+    void equality();
+    void keysAndValues();
+    void fromAndToHash();
+
+private:
+    template <typename Key, typename T>
+    static bool checkNode(const QPersistentHashPrivate::Node<Key, T> *node, int shift, bool isRoot);
+    template <typename Key, typename T>
+    static bool checkInvariants(const QPersistentHash<Key, T> &hash);
+    template <typename Key, typename T>
+    static bool sameAsHash(const QPersistentHash<Key, T> &hash, const QHash<Key, T> &reference);
+};
+
+// Checks that the maps of the nodes match their contents, and that no
+// node could be replaced by the single entry it holds.
+template <typename Key, typename T>
+bool tst_QPersistentHash::checkNode(const QPersistentHashPrivate::Node<Key, T> *node, int shift, bool isRoot)
+{
+    if (shift < QPersistentHashPrivate::HashBits) {
+        if (int(qPopulationCount(node->dataMap)) != node->entryCount
+            || int(qPopulationCount(node->nodeMap)) != node->childCount
+            || (node->dataMap & node->nodeMap)) {
+            return false;
+        }
+    } else if (node->dataMap || node->nodeMap || node->childCount) {
+        return false;
+    }
+    if (!isRoot && node->childCount == 0 && node->entryCount < 2)
+        return false;
+    for (int i = 0; i < node->childCount; ++i) {
+        if (!checkNode(node->children()[i], shift + QPersistentHashPrivate::Bits, false))
+            return false;
+    }
+    return true;
+}
+
+template <typename Key, typename T>
+bool tst_QPersistentHash::checkInvariants(const QPersistentHash<Key, T> &hash)
+{
+    if (!hash.root)
+        return hash.s == 0;
+    qsizetype count = 0;
+    for (auto it = hash.begin(); it != hash.end(); ++it)
+        ++count;
+    return count == hash.s && checkNode(hash.root, 0, true);
+}
+
+template <typename Key, typename T>
+bool tst_QPersistentHash::sameAsHash(const QPersistentHash<Key, T> &hash, const QHash<Key, T> &reference)
+{
+    if (hash.size() != reference.size())
+        return false;
+    for (auto it = reference.cbegin(); it != reference.cend(); ++it) {
+        auto found = hash.find(it.key());
+        if (found == hash.end() || !(found.key() == it.key()) || !(*found == it.value()))
+            return false;
+    }
+    for (auto it = hash.begin(); it != hash.end(); ++it) {
+        if (!reference.contains(it.key()))
+            return false;
+    }
+    return checkInvariants(hash);
+}
+
+void tst_QPersistentHash::insertAndFind()
+{
+    QPersistentHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QVERIFY(!hash.contains(1));
+    QCOMPARE(hash.find(1), hash.end());
+    QCOMPARE(hash.value(1), 0);
+
+    for (int i = 0; i < 10000; ++i)
+        hash.insert(i, i * 2);
+    QCOMPARE(hash.size(), 10000);
+    for (int i = 0; i < 10000; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.value(i), i * 2);
+        QCOMPARE(hash[i], i * 2);
+        QCOMPARE(hash.find(i).key(), i);
+        QCOMPARE(*hash.constFind(i), i * 2);
+    }
+    QVERIFY(!hash.contains(10000));
+    QCOMPARE(hash.value(10000, -1), -1);
+    QCOMPARE(hash.count(5), 1);
+    QVERIFY(checkInvariants(hash));
+
+    // replacing does not add
+    hash.insert(5, 50);
+    QCOMPARE(hash.size(), 10000);
+    QCOMPARE(hash.value(5), 50);
+
+    QPersistentHash<QString, int> strings;
+    strings.insert(QLatin1String("one"), 1);
+    strings.insert(QLatin1String("two"), 2);
+    QCOMPARE(strings.value(QLatin1String("two")), 2);
+    QVERIFY(!strings.contains(QLatin1String("three")));
+}
+
+void tst_QPersistentHash::emplace()
+{
+    {
+        QPersistentHash<Counted, Counted> hash;
+        for (int i = 0; i < 200; ++i)
+            hash.emplace(Counted(i), i + 1);
+        QCOMPARE(hash.size(), 200);
+        hash.emplace(Counted(7), 70);
+        QCOMPARE(hash.size(), 200);
+        QCOMPARE(hash.value(Counted(7)).value, 70);
+        QCOMPARE(hash.value(Counted(8)).value, 9);
+    }
+    QCOMPARE(Counted::alive(), 0);
+}
+
+void tst_QPersistentHash::iterators()
+{
+    QPersistentHash<int, int> hash;
+    for (int i = 0; i < 5000; ++i)
+        hash.insert(i, -i);
+
+    QSet<int> seen;
+    for (auto it = hash.begin(); it != hash.end(); ++it) {
+        QCOMPARE(it.value(), -it.key());
+        QVERIFY(!seen.contains(it.key()));
+        seen.insert(it.key());
+    }
+    QCOMPARE(seen.size(), 5000);
+
+    // find() gives an iterator that continues the iteration
+    qsizetype after = 0;
+    for (auto it = hash.find(1234); it != hash.end(); ++it)
+        ++after;
+    qsizetype position = 0;
+    for (auto it = hash.begin(); it.key() != 1234; ++it)
+        ++position;
+    QCOMPARE(position + after, hash.size());
+
+    int sum = 0;
+    for (auto [key, value] : hash.asKeyValueRange())
+        sum += key + value;
+    QCOMPARE(sum, 0);
+    QCOMPARE(std::distance(hash.keyBegin(), hash.keyEnd()), 5000);
+    QCOMPARE(std::distance(hash.keyValueBegin(), hash.keyValueEnd()), 5000);
+
+    const QPersistentHash<int, int> empty;
+    QCOMPARE(empty.begin(), empty.end());
+}
+
+void tst_QPersistentHash::remove()
+{
+    {
+        QPersistentHash<Counted, Counted> hash;
+        for (int i = 0; i < 3000; ++i)
+            hash.insert(i, i);
+        QVERIFY(!hash.remove(3000));
+        QCOMPARE(hash.size(), 3000);
+
+        for (int i = 0; i < 3000; i += 2) {
+            QVERIFY(hash.remove(i));
+            QVERIFY(!hash.contains(i));
+        }
+        QCOMPARE(hash.size(), 1500);
+        QVERIFY(checkInvariants(hash));
+        for (int i = 1; i < 3000; i += 2)
+            QCOMPARE(hash.value(i).value, i);
+
+        // removing a key that refers into the hash itself
+        while (!hash.isEmpty())
+            QVERIFY(hash.remove(hash.begin().key()));
+        QVERIFY(checkInvariants(hash));
+        QCOMPARE(hash.begin(), hash.end());
+    }
+    QCOMPARE(Counted::alive(), 0);
+
+    // removing an absent key does not detach
+    QPersistentHash<int, int> hash = { { 1, 1 }, { 2, 2 } };
+    const QPersistentHash<int, int> copy = hash;
+    QVERIFY(!hash.remove(3));
+    QVERIFY(hash.isSharedWith(copy));
+}
+
+void tst_QPersistentHash::take()
+{
+    QPersistentHash<QString, QString> hash;
+    hash.insert(QLatin1String("a"), QLatin1String("A"));
+    hash.insert(QLatin1String("b"), QLatin1String("B"));
+    QCOMPARE(hash.take(QLatin1String("a")), QLatin1String("A"));
+    QCOMPARE(hash.take(QLatin1String("a")), QString());
+    QCOMPARE(hash.size(), 1);
+}
+
+void tst_QPersistentHash::collisions()
+{
+    // full collisions end up in nodes below the last bits of the hash,
+    // partial ones in chains of nodes
+    const auto key = [](int i) { return Colliding{ i, size_t(i % 4) * 32 * 32 }; };
+    QPersistentHash<Colliding, int> hash;
+    for (int i = 0; i < 200; ++i)
+        hash.insert(key(i), i);
+    QCOMPARE(hash.size(), 200);
+    QVERIFY(checkInvariants(hash));
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(key(i)), i);
+    QCOMPARE(std::distance(hash.begin(), hash.end()), 200);
+    QCOMPARE(hash.find(key(150)).value(), 150);
+
+    const QPersistentHash<Colliding, int> snapshot = hash;
+    hash.insert(key(5), -5);
+    QCOMPARE(hash.value(key(5)), -5);
+    QCOMPARE(snapshot.value(key(5)), 5);
+
+    for (int i = 0; i < 200; ++i) {
+        QVERIFY(hash.remove(key(i)));
+        QVERIFY(checkInvariants(hash));
+    }
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(snapshot.size(), 200);
+    QVERIFY(checkInvariants(snapshot));
+}
+
+void tst_QPersistentHash::randomOperations()
+{
+    QRandomGenerator rng(4321);
+    QPersistentHash<int, int> hash;
+    QHash<int, int> reference;
+    QList<QPair<QPersistentHash<int, int>, QHash<int, int>>> snapshots;
+
+    for (int round = 0; round < 50000; ++round) {
+        const int key = rng.bounded(5000);
+        const int op = rng.bounded(100);
+        if (op < 55) {
+            const int v = int(rng.generate());
+            hash.insert(key, v);
+            reference.insert(key, v);
+        } else if (op < 99) {
+            QCOMPARE(hash.remove(key), reference.remove(key));
+        } else if (snapshots.size() < 20) {
+            snapshots.append({ hash, reference });
+        }
+        QCOMPARE(hash.size(), reference.size());
+    }
+    QVERIFY(sameAsHash(hash, reference));
+    for (const auto &snapshot : std::as_const(snapshots))
+        QVERIFY(sameAsHash(snapshot.first, snapshot.second));
+}
+
+void tst_QPersistentHash::snapshots()
+{
+    QPersistentHash<int, QString> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, QString::number(i));
+
+    const QPersistentHash<int, QString> snapshot = hash;
+    QVERIFY(snapshot.isSharedWith(hash));
+    hash.insert(500, QLatin1String("changed"));
+    hash.insert(1000, QLatin1String("added"));
+    hash.remove(0);
+    QVERIFY(!snapshot.isSharedWith(hash));
+
+    QCOMPARE(snapshot.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(snapshot.value(i), QString::number(i));
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(hash.value(500), QLatin1String("changed"));
+    QVERIFY(!hash.contains(0));
+}
+
+void tst_QPersistentHash::snapshotsInThreads()
+{
+    QPersistentHash<int, QString> hash;
+    for (int i = 0; i < 2000; ++i)
+        hash.insert(i, QString::number(i));
+
+    // each thread modifies its own copy, while the others read theirs
+    QList<QThread *> threads;
+    QAtomicInt failures = 0;
+    for (int t = 0; t < 4; ++t) {
+        threads.append(QThread::create([hash, t, &failures]() mutable {
+            const QPersistentHash<int, QString> original = hash;
+            for (int round = 0; round < 500; ++round) {
+                const int key = (round * 37 + t) % 2000;
+                hash.insert(key, QString::number(-t));
+                hash.insert(2000 + round, QString());
+                hash.remove(2000 + round);
+            }
+            for (int i = 0; i < 2000; ++i) {
+                if (original.value(i) != QString::number(i))
+                    failures.ref();
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread *thread : std::as_const(threads)) {
+        QVERIFY(thread->wait());
+        delete thread;
+    }
+    QCOMPARE(failures.loadRelaxed(), 0);
+    for (int i = 0; i < 2000; ++i)
+        QCOMPARE(hash.value(i), QString::number(i));
+}
+
+void tst_QPersistentHash::versionHistory()
+{
+    // each version is derived from the previous one by a few edits; making
+    // the later ones must not have changed any of the earlier ones
+    QRandomGenerator rng(99);
+    QList<QPersistentHash<int, int>> versions = { {} };
+    QList<QHash<int, int>> references = { {} };
+    for (int version = 1; version < 300; ++version) {
+        QPersistentHash<int, int> hash = versions.constLast();
+        QHash<int, int> reference = references.constLast();
+        for (int edit = 0; edit < 20; ++edit) {
+            const int key = rng.bounded(2000);
+            if (rng.bounded(3)) {
+                hash.insert(key, version);
+                reference.insert(key, version);
+            } else {
+                QCOMPARE(hash.remove(key), reference.remove(key));
+            }
+        }
+        versions.append(hash);
+        references.append(reference);
+    }
+    for (qsizetype i = 0; i < versions.size(); ++i)
+        QVERIFY2(sameAsHash(versions.at(i), references.at(i)), QByteArray::number(i));
+}
+
+void tst_QPersistentHash::structuralSharing()
+{
+    {
+        QPersistentHash<int, Counted> hash;
+        for (int i = 0; i < 10000; ++i)
+            hash.insert(i, i);
+
+        // An edit of a copy only copies the nodes on the path to the entry,
+        // each holding at most 32 entries; 10000 keys don't need more than
+        // four levels.
+        const int before = Counted::constructions.loadRelaxed();
+        QPersistentHash<int, Counted> copy = hash;
+        copy.insert(5000, -1);
+        copy.insert(10000, 10000);
+        copy.remove(1);
+        const int copies = Counted::constructions.loadRelaxed() - before;
+        QVERIFY2(copies <= 3 * (4 * 32 + 2), QByteArray::number(copies));
+
+        QCOMPARE(copy.size(), 10000);
+        QCOMPARE(copy.value(5000).value, -1);
+        QCOMPARE(hash.value(5000).value, 5000);
+        QVERIFY(hash.contains(1));
+        QVERIFY(!hash.contains(10000));
+    }
+    QCOMPARE(Counted::alive(), 0);
+}
+
+void tst_QPersistentHash::equality()
+{
+    QPersistentHash<int, int> a = { { 1, 1 }, { 2, 2 }, { 3, 3 } };
+    QPersistentHash<int, int> b;
+    b.insert(3, 3);
+    b.insert(2, 2);
+    b.insert(1, 1);
+    QVERIFY(a == b);
+    b.insert(1, 0);
+    QVERIFY(a != b);
+    b.remove(1);
+    QVERIFY(a != b);
+    QVERIFY((QPersistentHash<int, int>() == QPersistentHash<int, int>()));
+}
+
+void tst_QPersistentHash::keysAndValues()
+{
+    QPersistentHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i + 1000);
+    QList<int> keys = hash.keys();
+    QList<int> values = hash.values();
+    std::sort(keys.begin(), keys.end());
+    std::sort(values.begin(), values.end());
+    QCOMPARE(keys.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(keys.at(i), i);
+        QCOMPARE(values.at(i), i + 1000);
+    }
+}
+
+void tst_QPersistentHash::fromAndToHash()
+{
+    QHash<QString, int> hash;
+    for (int i = 0; i < 300; ++i)
+        hash.insert(QString::number(i), i);
+    const QPersistentHash<QString, int> persistent(hash);
+    QVERIFY(sameAsHash(persistent, hash));
+    QCOMPARE(persistent.toHash(), hash);
+}
+
+QTEST_APPLESS_MAIN(tst_QPersistentHash)
+#include "tst_qpersistenthash.moc"
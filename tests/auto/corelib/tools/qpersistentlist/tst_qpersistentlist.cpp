@@ -0,0 +1,444 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+
+#include <qlist.h>
+#include <qpersistentlist.h>
+#include <qrandom.h>
+#include <qstring.h>
+#include <qthread.h>
+
+#include "../../../../shared/containertesthelpers.h"
+
+using QTestContainerHelpers::Counted;
+
+class tst_QPersistentList : public QObject
+{
+    Q_OBJECT
+private slots:
+    void append();
+    void emplaceBack();
+    void iterators();
+    void replace();
+    void operatorBracket();
+    void removeLast_data();
+    void removeLast();
+    void randomOperations();
+    void snapshots();
+    void snapshotsInThreads();
+    void versionHistory();
+    void structuralSharing();
+    void indexOfAndContains();
+    void equality();
+    void fromAndToList();
+
+private:
+    template <typename T>
+    static bool sameAsList(const QPersistentList<T> &list, const QList<T> &reference);
+    template <typename T>
+    static int depth(const QPersistentList<T> &list) { return list.root ? list.shift / QPersistentListPrivate::Bits : 0; }
+};
+
+template <typename T>
+bool tst_QPersistentList::sameAsList(const QPersistentList<T> &list, const QList<T> &reference)
+{
+    if (list.size() != reference.size())
+        return false;
+    for (qsizetype i = 0; i < list.size(); ++i) {
+        if (!(list.at(i) == reference.at(i)))
+            return false;
+    }
+    return std::equal(list.begin(), list.end(), reference.begin(), reference.end())
+        && std::equal(list.rbegin(), list.rend(), reference.rbegin(), reference.rend());
+}
+
+void tst_QPersistentList::append()
+{
+    QPersistentList<int> list;
+    QVERIFY(list.isEmpty());
+    QCOMPARE(list.begin(), list.end());
+
+    // enough for three levels of branches
+    const int count = 32 * 32 * 32 + 100;
+    for (int i = 0; i < count; ++i) {
+        list.append(i);
+        QCOMPARE(list.size(), i + 1);
+        QCOMPARE(list.last(), i);
+    }
+    QCOMPARE(depth(list), 3);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(list.at(i), i);
+    QCOMPARE(list.first(), 0);
+    QCOMPARE(list.value(count), 0);
+    QCOMPARE(list.value(-1, 42), 42);
+
+    QPersistentList<QString> strings;
+    for (int i = 0; i < 100; ++i)
+        strings.push_back(QString::number(i));
+    QCOMPARE(strings.at(33), QLatin1String("33"));
+    QCOMPARE(strings.back(), QLatin1String("99"));
+}
+
+void tst_QPersistentList::emplaceBack()
+{
+    {
+        QPersistentList<Counted> list;
+        for (int i = 0; i < 100; ++i)
+            QCOMPARE(list.emplaceBack(i).value, i);
+        QCOMPARE(list.size(), 100);
+
+        // the argument refers to the shared tail
+        QPersistentList<Counted> copy = list;
+        list.emplaceBack(list.last());
+        QCOMPARE(list.last().value, 99);
+        QCOMPARE(list.size(), 101);
+        QCOMPARE(copy.size(), 100);
+    }
+    QCOMPARE(Counted::alive(), 0);
+}
+
+void tst_QPersistentList::iterators()
+{
+    QPersistentList<int> list;
+    for (int i = 0; i < 1000; ++i)
+        list.append(i);
+
+    int expected = 0;
+    for (int i : list)
+        QCOMPARE(i, expected++);
+    QCOMPARE(expected, 1000);
+
+    auto it = list.end();
+    while (it != list.begin())
+        QCOMPARE(*--it, --expected);
+    QCOMPARE(expected, 0);
+
+    QCOMPARE(list.end() - list.begin(), 1000);
+    QCOMPARE(*(list.begin() + 500), 500);
+    QCOMPARE(*(list.end() - 1), 999);
+    QCOMPARE(list.begin()[64], 64);
+    QVERIFY(list.begin() < list.end());
+    QCOMPARE(*std::lower_bound(list.begin(), list.end(), 777), 777);
+    QCOMPARE(*list.rbegin(), 999);
+}
+
+void tst_QPersistentList::replace()
+{
+    QPersistentList<QString> list;
+    for (int i = 0; i < 100; ++i)
+        list.append(QString::number(i));
+
+    list.replace(3, QLatin1String("three"));
+    list.replace(99, QLatin1String("last"));
+    QCOMPARE(list.at(3), QLatin1String("three"));
+    QCOMPARE(list.last(), QLatin1String("last"));
+
+    // the value refers to an element of a shared node
+    QPersistentList<QString> copy = list;
+    list.replace(5, list.at(3));
+    QCOMPARE(list.at(5), QLatin1String("three"));
+    QCOMPARE(copy.at(5), QLatin1String("5"));
+}
+
+void tst_QPersistentList::operatorBracket()
+{
+    QPersistentList<int> list;
+    for (int i = 0; i < 2000; ++i)
+        list.append(i);
+    const QPersistentList<int> copy = list;
+
+    list[1000] = -1;
+    list[1999] = -2;
+    QCOMPARE(list.at(1000), -1);
+    QCOMPARE(list.at(1999), -2);
+    QCOMPARE(copy.at(1000), 1000);
+    QCOMPARE(copy.at(1999), 1999);
+    QCOMPARE(copy[1000], 1000);
+}
+
+void tst_QPersistentList::removeLast_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("tail only") << 20;
+    QTest::newRow("one leaf") << 64;
+    QTest::newRow("one level") << 1000;
+    QTest::newRow("two levels") << 32 * 32 * 2 + 5;
+    QTest::newRow("three levels") << 32 * 32 * 32 + 33;
+}
+
+void tst_QPersistentList::removeLast()
+{
+    QFETCH(int, count);
+    {
+        QPersistentList<Counted> list;
+        for (int i = 0; i < count; ++i)
+            list.append(i);
+        QList<QPersistentList<Counted>> snapshots;
+        for (int i = count; i > 0; --i) {
+            if (i % 97 == 0)
+                snapshots.append(list);
+            QCOMPARE(list.last().value, i - 1);
+            QCOMPARE(list.takeLast().value, i - 1);
+            QCOMPARE(list.size(), i - 1);
+            if (i % 31 == 0) {
+                for (int j = 0; j < i - 1; j += 7)
+                    QCOMPARE(list.at(j).value, j);
+            }
+        }
+        QVERIFY(list.isEmpty());
+        QCOMPARE(depth(list), 0);
+
+        // the trie shrinks as it empties
+        for (int i = 0; i < count; ++i)
+            list.append(i);
+        const int fullDepth = depth(list);
+        while (list.size() > 32 * 2)
+            list.removeLast();
+        QVERIFY(depth(list) <= 1);
+        QVERIFY(depth(list) <= fullDepth);
+
+        for (const QPersistentList<Counted> &snapshot : std::as_const(snapshots)) {
+            for (int j = 0; j < snapshot.size(); ++j)
+                QCOMPARE(snapshot.at(j).value, j);
+        }
+    }
+    QCOMPARE(Counted::alive(), 0);
+}
+
+void tst_QPersistentList::randomOperations()
+{
+    QRandomGenerator rng(1234);
+    QPersistentList<int> list;
+    QList<int> reference;
+    QList<QPair<QPersistentList<int>, QList<int>>> snapshots;
+
+    for (int round = 0; round < 20000; ++round) {
+        const int op = rng.bounded(10);
+        if (op < 5 || reference.isEmpty()) {
+            const int n = rng.bounded(100);
+            for (int i = 0; i < n; ++i) {
+                const int v = int(rng.generate());
+                list.append(v);
+                reference.append(v);
+            }
+        } else if (op < 7) {
+            const int n = rng.bounded(int(qMin(reference.size(), qsizetype(80)))) + 1;
+            for (int i = 0; i < n; ++i) {
+                list.removeLast();
+                reference.removeLast();
+            }
+        } else if (op < 9) {
+            const qsizetype i = rng.bounded(int(reference.size()));
+            const int v = int(rng.generate());
+            list[i] = v;
+            reference[i] = v;
+        } else if (snapshots.size() < 20) {
+            snapshots.append({ list, reference });
+        }
+    }
+    QVERIFY(sameAsList(list, reference));
+    for (const auto &snapshot : std::as_const(snapshots))
+        QVERIFY(sameAsList(snapshot.first, snapshot.second));
+}
+
+void tst_QPersistentList::snapshots()
+{
+    QPersistentList<int> list;
+    for (int i = 0; i < 5000; ++i)
+        list.append(i);
+
+    const QPersistentList<int> snapshot = list;
+    QVERIFY(snapshot.isSharedWith(list));
+    list.replace(2500, -1);
+    QVERIFY(!snapshot.isSharedWith(list));
+    list.append(5000);
+    list.removeLast();
+    list.removeLast();
+
+    QCOMPARE(snapshot.size(), 5000);
+    for (int i = 0; i < 5000; ++i)
+        QCOMPARE(snapshot.at(i), i);
+    QCOMPARE(list.size(), 4999);
+    QCOMPARE(list.at(2500), -1);
+
+    // a copy shares everything but the modified path
+    QPersistentList<int> other = snapshot;
+    other.clear();
+    QVERIFY(other.isEmpty());
+    QCOMPARE(snapshot.size(), 5000);
+}
+
+void tst_QPersistentList::snapshotsInThreads()
+{
+    QPersistentList<QString> list;
+    for (int i = 0; i < 2000; ++i)
+        list.append(QString::number(i));
+
+    // each thread modifies its own copy, while the others read theirs
+    QList<QThread *> threads;
+    QAtomicInt failures = 0;
+    for (int t = 0; t < 4; ++t) {
+        threads.append(QThread::create([list, t, &failures]() mutable {
+            const QPersistentList<QString> original = list;
+            for (int round = 0; round < 200; ++round) {
+                const qsizetype i = (round * 37 + t) % list.size();
+                list[i] = QString::number(-t);
+                list.append(QString::number(round));
+                list.removeLast();
+            }
+            for (int i = 0; i < original.size(); ++i) {
+                if (original.at(i) != QString::number(i))
+                    failures.ref();
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread *thread : std::as_const(threads)) {
+        QVERIFY(thread->wait());
+        delete thread;
+    }
+    QCOMPARE(failures.loadRelaxed(), 0);
+    for (int i = 0; i < list.size(); ++i)
+        QCOMPARE(list.at(i), QString::number(i));
+}
+
+void tst_QPersistentList::versionHistory()
+{
+    // Each version is derived from the previous one by a few edits, around
+    // the size where the trie gains and loses its second level of branches.
+    // Making the later ones must not have changed any of the earlier ones.
+    constexpr int Width = QPersistentListPrivate::Width;
+    QRandomGenerator rng(17);
+    QPersistentList<int> first;
+    for (int i = 0; i < Width * Width; ++i)
+        first.append(i);
+    QList<QPersistentList<int>> versions = { first };
+    QList<QList<int>> references = { first.toList() };
+    for (int version = 1; version < 300; ++version) {
+        QPersistentList<int> list = versions.constLast();
+        QList<int> reference = references.constLast();
+        const int count = rng.bounded(2 * Width);
+        if (rng.bounded(2)) {
+            for (int i = 0; i < count; ++i) {
+                list.append(version);
+                reference.append(version);
+            }
+        } else {
+            for (int i = 0; i < count && !list.isEmpty(); ++i) {
+                list.removeLast();
+                reference.removeLast();
+            }
+        }
+        for (int i = 0; i < 3 && !list.isEmpty(); ++i) {
+            const qsizetype index = rng.bounded(int(list.size()));
+            list.replace(index, -version);
+            reference.replace(index, -version);
+        }
+        versions.append(list);
+        references.append(reference);
+    }
+    for (qsizetype i = 0; i < versions.size(); ++i)
+        QVERIFY2(sameAsList(versions.at(i), references.at(i)), QByteArray::number(i));
+}
+
+void tst_QPersistentList::structuralSharing()
+{
+    constexpr int Width = QPersistentListPrivate::Width;
+    {
+        QPersistentList<Counted> list;
+        for (int i = 0; i < 5000; ++i)
+            list.append(i);
+
+        // an edit of a copy only copies the leaf it touches, never all
+        // the elements
+        int before = Counted::constructions.loadRelaxed();
+        QPersistentList<Counted> copy = list;
+        copy.replace(2500, -1);
+        QVERIFY2(Counted::constructions.loadRelaxed() - before <= Width + 1,
+                 QByteArray::number(Counted::constructions.loadRelaxed() - before));
+
+        // and so do appending to and removing from the shared tail
+        before = Counted::constructions.loadRelaxed();
+        QPersistentList<Counted> longer = list;
+        longer.append(5000);
+        QPersistentList<Counted> shorter = list;
+        shorter.removeLast();
+        QVERIFY2(Counted::constructions.loadRelaxed() - before <= 2 * (Width + 1),
+                 QByteArray::number(Counted::constructions.loadRelaxed() - before));
+
+        QCOMPARE(list.size(), 5000);
+        QCOMPARE(list.at(2500).value, 2500);
+        QCOMPARE(copy.at(2500).value, -1);
+        QCOMPARE(longer.size(), 5001);
+        QCOMPARE(shorter.size(), 4999);
+        QCOMPARE(shorter.last().value, 4998);
+    }
+    QCOMPARE(Counted::alive(), 0);
+}
+
+void tst_QPersistentList::indexOfAndContains()
+{
+    QPersistentList<int> list;
+    for (int i = 0; i < 100; ++i)
+        list.append(i % 50);
+    QCOMPARE(list.indexOf(7), 7);
+    QCOMPARE(list.indexOf(7, 8), 57);
+    QCOMPARE(list.indexOf(7, -10), -1);
+    QCOMPARE(list.indexOf(42, -60), 42);
+    QVERIFY(list.contains(49));
+    QVERIFY(!list.contains(50));
+}
+
+void tst_QPersistentList::equality()
+{
+    QPersistentList<int> a = { 1, 2, 3 };
+    QPersistentList<int> b = a;
+    QVERIFY(a == b);
+    b.append(4);
+    QVERIFY(a != b);
+    b.removeLast();
+    QVERIFY(a == b);
+    QVERIFY(!a.isSharedWith(b));
+    b.replace(0, 0);
+    QVERIFY(a != b);
+}
+
+void tst_QPersistentList::fromAndToList()
+{
+    QList<int> list;
+    for (int i = 0; i < 300; ++i)
+        list.append(i * 3);
+    const QPersistentList<int> persistent(list);
+    QVERIFY(sameAsList(persistent, list));
+    QCOMPARE(persistent.toList(), list);
+    QCOMPARE(QPersistentList<int>(list.begin() + 10, list.end()).first(), 30);
+}
+
+QTEST_APPLESS_MAIN(tst_QPersistentList)
+#include "tst_qpersistentlist.moc"
@@ -56,6 +56,8 @@ class tst_QSortFilterProxyModel : public QObject
 private slots:
     void clearFilter_data();
     void clearFilter();
+    void sortLocaleAware_data();
+    void sortLocaleAware();
 
 private:
     QStringList m_numberList; ///< Cache the strings for efficiency.
@@ -118,6 +120,48 @@ void tst_QSortFilterProxyModel::clearFilter()
     QCOMPARE(proxy.rowCount(), itemCount);
 }
 
+void tst_QSortFilterProxyModel::sortLocaleAware_data()
+{
+    QTest::addColumn<int>("itemCount");
+    QTest::addColumn<bool>("collationKeys");
+
+    for (int thousandItemCount : { 10, 100, 500 }) {
+        const auto itemCount = thousandItemCount * 1000;
+        QTest::addRow("compare %dK", thousandItemCount) << itemCount << false;
+        QTest::addRow("collation keys %dK", thousandItemCount) << itemCount << true;
+    }
+}
+
+void tst_QSortFilterProxyModel::sortLocaleAware()
+{
+    QFETCH(const int, itemCount);
+    QFETCH(const bool, collationKeys);
+
+    const QStringView letters = u"abcdefghijklmnopqrstuvwxyzABCDE\u00e9\u00e8\u00f6\u00e5";
+    QStringList words;
+    words.reserve(itemCount);
+    quint32 seed = 1;
+    for (int i = 0; i < itemCount; ++i) {
+        QString word;
+        for (int length = 4 + i % 8; length > 0; --length) {
+            seed = seed * 1103515245 + 12345;
+            word.append(letters.at((seed >> 16) % letters.size()));
+        }
+        words.append(word);
+    }
+    QStringListModel model(words);
+
+    QSortFilterProxyModel proxy;
+    proxy.setSortLocaleAware(true);
+    proxy.setSortUsingCollationKeys(collationKeys);
+    proxy.setSourceModel(&model);
+
+    QBENCHMARK_ONCE {
+        proxy.sort(0);
+    }
+    QCOMPARE(proxy.rowCount(), itemCount);
+}
+
 QTEST_MAIN(tst_QSortFilterProxyModel)
 
 #include "tst_bench_qsortfilterproxymodel.moc"
@@ -30,6 +30,34 @@
 #include <qtest.h>
 #include <qtesteventloop.h>
 
+#include <private/qeventpool_p.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Count every allocation in the process, including those made inside Qt.
+static std::atomic<qint64> allocationCount = 0;
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+        qBadAlloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
 class PingPong : public QObject
 {
 public:
@@ -83,6 +111,22 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+class QueuedEmitter : public QObject
+{
+    Q_OBJECT
+signals:
+    void triggered();
+};
+
+class QueuedCounter : public QObject
+{
+    Q_OBJECT
+public:
+    int count = 0;
+public slots:
+    void increment() { ++count; }
+};
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -96,6 +140,8 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void postedEventAllocations_data();
+    void postedEventAllocations();
 };
 
 void EventsBench::initTestCase()
@@ -169,6 +215,62 @@ void EventsBench::postEvent()
     }
 }
 
+void EventsBench::postedEventAllocations_data()
+{
+    QTest::addColumn<bool>("pooled");
+    QTest::addColumn<bool>("metaCall");
+    QTest::newRow("queued signal, malloc") << false << true;
+    QTest::newRow("queued signal, pooled") << true << true;
+    QTest::newRow("deleteLater, malloc") << false << false;
+    QTest::newRow("deleteLater, pooled") << true << false;
+}
+
+void EventsBench::postedEventAllocations()
+{
+    QFETCH(bool, pooled);
+    QFETCH(bool, metaCall);
+    const bool wasEnabled = QEventPool::isEnabled();
+    QEventPool::setEnabled(pooled);
+    auto restore = qScopeGuard([wasEnabled] { QEventPool::setEnabled(wasEnabled); });
+
+    const int eventCount = 1000;
+    QueuedEmitter emitter;
+    QueuedCounter counter;
+    QObject::connect(&emitter, &QueuedEmitter::triggered, &counter, &QueuedCounter::increment,
+                     Qt::QueuedConnection);
+    QList<QObject *> objects(eventCount);
+
+    // Posts eventCount events and delivers them; returns the number of
+    // allocations made for that, excluding the objects to be deleted.
+    auto postAndSend = [&]() {
+        if (!metaCall) {
+            for (QObject *&object : objects)
+                object = new QObject;
+        }
+        const qint64 before = allocationCount.load(std::memory_order_relaxed);
+        for (int i = 0; i < eventCount; ++i) {
+            if (metaCall)
+                emit emitter.triggered();
+            else
+                objects.at(i)->deleteLater();
+        }
+        QCoreApplication::sendPostedEvents(nullptr, metaCall ? 0 : int(QEvent::DeferredDelete));
+        return allocationCount.load(std::memory_order_relaxed) - before;
+    };
+
+    // warm up the pools
+    postAndSend();
+
+    qint64 allocations = 0;
+    int rounds = 0;
+    QBENCHMARK {
+        allocations += postAndSend();
+        ++rounds;
+    }
+    qDebug("%.2f allocations per posted event",
+           double(allocations) / (double(rounds) * eventCount));
+}
+
 QTEST_MAIN(EventsBench)
 
 #include "tst_bench_events.moc"
@@ -0,0 +1,191 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QtCore/qeventloop.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qthread.h>
+
+#include <QtCore/private/qeventdispatcher_unix_p.h>
+#include <QtCore/private/qeventdispatcher_epoll_p.h>
+
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+enum DispatcherType {
+    PollDispatcher,
+    EpollDispatcher,
+    EpollTimerFdDispatcher
+};
+
+// Passes a token around a ring of eventfd-backed socket notifiers. Only one
+// notifier is ready at any time, so this measures the per-iteration overhead
+// of the idle notifiers the dispatcher has to carry around.
+class NotifierRing : public QThread
+{
+public:
+    explicit NotifierRing(int iterations)
+        : numberOfIterations(iterations)
+    { }
+
+    ~NotifierRing()
+    {
+        for (int fd : qAsConst(fds))
+            ::close(fd);
+    }
+
+    // Must be called before start(), from the thread running the test.
+    bool createEventFds(int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            const int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (fd == -1)
+                return false;
+            fds.append(fd);
+        }
+        return true;
+    }
+
+    qint64 elapsed = 0;
+
+protected:
+    void run() override
+    {
+        QEventLoop eventLoop;
+        QList<QSocketNotifier *> notifiers;
+        const qsizetype numberOfNotifiers = fds.size();
+        int remaining = numberOfIterations;
+
+        for (int i = 0; i < numberOfNotifiers; ++i) {
+            QSocketNotifier *notifier = new QSocketNotifier(fds[i], QSocketNotifier::Read);
+            QObject::connect(notifier, &QSocketNotifier::activated, notifier, [&, i]() {
+                eventfd_t value;
+                eventfd_read(fds[i], &value);
+                if (--remaining == 0)
+                    eventLoop.quit();
+                else
+                    eventfd_write(fds[(i + 1) % numberOfNotifiers], 1);
+            });
+            notifiers.append(notifier);
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        eventfd_write(fds[0], 1);
+        eventLoop.exec();
+        elapsed = timer.elapsed();
+
+        qDeleteAll(notifiers);
+    }
+
+private:
+    QList<int> fds;
+    int numberOfIterations;
+};
+
+class tst_QEventDispatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void socketNotifierRing_data();
+    void socketNotifierRing();
+
+private:
+    rlim_t maxFileDescriptors = 0;
+};
+
+void tst_QEventDispatcher::initTestCase()
+{
+    // 10k notifiers need more file descriptors than the usual soft limit
+    rlimit limit;
+    QCOMPARE(getrlimit(RLIMIT_NOFILE, &limit), 0);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    QCOMPARE(getrlimit(RLIMIT_NOFILE, &limit), 0);
+    maxFileDescriptors = limit.rlim_cur;
+}
+
+void tst_QEventDispatcher::socketNotifierRing_data()
+{
+    QTest::addColumn<DispatcherType>("dispatcher");
+    QTest::addColumn<int>("notifiers");
+
+    const struct {
+        DispatcherType type;
+        const char *name;
+    } dispatchers[] = {
+        { PollDispatcher, "poll" },
+        { EpollDispatcher, "epoll" },
+        { EpollTimerFdDispatcher, "epoll-timerfd" }
+    };
+
+    for (int notifiers : {10, 1000, 10000}) {
+        for (const auto &d : dispatchers)
+            QTest::addRow("%s, notifiers: %d", d.name, notifiers) << d.type << notifiers;
+    }
+}
+
+void tst_QEventDispatcher::socketNotifierRing()
+{
+    QFETCH(DispatcherType, dispatcher);
+    QFETCH(int, notifiers);
+
+    if (rlim_t(notifiers) + 64 > maxFileDescriptors)
+        QSKIP("Not enough file descriptors available");
+
+    const int iterations = 100000;
+
+    NotifierRing ring(iterations);
+    if (!ring.createEventFds(notifiers))
+        QSKIP(qPrintable(QLatin1String("Cannot create the eventfds: ") + qt_error_string(errno)));
+    switch (dispatcher) {
+    case PollDispatcher:
+        ring.setEventDispatcher(new QEventDispatcherUNIX);
+        break;
+    case EpollDispatcher:
+        ring.setEventDispatcher(new QEventDispatcherEpoll(QEventDispatcherEpoll::PollTimeout));
+        break;
+    case EpollTimerFdDispatcher:
+        ring.setEventDispatcher(new QEventDispatcherEpoll(QEventDispatcherEpoll::TimerFd));
+        break;
+    }
+
+    ring.start();
+    QVERIFY(ring.wait());
+
+    QTest::setBenchmarkResult(ring.elapsed, QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(tst_QEventDispatcher)
+
+#include "tst_bench_qeventdispatcher.moc"
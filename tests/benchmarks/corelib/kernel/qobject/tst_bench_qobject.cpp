@@ -31,6 +31,11 @@
 #include "object.h"
 #include <qcoreapplication.h>
 #include <qdatetime.h>
+#include <private/qobject_p.h>
+#include <private/qthread_p.h>
+
+#include <memory>
+#include <vector>
 
 enum {
     CreationDeletionBenckmarkConstant = 34567,
@@ -51,10 +56,35 @@ private slots:
     void connect_disconnect_benchmark_data();
     void connect_disconnect_benchmark();
     void receiver_destroyed_benchmark();
+    void queued_signal_throughput_data();
+    void queued_signal_throughput();
 
     void stdAllocator();
 };
 
+class QueuedSender : public QObject
+{
+    Q_OBJECT
+signals:
+    void valueChanged(int value);
+};
+
+class QueuedReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    QEventLoop *loop = nullptr;
+    int expected = 0;
+    int received = 0;
+
+public slots:
+    void receive(int)
+    {
+        if (++received == expected)
+            loop->quit();
+    }
+};
+
 class QObjectUsingStandardAllocator : public QObject
 {
     Q_OBJECT
@@ -305,6 +335,58 @@ void tst_QObject::receiver_destroyed_benchmark()
     }
 }
 
+void tst_QObject::queued_signal_throughput_data()
+{
+    QTest::addColumn<int>("producerCount");
+    QTest::newRow("1 producer") << 1;
+    QTest::newRow("2 producers") << 2;
+    QTest::newRow("4 producers") << 4;
+}
+
+void tst_QObject::queued_signal_throughput()
+{
+    QFETCH(int, producerCount);
+    const int emissionsPerProducer = 100000;
+
+    QueuedReceiver receiver;
+    std::vector<std::unique_ptr<QueuedSender>> senders;
+    for (int i = 0; i < producerCount; ++i) {
+        senders.emplace_back(new QueuedSender);
+        QObject::connect(senders.back().get(), &QueuedSender::valueChanged,
+                         &receiver, &QueuedReceiver::receive, Qt::QueuedConnection);
+    }
+
+    QThreadData *data = QThreadData::current();
+    const QMetaCallEventQueue::Statistics before = data->metaCallQueue.statistics();
+    QBENCHMARK {
+        QEventLoop loop;
+        receiver.loop = &loop;
+        receiver.expected = producerCount * emissionsPerProducer;
+        receiver.received = 0;
+
+        std::vector<std::unique_ptr<QThread>> producers;
+        for (const auto &sender : senders) {
+            QueuedSender *s = sender.get();
+            producers.emplace_back(QThread::create([s, emissionsPerProducer]() {
+                for (int i = 0; i < emissionsPerProducer; ++i)
+                    emit s->valueChanged(i);
+            }));
+            producers.back()->start();
+        }
+        loop.exec();
+        for (const auto &producer : producers)
+            producer->wait();
+    }
+    QCOMPARE(receiver.received, receiver.expected);
+
+    const QMetaCallEventQueue::Statistics after = data->metaCallQueue.statistics();
+    const QEventPool::Statistics pool = QMetaCallEvent::poolStatistics();
+    qDebug("%llu queued meta calls in %llu batches, %llu wake-ups; "
+           "event pool: %llu system allocations, %llu depot exchanges",
+           after.events - before.events, after.batches - before.batches,
+           after.wakeUps - before.wakeUps, pool.systemAllocations, pool.depotExchanges);
+}
+
 QTEST_MAIN(tst_QObject)
 
 #include "tst_bench_qobject.moc"
@@ -0,0 +1,136 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QtCore/qabstracteventdispatcher.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qrandom.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+
+class TimerObject : public QObject
+{
+public:
+    int fired = 0;
+
+protected:
+    void timerEvent(QTimerEvent *) override { ++fired; }
+};
+
+// Per-connection style timers: every timer lives on its own object, and the
+// timers are stopped in a different order than they were started.
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void startStopTimers_data();
+    void startStopTimers();
+    void activateWithIdleTimers_data();
+    void activateWithIdleTimers();
+};
+
+static void addTimerRows()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<Qt::TimerType>("timerType");
+
+    const struct {
+        Qt::TimerType type;
+        const char *name;
+    } timerTypes[] = {
+        { Qt::PreciseTimer, "precise" },
+        { Qt::CoarseTimer, "coarse" },
+        { Qt::VeryCoarseTimer, "verycoarse" }
+    };
+
+    for (int count : {1000, 10000, 100000}) {
+        for (const auto &t : timerTypes)
+            QTest::addRow("%s, timers: %d", t.name, count) << count << t.type;
+    }
+}
+
+void tst_QTimer::startStopTimers_data()
+{
+    addTimerRows();
+}
+
+void tst_QTimer::startStopTimers()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, timerType);
+
+    std::unique_ptr<TimerObject[]> objects(new TimerObject[count]);
+    QList<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), *QRandomGenerator::global());
+    QList<int> ids(count);
+
+    QBENCHMARK {
+        // long enough not to fire while the benchmark runs
+        for (int i = 0; i < count; ++i)
+            ids[i] = objects[i].startTimer(60000 + i % 5000, timerType);
+        for (int i : qAsConst(order))
+            objects[i].killTimer(ids[i]);
+    }
+}
+
+void tst_QTimer::activateWithIdleTimers_data()
+{
+    addTimerRows();
+}
+
+void tst_QTimer::activateWithIdleTimers()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, timerType);
+
+    std::unique_ptr<TimerObject[]> idle(new TimerObject[count]);
+    for (int i = 0; i < count; ++i)
+        idle[i].startTimer(60000 + i % 5000, timerType);
+
+    TimerObject busy;
+    busy.startTimer(0, timerType);
+
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            dispatcher->processEvents(QEventLoop::AllEvents);
+    }
+
+    QVERIFY(busy.fired > 0);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(idle[i].fired, 0);
+}
+
+QTEST_MAIN(tst_QTimer)
+
+#include "tst_bench_qtimer.moc"
@@ -30,6 +30,7 @@
 #include <QIODevice>
 #include <QFile>
 #include <QString>
+#include <QByteArrayMatcher>
 
 #include <qtest.h>
 #include <limits>
@@ -56,6 +57,11 @@ private slots:
 
     void toPercentEncoding_data();
     void toPercentEncoding();
+
+    void indexOf_data();
+    void indexOf();
+    void matcherIndexIn_data() { indexOf_data(); }
+    void matcherIndexIn();
 };
 
 void tst_QByteArray::initTestCase()
@@ -378,6 +384,51 @@ void tst_QByteArray::toPercentEncoding()
     QTEST(encoded, "expected");
 }
 
+// Searches a multi-megabyte log for needles of different lengths that are
+// not in it: needles of up to 32 bytes are found with the SIMD filter on
+// their first and last bytes, longer ones with Boyer-Moore.
+void tst_QByteArray::indexOf_data()
+{
+    QTest::addColumn<QByteArray>("haystack");
+    QTest::addColumn<QByteArray>("needle");
+
+    QByteArray log;
+    for (int i = 0; log.size() < 4 * 1024 * 1024; ++i) {
+        log += "2022-03-17T10:" + QByteArray::number(i % 60) + ":" + QByteArray::number(i % 997)
+                + " qt.network.ssl: [info] session " + QByteArray::number(i)
+                + " resumed, cipher TLS_AES_256_GCM_SHA384\n";
+    }
+
+    const QByteArray needle = "session 12345678 failed: handshake timed out after 30s with peer";
+    for (int length : { 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64 })
+        QTest::addRow("%d", length) << log << needle.right(length);
+}
+
+void tst_QByteArray::indexOf()
+{
+    QFETCH(QByteArray, haystack);
+    QFETCH(QByteArray, needle);
+
+    qsizetype result = 0;
+    QBENCHMARK {
+        result = haystack.indexOf(needle);
+    }
+    QCOMPARE(result, -1);
+}
+
+void tst_QByteArray::matcherIndexIn()
+{
+    QFETCH(QByteArray, haystack);
+    QFETCH(QByteArray, needle);
+
+    const QByteArrayMatcher matcher(needle);
+    qsizetype result = 0;
+    QBENCHMARK {
+        result = matcher.indexIn(haystack);
+    }
+    QCOMPARE(result, -1);
+}
+
 QTEST_MAIN(tst_QByteArray)
 
 #include "tst_bench_qbytearray.moc"
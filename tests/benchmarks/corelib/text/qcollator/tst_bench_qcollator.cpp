@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QCollator>
+#include <QStringList>
+#include <QTest>
+
+#include <algorithm>
+#include <numeric>
+
+class tst_QCollator : public QObject
+{
+    Q_OBJECT
+
+    enum Method { Compare, SortKey, SortKeys };
+
+private slots:
+    void sort_data();
+    void sort();
+    void sortKeys_data();
+    void sortKeys();
+
+private:
+    static QStringList words(int count);
+};
+
+QStringList tst_QCollator::words(int count)
+{
+    const QStringView letters = u"abcdefghijklmnopqrstuvwxyzABCDEéèöå";
+    QStringList result;
+    result.reserve(count);
+    quint32 seed = 1;
+    for (int i = 0; i < count; ++i) {
+        QString word;
+        for (int length = 4 + i % 8; length > 0; --length) {
+            seed = seed * 1103515245 + 12345;
+            word.append(letters.at((seed >> 16) % letters.size()));
+        }
+        result.append(word);
+    }
+    return result;
+}
+
+void tst_QCollator::sort_data()
+{
+    QTest::addColumn<QStringList>("strings");
+    QTest::addColumn<int>("method");
+
+    for (int count : { 1000, 10000, 100000 }) {
+        const QStringList strings = words(count);
+        QTest::addRow("compare %d", count) << strings << int(Compare);
+        QTest::addRow("sortKey %d", count) << strings << int(SortKey);
+        QTest::addRow("sortKeys %d", count) << strings << int(SortKeys);
+    }
+}
+
+void tst_QCollator::sort()
+{
+    QFETCH(const QStringList, strings);
+    QFETCH(const int, method);
+    const QCollator collator(QLocale(QLocale::English, QLocale::UnitedStates));
+
+    switch (method) {
+    case Compare:
+        QBENCHMARK {
+            QStringList sorted = strings;
+            std::sort(sorted.begin(), sorted.end(), collator);
+        }
+        break;
+    case SortKey:
+        QBENCHMARK {
+            QList<QCollatorSortKey> keys;
+            keys.reserve(strings.size());
+            for (const QString &string : strings)
+                keys.append(collator.sortKey(string));
+            QList<qsizetype> indexes(strings.size());
+            std::iota(indexes.begin(), indexes.end(), 0);
+            std::sort(indexes.begin(), indexes.end(), [&keys](qsizetype lhs, qsizetype rhs) {
+                return keys.at(lhs).compare(keys.at(rhs)) < 0;
+            });
+        }
+        break;
+    case SortKeys:
+        QBENCHMARK {
+            const QList<qsizetype> indexes = collator.sortKeys(strings).sortedIndexes();
+            Q_UNUSED(indexes);
+        }
+        break;
+    }
+}
+
+void tst_QCollator::sortKeys_data()
+{
+    QTest::addColumn<QStringList>("strings");
+
+    for (int count : { 1000, 10000, 100000 })
+        QTest::addRow("%d", count) << words(count);
+}
+
+void tst_QCollator::sortKeys()
+{
+    QFETCH(const QStringList, strings);
+    const QCollator collator(QLocale(QLocale::English, QLocale::UnitedStates));
+
+    QBENCHMARK {
+        const QCollatorSortKeys keys = collator.sortKeys(strings);
+        Q_UNUSED(keys);
+    }
+}
+
+QTEST_MAIN(tst_QCollator)
+
+#include "tst_bench_qcollator.moc"
@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QBuffer>
+#include <QDelimitedTextScanner>
+#include <QStringList>
+#include <QStringTokenizer>
+#include <QTest>
+
+class tst_QDelimitedTextScanner : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void split();
+    void tokenizer();
+    void scanner();
+    void utf8Scanner();
+    void reader();
+
+private:
+    QByteArray utf8;
+    QString text;
+    qsizetype fieldCount = 0;
+};
+
+// About a megabyte of comma-separated records of eight fields, the last of
+// which is quoted, so that QString::split() gets the same fields as the
+// scanners.
+void tst_QDelimitedTextScanner::initTestCase()
+{
+    static const char *const cities[] = { "Oslo", "Berlin", "Helsinki", "Lisboa", "Tokyo" };
+    for (int i = 0; utf8.size() < 1024 * 1024; ++i) {
+        utf8 += QByteArray::number(i) + ",2022-03-" + QByteArray::number(10 + i % 20) + ','
+                + cities[i % 5] + ',' + QByteArray::number(i * 7 % 1000) + ".50,EUR,"
+                + QByteArray::number(i % 3) + ",ok,\"note " + QByteArray::number(i) + "\"\n";
+    }
+    text = QString::fromUtf8(utf8);
+    fieldCount = 8 * text.count(u'\n');
+}
+
+void tst_QDelimitedTextScanner::split()
+{
+    QBENCHMARK {
+        qsizetype fields = 0;
+        const QStringList lines = text.split(u'\n', Qt::SkipEmptyParts);
+        for (const QString &line : lines)
+            fields += line.split(u',').size();
+        QCOMPARE(fields, fieldCount);
+    }
+}
+
+void tst_QDelimitedTextScanner::tokenizer()
+{
+    QBENCHMARK {
+        qsizetype fields = 0;
+        for (QStringView line : QStringTokenizer(text, u'\n', Qt::SkipEmptyParts)) {
+            for (QStringView field : QStringTokenizer(line, u','))
+                fields += field.isNull() ? 0 : 1;
+        }
+        QCOMPARE(fields, fieldCount);
+    }
+}
+
+void tst_QDelimitedTextScanner::scanner()
+{
+    QList<QDelimitedTextScanner::Field> record;
+    QBENCHMARK {
+        qsizetype fields = 0;
+        QDelimitedTextScanner scanner(text);
+        while (scanner.readRecord(record))
+            fields += record.size();
+        QCOMPARE(fields, fieldCount);
+    }
+}
+
+void tst_QDelimitedTextScanner::utf8Scanner()
+{
+    QList<QUtf8DelimitedTextScanner::Field> record;
+    QBENCHMARK {
+        qsizetype fields = 0;
+        QUtf8DelimitedTextScanner scanner(utf8);
+        while (scanner.readRecord(record))
+            fields += record.size();
+        QCOMPARE(fields, fieldCount);
+    }
+}
+
+void tst_QDelimitedTextScanner::reader()
+{
+    QList<QDelimitedTextReader::Field> record;
+    QBENCHMARK {
+        qsizetype fields = 0;
+        QBuffer buffer(&utf8);
+        buffer.open(QIODevice::ReadOnly);
+        QDelimitedTextReader reader(&buffer);
+        while (reader.readRecord(record))
+            fields += record.size();
+        QCOMPARE(fields, fieldCount);
+    }
+}
+
+QTEST_MAIN(tst_QDelimitedTextScanner)
+
+#include "tst_bench_qdelimitedtextscanner.moc"
@@ -29,6 +29,8 @@
 #include <QLocale>
 #include <QTest>
 
+#include <cmath>
+
 class tst_QLocale : public QObject
 {
     Q_OBJECT
@@ -54,6 +56,18 @@ private Q_SLOTS:
     void toUpper_QLocale_2();
     void toUpper_QString();
     void number_QString();
+    void number_double_data();
+    void number_double();
+    void number_double_QByteArray_data() { number_double_data(); }
+    void number_double_QByteArray();
+    void toString_double_C_data() { number_double_data(); }
+    void toString_double_C();
+    void toDouble_data();
+    void toDouble();
+    void toDouble_QByteArray_data() { toDouble_data(); }
+    void toDouble_QByteArray();
+    void toDouble_C_data() { toDouble_data(); }
+    void toDouble_C();
 };
 
 static QString data()
@@ -392,6 +406,117 @@ void tst_QLocale::number_QString()
     }
 }
 
+// Values like the ones exported to JSON or CSV: measurements, prices and
+// ratios of varying magnitude.
+static QList<double> doubles()
+{
+    QList<double> values;
+    values.reserve(1000);
+    for (int i = 0; i < 1000; ++i)
+        values.append((i - 500) * 1.2345678901 * std::pow(10.0, i % 17 - 8));
+    return values;
+}
+
+void tst_QLocale::number_double_data()
+{
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+
+    QTest::newRow("shortest") << 'g' << int(QLocale::FloatingPointShortest);
+    QTest::newRow("g6") << 'g' << 6;
+    QTest::newRow("f2") << 'f' << 2;
+    QTest::newRow("e10") << 'e' << 10;
+}
+
+void tst_QLocale::number_double()
+{
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    const QList<double> values = doubles();
+    QBENCHMARK {
+        for (double value : values)
+            QString s = QString::number(value, format, precision);
+    }
+}
+
+void tst_QLocale::number_double_QByteArray()
+{
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    const QList<double> values = doubles();
+    QBENCHMARK {
+        for (double value : values)
+            QByteArray s = QByteArray::number(value, format, precision);
+    }
+}
+
+void tst_QLocale::toString_double_C()
+{
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    const QList<double> values = doubles();
+    const QLocale c = QLocale::c();
+    QBENCHMARK {
+        for (double value : values)
+            QString s = c.toString(value, format, precision);
+    }
+}
+
+void tst_QLocale::toDouble_data()
+{
+    QTest::addColumn<QStringList>("strings");
+
+    const QList<double> values = doubles();
+    QStringList shortest;
+    QStringList fixed;
+    for (double value : values) {
+        shortest.append(QString::number(value, 'g', QLocale::FloatingPointShortest));
+        fixed.append(QString::number(value, 'f', 2));
+    }
+    QTest::newRow("shortest") << shortest;
+    QTest::newRow("f2") << fixed;
+}
+
+void tst_QLocale::toDouble()
+{
+    QFETCH(QStringList, strings);
+    QBENCHMARK {
+        for (const QString &string : std::as_const(strings)) {
+            bool ok;
+            double d = string.toDouble(&ok);
+            Q_UNUSED(d);
+        }
+    }
+}
+
+void tst_QLocale::toDouble_QByteArray()
+{
+    QFETCH(QStringList, strings);
+    QByteArrayList utf8;
+    for (const QString &string : std::as_const(strings))
+        utf8.append(string.toUtf8());
+    QBENCHMARK {
+        for (const QByteArray &string : std::as_const(utf8)) {
+            bool ok;
+            double d = string.toDouble(&ok);
+            Q_UNUSED(d);
+        }
+    }
+}
+
+void tst_QLocale::toDouble_C()
+{
+    QFETCH(QStringList, strings);
+    const QLocale c = QLocale::c();
+    QBENCHMARK {
+        for (const QString &string : std::as_const(strings)) {
+            bool ok;
+            double d = c.toDouble(string, &ok);
+            Q_UNUSED(d);
+        }
+    }
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "tst_bench_qlocale.moc"
@@ -0,0 +1,126 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QMultiStringMatcher>
+#include <QStringList>
+#include <QStringMatcher>
+#include <QTest>
+
+class tst_QMultiStringMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesIn_data();
+    void matchesIn();
+    void loopedStringMatcher_data() { matchesIn_data(); }
+    void loopedStringMatcher();
+    void construct_data() { matchesIn_data(); }
+    void construct();
+};
+
+// Filters a log of about a megabyte against growing lists of keywords, of
+// which every tenth occurs in the log.
+void tst_QMultiStringMatcher::matchesIn_data()
+{
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<QStringList>("keywords");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+
+    static const char *const components[] = { "network", "ssl", "dns", "http", "cache" };
+    static const char *const events[] = { "connected", "resumed", "retrying", "closed" };
+    QByteArray log;
+    for (int i = 0; log.size() < 1024 * 1024; ++i) {
+        log += "2022-03-17T10:" + QByteArray::number(i % 60) + " qt." + components[i % 5]
+                + ": [info] session " + QByteArray::number(i) + ' ' + events[i % 4]
+                + ", peer 10.0.0." + QByteArray::number(i % 251) + '\n';
+    }
+    const QString haystack = QString::fromLatin1(log);
+
+    for (Qt::CaseSensitivity cs : { Qt::CaseSensitive, Qt::CaseInsensitive }) {
+        for (int count : { 1, 10, 100, 500 }) {
+            QStringList keywords;
+            for (int i = 0; i < count; ++i) {
+                keywords.append(i % 10 == 9 ? QStringLiteral("session %1 ").arg(i * 13)
+                                            : QStringLiteral("failure-%1").arg(i));
+            }
+            QTest::addRow("%s-%d", cs == Qt::CaseSensitive ? "cs" : "ci", count)
+                    << haystack << keywords << cs;
+        }
+    }
+}
+
+void tst_QMultiStringMatcher::matchesIn()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QStringList, keywords);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    const QMultiStringMatcher matcher(keywords, cs);
+    qsizetype matches = 0;
+    QBENCHMARK {
+        matches = matcher.matchesIn(haystack).size();
+    }
+    QCOMPARE(matches, keywords.size() / 10);
+}
+
+void tst_QMultiStringMatcher::loopedStringMatcher()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QStringList, keywords);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    QList<QStringMatcher> matchers;
+    for (const QString &keyword : std::as_const(keywords))
+        matchers.append(QStringMatcher(keyword, cs));
+    qsizetype matches = 0;
+    QBENCHMARK {
+        matches = 0;
+        for (const QStringMatcher &matcher : std::as_const(matchers)) {
+            qsizetype i = -1;
+            while ((i = matcher.indexIn(haystack, i + 1)) >= 0)
+                ++matches;
+        }
+    }
+    QCOMPARE(matches, keywords.size() / 10);
+}
+
+void tst_QMultiStringMatcher::construct()
+{
+    QFETCH(QStringList, keywords);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    QBENCHMARK {
+        QMultiStringMatcher matcher(keywords, cs);
+        Q_UNUSED(matcher);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QMultiStringMatcher)
+
+#include "tst_bench_qmultistringmatcher.moc"
@@ -28,6 +28,7 @@
 
 #include <QRegularExpression>
 #include <QTest>
+#include <QThreadPool>
 
 /*!
     \internal
@@ -70,6 +71,11 @@ private slots:
     void queryMatchResultsByGroupIndex();
     void queryMatchResultsByGroupName();
     void iterateThroughGlobalMatchResults();
+
+    void globalMatchLongText();
+    void globalMatchOffsetsLongText();
+    void matchFromThreads_data();
+    void matchFromThreads();
 };
 
 void tst_QRegularExpressionBenchmark::createDefault()
@@ -295,6 +301,85 @@ void tst_QRegularExpressionBenchmark::iterateThroughGlobalMatchResults()
     }
 }
 
+static QString longTextToMatch()
+{
+    return textToMatch.repeated(1000);
+}
+
+/*!
+    \internal This benchmark measures the performance of finding all the
+    matches in a long text by iterating over the results of globalMatch().
+    Every match results in a QRegularExpressionMatch object.
+*/
+void tst_QRegularExpressionBenchmark::globalMatchLongText()
+{
+    const QString text = longTextToMatch();
+    QRegularExpression re(nonEmptyPattern, nonEmptyPatternOptions);
+    re.optimize();
+    QBENCHMARK {
+        qsizetype end = 0;
+        for (const QRegularExpressionMatch &match : re.globalMatch(text))
+            end = match.capturedEnd();
+        QVERIFY(end > 0);
+    }
+}
+
+/*!
+    \internal This benchmark does the same as globalMatchLongText(), but
+    only collects the offsets of the matches with globalMatchOffsets().
+*/
+void tst_QRegularExpressionBenchmark::globalMatchOffsetsLongText()
+{
+    const QString text = longTextToMatch();
+    QRegularExpression re(nonEmptyPattern, nonEmptyPatternOptions);
+    re.optimize();
+    QBENCHMARK {
+        const QList<qsizetype> offsets = re.globalMatchOffsets(text);
+        QVERIFY(!offsets.isEmpty());
+    }
+}
+
+void tst_QRegularExpressionBenchmark::matchFromThreads_data()
+{
+    QTest::addColumn<bool>("shared");
+
+    QTest::newRow("shared-object") << true;
+    QTest::newRow("object-per-match") << false;
+}
+
+/*!
+    \internal This benchmark measures the performance of matching from
+    several threads at the same time, either using the same object, or
+    constructing a new object for every match. In the latter case the compiled
+    pattern is looked up in the cache shared by all threads.
+*/
+void tst_QRegularExpressionBenchmark::matchFromThreads()
+{
+    QFETCH(bool, shared);
+
+    const QRegularExpression sharedRe(nonEmptyPattern, nonEmptyPatternOptions);
+    sharedRe.optimize();
+    const int threadCount = qMax(QThreadPool::globalInstance()->maxThreadCount(), 2);
+
+    QBENCHMARK {
+        for (int i = 0; i < threadCount; ++i) {
+            QThreadPool::globalInstance()->start([&] {
+                for (int j = 0; j < 1000; ++j) {
+                    if (shared) {
+                        auto matchResult = sharedRe.match(textToMatch);
+                        Q_UNUSED(matchResult);
+                    } else {
+                        QRegularExpression re(nonEmptyPattern, nonEmptyPatternOptions);
+                        auto matchResult = re.match(textToMatch);
+                        Q_UNUSED(matchResult);
+                    }
+                }
+            });
+        }
+        QThreadPool::globalInstance()->waitForDone();
+    }
+}
+
 QTEST_MAIN(tst_QRegularExpressionBenchmark)
 
 #include "tst_bench_qregularexpression.moc"
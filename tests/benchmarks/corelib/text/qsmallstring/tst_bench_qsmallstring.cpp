@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QHash>
+#include <QSmallString>
+#include <QStringList>
+#include <QTest>
+
+class tst_QSmallString : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void construct_data() { types(); }
+    void construct();
+    void copy_data() { types(); }
+    void copy();
+    void hashInsert_data() { types(); }
+    void hashInsert();
+    void hashLookup_data() { types(); }
+    void hashLookup();
+    void memory_data() { types(); }
+    void memory();
+
+private:
+    void types();
+
+    // identifiers of the length typically found in source code, markup and
+    // configuration files; nearly all of them fit inline
+    QStringList keys;
+};
+
+void tst_QSmallString::initTestCase()
+{
+    static const char *const words[] = {
+        "id", "name", "value", "width", "height", "parent", "children", "enabled",
+        "visible", "x", "y", "opacity", "objectName", "anchors", "color", "source"
+    };
+    for (int i = 0; i < 20000; ++i)
+        keys.append(QLatin1StringView(words[i % 16]) + QString::number(i / 16));
+}
+
+void tst_QSmallString::types()
+{
+    QTest::addColumn<bool>("small");
+    QTest::newRow("QString") << false;
+    QTest::newRow("QSmallString") << true;
+}
+
+template <typename String>
+static String makeString(QStringView text)
+{
+    if constexpr (std::is_same_v<String, QString>)
+        return text.toString();
+    else
+        return String(text);
+}
+
+template <typename String>
+static void constructStrings(const QStringList &keys)
+{
+    QBENCHMARK {
+        QList<String> strings;
+        strings.reserve(keys.size());
+        for (const QString &key : keys)
+            strings.append(makeString<String>(key));
+    }
+}
+
+void tst_QSmallString::construct()
+{
+    QFETCH(bool, small);
+    if (small)
+        constructStrings<QSmallString>(keys);
+    else
+        constructStrings<QString>(keys);
+}
+
+template <typename String>
+static void copyStrings(const QStringList &keys)
+{
+    QList<String> strings;
+    for (const QString &key : keys)
+        strings.append(makeString<String>(key));
+    QBENCHMARK {
+        QList<String> copies;
+        copies.reserve(strings.size());
+        for (const String &s : std::as_const(strings))
+            copies.append(s);
+    }
+}
+
+void tst_QSmallString::copy()
+{
+    QFETCH(bool, small);
+    if (small)
+        copyStrings<QSmallString>(keys);
+    else
+        copyStrings<QString>(keys);
+}
+
+template <typename String>
+static void insertStrings(const QStringList &keys)
+{
+    QBENCHMARK {
+        QHash<String, int> hash;
+        for (qsizetype i = 0; i < keys.size(); ++i)
+            hash.insert(makeString<String>(keys.at(i)), int(i));
+    }
+}
+
+void tst_QSmallString::hashInsert()
+{
+    QFETCH(bool, small);
+    if (small)
+        insertStrings<QSmallString>(keys);
+    else
+        insertStrings<QString>(keys);
+}
+
+template <typename String>
+static void lookupStrings(const QStringList &keys)
+{
+    QHash<String, int> hash;
+    QList<String> lookups;
+    for (qsizetype i = 0; i < keys.size(); ++i) {
+        hash.insert(makeString<String>(keys.at(i)), int(i));
+        lookups.append(makeString<String>(keys.at(i)));
+    }
+    qsizetype found = 0;
+    QBENCHMARK {
+        for (const String &s : std::as_const(lookups))
+            found += hash.contains(s);
+    }
+    QVERIFY(found > 0);
+}
+
+void tst_QSmallString::hashLookup()
+{
+    QFETCH(bool, small);
+    if (small)
+        lookupStrings<QSmallString>(keys);
+    else
+        lookupStrings<QString>(keys);
+}
+
+// Bytes needed to hold all keys: the objects themselves plus, for every
+// string that does not store its text inline, the header and the
+// '\0'-terminated text of a QString allocation.
+void tst_QSmallString::memory()
+{
+    QFETCH(bool, small);
+    const qsizetype objectSize = small ? sizeof(QSmallString) : sizeof(QString);
+    qint64 bytes = 0;
+    for (const QString &key : std::as_const(keys)) {
+        bytes += objectSize;
+        if (!small || key.size() > QSmallString::InlineCapacity)
+            bytes += sizeof(QArrayData) + (key.size() + 1) * sizeof(char16_t);
+    }
+    QTest::setBenchmarkResult(bytes, QTest::BytesAllocated);
+}
+
+QTEST_MAIN(tst_QSmallString)
+
+#include "tst_bench_qsmallstring.moc"
@@ -26,6 +26,7 @@
 **
 ****************************************************************************/
 #include <QStringList>
+#include <QStringMatcher>
 #include <QFile>
 #include <QTest>
 #include <limits>
@@ -48,6 +49,7 @@ private slots:
     void toLower();
     void toCaseFolded_data();
     void toCaseFolded();
+    void toLowerFileNames();
 
     void number_qlonglong_data();
     void number_qlonglong() { number_impl<qlonglong>(); }
@@ -57,6 +59,16 @@ private slots:
     void number_double_data();
     void number_double();
 
+    void indexOf_data();
+    void indexOf();
+    void matcherIndexIn_data() { indexOf_data(); }
+    void matcherIndexIn();
+    void indexOfCharCaseInsensitive();
+
+    void compareCaseInsensitive_data();
+    void compareCaseInsensitive();
+    void sortCaseInsensitive();
+
 private:
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
@@ -197,6 +209,27 @@ void tst_QString::toCaseFolded()
     }
 }
 
+static QStringList fileNames()
+{
+    static const char *const directories[] = { "Documents", "Pictures", "src", "Build-Release" };
+    static const char *const suffixes[] = { ".txt", ".JPG", ".cpp", ".H", ".Log" };
+    QStringList names;
+    for (int i = 0; i < 10000; ++i) {
+        names.append(QLatin1StringView(directories[i % 4]) + u"/Report_"_qs
+                     + QString::number((i * 7919) % 10007) + QLatin1StringView(suffixes[i % 5]));
+    }
+    return names;
+}
+
+void tst_QString::toLowerFileNames()
+{
+    const QStringList names = fileNames();
+    QBENCHMARK {
+        for (const QString &name : names)
+            [[maybe_unused]] auto r = name.toLower();
+    }
+}
+
 template <typename Integer>
 void tst_QString::number_impl()
 {
@@ -319,6 +352,114 @@ void tst_QString::number_double()
     QCOMPARE(actual, expected);
 }
 
+// Searches a multi-megabyte log for needles of different lengths that are
+// not in it: needles of up to 32 characters are found with the SIMD filter on
+// their first and last characters, longer ones with Boyer-Moore.
+static QString logText()
+{
+    QByteArray log;
+    for (int i = 0; log.size() < 2 * 1024 * 1024; ++i) {
+        log += "2022-03-17T10:" + QByteArray::number(i % 60) + ":" + QByteArray::number(i % 997)
+                + " qt.network.ssl: [info] session " + QByteArray::number(i)
+                + " resumed, cipher TLS_AES_256_GCM_SHA384\n";
+    }
+    return QString::fromLatin1(log);
+}
+
+void tst_QString::indexOf_data()
+{
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<QString>("needle");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+
+    const QString haystack = logText();
+
+    const QString needle = QStringLiteral("session 12345678 failed: handshake timed out after 30s with peer");
+    for (Qt::CaseSensitivity cs : { Qt::CaseSensitive, Qt::CaseInsensitive }) {
+        for (int length : { 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64 }) {
+            QTest::addRow("%s-%d", cs == Qt::CaseSensitive ? "cs" : "ci", length)
+                    << haystack << needle.right(length) << cs;
+        }
+    }
+}
+
+void tst_QString::indexOf()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QString, needle);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    qsizetype result = 0;
+    QBENCHMARK {
+        result = haystack.indexOf(needle, 0, cs);
+    }
+    QCOMPARE(result, -1);
+}
+
+void tst_QString::matcherIndexIn()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QString, needle);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    const QStringMatcher matcher(needle, cs);
+    qsizetype result = 0;
+    QBENCHMARK {
+        result = matcher.indexIn(haystack);
+    }
+    QCOMPARE(result, -1);
+}
+
+void tst_QString::indexOfCharCaseInsensitive()
+{
+    const QString haystack = logText();
+    qsizetype result = 0;
+    QBENCHMARK {
+        result = haystack.indexOf(u'z', 0, Qt::CaseInsensitive);
+    }
+    QCOMPARE(result, -1);
+}
+
+void tst_QString::compareCaseInsensitive_data()
+{
+    QTest::addColumn<QString>("lhs");
+    QTest::addColumn<QString>("rhs");
+
+    const QString sentence = u"The Quick Brown Fox Jumps Over The Lazy Dog. "_qs;
+    for (int length : { 8, 16, 64, 1024 }) {
+        QString text;
+        while (text.size() < length)
+            text += sentence;
+        text.truncate(length);
+        QTest::addRow("ascii-%d", length) << text << text.toUpper();
+        const QString nonAscii = text.left(length - 1) + u'\u00c4';
+        QTest::addRow("ascii+1-%d", length) << nonAscii << nonAscii.toLower();
+    }
+}
+
+void tst_QString::compareCaseInsensitive()
+{
+    QFETCH(QString, lhs);
+    QFETCH(QString, rhs);
+
+    int result = 0;
+    QBENCHMARK {
+        result = QString::compare(lhs, rhs, Qt::CaseInsensitive);
+    }
+    QCOMPARE(result, 0);
+}
+
+void tst_QString::sortCaseInsensitive()
+{
+    const QStringList names = fileNames();
+    QBENCHMARK {
+        QStringList sorted = names;
+        std::sort(sorted.begin(), sorted.end(), [](const QString &lhs, const QString &rhs) {
+            return QString::compare(lhs, rhs, Qt::CaseInsensitive) < 0;
+        });
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "tst_bench_qstring.moc"
@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QStringDecoder>
+#include <QStringEncoder>
+#include <QTest>
+
+class tst_QStringConverter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fromUtf8_data() { corpora(); }
+    void fromUtf8();
+    void decoderChunked_data() { corpora(); }
+    void decoderChunked();
+    void toUtf8_data() { corpora(); }
+    void toUtf8();
+    void encoderChunked_data() { corpora(); }
+    void encoderChunked();
+    void isValidUtf8_data() { corpora(); }
+    void isValidUtf8();
+
+private:
+    void corpora();
+};
+
+// Roughly 64 kB of text made by repeating a sentence, with a counter mixed in
+// so that the runs of ASCII and non-ASCII characters don't all line up the
+// same way.
+static QString corpus(const char16_t *sentence)
+{
+    QString result;
+    const QString s = QString::fromUtf16(sentence);
+    for (int i = 0; result.size() < 32 * 1024; ++i)
+        result += s + QString::number(i) + u' ';
+    return result;
+}
+
+void tst_QStringConverter::corpora()
+{
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("ascii") << corpus(u"The quick brown fox jumps over the lazy dog.");
+    QTest::newRow("latin") << corpus(u"Portez ce vieux whisky au juge blond qui fume, à côté.");
+    QTest::newRow("cyrillic") << corpus(u"Съешь же ещё этих мягких французских булок, да выпей чаю.");
+    QTest::newRow("greek") << corpus(u"Ξεσκεπάζω την ψυχοφθόρα βδελυγμία.");
+    QTest::newRow("cjk") << corpus(u"いろはにほへと ちりぬるを わかよたれそ 天地玄黄宇宙洪荒日月盈昃");
+    QTest::newRow("hangul") << corpus(u"키스의 고유조건은 입술끼리 만나야 하고 특별한 기술은 필요치 않다.");
+    QTest::newRow("mixed") << corpus(u"Qt 6: Привет, мир! 你好，世界！ Γειά σου Κόσμε! こんにちは");
+    QTest::newRow("emoji") << corpus(u"Smile \U0001F600 wink \U0001F609 party \U0001F389 rocket \U0001F680");
+}
+
+void tst_QStringConverter::fromUtf8()
+{
+    QFETCH(QString, text);
+    const QByteArray utf8 = text.toUtf8();
+
+    QBENCHMARK {
+        QString result = QString::fromUtf8(utf8);
+        Q_UNUSED(result);
+    }
+}
+
+void tst_QStringConverter::decoderChunked()
+{
+    QFETCH(QString, text);
+    const QByteArray utf8 = text.toUtf8();
+    constexpr qsizetype ChunkSize = 4093; // odd, so that chunks split sequences
+
+    QBENCHMARK {
+        QStringDecoder decoder(QStringDecoder::Utf8);
+        QString result;
+        for (qsizetype i = 0; i < utf8.size(); i += ChunkSize)
+            result += decoder.decode(QByteArrayView(utf8).sliced(i, qMin(ChunkSize, utf8.size() - i)));
+        QCOMPARE(result.size(), text.size());
+    }
+}
+
+void tst_QStringConverter::toUtf8()
+{
+    QFETCH(QString, text);
+
+    QBENCHMARK {
+        QByteArray result = text.toUtf8();
+        Q_UNUSED(result);
+    }
+}
+
+void tst_QStringConverter::encoderChunked()
+{
+    QFETCH(QString, text);
+    const QStringView view = text;
+    constexpr qsizetype ChunkSize = 4093;
+
+    QBENCHMARK {
+        QStringEncoder encoder(QStringEncoder::Utf8);
+        QByteArray result;
+        for (qsizetype i = 0; i < view.size(); i += ChunkSize)
+            result += encoder.encode(view.sliced(i, qMin(ChunkSize, view.size() - i)));
+        Q_UNUSED(result);
+    }
+}
+
+void tst_QStringConverter::isValidUtf8()
+{
+    QFETCH(QString, text);
+    const QByteArray utf8 = text.toUtf8();
+
+    QBENCHMARK {
+        bool valid = utf8.isValidUtf8();
+        Q_UNUSED(valid);
+    }
+}
+
+QTEST_MAIN(tst_QStringConverter)
+
+#include "tst_bench_qstringconverter.moc"
@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QSet>
+#include <QStringList>
+#include <QStringPool>
+#include <QTest>
+
+class tst_QStringPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void copy();
+    void intern();
+    void memory_data();
+    void memory();
+
+private:
+    // status values as they come out of a parser: equal text, separate data
+    QList<QString> values;
+};
+
+void tst_QStringPool::initTestCase()
+{
+    static const char *const statuses[] = {
+        "active", "inactive", "pending", "closed", "suspended", "archived"
+    };
+    for (int i = 0; i < 100000; ++i)
+        values.append(QString::fromLatin1(statuses[i % 6]));
+}
+
+void tst_QStringPool::copy()
+{
+    QBENCHMARK {
+        QStringList strings;
+        strings.reserve(values.size());
+        for (const QString &value : std::as_const(values))
+            strings.append(QStringView(value).toString());
+    }
+}
+
+void tst_QStringPool::intern()
+{
+    QStringPool pool;
+    QBENCHMARK {
+        QStringList strings;
+        strings.reserve(values.size());
+        for (const QString &value : std::as_const(values))
+            strings.append(pool.intern(QStringView(value)));
+    }
+}
+
+void tst_QStringPool::memory_data()
+{
+    QTest::addColumn<bool>("interned");
+    QTest::newRow("copies") << false;
+    QTest::newRow("interned") << true;
+}
+
+// Bytes of string data held by the strings of the list: shared data counts
+// only once.
+void tst_QStringPool::memory()
+{
+    QFETCH(bool, interned);
+    QStringPool pool;
+    QStringList strings;
+    for (const QString &value : std::as_const(values))
+        strings.append(interned ? pool.intern(QStringView(value)) : QStringView(value).toString());
+
+    QSet<const QChar *> seen;
+    qint64 bytes = 0;
+    for (const QString &s : std::as_const(strings)) {
+        if (!seen.contains(s.constData())) {
+            seen.insert(s.constData());
+            bytes += sizeof(QArrayData) + (s.size() + 1) * sizeof(char16_t);
+        }
+    }
+    QTest::setBenchmarkResult(bytes, QTest::BytesAllocated);
+}
+
+QTEST_MAIN(tst_QStringPool)
+
+#include "tst_bench_qstringpool.moc"
@@ -0,0 +1,222 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QMpmcQueue>
+#include <QMutex>
+#include <QQueue>
+#include <QSpscQueue>
+#include <QTest>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <memory>
+#include <vector>
+
+namespace {
+// a QQueue that blocks when full, the way such a queue is usually written
+class LockedQueue
+{
+public:
+    explicit LockedQueue(qsizetype capacity) : capacity(capacity) {}
+
+    void enqueue(int value)
+    {
+        QMutexLocker locker(&mutex);
+        while (queue.size() == capacity)
+            notFull.wait(&mutex);
+        queue.enqueue(value);
+        notEmpty.wakeOne();
+    }
+    int dequeue()
+    {
+        QMutexLocker locker(&mutex);
+        while (queue.isEmpty())
+            notEmpty.wait(&mutex);
+        const int value = queue.dequeue();
+        notFull.wakeOne();
+        return value;
+    }
+
+private:
+    const qsizetype capacity;
+    QMutex mutex;
+    QWaitCondition notEmpty;
+    QWaitCondition notFull;
+    QQueue<int> queue;
+};
+} // unnamed namespace
+
+class tst_QBoundedQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Container { SpscQueue, MpmcQueue, Locked };
+    Q_ENUM(Container)
+
+private slots:
+    void uncontended_data() { latency_data(); }
+    void uncontended();
+    void throughput_data();
+    void throughput();
+    void latency_data();
+    void latency();
+
+private:
+    template <typename Function> void dispatch(Container container, qsizetype capacity, Function f);
+};
+
+static constexpr int Count = 1000000;
+static constexpr qsizetype Capacity = 1024;
+
+template <typename Function>
+void tst_QBoundedQueue::dispatch(Container container, qsizetype capacity, Function f)
+{
+    switch (container) {
+    case SpscQueue: {
+        QSpscQueue<int> queue(capacity);
+        f(queue);
+        break;
+    }
+    case MpmcQueue: {
+        QMpmcQueue<int> queue(capacity);
+        f(queue);
+        break;
+    }
+    case Locked: {
+        LockedQueue queue(capacity);
+        f(queue);
+        break;
+    }
+    }
+}
+
+template <typename Functor>
+static std::unique_ptr<QThread> startThread(Functor &&f)
+{
+    std::unique_ptr<QThread> thread(QThread::create(std::forward<Functor>(f)));
+    thread->start();
+    return thread;
+}
+
+// The cost of the queue operations themselves, in a single thread.
+void tst_QBoundedQueue::uncontended()
+{
+    QFETCH(Container, container);
+
+    dispatch(container, Capacity, [&](auto &queue) {
+        int sum = 0;
+        QBENCHMARK {
+            for (int i = 0; i < Count; ++i) {
+                queue.enqueue(i);
+                sum += queue.dequeue();
+            }
+        }
+        Q_UNUSED(sum);
+    });
+}
+
+void tst_QBoundedQueue::throughput_data()
+{
+    QTest::addColumn<Container>("container");
+    QTest::addColumn<int>("threads");
+
+    QTest::addRow("QSpscQueue:1") << SpscQueue << 1;
+    for (int threads : { 1, 2, 4 }) {
+        QTest::addRow("QMpmcQueue:%d", threads) << MpmcQueue << threads;
+        QTest::addRow("QQueue+QMutex:%d", threads) << Locked << threads;
+    }
+}
+
+// Count elements go from the given number of producers to as many
+// consumers, through a queue of Capacity elements.
+void tst_QBoundedQueue::throughput()
+{
+    QFETCH(Container, container);
+    QFETCH(int, threads);
+
+    dispatch(container, Capacity, [&](auto &queue) {
+        QBENCHMARK {
+            const int perThread = Count / threads;
+            std::vector<std::unique_ptr<QThread>> workers;
+            for (int t = 0; t < threads; ++t) {
+                workers.push_back(startThread([&queue, perThread] {
+                    for (int i = 0; i < perThread; ++i)
+                        queue.enqueue(i);
+                }));
+                workers.push_back(startThread([&queue, perThread] {
+                    int sum = 0;
+                    for (int i = 0; i < perThread; ++i)
+                        sum += queue.dequeue();
+                    Q_UNUSED(sum);
+                }));
+            }
+            for (const auto &worker : workers)
+                worker->wait();
+        }
+    });
+}
+
+void tst_QBoundedQueue::latency_data()
+{
+    QTest::addColumn<Container>("container");
+
+    QTest::addRow("QSpscQueue") << SpscQueue;
+    QTest::addRow("QMpmcQueue") << MpmcQueue;
+    QTest::addRow("QQueue+QMutex") << Locked;
+}
+
+// Round trips of one element between two threads, through a queue in
+// each direction.
+void tst_QBoundedQueue::latency()
+{
+    QFETCH(Container, container);
+    constexpr int RoundTrips = 10000;
+
+    dispatch(container, 1, [&](auto &requests) {
+        dispatch(container, 1, [&](auto &replies) {
+            int mismatches = 0;
+            QBENCHMARK {
+                auto echo = startThread([&] {
+                    for (int i = 0; i < RoundTrips; ++i)
+                        replies.enqueue(requests.dequeue());
+                });
+                for (int i = 0; i < RoundTrips; ++i) {
+                    requests.enqueue(i);
+                    mismatches += replies.dequeue() != i;
+                }
+                echo->wait();
+            }
+            QCOMPARE(mismatches, 0);
+        });
+    });
+}
+
+QTEST_MAIN(tst_QBoundedQueue)
+
+#include "tst_bench_qboundedqueue.moc"
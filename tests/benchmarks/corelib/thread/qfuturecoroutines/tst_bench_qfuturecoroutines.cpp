@@ -0,0 +1,178 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+
+#include <qeventloop.h>
+#include <qfuture.h>
+#include <qpromise.h>
+#include <qthreadpool.h>
+
+#include <memory>
+#include <vector>
+
+// Each benchmark resumes the same number of continuations, either as a
+// then() chain or as a coroutine awaiting futures one after another.
+static constexpr int Steps = 100;
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+struct Task
+{
+    struct promise_type
+    {
+        Task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() { }
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+static Task awaitAll(std::vector<QFuture<int>> futures, int *sum)
+{
+    for (const auto &future : futures)
+        *sum += co_await future;
+}
+
+static QFuture<int> finishInPool()
+{
+    auto promise = std::make_shared<QPromise<int>>();
+    promise->start();
+    auto future = promise->future();
+    QThreadPool::globalInstance()->start([promise] {
+        promise->addResult(1);
+        promise->finish();
+    });
+    return future;
+}
+
+static Task pingPong(int *sum, QEventLoop *loop)
+{
+    for (int i = 0; i < Steps; ++i)
+        *sum += co_await finishInPool();
+    loop->quit();
+}
+
+// A pool thread may win the race every time, in which case neither version
+// needs the event loop.
+static void thenPingPong(int remaining, int *sum, QObject *context, QEventLoop *loop)
+{
+    finishInPool().then(context, [=](int value) {
+        *sum += value;
+        if (remaining == 1)
+            loop->quit();
+        else
+            thenPingPong(remaining - 1, sum, context, loop);
+    });
+}
+
+#endif // __cpp_impl_coroutine
+
+class tst_QFutureCoroutines : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sameThread_then();
+    void sameThread_coAwait();
+    void otherThread_then();
+    void otherThread_coAwait();
+};
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+void tst_QFutureCoroutines::sameThread_then()
+{
+    QBENCHMARK {
+        QPromise<int> promise;
+        auto future = promise.future();
+        for (int i = 0; i < Steps; ++i)
+            future = future.then([](int value) { return value + 1; });
+        promise.start();
+        promise.addResult(0);
+        promise.finish();
+        QCOMPARE(future.result(), Steps);
+    }
+}
+
+void tst_QFutureCoroutines::sameThread_coAwait()
+{
+    QBENCHMARK {
+        std::vector<QPromise<int>> promises(Steps);
+        std::vector<QFuture<int>> futures;
+        for (auto &promise : promises)
+            futures.push_back(promise.future());
+        int sum = 0;
+        awaitAll(std::move(futures), &sum);
+        for (auto &promise : promises) {
+            promise.start();
+            promise.addResult(1);
+            promise.finish();
+        }
+        QCOMPARE(sum, Steps);
+    }
+}
+
+void tst_QFutureCoroutines::otherThread_then()
+{
+    QObject context;
+    QBENCHMARK {
+        QEventLoop loop;
+        int sum = 0;
+        thenPingPong(Steps, &sum, &context, &loop);
+        if (sum < Steps)
+            loop.exec();
+        QCOMPARE(sum, Steps);
+    }
+}
+
+void tst_QFutureCoroutines::otherThread_coAwait()
+{
+    QBENCHMARK {
+        QEventLoop loop;
+        int sum = 0;
+        pingPong(&sum, &loop);
+        if (sum < Steps)
+            loop.exec();
+        QCOMPARE(sum, Steps);
+    }
+}
+
+#else
+
+void tst_QFutureCoroutines::sameThread_then() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::sameThread_coAwait() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::otherThread_then() { QSKIP("No coroutine support"); }
+void tst_QFutureCoroutines::otherThread_coAwait() { QSKIP("No coroutine support"); }
+
+#endif // __cpp_impl_coroutine
+
+QTEST_MAIN(tst_QFutureCoroutines)
+
+#include "tst_bench_qfuturecoroutines.moc"
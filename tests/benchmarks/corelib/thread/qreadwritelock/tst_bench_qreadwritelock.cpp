@@ -49,6 +49,26 @@ struct QRecursiveReadWriteLock : QReadWriteLock
     QRecursiveReadWriteLock() : QReadWriteLock(Recursive) {}
 };
 
+struct QReaderBiasedReadWriteLock : QShardedReadWriteLock
+{
+    QReaderBiasedReadWriteLock() : QShardedReadWriteLock(ReaderBiased) {}
+};
+
+// QReadLocker and QWriteLocker only take a QReadWriteLock
+struct QShardedReadLocker
+{
+    QShardedReadWriteLock *lock;
+    explicit QShardedReadLocker(QShardedReadWriteLock *lock) : lock(lock) { lock->lockForRead(); }
+    ~QShardedReadLocker() { lock->unlock(); }
+};
+
+struct QShardedWriteLocker
+{
+    QShardedReadWriteLock *lock;
+    explicit QShardedWriteLocker(QShardedReadWriteLock *lock) : lock(lock) { lock->lockForWrite(); }
+    ~QShardedWriteLocker() { lock->unlock(); }
+};
+
 template <typename T, size_t N>
   // requires N = 2^M for some Integral M >= 0
 struct Recursive
@@ -107,6 +127,8 @@ private slots:
     void readOnly();
     void writeOnly_data();
     void writeOnly();
+    void readScaling_data();
+    void readScaling();
     // void readWrite();
 };
 
@@ -120,6 +142,16 @@ struct FunctionPtrHolder
 };
 Q_DECLARE_METATYPE(FunctionPtrHolder)
 
+struct ScalingFunctionPtrHolder
+{
+    ScalingFunctionPtrHolder(void (*value)(int) = nullptr)
+        : value(value)
+    {
+    }
+    void (*value)(int);
+};
+Q_DECLARE_METATYPE(ScalingFunctionPtrHolder)
+
 struct FakeLock
 {
     FakeLock(volatile int *i) { *i = 0; }
@@ -148,6 +180,10 @@ void tst_QReadWriteLock::uncontended_data()
         << FunctionPtrHolder(testUncontended<QReadWriteLock, QReadLocker>);
     QTest::newRow("QReadWriteLock, write")
         << FunctionPtrHolder(testUncontended<QReadWriteLock, QWriteLocker>);
+    QTest::newRow("QShardedReadWriteLock, read")
+        << FunctionPtrHolder(testUncontended<QShardedReadWriteLock, QShardedReadLocker>);
+    QTest::newRow("QShardedReadWriteLock, write")
+        << FunctionPtrHolder(testUncontended<QShardedReadWriteLock, QShardedWriteLocker>);
 #define ROW(n) \
     QTest::addRow("QReadWriteLock, %s, recursive: %d", "read", n) \
         << FunctionPtrHolder(testUncontended<QRecursiveReadWriteLock, QRecursiveReadLocker<n>>); \
@@ -224,6 +260,10 @@ void tst_QReadWriteLock::readOnly_data()
     QTest::newRow("nothing") << FunctionPtrHolder(testReadOnly<int, FakeLock>);
     QTest::newRow("QMutex") << FunctionPtrHolder(testReadOnly<QMutex, QMutexLocker<QMutex>>);
     QTest::newRow("QReadWriteLock") << FunctionPtrHolder(testReadOnly<QReadWriteLock, QReadLocker>);
+    QTest::newRow("QShardedReadWriteLock")
+        << FunctionPtrHolder(testReadOnly<QShardedReadWriteLock, QShardedReadLocker>);
+    QTest::newRow("QShardedReadWriteLock, reader-biased")
+        << FunctionPtrHolder(testReadOnly<QReaderBiasedReadWriteLock, QShardedReadLocker>);
 #define ROW(n) \
     QTest::addRow("QReadWriteLock, recursive: %d", n) \
         << FunctionPtrHolder(testReadOnly<QRecursiveReadWriteLock, QRecursiveReadLocker<n>>)
@@ -292,6 +332,8 @@ void tst_QReadWriteLock::writeOnly_data()
     // QTest::newRow("nothing") << FunctionPtrHolder(testWriteOnly<int, FakeLock>);
     QTest::newRow("QMutex") << FunctionPtrHolder(testWriteOnly<QMutex, QMutexLocker<QMutex>>);
     QTest::newRow("QReadWriteLock") << FunctionPtrHolder(testWriteOnly<QReadWriteLock, QWriteLocker>);
+    QTest::newRow("QShardedReadWriteLock")
+        << FunctionPtrHolder(testWriteOnly<QShardedReadWriteLock, QShardedWriteLocker>);
 #define ROW(n) \
     QTest::addRow("QReadWriteLock, recursive: %d", n) \
         << FunctionPtrHolder(testWriteOnly<QRecursiveReadWriteLock, QRecursiveWriteLocker<n>>)
@@ -319,5 +361,80 @@ void tst_QReadWriteLock::writeOnly()
     holder.value();
 }
 
+static const int scaling_keys[] = { 1, 2, 3, 5, 8, 13, 21, 34 };
+static QHash<int, int> scaling_hash;
+
+// Unlike readOnly(), the critical section is short and there is no work
+// outside of it, so the time is dominated by the lock itself. Each thread
+// does the same number of reads: with a lock whose read side scales, the
+// time stays flat as threads are added (as long as there are enough cores).
+template <typename Mutex, typename Locker>
+void testReadScaling(int threads)
+{
+    enum { ReadIterations = 200000 };
+    struct Thread : QThread
+    {
+        Mutex *lock;
+        qsizetype found = 0;
+        void run() override
+        {
+            for (int i = 0; i < ReadIterations; ++i) {
+                Locker locker(lock);
+                found += scaling_hash.contains(scaling_keys[i % std::size(scaling_keys)]);
+            }
+        }
+    };
+    if (scaling_hash.isEmpty()) {
+        for (int key : scaling_keys)
+            scaling_hash.insert(key, key);
+    }
+    Mutex lock;
+    std::vector<std::unique_ptr<Thread>> pool;
+    for (int i = 0; i < threads; ++i) {
+        auto t = std::make_unique<Thread>();
+        t->lock = &lock;
+        pool.push_back(std::move(t));
+    }
+    QBENCHMARK {
+        for (auto &t : pool)
+            t->start();
+        for (auto &t : pool)
+            t->wait();
+    }
+}
+
+void tst_QReadWriteLock::readScaling_data()
+{
+    QTest::addColumn<ScalingFunctionPtrHolder>("holder");
+    QTest::addColumn<int>("threads");
+
+    for (int threads : { 1, 2, 4, 8, 16, 32 }) {
+        QTest::addRow("QReadWriteLock, %d threads", threads)
+            << ScalingFunctionPtrHolder(testReadScaling<QReadWriteLock, QReadLocker>)
+            << threads;
+        QTest::addRow("QShardedReadWriteLock, %d threads", threads)
+            << ScalingFunctionPtrHolder(testReadScaling<QShardedReadWriteLock, QShardedReadLocker>)
+            << threads;
+        QTest::addRow("QShardedReadWriteLock, reader-biased, %d threads", threads)
+            << ScalingFunctionPtrHolder(
+                   testReadScaling<QReaderBiasedReadWriteLock, QShardedReadLocker>)
+            << threads;
+#ifdef __cpp_lib_shared_mutex
+        QTest::addRow("std::shared_mutex, %d threads", threads)
+            << ScalingFunctionPtrHolder(
+                   testReadScaling<std::shared_mutex,
+                                   LockerWrapper<std::shared_lock<std::shared_mutex>>>)
+            << threads;
+#endif
+    }
+}
+
+void tst_QReadWriteLock::readScaling()
+{
+    QFETCH(ScalingFunctionPtrHolder, holder);
+    QFETCH(int, threads);
+    holder.value(threads);
+}
+
 QTEST_MAIN(tst_QReadWriteLock)
 #include "tst_bench_qreadwritelock.moc"
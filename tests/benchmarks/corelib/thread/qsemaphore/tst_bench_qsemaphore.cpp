@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QtCore>
+#include <QTest>
+
+class tst_QSemaphore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void uncontended_data();
+    void uncontended();
+    void pingPong_data();
+    void pingPong();
+    void producerConsumer_data();
+    void producerConsumer();
+};
+
+void tst_QSemaphore::uncontended_data()
+{
+    QTest::addColumn<int>("tokens");
+    QTest::newRow("1") << 1;
+    QTest::newRow("4") << 4;
+}
+
+void tst_QSemaphore::uncontended()
+{
+    QFETCH(int, tokens);
+    QSemaphore sem(tokens);
+    QBENCHMARK {
+        for (int i = 0; i < 100000; ++i) {
+            sem.acquire(tokens);
+            sem.release(tokens);
+        }
+    }
+}
+
+// Two threads alternate through a pair of semaphores, so every acquire
+// blocks and every release has to wake the other thread: one iteration is a
+// round trip. Acquiring more than one token at a time takes the multi-token
+// wait path.
+void tst_QSemaphore::pingPong_data()
+{
+    QTest::addColumn<int>("tokens");
+    QTest::newRow("1 token") << 1;
+    QTest::newRow("4 tokens") << 4;
+}
+
+void tst_QSemaphore::pingPong()
+{
+    QFETCH(int, tokens);
+    enum { RoundTrips = 20000 };
+    QSemaphore ping;
+    QSemaphore pong;
+
+    QBENCHMARK {
+        QScopedPointer<QThread> other(QThread::create([&] {
+            for (int i = 0; i < RoundTrips; ++i) {
+                ping.acquire(tokens);
+                pong.release(tokens);
+            }
+        }));
+        other->start();
+        for (int i = 0; i < RoundTrips; ++i) {
+            ping.release(tokens);
+            pong.acquire(tokens);
+        }
+        other->wait();
+    }
+}
+
+// Producers release single tokens, consumers take them in batches.
+void tst_QSemaphore::producerConsumer_data()
+{
+    QTest::addColumn<int>("producers");
+    QTest::addColumn<int>("batch");
+    QTest::newRow("1 producer, batch 1") << 1 << 1;
+    QTest::newRow("1 producer, batch 8") << 1 << 8;
+    QTest::newRow("4 producers, batch 1") << 4 << 1;
+    QTest::newRow("4 producers, batch 8") << 4 << 8;
+}
+
+void tst_QSemaphore::producerConsumer()
+{
+    QFETCH(int, producers);
+    QFETCH(int, batch);
+    enum { TokensPerProducer = 40000 };
+    QSemaphore sem;
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back(QThread::create([&] {
+                for (int i = 0; i < TokensPerProducer; ++i)
+                    sem.release();
+            }));
+            threads.back()->start();
+        }
+        for (int taken = 0; taken < producers * TokensPerProducer; taken += batch)
+            sem.acquire(batch);
+        for (auto &thread : threads)
+            thread->wait();
+    }
+}
+
+QTEST_MAIN(tst_QSemaphore)
+
+#include "tst_bench_qsemaphore.moc"
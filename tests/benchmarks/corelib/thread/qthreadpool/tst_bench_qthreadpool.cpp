@@ -40,6 +40,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void fineGrainedTasks_data();
+    void fineGrainedTasks();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,6 +77,44 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+void tst_QThreadPool::fineGrainedTasks_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("workStealing");
+
+    const int idealThreadCount = qMax(QThread::idealThreadCount(), 2);
+    for (int threads = 1; threads <= idealThreadCount; threads *= 2) {
+        QTest::addRow("shared queue, %d threads", threads) << threads << false;
+        QTest::addRow("work stealing, %d threads", threads) << threads << true;
+    }
+}
+
+void tst_QThreadPool::fineGrainedTasks()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, workStealing);
+
+    // Each task fans out into many tiny tasks from inside the pool, which
+    // stresses the submission path as well as the dequeuing in the workers.
+    const int fanOut = 64;
+    const int subTasks = 256;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+    QAtomicInt done;
+    QBENCHMARK {
+        done.storeRelaxed(0);
+        for (int i = 0; i < fanOut; ++i) {
+            threadPool.start([&threadPool, &done]() {
+                for (int j = 0; j < subTasks; ++j)
+                    threadPool.start([&done]() { done.ref(); });
+            });
+        }
+        threadPool.waitForDone();
+        QCOMPARE(done.loadRelaxed(), fanOut * subTasks);
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool)
 
 #include "tst_bench_qthreadpool.moc"
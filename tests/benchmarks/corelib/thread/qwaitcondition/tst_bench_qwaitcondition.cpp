@@ -57,6 +57,8 @@ private slots:
     void oscillate_std_condition_variable_any_QMutex();
     void oscillate_std_condition_variable_any_QReadWriteLock_data() { oscillate_mutex_data(); }
     void oscillate_std_condition_variable_any_QReadWriteLock();
+    void pingPong_QWaitCondition_QMutex();
+    void pingPong_std_condition_variable_std_mutex();
 
 private:
     void oscillate_mutex_data();
@@ -194,6 +196,56 @@ void tst_QWaitCondition::oscillate_std_condition_variable_any_QReadWriteLock()
     oscillate<std::condition_variable_any, QReadWriteLock, WriteLocker>(timeout);
 }
 
+// Two threads hand a token back and forth, each waking the other with
+// wakeOne(), so the result is dominated by wake-up latency: one iteration is
+// a round trip.
+enum { PingPongRoundTrips = 20000 };
+
+template <typename Cond, typename Mutex, typename Locker, typename Wait, typename Wake>
+void pingPong(Wait wait, Wake wake)
+{
+    Cond pingPongCond;
+    Mutex mutex;
+    int owner = 0;
+
+    const auto play = [&](int me) {
+        for (int i = 0; i < PingPongRoundTrips; ++i) {
+            Locker lock(mutex);
+            while (owner != me)
+                wait(pingPongCond, lock);
+            owner = 1 - me;
+            wake(pingPongCond);
+        }
+    };
+
+    QBENCHMARK {
+        owner = 0;
+        QScopedPointer<QThread> other(QThread::create(play, 1));
+        other->start();
+        play(0);
+        other->wait();
+    }
+}
+
+void tst_QWaitCondition::pingPong_QWaitCondition_QMutex()
+{
+    struct Locker : QMutexLocker<QMutex>
+    {
+        explicit Locker(QMutex &m) : QMutexLocker<QMutex>(&m) {}
+    };
+    pingPong<QWaitCondition, QMutex, Locker>(
+            [](QWaitCondition &c, Locker &l) { c.wait(l.mutex()); },
+            [](QWaitCondition &c) { c.wakeOne(); });
+}
+
+void tst_QWaitCondition::pingPong_std_condition_variable_std_mutex()
+{
+    using Locker = std::unique_lock<std::mutex>;
+    pingPong<std::condition_variable, std::mutex, Locker>(
+            [](std::condition_variable &c, Locker &l) { c.wait(l); },
+            [](std::condition_variable &c) { c.notify_one(); });
+}
+
 QTEST_MAIN(tst_QWaitCondition)
 
 #include "tst_bench_qwaitcondition.moc"
@@ -0,0 +1,263 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QBTreeMap>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <algorithm>
+
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+#  include <malloc.h>
+#  define HAVE_MALLINFO2
+#endif
+
+class tst_QBTreeMap : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Container { BTreeMap, Map };
+    Q_ENUM(Container)
+
+private slots:
+    void initTestCase();
+
+    void insertRandom_data() { data(); }
+    void insertRandom();
+    void insertInOrder_data() { data(); }
+    void insertInOrder();
+    void lookup_data() { data(); }
+    void lookup();
+    void rangeScan_data() { data(); }
+    void rangeScan();
+    void iterate_data() { data(); }
+    void iterate();
+    void removeAndInsert_data() { data(); }
+    void removeAndInsert();
+    void memory_data();
+    void memory();
+
+private:
+    void data();
+    template <typename Function> void dispatch(Container container, Function f);
+
+    QList<quint64> keys;
+    QList<quint64> sortedKeys;
+};
+
+template <typename Function>
+void tst_QBTreeMap::dispatch(Container container, Function f)
+{
+    switch (container) {
+    case BTreeMap:
+        f(QBTreeMap<quint64, quint64>());
+        break;
+    case Map:
+        f(QMap<quint64, quint64>());
+        break;
+    }
+}
+
+void tst_QBTreeMap::initTestCase()
+{
+    // timestamps some microseconds apart, as in a time series index
+    const int maximum = 1000000;
+    QRandomGenerator generator(1);
+    quint64 timestamp = Q_UINT64_C(1650000000000000);
+    sortedKeys.reserve(maximum);
+    for (int i = 0; i < maximum; ++i) {
+        timestamp += 1 + generator.bounded(1000);
+        sortedKeys.append(timestamp);
+    }
+    keys = sortedKeys;
+    std::shuffle(keys.begin(), keys.end(), generator);
+}
+
+void tst_QBTreeMap::data()
+{
+    QTest::addColumn<Container>("container");
+    QTest::addColumn<int>("size");
+
+    for (int size : { 1000, 100000, 1000000 }) {
+        QTest::addRow("QBTreeMap:%d", size) << BTreeMap << size;
+        QTest::addRow("QMap:%d", size) << Map << size;
+    }
+}
+
+void tst_QBTreeMap::insertRandom()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    const QList<quint64> randomKeys = keys.mid(0, size);
+    dispatch(container, [&](auto c) {
+        QBENCHMARK {
+            decltype(c) map;
+            for (int i = 0; i < size; ++i)
+                map.insert(randomKeys.at(i), quint64(i));
+        }
+    });
+}
+
+void tst_QBTreeMap::insertInOrder()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto c) {
+        QBENCHMARK {
+            decltype(c) map;
+            for (int i = 0; i < size; ++i)
+                map.insert(sortedKeys.at(i), quint64(i));
+        }
+    });
+}
+
+void tst_QBTreeMap::lookup()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto map) {
+        for (int i = 0; i < size; ++i)
+            map.insert(sortedKeys.at(i), quint64(i));
+        // all of the keys looked up are in the map, in random order
+        QList<quint64> lookups;
+        for (quint64 key : std::as_const(keys)) {
+            if (key <= sortedKeys.at(size - 1))
+                lookups.append(key);
+        }
+        int found = 0;
+        QBENCHMARK {
+            for (quint64 key : std::as_const(lookups))
+                found += map.contains(key);
+        }
+        QVERIFY(found >= size);
+    });
+}
+
+void tst_QBTreeMap::rangeScan()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto map) {
+        for (int i = 0; i < size; ++i)
+            map.insert(sortedKeys.at(i), quint64(i));
+        // scans of a window of about 50 entries, starting at random times
+        const quint64 first = sortedKeys.at(0);
+        const quint64 span = sortedKeys.at(size - 1) - first;
+        const quint64 window = 50 * 500;
+        QRandomGenerator generator(2);
+        QList<quint64> starts;
+        for (int i = 0; i < 10000; ++i)
+            starts.append(first + generator.bounded(span));
+        quint64 sum = 0;
+        QBENCHMARK {
+            for (quint64 start : std::as_const(starts)) {
+                const auto end = map.cend();
+                for (auto it = map.lowerBound(start); it != end && it.key() < start + window; ++it)
+                    sum += it.value();
+            }
+        }
+        QVERIFY(sum > 0);
+    });
+}
+
+void tst_QBTreeMap::iterate()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto map) {
+        for (int i = 0; i < size; ++i)
+            map.insert(keys.at(i), quint64(i));
+        quint64 sum = 0;
+        QBENCHMARK {
+            for (auto it = map.cbegin(); it != map.cend(); ++it)
+                sum += it.value();
+        }
+        QVERIFY(sum > 0);
+    });
+}
+
+void tst_QBTreeMap::removeAndInsert()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    const QList<quint64> randomKeys = keys.mid(0, size);
+    dispatch(container, [&](auto map) {
+        for (int i = 0; i < size; ++i)
+            map.insert(randomKeys.at(i), quint64(i));
+        QBENCHMARK {
+            for (int i = 0; i < size; ++i) {
+                map.remove(randomKeys.at(i));
+                map.insert(randomKeys.at(size - 1 - i), quint64(i));
+            }
+        }
+    });
+}
+
+void tst_QBTreeMap::memory_data()
+{
+    QTest::addColumn<Container>("container");
+    QTest::addColumn<bool>("inOrder");
+    QTest::addColumn<int>("size");
+
+    for (bool inOrder : { false, true }) {
+        const char *order = inOrder ? "inOrder" : "random";
+        QTest::addRow("QBTreeMap:%s", order) << BTreeMap << inOrder << 1000000;
+        QTest::addRow("QMap:%s", order) << Map << inOrder << 1000000;
+    }
+}
+
+void tst_QBTreeMap::memory()
+{
+#ifdef HAVE_MALLINFO2
+    QFETCH(Container, container);
+    QFETCH(bool, inOrder);
+    QFETCH(int, size);
+
+    const QList<quint64> &source = inOrder ? sortedKeys : keys;
+    dispatch(container, [&](auto map) {
+        const size_t before = mallinfo2().uordblks;
+        for (int i = 0; i < size; ++i)
+            map.insert(source.at(i), quint64(i));
+        const size_t after = mallinfo2().uordblks;
+        QTest::setBenchmarkResult(after - before, QTest::BytesAllocated);
+    });
+#else
+    QSKIP("This benchmark needs mallinfo2()");
+#endif
+}
+
+QTEST_MAIN(tst_QBTreeMap)
+
+#include "tst_bench_qbtreemap.moc"
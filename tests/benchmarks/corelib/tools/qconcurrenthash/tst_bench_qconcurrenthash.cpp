@@ -0,0 +1,191 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QConcurrentHash>
+#include <QHash>
+#include <QMutex>
+#include <QRandomGenerator>
+#include <QReadWriteLock>
+#include <QTest>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+namespace {
+// QHash behind a single lock, the way such a table is usually shared today
+template <typename Lock, typename ReadLocker, typename WriteLocker>
+class LockedHash
+{
+public:
+    bool contains(quint64 key) const
+    {
+        ReadLocker locker(&lock);
+        return hash.contains(key);
+    }
+    void insert(quint64 key, quint64 value)
+    {
+        WriteLocker locker(&lock);
+        hash.insert(key, value);
+    }
+
+private:
+    mutable Lock lock;
+    QHash<quint64, quint64> hash;
+};
+
+using MutexHash = LockedHash<QMutex, QMutexLocker<QMutex>, QMutexLocker<QMutex>>;
+using ReadWriteLockHash = LockedHash<QReadWriteLock, QReadLocker, QWriteLocker>;
+} // unnamed namespace
+
+class tst_QConcurrentHash : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Container { ConcurrentHash, Mutex, ReadWriteLock };
+    Q_ENUM(Container)
+
+private slots:
+    void initTestCase();
+
+    void lookup_data() { data(); }
+    void lookup();
+    void mixed_data() { data(); }
+    void mixed();
+
+private:
+    void data();
+    template <typename Function> void dispatch(Container container, Function f);
+    template <typename Hash> void run(Hash &hash, int threadCount, int writePercent);
+
+    QList<quint64> keys;
+};
+
+static constexpr int Size = 100000;
+static constexpr int OperationsPerThread = 200000;
+
+template <typename Function>
+void tst_QConcurrentHash::dispatch(Container container, Function f)
+{
+    switch (container) {
+    case ConcurrentHash: {
+        QConcurrentHash<quint64, quint64> hash;
+        f(hash);
+        break;
+    }
+    case Mutex: {
+        MutexHash hash;
+        f(hash);
+        break;
+    }
+    case ReadWriteLock: {
+        ReadWriteLockHash hash;
+        f(hash);
+        break;
+    }
+    }
+}
+
+void tst_QConcurrentHash::initTestCase()
+{
+    QRandomGenerator generator(1);
+    for (int i = 0; i < Size; ++i)
+        keys.append(generator.generate64());
+}
+
+void tst_QConcurrentHash::data()
+{
+    QTest::addColumn<Container>("container");
+    QTest::addColumn<int>("threads");
+
+    for (int threads : { 1, 2, 4, 8 }) {
+        QTest::addRow("QConcurrentHash:%d", threads) << ConcurrentHash << threads;
+        QTest::addRow("QMutex:%d", threads) << Mutex << threads;
+        QTest::addRow("QReadWriteLock:%d", threads) << ReadWriteLock << threads;
+    }
+}
+
+// Every thread runs OperationsPerThread operations on random keys of the
+// table; writePercent of them replace the value of an existing key.
+template <typename Hash>
+void tst_QConcurrentHash::run(Hash &hash, int threadCount, int writePercent)
+{
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back(QThread::create([&hash, this, t, writePercent] {
+            QRandomGenerator generator(t + 2);
+            int found = 0;
+            for (int i = 0; i < OperationsPerThread; ++i) {
+                const quint64 key = keys.at(generator.bounded(Size));
+                if (int(generator.bounded(100)) < writePercent)
+                    hash.insert(key, quint64(i));
+                else
+                    found += hash.contains(key);
+            }
+            Q_UNUSED(found);
+        }));
+    }
+    for (const auto &thread : threads)
+        thread->start();
+    for (const auto &thread : threads)
+        thread->wait();
+}
+
+void tst_QConcurrentHash::lookup()
+{
+    QFETCH(Container, container);
+    QFETCH(int, threads);
+
+    dispatch(container, [&](auto &hash) {
+        for (int i = 0; i < Size; ++i)
+            hash.insert(keys.at(i), quint64(i));
+        QBENCHMARK {
+            run(hash, threads, 0);
+        }
+    });
+}
+
+void tst_QConcurrentHash::mixed()
+{
+    QFETCH(Container, container);
+    QFETCH(int, threads);
+
+    // 90% lookups, 10% updates
+    dispatch(container, [&](auto &hash) {
+        for (int i = 0; i < Size; ++i)
+            hash.insert(keys.at(i), quint64(i));
+        QBENCHMARK {
+            run(hash, threads, 10);
+        }
+    });
+}
+
+QTEST_MAIN(tst_QConcurrentHash)
+
+#include "tst_bench_qconcurrenthash.moc"
@@ -0,0 +1,335 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QFlatHash>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QString>
+#include <QTest>
+
+#include <unordered_map>
+
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+#  include <malloc.h>
+#  define HAVE_MALLINFO2
+#endif
+
+// std::unordered_map with the same hash function as the Qt containers
+struct QtHasher
+{
+    template <typename Key>
+    size_t operator()(const Key &key) const { return qHash(key, QHashSeed::globalSeed()); }
+};
+
+template <typename Key, typename T>
+using StdUnorderedMap = std::unordered_map<Key, T, QtHasher>;
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Container { FlatHash, Hash, UnorderedMap };
+    Q_ENUM(Container)
+
+private slots:
+    void initTestCase();
+
+    void insert_data() { data(); }
+    void insert();
+    void insertReserved_data() { data(); }
+    void insertReserved();
+    void lookupHit_data() { data(); }
+    void lookupHit();
+    void lookupMiss_data() { data(); }
+    void lookupMiss();
+    void lookupString_data() { data(); }
+    void lookupString();
+    void iterate_data() { data(); }
+    void iterate();
+    void removeAndInsert_data() { data(); }
+    void removeAndInsert();
+    void memory_data();
+    void memory();
+
+private:
+    void data();
+    template <typename Function> void dispatch(Container container, Function f);
+
+    QList<quint32> keys;
+    QList<quint32> missingKeys;
+    QStringList stringKeys;
+};
+
+template <typename Function>
+void tst_QFlatHash::dispatch(Container container, Function f)
+{
+    switch (container) {
+    case FlatHash:
+        f(QFlatHash<quint32, quint32>());
+        break;
+    case Hash:
+        f(QHash<quint32, quint32>());
+        break;
+    case UnorderedMap:
+        f(StdUnorderedMap<quint32, quint32>());
+        break;
+    }
+}
+
+template <typename Container>
+static void insertKey(Container &c, typename Container::key_type key, typename Container::mapped_type value)
+{
+    if constexpr (std::is_same_v<Container, StdUnorderedMap<typename Container::key_type,
+                                                            typename Container::mapped_type>>)
+        c.insert_or_assign(key, value);
+    else
+        c.insert(key, value);
+}
+
+template <typename Container>
+static bool containsKey(const Container &c, const typename Container::key_type &key)
+{
+    if constexpr (std::is_same_v<Container, StdUnorderedMap<typename Container::key_type,
+                                                            typename Container::mapped_type>>)
+        return c.find(key) != c.end();
+    else
+        return c.contains(key);
+}
+
+template <typename Container>
+static void removeKey(Container &c, const typename Container::key_type &key)
+{
+    if constexpr (std::is_same_v<Container, StdUnorderedMap<typename Container::key_type,
+                                                            typename Container::mapped_type>>)
+        c.erase(key);
+    else
+        c.remove(key);
+}
+
+void tst_QFlatHash::initTestCase()
+{
+    const int maximum = 1000000;
+    QRandomGenerator generator(1);
+    QSet<quint32> used;
+    keys.reserve(maximum);
+    while (keys.size() < maximum) {
+        const quint32 key = generator.generate();
+        if (!used.contains(key)) {
+            used.insert(key);
+            keys.append(key);
+        }
+    }
+    while (missingKeys.size() < maximum) {
+        const quint32 key = generator.generate();
+        if (!used.contains(key))
+            missingKeys.append(key);
+    }
+    stringKeys.reserve(maximum);
+    for (quint32 key : std::as_const(keys))
+        stringKeys.append(QStringLiteral("/usr/share/item-%1").arg(key));
+}
+
+void tst_QFlatHash::data()
+{
+    QTest::addColumn<Container>("container");
+    QTest::addColumn<int>("size");
+
+    for (int size : { 1000, 100000, 1000000 }) {
+        QTest::addRow("QFlatHash:%d", size) << FlatHash << size;
+        QTest::addRow("QHash:%d", size) << Hash << size;
+        QTest::addRow("std::unordered_map:%d", size) << UnorderedMap << size;
+    }
+}
+
+void tst_QFlatHash::insert()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto c) {
+        QBENCHMARK {
+            decltype(c) hash;
+            for (int i = 0; i < size; ++i)
+                insertKey(hash, keys.at(i), quint32(i));
+        }
+    });
+}
+
+void tst_QFlatHash::insertReserved()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto c) {
+        QBENCHMARK {
+            decltype(c) hash;
+            hash.reserve(size);
+            for (int i = 0; i < size; ++i)
+                insertKey(hash, keys.at(i), quint32(i));
+        }
+    });
+}
+
+void tst_QFlatHash::lookupHit()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto hash) {
+        for (int i = 0; i < size; ++i)
+            insertKey(hash, keys.at(i), quint32(i));
+        int found = 0;
+        QBENCHMARK {
+            for (int i = 0; i < size; ++i)
+                found += containsKey(hash, keys.at(i));
+        }
+        QVERIFY(found >= size);
+    });
+}
+
+void tst_QFlatHash::lookupMiss()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto hash) {
+        for (int i = 0; i < size; ++i)
+            insertKey(hash, keys.at(i), quint32(i));
+        int found = 0;
+        QBENCHMARK {
+            for (int i = 0; i < size; ++i)
+                found += containsKey(hash, missingKeys.at(i));
+        }
+        QCOMPARE(found, 0);
+    });
+}
+
+void tst_QFlatHash::lookupString()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    auto run = [&](auto hash) {
+        for (int i = 0; i < size; ++i)
+            insertKey(hash, stringKeys.at(i), quint32(i));
+        int found = 0;
+        QBENCHMARK {
+            for (int i = 0; i < size; ++i)
+                found += containsKey(hash, stringKeys.at(i));
+        }
+        QVERIFY(found >= size);
+    };
+    switch (container) {
+    case FlatHash:
+        run(QFlatHash<QString, quint32>());
+        break;
+    case Hash:
+        run(QHash<QString, quint32>());
+        break;
+    case UnorderedMap:
+        run(StdUnorderedMap<QString, quint32>());
+        break;
+    }
+}
+
+void tst_QFlatHash::iterate()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto hash) {
+        for (int i = 0; i < size; ++i)
+            insertKey(hash, keys.at(i), quint32(i));
+        quint64 sum = 0;
+        QBENCHMARK {
+            for (auto it = hash.cbegin(); it != hash.cend(); ++it) {
+                if constexpr (std::is_same_v<decltype(hash), StdUnorderedMap<quint32, quint32>>)
+                    sum += it->second;
+                else
+                    sum += it.value();
+            }
+        }
+        QVERIFY(sum > 0);
+    });
+}
+
+void tst_QFlatHash::removeAndInsert()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto hash) {
+        for (int i = 0; i < size; ++i)
+            insertKey(hash, keys.at(i), quint32(i));
+        QBENCHMARK {
+            for (int i = 0; i < size; ++i) {
+                removeKey(hash, keys.at(i));
+                insertKey(hash, missingKeys.at(i), quint32(i));
+            }
+            for (int i = 0; i < size; ++i) {
+                removeKey(hash, missingKeys.at(i));
+                insertKey(hash, keys.at(i), quint32(i));
+            }
+        }
+    });
+}
+
+void tst_QFlatHash::memory_data()
+{
+    QTest::addColumn<Container>("container");
+    QTest::addColumn<int>("size");
+
+    for (int size : { 1000, 1000000 }) {
+        QTest::addRow("QFlatHash:%d", size) << FlatHash << size;
+        QTest::addRow("QHash:%d", size) << Hash << size;
+        QTest::addRow("std::unordered_map:%d", size) << UnorderedMap << size;
+    }
+}
+
+void tst_QFlatHash::memory()
+{
+#ifdef HAVE_MALLINFO2
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto hash) {
+        const size_t before = mallinfo2().uordblks;
+        for (int i = 0; i < size; ++i)
+            insertKey(hash, keys.at(i), quint32(i));
+        const size_t after = mallinfo2().uordblks;
+        QTest::setBenchmarkResult(after - before, QTest::BytesAllocated);
+    });
+#else
+    QSKIP("This benchmark needs mallinfo2()");
+#endif
+}
+
+QTEST_MAIN(tst_QFlatHash)
+
+#include "tst_bench_qflathash.moc"
@@ -0,0 +1,171 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QHash>
+#include <QPersistentHash>
+#include <QRandomGenerator>
+#include <QTest>
+
+class tst_QPersistentHash : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Container { PersistentHash, Hash };
+    Q_ENUM(Container)
+
+private slots:
+    void initTestCase();
+
+    void insert_data() { data(); }
+    void insert();
+    void lookup_data() { data(); }
+    void lookup();
+    void iterate_data() { data(); }
+    void iterate();
+    void snapshotAndInsert_data() { data(); }
+    void snapshotAndInsert();
+
+private:
+    void data();
+    template <typename Function> void dispatch(Container container, Function f);
+
+    QList<quint64> keys;
+};
+
+template <typename Function>
+void tst_QPersistentHash::dispatch(Container container, Function f)
+{
+    switch (container) {
+    case PersistentHash:
+        f(QPersistentHash<quint64, quint64>());
+        break;
+    case Hash:
+        f(QHash<quint64, quint64>());
+        break;
+    }
+}
+
+void tst_QPersistentHash::initTestCase()
+{
+    QRandomGenerator generator(1);
+    for (int i = 0; i < 1000000; ++i)
+        keys.append(generator.generate64());
+}
+
+void tst_QPersistentHash::data()
+{
+    QTest::addColumn<Container>("container");
+    QTest::addColumn<int>("size");
+
+    for (int size : { 1000, 100000, 1000000 }) {
+        QTest::addRow("QPersistentHash:%d", size) << PersistentHash << size;
+        QTest::addRow("QHash:%d", size) << Hash << size;
+    }
+}
+
+void tst_QPersistentHash::insert()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto c) {
+        QBENCHMARK {
+            decltype(c) hash;
+            for (int i = 0; i < size; ++i)
+                hash.insert(keys.at(i), quint64(i));
+        }
+    });
+}
+
+void tst_QPersistentHash::lookup()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto hash) {
+        for (int i = 0; i < size; ++i)
+            hash.insert(keys.at(i), quint64(i));
+        // half of the keys looked up are in the hash
+        QRandomGenerator generator(2);
+        QList<quint64> lookups;
+        for (int i = 0; i < 100000; ++i)
+            lookups.append(i % 2 ? keys.at(generator.bounded(size)) : generator.generate64());
+        int found = 0;
+        QBENCHMARK {
+            for (quint64 key : std::as_const(lookups))
+                found += hash.contains(key);
+        }
+        QVERIFY(found > 0);
+    });
+}
+
+void tst_QPersistentHash::iterate()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto hash) {
+        for (int i = 0; i < size; ++i)
+            hash.insert(keys.at(i), quint64(i));
+        quint64 sum = 0;
+        QBENCHMARK {
+            for (auto it = hash.cbegin(); it != hash.cend(); ++it)
+                sum += it.value();
+        }
+        QVERIFY(sum > 0);
+    });
+}
+
+void tst_QPersistentHash::snapshotAndInsert()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    // versions of a configuration: each step keeps the previous state, and
+    // changes one entry of the current one
+    dispatch(container, [&](auto hash) {
+        for (int i = 0; i < size; ++i)
+            hash.insert(keys.at(i), quint64(i));
+        QRandomGenerator generator(3);
+        QList<quint64> changes;
+        for (int i = 0; i < 100; ++i)
+            changes.append(keys.at(generator.bounded(size)));
+        QList<decltype(hash)> history(16);
+        QBENCHMARK {
+            for (int step = 0; step < changes.size(); ++step) {
+                history[step % history.size()] = hash;
+                hash.insert(changes.at(step), quint64(step));
+            }
+        }
+    });
+}
+
+QTEST_MAIN(tst_QPersistentHash)
+
+#include "tst_bench_qpersistenthash.moc"
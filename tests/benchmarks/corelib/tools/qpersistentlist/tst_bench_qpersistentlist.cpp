@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QList>
+#include <QPersistentList>
+#include <QRandomGenerator>
+#include <QTest>
+
+class tst_QPersistentList : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Container { PersistentList, List };
+    Q_ENUM(Container)
+
+private slots:
+    void append_data() { data(); }
+    void append();
+    void indexedAccess_data() { data(); }
+    void indexedAccess();
+    void iterate_data() { data(); }
+    void iterate();
+    void snapshotAndModify_data() { data(); }
+    void snapshotAndModify();
+
+private:
+    void data();
+    template <typename Function> void dispatch(Container container, Function f);
+};
+
+template <typename Function>
+void tst_QPersistentList::dispatch(Container container, Function f)
+{
+    switch (container) {
+    case PersistentList:
+        f(QPersistentList<quint64>());
+        break;
+    case List:
+        f(QList<quint64>());
+        break;
+    }
+}
+
+void tst_QPersistentList::data()
+{
+    QTest::addColumn<Container>("container");
+    QTest::addColumn<int>("size");
+
+    for (int size : { 1000, 100000, 1000000 }) {
+        QTest::addRow("QPersistentList:%d", size) << PersistentList << size;
+        QTest::addRow("QList:%d", size) << List << size;
+    }
+}
+
+void tst_QPersistentList::append()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto c) {
+        QBENCHMARK {
+            decltype(c) list;
+            for (int i = 0; i < size; ++i)
+                list.append(quint64(i));
+        }
+    });
+}
+
+void tst_QPersistentList::indexedAccess()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto list) {
+        for (int i = 0; i < size; ++i)
+            list.append(quint64(i));
+        QRandomGenerator generator(1);
+        QList<int> indexes;
+        for (int i = 0; i < 100000; ++i)
+            indexes.append(generator.bounded(size));
+        quint64 sum = 0;
+        QBENCHMARK {
+            for (int i : std::as_const(indexes))
+                sum += list.at(i);
+        }
+        QVERIFY(sum > 0);
+    });
+}
+
+void tst_QPersistentList::iterate()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    dispatch(container, [&](auto list) {
+        for (int i = 0; i < size; ++i)
+            list.append(quint64(i));
+        quint64 sum = 0;
+        QBENCHMARK {
+            for (auto it = list.cbegin(); it != list.cend(); ++it)
+                sum += *it;
+        }
+        QVERIFY(sum > 0);
+    });
+}
+
+void tst_QPersistentList::snapshotAndModify()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    // an undo history: each step keeps the previous state, and changes
+    // one element of the current one
+    dispatch(container, [&](auto list) {
+        for (int i = 0; i < size; ++i)
+            list.append(quint64(i));
+        QRandomGenerator generator(2);
+        QList<int> indexes;
+        for (int i = 0; i < 100; ++i)
+            indexes.append(generator.bounded(size));
+        QList<decltype(list)> history(16);
+        QBENCHMARK {
+            for (int step = 0; step < indexes.size(); ++step) {
+                history[step % history.size()] = list;
+                list[indexes.at(step)] = quint64(step);
+            }
+        }
+    });
+}
+
+QTEST_MAIN(tst_QPersistentList)
+
+#include "tst_bench_qpersistentlist.moc"
@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QT_TESTS_SHARED_CONTAINERTESTHELPERS_H
+#define QT_TESTS_SHARED_CONTAINERTESTHELPERS_H
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qthread.h>
+
+#include <memory>
+#include <utility>
+
+namespace QTestContainerHelpers {
+
+    // An element type counting its instances, to check that a container
+    // destroys every element it constructs. The counters are atomic, so
+    // that it can be used with concurrent containers too.
+    struct Counted
+    {
+        static inline QAtomicInt constructions;
+        static inline QAtomicInt destructions;
+
+        // the number of instances that currently exist
+        static int alive()
+        { return constructions.loadRelaxed() - destructions.loadRelaxed(); }
+
+        int value = 0;
+
+        Counted(int v = 0) : value(v) { constructions.ref(); }
+        Counted(const Counted &other) : value(other.value) { constructions.ref(); }
+        Counted(Counted &&other) noexcept : value(other.value) { constructions.ref(); }
+        Counted &operator=(const Counted &other) = default;
+        Counted &operator=(Counted &&other) noexcept = default;
+        ~Counted() { destructions.ref(); }
+
+        friend bool operator==(const Counted &lhs, const Counted &rhs)
+        { return lhs.value == rhs.value; }
+        friend bool operator<(const Counted &lhs, const Counted &rhs)
+        { return lhs.value < rhs.value; }
+        friend size_t qHash(const Counted &c, size_t seed = 0)
+        { return qHash(c.value, seed); }
+    };
+
+    // A key type whose hash is chosen by the test, ignoring the seed, so
+    // that any number of keys can share all or some bits of their hashes.
+    struct Colliding
+    {
+        int value = 0;
+        size_t hash = 0;
+
+        friend bool operator==(const Colliding &lhs, const Colliding &rhs)
+        { return lhs.value == rhs.value; }
+        friend size_t qHash(const Colliding &c, size_t = 0)
+        { return c.hash; }
+    };
+
+    // Runs f in a new thread, for the producers and consumers of the
+    // concurrent containers. Destroying the result before the thread
+    // finished is fatal, so tests wait() for it.
+    template <typename Functor>
+    std::unique_ptr<QThread> startThread(Functor &&f)
+    {
+        std::unique_ptr<QThread> thread(QThread::create(std::forward<Functor>(f)));
+        thread->start();
+        return thread;
+    }
+
+} // namespace QTestContainerHelpers
+
+#endif // QT_TESTS_SHARED_CONTAINERTESTHELPERS_H